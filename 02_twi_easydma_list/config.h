@@ -24,6 +24,13 @@
     #define EEPROM_SIM_SEQ_WRITE_MAX 8    //!< Maximum number of bytes writable in one sequential access
     #define EEPROM_SIM_ADDR          0x50 //!< Simulated EEPROM TWI address
 
+    #define EEPROM_WRITER_TIMER      NRF_TIMER3 //!< TIMER starting the page writes over PPI
+    #define EEPROM_WRITE_CYCLE_US    5000 //!< EEPROM write cycle time, delay from one page to the next
+    #define EEPROM_POLL_INTERVAL_US  500  //!< Delay between ACK polls while the EEPROM is still busy
+    #define EEPROM_POLL_MAX          20   //!< ACK polls before a page write is given up
+    #define EEPROM_LOG_ENABLED       0    //!< Keep the latest raw batches in the EEPROM with eeprom_writer.c, needs TWI1_ENABLED and not TWIS1_ENABLED in config/nrf_drv_config.h
+    #define EEPROM_TWI_INST          1    //!< TWI instance of the EEPROM bus, on TWI_SCL_M and TWI_SDA_M
+
     #define TWI_SCL_M                3   //!< Master SCL pin
     #define TWI_SDA_M                4   //!< Master SDA pin
     #define EEPROM_SIM_SCL_S         31   //!< Slave SCL pin
@@ -34,4 +41,38 @@
 
     #define IN_LINE_PRINT_CNT        16  //<! Number of data bytes printed in single line
 
+    #define SAMPLE_STREAM_BINARY      1   //!< Send samples as binary frames over UARTE, 0 prints them as text
+    #define SAMPLE_STREAM_MAX_SAMPLES 16  //!< Maximum number of XYZ samples in one binary frame
+    #define SAMPLE_STREAM_CODEC       0   //!< Delta code the binary frame payload with sample_codec.c when that is shorter
+
+    #define SAMPLE_TRIGGER_INT         0  //!< Read the sensor when its INT pin signals a change, 0 reads it on every RTC0 tick
+    #define MMA7660_INT_PIN           25  //!< Pin connected to the MMA7660 INT output
+
+    #define SAMPLE_RATE_GOVERNOR       0  //!< Lower the RTC0 sample rate while the sensor is still, 0 samples at a fixed rate
+    #define GOVERNOR_ACTIVE_VAR        4  //!< Batch variance, in counts squared over X, Y and Z, that switches to the full rate
+    #define GOVERNOR_IDLE_VAR          1  //!< Batch variance below which a batch counts as idle
+    #define GOVERNOR_IDLE_BATCHES      2  //!< Idle batches in a row before the rate is halved
+    #define GOVERNOR_RATE_MIN          SAMPLES_PER_SEC_1 //!< Lowest rate, a batch of N samples then takes N seconds
+    #define MMA7660_SLEEP_COUNT      240  //!< SPCNT, idle sensor samples before it drops to its auto-wake rate
+
+    #define SAMPLE_PRINT_FEATURES      0  //!< Text output: one line of motion features per batch instead of the samples
+
+    #define SAMPLE_FILTER_ENABLED      0  //!< Filter the decoded samples with sample_filter.c before they go out
+    #define SAMPLE_FILTER_MEDIAN       1  //!< Median of three stage
+    #define SAMPLE_FILTER_FIR          1  //!< FIR low-pass stage, coefficients in sample_filter_coeffs.h
+    #define SAMPLE_FILTER_IIR          0  //!< Biquad low-pass stage, coefficients in sample_filter_coeffs.h
+
+    #define SAMPLE_RING_SIZE           4  //!< Number of batch records in the sample ring, power of two
+    #define SAMPLE_RING_BATCH_SAMPLES 16  //!< Number of XYZ samples in one batch record, the largest batch of the profiles
+
+    #define SAMPLE_PROFILE_0_HZ      120  //!< Start-up profile: RTC0 sample rate
+    #define SAMPLE_PROFILE_0_MS      133  //!< Start-up profile: batch period, sets the number of samples per batch
+    #define SAMPLE_PROFILE_1_HZ       32  //!< Profile 1 sample rate, 0 leaves the profile out
+    #define SAMPLE_PROFILE_1_MS      500  //!< Profile 1 batch period
+    #define SAMPLE_PROFILE_2_HZ        8  //!< Profile 2 sample rate, 0 leaves the profile out
+    #define SAMPLE_PROFILE_2_MS     2000  //!< Profile 2 batch period
+    #define SAMPLE_PROFILE_3_HZ        0  //!< Profile 3 sample rate, 0 leaves the profile out
+    #define SAMPLE_PROFILE_3_MS        0  //!< Profile 3 batch period
+    #define SAMPLE_PROFILE_BUTTON  BUTTON_1 //!< Button stepping to the next profile, when there is more than one
+
 /** @} */
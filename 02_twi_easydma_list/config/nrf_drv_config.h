@@ -98,7 +98,7 @@
 #define RTC0_INSTANCE_INDEX      0
 #endif
 
-#define RTC1_ENABLED 1
+#define RTC1_ENABLED 0
 
 #if (RTC1_ENABLED == 1)
 #define RTC1_CONFIG_FREQUENCY    32768
@@ -195,7 +195,8 @@
 #define TWI0_INSTANCE_INDEX      0
 #endif
 
-#define TWI1_ENABLED 0
+#define TWI1_ENABLED 0 /* Set to 1 with EEPROM_LOG_ENABLED in config.h, and TWIS1_ENABLED to 0. */
+#define TWI1_USE_EASY_DMA 1
 
 #if (TWI1_ENABLED == 1)
 #define TWI1_CONFIG_FREQUENCY    NRF_TWI_FREQ_100K
@@ -208,6 +209,24 @@
 
 #define TWI_COUNT                (TWI0_ENABLED+TWI1_ENABLED)
 
+#define TWI_QUEUE_SIZE           8    /* Transfers queued per instance, must be a power of two. */
+#define TWI_SCAN_TABLE_SIZE      5    /* Maximum number of entries in a TWIM scan table. */
+
+/* TWI driver features, disabled ones are compiled out. */
+#define TWI_BLOCKING_ENABLED     0    /* Blocking mode when no event handler is given. */
+#define TWI_LIST_ENABLED         1    /* TWIM TX/RX list post-increment. */
+#define TWI_REPEATED_ENABLED     1    /* Repeated and held transfers triggered over PPI. */
+#define TWI_QUEUE_ENABLED        1    /* Transfer queue. */
+#define TWI_SCAN_ENABLED         1    /* Multi-slave scan tables, needs TWI_LIST_ENABLED. */
+#define TWI_RECOVERY_ENABLED     1    /* Retries, bus clear and error counters. */
+
+#define TWI_RECOVERY_RETRIES          2    /* Retries of a failed transfer, up to 8. */
+#define TWI_RECOVERY_BACKOFF_US       100  /* Delay before the first blocking retry, doubled per retry. */
+#define TWI_RECOVERY_BUS_CLEAR_AFTER  3    /* Failed transfers in a row before the bus is cleared. */
+
+#define TWI_TRACE_ENABLED        0    /* Per-transfer timestamps in a trace ring. */
+#define TWI_TRACE_SIZE           32   /* Records in the trace ring, must be a power of two. */
+
 /* TWIS */
 #define TWIS0_ENABLED 0
 
@@ -221,7 +240,7 @@
     #define TWIS0_INSTANCE_INDEX      0
 #endif
 
-#define TWIS1_ENABLED 1
+#define TWIS1_ENABLED 1 /* Set to 0 with EEPROM_LOG_ENABLED, peripheral ID 1 is then the TWIM of the EEPROM log. */
 
 #if (TWIS1_ENABLED ==  1)
     #define TWIS1_CONFIG_ADDR0        0
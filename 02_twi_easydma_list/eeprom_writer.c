@@ -0,0 +1,194 @@
+/* Copyright (c) 2015 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+#include "eeprom_writer.h"
+#include "nrf.h"
+#include "nrf_error.h"
+#include "nrf_drv_ppi.h"
+#include "nrf_assert.h"
+#include "app_util.h"
+#include <string.h>
+
+// Devices up to 256 bytes take one address byte, larger ones two, most significant first.
+#define EEPROM_ADDR_BYTES   ((EEPROM_SIM_SIZE > 256) ? 2 : 1)
+
+typedef struct
+{
+    eeprom_writer_handler_t handler;
+    uint8_t const *         p_data;      //!< First byte of the page in flight.
+    uint16_t                address;     //!< EEPROM address of the page in flight.
+    uint16_t                length;      //!< Length of the whole write.
+    uint16_t                remaining;   //!< Bytes not yet accepted, including the page in flight.
+    uint8_t                 page_length; //!< Length of the page in flight.
+    uint8_t                 polls;       //!< Attempts of the page in flight that were not acknowledged.
+    volatile bool           active;
+} eeprom_writer_cb_t;
+
+static nrf_drv_twi_t const * mp_twi;
+static eeprom_writer_cb_t    m_cb;
+static uint8_t               m_page_buf[EEPROM_ADDR_BYTES + EEPROM_SIM_SEQ_WRITE_MAX]; // EasyDMA source, must stay in RAM.
+static uint32_t              m_polls;
+
+/**
+ * @brief Set up the page at the current address as a held transfer and let the TIMER start it.
+ *
+ * The memory address and the data go out in one TX, a repeated START between them would make
+ * the EEPROM take the first data byte as the address.
+ */
+static ret_code_t page_start(uint32_t delay_us)
+{
+    ret_code_t ret;
+
+    m_cb.page_length = MIN(m_cb.remaining,
+                           EEPROM_SIM_SEQ_WRITE_MAX - (m_cb.address % EEPROM_SIM_SEQ_WRITE_MAX));
+    if (EEPROM_ADDR_BYTES == 2)
+    {
+        m_page_buf[0] = (uint8_t)(m_cb.address >> 8);
+    }
+    m_page_buf[EEPROM_ADDR_BYTES - 1] = (uint8_t)m_cb.address;
+    memcpy(&m_page_buf[EEPROM_ADDR_BYTES], m_cb.p_data, m_cb.page_length);
+
+    nrf_drv_twi_xfer_desc_t xfer = NRF_DRV_TWI_XFER_DESC_TX(EEPROM_SIM_ADDR, m_page_buf,
+                                                            EEPROM_ADDR_BYTES + m_cb.page_length);
+    ret = nrf_drv_twi_xfer(mp_twi, &xfer, NRF_DRV_TWI_FLAGS_HOLD_XFER | NRF_DRV_TWI_FLAGS_NO_RETRY);
+    if (ret != NRF_SUCCESS)
+    {
+        return ret;
+    }
+
+    // The compare event is the only trigger, the short stops the TIMER until the next page.
+    EEPROM_WRITER_TIMER->CC[0] = MAX(delay_us, 1);
+    EEPROM_WRITER_TIMER->TASKS_CLEAR = 1;
+    EEPROM_WRITER_TIMER->TASKS_START = 1;
+    return NRF_SUCCESS;
+}
+
+static void write_end(ret_code_t result)
+{
+    EEPROM_WRITER_TIMER->TASKS_STOP = 1;
+    m_cb.active = false;
+    m_cb.handler(result, m_cb.length - m_cb.remaining);
+}
+
+ret_code_t eeprom_writer_init(nrf_drv_twi_t const * p_twi)
+{
+    nrf_ppi_channel_t ppi_channel;
+    ret_code_t        ret;
+
+    if (!p_twi->use_easy_dma)
+    {
+        return NRF_ERROR_NOT_SUPPORTED;
+    }
+    mp_twi = p_twi;
+
+    EEPROM_WRITER_TIMER->MODE      = TIMER_MODE_MODE_Timer << TIMER_MODE_MODE_Pos;
+    EEPROM_WRITER_TIMER->BITMODE   = TIMER_BITMODE_BITMODE_32Bit << TIMER_BITMODE_BITMODE_Pos;
+    EEPROM_WRITER_TIMER->PRESCALER = 4;
+    EEPROM_WRITER_TIMER->SHORTS    = TIMER_SHORTS_COMPARE0_STOP_Msk;
+
+    ret = nrf_drv_ppi_channel_alloc(&ppi_channel);
+    if (ret != NRF_SUCCESS)
+    {
+        return ret;
+    }
+    nrf_drv_ppi_channel_assign(ppi_channel, (uint32_t)&EEPROM_WRITER_TIMER->EVENTS_COMPARE[0],
+                               nrf_drv_twi_start_task_get(p_twi, NRF_DRV_TWI_XFER_TX));
+    return nrf_drv_ppi_channel_enable(ppi_channel);
+}
+
+ret_code_t eeprom_writer_write(uint16_t                address,
+                               uint8_t const *         p_data,
+                               uint16_t                length,
+                               eeprom_writer_handler_t handler)
+{
+    ret_code_t ret;
+
+    ASSERT(handler);
+
+    if (m_cb.active)
+    {
+        return NRF_ERROR_BUSY;
+    }
+    if ((length == 0) || ((uint32_t)address + length > EEPROM_SIM_SIZE))
+    {
+        return NRF_ERROR_INVALID_LENGTH;
+    }
+
+    m_cb.handler   = handler;
+    m_cb.p_data    = p_data;
+    m_cb.address   = address;
+    m_cb.length    = length;
+    m_cb.remaining = length;
+    m_cb.polls     = 0;
+    m_cb.active    = true;
+
+    // A previous write may still be in its write cycle, the first page polls for it like any other.
+    ret = page_start(0);
+    if (ret != NRF_SUCCESS)
+    {
+        m_cb.active = false;
+    }
+    return ret;
+}
+
+void eeprom_writer_twi_evt_handler(nrf_drv_twi_evt_t const * p_event)
+{
+    ret_code_t ret;
+
+    if (!m_cb.active || (p_event->xfer_desc.address != EEPROM_SIM_ADDR))
+    {
+        return;
+    }
+
+    switch (p_event->type)
+    {
+        case NRF_DRV_TWI_EVT_DONE:
+            m_cb.p_data    += m_cb.page_length;
+            m_cb.address   += m_cb.page_length;
+            m_cb.remaining -= m_cb.page_length;
+            m_cb.polls      = 0;
+            if (m_cb.remaining == 0)
+            {
+                write_end(NRF_SUCCESS);
+                return;
+            }
+            // Armed now, started by the TIMER once the write cycle of this page should be over.
+            ret = page_start(EEPROM_WRITE_CYCLE_US);
+            break;
+
+        case NRF_DRV_TWI_EVT_ADDRESS_NACK:
+            // Still in the write cycle, nothing of the page was taken.
+            m_polls++;
+            if (++m_cb.polls > EEPROM_POLL_MAX)
+            {
+                ret = NRF_ERROR_TIMEOUT;
+                break;
+            }
+            ret = page_start(EEPROM_POLL_INTERVAL_US);
+            break;
+
+        default:
+            // Data refused, for example by a write protected device.
+            ret = NRF_ERROR_INTERNAL;
+            break;
+    }
+
+    if (ret != NRF_SUCCESS)
+    {
+        write_end(ret);
+    }
+}
+
+uint32_t eeprom_writer_polls_get(void)
+{
+    return m_polls;
+}
@@ -0,0 +1,100 @@
+/* Copyright (c) 2015 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+#ifndef EEPROM_WRITER_H__
+#define EEPROM_WRITER_H__
+
+#include <stdint.h>
+#include "config.h"
+#include "nrf_drv_twi_mod.h"
+
+/**
+ * @defgroup eeprom_writer I2C EEPROM page writer
+ * @{
+ * @brief Writes buffers of any length to an I2C EEPROM at @ref EEPROM_SIM_ADDR.
+ *
+ * The buffer is split at the page boundaries (@ref EEPROM_SIM_SEQ_WRITE_MAX bytes) and each page
+ * goes out as one TX transfer of the memory address followed by the data, copied together into an
+ * internal buffer. Every page is set up as a held transfer and started over PPI
+ * by a one-shot TIMER (@ref EEPROM_WRITER_TIMER). The next page is set up as soon as the previous
+ * one was acknowledged, so it waits in the TWIM while the EEPROM runs its write cycle and goes out
+ * @ref EEPROM_WRITE_CYCLE_US later. If the EEPROM is still busy it does not acknowledge its
+ * address; the same page is then armed again and retried every @ref EEPROM_POLL_INTERVAL_US.
+ * The page write itself is the ACK poll, and the CPU only runs in the interrupts of each attempt.
+ *
+ * The writer needs the TWI instance to itself while a write is in progress: no other transfer
+ * may be set up on it, and nothing else may be connected to its start task.
+ */
+
+/**
+ * @brief Write completion handler.
+ *
+ * @param[in] result  NRF_SUCCESS, NRF_ERROR_TIMEOUT if the EEPROM stayed busy for
+ *                    @ref EEPROM_POLL_MAX polls, or NRF_ERROR_INTERNAL if it refused data.
+ * @param[in] written Number of bytes written before the write ended.
+ */
+typedef void (* eeprom_writer_handler_t)(ret_code_t result, uint16_t written);
+
+/**
+ * @brief Function for initializing the writer.
+ *
+ * Allocates a PPI channel connecting @ref EEPROM_WRITER_TIMER to the TX start task of @p p_twi.
+ *
+ * @param[in] p_twi   TWI instance, initialized with an event handler and using EasyDMA.
+ *
+ * @retval NRF_SUCCESS             If the writer was initialized.
+ * @retval NRF_ERROR_NOT_SUPPORTED If the instance does not use EasyDMA.
+ * @retval NRF_ERROR_NO_MEM        If no PPI channel was available.
+ */
+ret_code_t eeprom_writer_init(nrf_drv_twi_t const * p_twi);
+
+/**
+ * @brief Function for starting a write.
+ *
+ * Returns right away, @p handler is called from the TWI event handler when the last page was
+ * accepted. The EEPROM may still be in the write cycle of that page; the next write polls for it.
+ *
+ * @param[in] address  EEPROM address of the first byte.
+ * @param[in] p_data   Data to write, untouched until @p handler is called. The pages are copied
+ *                     one at a time, so it may be in flash.
+ * @param[in] length   Number of bytes.
+ * @param[in] handler  Completion handler.
+ *
+ * @retval NRF_SUCCESS              If the write was started.
+ * @retval NRF_ERROR_BUSY           If a write is already in progress.
+ * @retval NRF_ERROR_INVALID_LENGTH If the data does not fit in the EEPROM or @p length is zero.
+ */
+ret_code_t eeprom_writer_write(uint16_t                address,
+                               uint8_t const *         p_data,
+                               uint16_t                length,
+                               eeprom_writer_handler_t handler);
+
+/**
+ * @brief Function for passing the TWI events to the writer.
+ *
+ * To be called from the event handler of the instance given to @ref eeprom_writer_init.
+ * Events of other transfers are ignored.
+ *
+ * @param[in] p_event  TWI event.
+ */
+void eeprom_writer_twi_evt_handler(nrf_drv_twi_evt_t const * p_event);
+
+/**
+ * @brief Function for getting the number of page writes that found the EEPROM still busy.
+ *
+ * A count that keeps growing with every page means @ref EEPROM_WRITE_CYCLE_US is too short.
+ */
+uint32_t eeprom_writer_polls_get(void);
+
+/** @} */
+
+#endif // EEPROM_WRITER_H__
@@ -34,13 +34,56 @@
 #include "nrf_drv_twi_mod.h"
 #include "nrf_drv_ppi.h"
 #include "nrf_drv_rtc.h"
+#include "nrf_drv_gpiote.h"
+#include "sample_stream.h"
+#include "sample_ring.h"
+#include "rate_governor.h"
+#include "motion_features.h"
+#include "sample_filter.h"
+#include "sample_profile.h"
+#include "eeprom_writer.h"
 #include <string.h>
 
-#define NUMBER_OF_XFERS 16
+// Sensor rate and RTC0 timing come from the sample profiles in config.h, see sample_profile.h.
+#define SENSOR_POLL_RATE SAMPLE_PROFILE_SENSOR_RATE
 
-#define SENSOR_POLL_RATE SAMPLES_PER_SEC_16
-#define SENSOR_POLL_FREQ_MS 62
-#define CC_VALUE ((32768*SENSOR_POLL_FREQ_MS)/1000)
+// Free running RTC used for the frame timestamps.
+#define TIMESTAMP_RTC       NRF_RTC1
+
+// Presses of the profile button closer than this to the previous one are contact bounce.
+#define PROFILE_BUTTON_DEBOUNCE_MS  200
+
+// TIMER counting TWIM STOPPED events to detect the end of each half of the RX buffer.
+#define BATCH_TIMER         NRF_TIMER1
+#define BATCH_TIMER_IRQn    TIMER1_IRQn
+#define BATCH_TIMER_IRQ_HANDLER TIMER1_IRQHandler
+
+// Free running 1 MHz TIMER capturing when each stage of the pipeline happened.
+#define LATENCY_TIMER       NRF_TIMER2
+#define LATENCY_CC_TRIGGER  0
+#define LATENCY_CC_STOPPED  1
+#define LATENCY_CC_ISR      2
+#define LATENCY_CC_NOW      3
+
+#if SAMPLE_RATE_GOVERNOR && SAMPLE_TRIGGER_INT
+#error "The rate governor sets the RTC0 sample rate, it does not apply to INT sampling."
+#endif
+
+#if SAMPLE_RATE_GOVERNOR && ((SAMPLE_PROFILE_COUNT > 1) || (SAMPLE_PROFILE_0_HZ != SAMPLE_PROFILE_SENSOR_HZ))
+#error "The rate governor owns the RTC0 rate, it needs a single profile at an MMA7660 rate."
+#endif
+
+#if SAMPLE_FILTER_ENABLED && (SAMPLE_RATE_GOVERNOR || SAMPLE_TRIGGER_INT)
+#error "The filter coefficients are designed for the profile rates, the samples must come at those rates."
+#endif
+
+#if EEPROM_LOG_ENABLED && (3 * SAMPLE_RING_BATCH_SAMPLES > EEPROM_SIM_SIZE)
+#error "A batch does not fit in the EEPROM."
+#endif
+
+#if EEPROM_LOG_ENABLED && ((TWI1_ENABLED != 1) || (TWIS1_ENABLED == 1))
+#error "The EEPROM log needs TWI1_ENABLED and TWIS1_ENABLED off in config/nrf_drv_config.h."
+#endif
 
 /**
  * @brief TWI master instance
@@ -49,69 +92,506 @@
  * eeprom memory.
  */
 static const nrf_drv_twi_t m_twi_master = NRF_DRV_TWI_INSTANCE(0);
-static uint8_t m_rxbuf[3*NUMBER_OF_XFERS] = {0};
+static uint8_t m_rxbuf[2*3*SAMPLE_RING_BATCH_SAMPLES] = {0}; // Two halves, EasyDMA fills one while the other is drained.
 static uint8_t m_txbuf[1] = {0};
+#if SAMPLE_TRIGGER_INT
+static uint8_t m_int_rxbuf[4]; // X, Y, Z and TILT, reading TILT releases INT.
+#endif
 
 nrf_drv_rtc_t rtc0 = NRF_DRV_RTC_INSTANCE(0);
-nrf_drv_rtc_t rtc1 = NRF_DRV_RTC_INSTANCE(1);
 
-void twim_sync_xfer_setup(void);
+static uint8_t m_batch_samples; // Samples per RX buffer half, of the profile in use.
 
-static void rtc_event_handler(nrf_drv_rtc_int_type_t int_type)
+#if EEPROM_LOG_ENABLED
+/**
+ * @brief TWI instance of the EEPROM
+ *
+ * The page writer holds its transfers on the instance, the sensor transfers are held on the
+ * other one, so the EEPROM has a bus of its own.
+ */
+static const nrf_drv_twi_t m_twi_eeprom = NRF_DRV_TWI_INSTANCE(EEPROM_TWI_INST);
+static uint8_t             m_log_buf[3*SAMPLE_RING_BATCH_SAMPLES]; // Source of the write in progress.
+static volatile bool       m_log_busy;
+static uint16_t            m_log_address;
+static uint32_t            m_log_skipped; // Batches not logged, the previous write still in progress.
+static uint32_t            m_log_failed;  // Writes the EEPROM did not take completely.
+#endif
+
+#if !SAMPLE_TRIGGER_INT
+/**
+ * @brief Move the RTC0 trigger to another sample period
+ *
+ * RTC0 is cleared by its own compare, so only CC[0] changes. A compare that is already behind
+ * the counter would only come after the 24-bit wrap, the period is restarted then.
+ */
+static void rtc_period_set(uint32_t cc)
 {
-    int i;
-    for (i = 0; i < 3*NUMBER_OF_XFERS; i++)
+    nrf_drv_rtc_cc_set(&rtc0, 0, cc, false);
+    if (NRF_RTC0->COUNTER + 2 >= cc)
     {
-        if(m_rxbuf[i] > 31) m_rxbuf[i] = m_rxbuf[i] | 0xE0;
+        NRF_RTC0->TASKS_CLEAR = 1;
     }
+}
+#endif
 
-    printf("-----------------\n\r");
-    for (i = 0; i < NUMBER_OF_XFERS; i++)
+#if SAMPLE_RATE_GOVERNOR
+static void governor_update(sample_record_t const * p_record)
+{
+    if (rate_governor_update(p_record->samples, p_record->count))
     {
-        printf("%4i %4i %4i \n\r", (int8_t)m_rxbuf[3*i], (int8_t)m_rxbuf[3*i+1], (int8_t)m_rxbuf[3*i+2]);
+        rtc_period_set(SAMPLE_PROFILE_CC(rate_governor_hz_get()));
     }
-    memset(m_rxbuf, 0, sizeof(m_rxbuf));   
-    
-    twim_sync_xfer_setup();
-    nrf_drv_rtc_cc_set(&rtc1, 0, NUMBER_OF_XFERS*CC_VALUE+100, true);    
 }
+#endif
 
-uint32_t rtc_init(mma7660_mode_t sensor_poll_mode)
+#if SAMPLE_STREAM_BINARY
+static void batch_process(sample_record_t * p_record)
+{
+    // Values read during a sensor update cannot be read again by now, patch them before they go out.
+    (void)mma7660_batch_patch(p_record->samples, p_record->count);
+#if SAMPLE_RATE_GOVERNOR
+    governor_update(p_record);
+#endif
+#if SAMPLE_FILTER_ENABLED
+    // Filtered values stay in the 6-bit range and are packed like the raw ones.
+    (void)mma7660_decode((int8_t *)p_record->samples, p_record->samples, 3*p_record->count);
+    sample_filter_run((int8_t *)p_record->samples, p_record->count, p_record->profile);
+#endif
+    // A busy UARTE drops the frame, the host sees the gap in the sequence numbers.
+    (void)sample_stream_send(p_record->samples, p_record->count, p_record->timestamp);
+}
+#else
+#if SAMPLE_PRINT_FEATURES
+static motion_features_acc_t m_features_acc; // Zero is an empty window with no history.
+#endif
+
+static void batch_process(sample_record_t * p_record)
+{
+    uint8_t * p_batch = p_record->samples;
+    uint32_t  now;
+    uint32_t  patched;
+
+    LATENCY_TIMER->TASKS_CAPTURE[LATENCY_CC_NOW] = 1;
+    now = LATENCY_TIMER->CC[LATENCY_CC_NOW];
+
+    patched = mma7660_batch_patch(p_batch, p_record->count);
+#if SAMPLE_RATE_GOVERNOR
+    governor_update(p_record);
+#endif
+    (void)mma7660_decode((int8_t *)p_batch, p_batch, 3*p_record->count);
+#if SAMPLE_FILTER_ENABLED
+    sample_filter_run((int8_t *)p_batch, p_record->count, p_record->profile);
+#endif
+
+    printf("---- trigger->stopped %lu us, stopped->isr %lu us, queued %lu us, patched %lu\n\r",
+           (unsigned long)(p_record->stopped_time - p_record->trigger_time),
+           (unsigned long)(p_record->isr_time - p_record->stopped_time),
+           (unsigned long)(now - p_record->isr_time),
+           (unsigned long)patched);
+#if SAMPLE_PRINT_FEATURES
+    {
+        motion_features_t features;
+
+        // One line per batch instead of one per sample.
+        motion_features_add(&m_features_acc, (int8_t *)p_batch, p_record->count);
+        motion_features_get(&m_features_acc, &features);
+        printf("mean %4i %4i %4i var/16 %5u %5u %5u |a| %2u zc %2u %2u %2u orient %u events 0x%02x\n\r",
+               features.mean[0], features.mean[1], features.mean[2],
+               features.variance[0], features.variance[1], features.variance[2],
+               features.magnitude,
+               features.zero_crossings[0], features.zero_crossings[1], features.zero_crossings[2],
+               features.orientation, features.events);
+    }
+#else
+    for (int i = 0; i < p_record->count; i++)
+    {
+        printf("%4i %4i %4i \n\r", (int8_t)p_batch[3*i], (int8_t)p_batch[3*i+1], (int8_t)p_batch[3*i+2]);
+    }
+#endif
+}
+
+#if (TWI_TRACE_ENABLED == 1)
+/**
+ * @brief Print the new TWI driver trace records, one line each.
+ *
+ * The lines start with "TWI," and are read by common/tools/twi_trace_hist.py. The first field
+ * is the record index, a gap means records were overwritten before they were printed.
+ */
+static void twi_trace_export(void)
+{
+    static uint32_t     cursor;
+    nrf_drv_twi_trace_t record;
+
+    while (nrf_drv_twi_trace_read(&cursor, &record) == NRF_SUCCESS)
+    {
+        printf("TWI,%lu,%u,%u,%u,%u,%u,%u,%lu,%lu,%lu,%lu\n\r",
+               (unsigned long)(cursor - 1), record.instance, record.address, record.type,
+               record.attempts, record.errorsrc, record.bytes,
+               (unsigned long)record.submit, (unsigned long)record.start,
+               (unsigned long)record.end, (unsigned long)record.done);
+    }
+}
+#endif
+#endif
+
+static void rtc_event_handler(nrf_drv_rtc_int_type_t int_type){}
+
+#if !SAMPLE_TRIGGER_INT
+/**
+ * @brief Switch to another sample profile at the end of the second RX buffer half
+ *
+ * The RX list was just rewound and the batch TIMER cleared by its COMPARE1 short, so both
+ * halves start over with the new size. The last sample has just completed, so the next one is
+ * almost a full sample period away.
+ */
+static void profile_apply(sample_profile_t const * p_profile)
+{
+    m_batch_samples = p_profile->batch;
+    nrf_drv_twi_rx_half_size_set(&m_twi_master, p_profile->batch);
+    BATCH_TIMER->CC[0] = p_profile->batch;
+    BATCH_TIMER->CC[1] = 2*p_profile->batch;
+    rtc_period_set(p_profile->rtc_cc);
+}
+
+#if SAMPLE_PROFILE_COUNT > 1
+/**
+ * @brief Step to the next sample profile on a press of SAMPLE_PROFILE_BUTTON
+ *
+ * Contact bounce gives more edges, only the first one within PROFILE_BUTTON_DEBOUNCE_MS counts.
+ * The switch itself happens at the end of the next full RX buffer.
+ */
+static void profile_button_handler(nrf_drv_gpiote_pin_t pin, nrf_gpiote_polarity_t action)
+{
+    static uint32_t last_press;
+    uint32_t        now = TIMESTAMP_RTC->COUNTER;
+
+    // TIMESTAMP_RTC counts at 32768 Hz and wraps at 24 bits.
+    if (((now - last_press) & RTC_COUNTER_COUNTER_Msk) < PROFILE_BUTTON_DEBOUNCE_MS * 32768 / 1000)
+    {
+        return;
+    }
+    last_press = now;
+    APP_ERROR_CHECK(sample_profile_select((sample_profile_current_get() + 1) % sample_profile_count()));
+}
+
+static void profile_button_init(void)
+{
+    nrf_drv_gpiote_in_config_t config = GPIOTE_CONFIG_IN_SENSE_HITOLO(false);
+
+    config.pull = NRF_GPIO_PIN_PULLUP;
+
+    if (!nrf_drv_gpiote_is_init())
+    {
+        APP_ERROR_CHECK(nrf_drv_gpiote_init());
+    }
+    APP_ERROR_CHECK(nrf_drv_gpiote_in_init(SAMPLE_PROFILE_BUTTON, &config, profile_button_handler));
+    nrf_drv_gpiote_in_event_enable(SAMPLE_PROFILE_BUTTON, true);
+}
+#endif
+
+/**
+ * @brief Handle the end of each half of the RX buffer
+ *
+ * Sampling goes on into the other half, so the batch is only tagged and moved to the
+ * sample ring here. It is processed from the main loop.
+ */
+void BATCH_TIMER_IRQ_HANDLER(void)
+{
+    uint8_t * p_batch;
+    sample_record_t * p_record;
+    sample_profile_t const * p_profile;
+
+    LATENCY_TIMER->TASKS_CAPTURE[LATENCY_CC_ISR] = 1;
+    BATCH_TIMER->EVENTS_COMPARE[0] = 0;
+    BATCH_TIMER->EVENTS_COMPARE[1] = 0;
+
+    p_batch = nrf_drv_twi_rx_half_get(&m_twi_master);
+    if (p_batch == NULL)
+    {
+        return;
+    }
+
+    p_record = sample_ring_alloc();
+    if (p_record != NULL)
+    {
+        p_record->timestamp    = TIMESTAMP_RTC->COUNTER;
+        p_record->trigger_time = LATENCY_TIMER->CC[LATENCY_CC_TRIGGER];
+        p_record->stopped_time = LATENCY_TIMER->CC[LATENCY_CC_STOPPED];
+        p_record->isr_time     = LATENCY_TIMER->CC[LATENCY_CC_ISR];
+        p_record->count        = m_batch_samples;
+        p_record->profile      = (uint8_t)sample_profile_current_get();
+        memcpy(p_record->samples, p_batch, 3*m_batch_samples);
+        sample_ring_commit();
+    }
+
+    if ((p_batch != m_rxbuf) && ((p_profile = sample_profile_pending_take()) != NULL))
+    {
+        profile_apply(p_profile);
+    }
+}
+
+/**
+ * @brief Count the transfers with a TIMER to get an interrupt at the end of each half
+ */
+static void batch_timer_init(void)
 {
     nrf_ppi_channel_t ppi_channel;
-    
+
+    BATCH_TIMER->MODE     = TIMER_MODE_MODE_Counter << TIMER_MODE_MODE_Pos;
+    BATCH_TIMER->BITMODE  = TIMER_BITMODE_BITMODE_16Bit << TIMER_BITMODE_BITMODE_Pos;
+    BATCH_TIMER->CC[0]    = m_batch_samples;
+    BATCH_TIMER->CC[1]    = 2*m_batch_samples;
+    BATCH_TIMER->SHORTS   = TIMER_SHORTS_COMPARE1_CLEAR_Msk;
+    BATCH_TIMER->INTENSET = TIMER_INTENSET_COMPARE0_Msk | TIMER_INTENSET_COMPARE1_Msk;
+    NVIC_SetPriority(BATCH_TIMER_IRQn, APP_IRQ_PRIORITY_LOW);
+    NVIC_EnableIRQ(BATCH_TIMER_IRQn);
+    BATCH_TIMER->TASKS_CLEAR = 1;
+    BATCH_TIMER->TASKS_START = 1;
+
+    nrf_drv_ppi_channel_alloc(&ppi_channel);
+    nrf_drv_ppi_channel_assign(ppi_channel, nrf_drv_twi_stopped_event_get(&m_twi_master),
+                               (uint32_t)&BATCH_TIMER->TASKS_COUNT);
+    nrf_drv_ppi_channel_enable(ppi_channel);
+}
+#endif
+
+/**
+ * @brief Capture the sample trigger and the TWIM STOPPED of every sample in the latency TIMER
+ *
+ * @param[in] trigger_event Address of the event starting each sample read.
+ */
+static void latency_timer_init(uint32_t trigger_event)
+{
+    nrf_ppi_channel_t ppi_channel;
+
+    LATENCY_TIMER->MODE      = TIMER_MODE_MODE_Timer << TIMER_MODE_MODE_Pos;
+    LATENCY_TIMER->BITMODE   = TIMER_BITMODE_BITMODE_32Bit << TIMER_BITMODE_BITMODE_Pos;
+    LATENCY_TIMER->PRESCALER = 4;
+    LATENCY_TIMER->TASKS_CLEAR = 1;
+    LATENCY_TIMER->TASKS_START = 1;
+
+    nrf_drv_ppi_channel_alloc(&ppi_channel);
+    nrf_drv_ppi_channel_assign(ppi_channel, trigger_event,
+                               (uint32_t)&LATENCY_TIMER->TASKS_CAPTURE[LATENCY_CC_TRIGGER]);
+    nrf_drv_ppi_channel_enable(ppi_channel);
+
+    nrf_drv_ppi_channel_alloc(&ppi_channel);
+    nrf_drv_ppi_channel_assign(ppi_channel, nrf_drv_twi_stopped_event_get(&m_twi_master),
+                               (uint32_t)&LATENCY_TIMER->TASKS_CAPTURE[LATENCY_CC_STOPPED]);
+    nrf_drv_ppi_channel_enable(ppi_channel);
+}
+
+static void timestamp_rtc_init(void)
+{
     NRF_CLOCK->TASKS_LFCLKSTART = 1;
     while (NRF_CLOCK->EVENTS_LFCLKSTARTED == 0);
     
+    TIMESTAMP_RTC->PRESCALER   = 0;
+    TIMESTAMP_RTC->TASKS_START = 1;
+}
+
+uint32_t rtc_init(mma7660_mode_t sensor_poll_mode)
+{
+    nrf_ppi_channel_t ppi_channel;
+    
+    timestamp_rtc_init();
+
     nrf_drv_rtc_init(&rtc0, NULL, rtc_event_handler);
-    nrf_drv_rtc_cc_set(&rtc0, 0, CC_VALUE, false);
-    nrf_drv_rtc_enable(&rtc0);
+    nrf_drv_rtc_cc_set(&rtc0, 0, sample_profile_get(0)->rtc_cc, false);
     
     nrf_drv_ppi_channel_alloc(&ppi_channel);
-    nrf_drv_ppi_channel_assign(ppi_channel, (uint32_t)&NRF_RTC0->EVENTS_COMPARE[0], (uint32_t)&NRF_TWIM0->TASKS_STARTTX);
+    nrf_drv_ppi_channel_assign(ppi_channel, (uint32_t)&NRF_RTC0->EVENTS_COMPARE[0],
+                               nrf_drv_twi_start_task_get(&m_twi_master, NRF_DRV_TWI_XFER_TXRX));
     nrf_drv_ppi_channel_enable(ppi_channel);
     
     nrf_drv_ppi_channel_alloc(&ppi_channel);
     nrf_drv_ppi_channel_assign(ppi_channel, (uint32_t)&NRF_RTC0->EVENTS_COMPARE[0], (uint32_t)&NRF_RTC0->TASKS_CLEAR);
     nrf_drv_ppi_channel_enable(ppi_channel);
     
-    nrf_drv_rtc_init(&rtc1, NULL, rtc_event_handler);
-    nrf_drv_rtc_cc_set(&rtc1, 0, NUMBER_OF_XFERS*CC_VALUE+100, true);
-    nrf_drv_rtc_enable(&rtc1);
-    
-    nrf_drv_ppi_channel_alloc(&ppi_channel);
-    nrf_drv_ppi_channel_assign(ppi_channel, (uint32_t)&NRF_RTC1->EVENTS_COMPARE[0], (uint32_t)&NRF_RTC1->TASKS_CLEAR);
-    nrf_drv_ppi_channel_enable(ppi_channel);
+    // Sampling runs freely from here on, the RX buffer halves are swapped by the batch TIMER.
+    nrf_drv_rtc_enable(&rtc0);
     
+    return NRF_SUCCESS;
+}
+
+#if SAMPLE_TRIGGER_INT
+/**
+ * @brief Set up the INT read as a held transfer, started over PPI on every falling edge of INT
+ */
+static void int_xfer_setup(void)
+{
+    ret_code_t err_code;
+    nrf_drv_twi_xfer_desc_t xfer = NRF_DRV_TWI_XFER_DESC_TXRX(MMA7660_DEFAULT_ADDRESS,
+                                                              m_txbuf, sizeof(m_txbuf),
+                                                              m_int_rxbuf, sizeof(m_int_rxbuf));
+    uint32_t flags = NRF_DRV_TWI_FLAGS_HOLD_XFER | NRF_DRV_TWI_FLAGS_REPEATED_XFER;
+
+    // Only called once the sensor setup is done, and from the handler of the failed read.
+    err_code = nrf_drv_twi_xfer(&m_twi_master, &xfer, flags);
+    APP_ERROR_CHECK(err_code);
+}
+
+/**
+ * @brief Move the sample read on INT to the sample ring
+ *
+ * Each read is a record of its own. INT only fires on orientation and shake changes, so there
+ * is nothing to batch.
+ */
+static void int_sample_handler(nrf_drv_twi_evt_t const * p_event)
+{
+    sample_record_t * p_record;
+
+    if (p_event->xfer_desc.p_secondary_buf != m_int_rxbuf)
+    {
+        return;
+    }
+
+    if (p_event->type != NRF_DRV_TWI_EVT_DONE)
+    {
+        // The error ended the repeated transfer and INT is still asserted, so no new edge
+        // will come: arm it again and read right away.
+        int_xfer_setup();
+        if (nrf_gpio_pin_read(MMA7660_INT_PIN) == 0)
+        {
+            *(volatile uint32_t *)nrf_drv_twi_start_task_get(&m_twi_master, NRF_DRV_TWI_XFER_TXRX) = 1;
+        }
+        return;
+    }
+
+    LATENCY_TIMER->TASKS_CAPTURE[LATENCY_CC_ISR] = 1;
+    p_record = sample_ring_alloc();
+    if (p_record != NULL)
+    {
+        p_record->timestamp    = TIMESTAMP_RTC->COUNTER;
+        p_record->trigger_time = LATENCY_TIMER->CC[LATENCY_CC_TRIGGER];
+        p_record->stopped_time = LATENCY_TIMER->CC[LATENCY_CC_STOPPED];
+        p_record->isr_time     = LATENCY_TIMER->CC[LATENCY_CC_ISR];
+        p_record->count        = 1;
+        p_record->profile      = 0;
+        memcpy(p_record->samples, m_int_rxbuf, 3);
+        sample_ring_commit();
+    }
+}
+
+/**
+ * @brief Get a GPIOTE event for the falling edges of the MMA7660 INT pin
+ */
+static void int_pin_init(void)
+{
+    nrf_drv_gpiote_in_config_t config = GPIOTE_CONFIG_IN_SENSE_HITOLO(true);
+
+    // INT is open drain.
+    config.pull = NRF_GPIO_PIN_PULLUP;
+
+    if (!nrf_drv_gpiote_is_init())
+    {
+        APP_ERROR_CHECK(nrf_drv_gpiote_init());
+    }
+    APP_ERROR_CHECK(nrf_drv_gpiote_in_init(MMA7660_INT_PIN, &config, NULL));
+}
+
+/**
+ * @brief Start a sensor read on every falling edge of INT
+ */
+static void int_sampling_start(void)
+{
+    nrf_ppi_channel_t ppi_channel;
+
+    int_xfer_setup();
+
     nrf_drv_ppi_channel_alloc(&ppi_channel);
-    nrf_drv_ppi_channel_assign(ppi_channel, (uint32_t)&NRF_RTC1->EVENTS_COMPARE[0], (uint32_t)&NRF_RTC0->TASKS_CLEAR);
+    nrf_drv_ppi_channel_assign(ppi_channel, nrf_drv_gpiote_in_event_addr_get(MMA7660_INT_PIN),
+                               nrf_drv_twi_start_task_get(&m_twi_master, NRF_DRV_TWI_XFER_TXRX));
     nrf_drv_ppi_channel_enable(ppi_channel);
-    
-    
-    return NRF_SUCCESS;
+
+    nrf_drv_gpiote_in_event_enable(MMA7660_INT_PIN, false);
+
+    // An INT asserted during the sensor setup has no edge left, release it with a first read.
+    if (nrf_gpio_pin_read(MMA7660_INT_PIN) == 0)
+    {
+        *(volatile uint32_t *)nrf_drv_twi_start_task_get(&m_twi_master, NRF_DRV_TWI_XFER_TXRX) = 1;
+    }
+}
+#endif
+
+#if EEPROM_LOG_ENABLED
+static void eeprom_twi_handler(nrf_drv_twi_evt_t const * p_event, void * p_context)
+{
+    eeprom_writer_twi_evt_handler(p_event);
 }
 
-void twi_cb_handler(nrf_drv_twi_evt_t const * p_event, void * p_context){}
+static void eeprom_log_handler(ret_code_t result, uint16_t written)
+{
+    if (result != NRF_SUCCESS)
+    {
+        m_log_failed++;
+    }
+    m_log_busy = false;
+}
+
+/**
+ * @brief Initialize the EEPROM bus and the page writer
+ *
+ * @return NRF_SUCCESS or the reason of failure
+ */
+static ret_code_t eeprom_log_init(void)
+{
+    ret_code_t ret;
+    const nrf_drv_twi_config_t config =
+    {
+       .scl                = TWI_SCL_M,
+       .sda                = TWI_SDA_M,
+       .frequency          = NRF_TWI_FREQ_400K,
+       .interrupt_priority = APP_IRQ_PRIORITY_LOW
+    };
+
+    ret = nrf_drv_twi_init(&m_twi_eeprom, &config, eeprom_twi_handler, NULL);
+    if (ret != NRF_SUCCESS)
+    {
+        return ret;
+    }
+    nrf_drv_twi_enable(&m_twi_eeprom);
+    return eeprom_writer_init(&m_twi_eeprom);
+}
+
+/**
+ * @brief Write the raw samples of a batch to the EEPROM, after the previous batch
+ *
+ * The log wraps to address 0 when the batch does not fit in the rest of the EEPROM. A batch
+ * that comes while the previous one is still being written is skipped.
+ */
+static void eeprom_log(sample_record_t const * p_record)
+{
+    uint16_t length = 3*p_record->count;
+
+    if (m_log_busy)
+    {
+        m_log_skipped++;
+        return;
+    }
+    if (m_log_address + length > EEPROM_SIM_SIZE)
+    {
+        m_log_address = 0;
+    }
+    memcpy(m_log_buf, p_record->samples, length);
+    m_log_busy = true;
+    if (eeprom_writer_write(m_log_address, m_log_buf, length, eeprom_log_handler) != NRF_SUCCESS)
+    {
+        m_log_busy = false;
+        m_log_failed++;
+        return;
+    }
+    m_log_address += length;
+}
+#endif
+
+void twi_cb_handler(nrf_drv_twi_evt_t const * p_event, void * p_context)
+{
+    mma7660_twi_evt_handler(p_event);
+#if SAMPLE_TRIGGER_INT
+    int_sample_handler(p_event);
+#endif
+}
 
 /**
  * @brief Initialize the master TWI
@@ -198,30 +678,103 @@ void twim_sync_xfer_setup(void)
     xfer_desc.p_primary_buf = m_txbuf;
     xfer_desc.p_secondary_buf = m_rxbuf;
     
-    uint32_t flags = NRF_DRV_TWI_FLAGS_HOLD_XFER | NRF_DRV_TWI_FLAGS_REPEATED_XFER | 
-                     NRF_DRV_TWI_FLAGS_NO_XFER_EVT_HANDLER | NRF_DRV_TWI_FLAGS_RX_POSTINC;
+    uint32_t flags = NRF_DRV_TWI_FLAGS_HOLD_XFER | NRF_DRV_TWI_FLAGS_NO_XFER_EVT_HANDLER;
+
+    err_code = nrf_drv_twi_rx_double_buffer_xfer(&m_twi_master, &xfer_desc, m_batch_samples, flags);
+    APP_ERROR_CHECK(err_code);
+}
+
+/**
+ * @brief Sleep until the sensor setup queued by mma7660_init or mma7660_int_init is done
+ *
+ * The sample transfers are held on the instance, they can only be set up on an idle bus.
+ */
+static void sensor_init_wait(void)
+{
+    uint32_t err_code;
 
-    do {
-    err_code = nrf_drv_twi_xfer(&m_twi_master, &xfer_desc, flags);
-    } while (err_code == NRF_ERROR_BUSY);    
+    while ((err_code = mma7660_init_result_get()) == NRF_ERROR_BUSY)
+    {
+        __WFE();
+    }
+    APP_ERROR_CHECK(err_code);
 }
 
 /**
  *  The begin of the journey
  */
 int main(void)
-{    
+{
+    sample_record_t * p_record;
+
     /* Initialization of UART */
     LEDS_CONFIGURE(LEDS_MASK);
     LEDS_OFF(LEDS_MASK);
     APP_ERROR_CHECK(nrf_drv_ppi_init());
-    APP_ERROR_CHECK(uart_init());   
+#if SAMPLE_STREAM_BINARY
+    sample_stream_init(TX_PIN_NUMBER, RTS_PIN_NUMBER, CTS_PIN_NUMBER, true);
+#else
+    APP_ERROR_CHECK(uart_init());
+#endif
     APP_ERROR_CHECK(twi_master_init());        
+#if EEPROM_LOG_ENABLED
+    APP_ERROR_CHECK(eeprom_log_init());
+#endif
+#if SAMPLE_FILTER_ENABLED
+    sample_filter_init();
+#endif
+#if SAMPLE_TRIGGER_INT
+    {
+        // Orientation and shake changes only, the sensor keeps sampling but the bus stays idle.
+        const mma7660_int_config_t int_config =
+        {
+            .intsu = MMA7660_INTSU_FBINT | MMA7660_INTSU_PLINT |
+                     MMA7660_INTSU_SHINTX | MMA7660_INTSU_SHINTY | MMA7660_INTSU_SHINTZ,
+            .spcnt = 0,
+            .pdet  = MMA7660_PDET_AXES_OFF,
+            .pd    = 0
+        };
+        APP_ERROR_CHECK(mma7660_int_init(&m_twi_master, SENSOR_POLL_RATE, &int_config));
+    }
+
+    int_pin_init();
+    sensor_init_wait();
+    timestamp_rtc_init();
+    latency_timer_init(nrf_drv_gpiote_in_event_addr_get(MMA7660_INT_PIN));
+    int_sampling_start();
+#else
+#if SAMPLE_RATE_GOVERNOR
+    {
+        // The sensor drops to its auto-wake rate on its own when still, and is back at the full
+        // rate on the first orientation or shake change, before the governor has seen a batch.
+        const mma7660_int_config_t sleep_config =
+        {
+            .intsu = MMA7660_INTSU_FBINT | MMA7660_INTSU_PLINT |
+                     MMA7660_INTSU_SHINTX | MMA7660_INTSU_SHINTY | MMA7660_INTSU_SHINTZ,
+            .spcnt = MMA7660_SLEEP_COUNT,
+            .pdet  = MMA7660_PDET_AXES_OFF,
+            .pd    = 0,
+            .mode  = MMA7660_MODE_ASE | MMA7660_MODE_AWE,
+            .sr    = MMA7660_SR_AWSR_8
+        };
+        APP_ERROR_CHECK(mma7660_int_init(&m_twi_master, SENSOR_POLL_RATE, &sleep_config));
+    }
+    rate_governor_init(SENSOR_POLL_RATE);
+#else
     APP_ERROR_CHECK(mma7660_init(&m_twi_master, SENSOR_POLL_RATE));        
+#endif
     
+    sensor_init_wait();
+    m_batch_samples = sample_profile_get(0)->batch;
     twim_sync_xfer_setup();
+    batch_timer_init();
+    latency_timer_init((uint32_t)&NRF_RTC0->EVENTS_COMPARE[0]);
     
     APP_ERROR_CHECK(rtc_init(SENSOR_POLL_RATE));
+#if SAMPLE_PROFILE_COUNT > 1
+    profile_button_init();
+#endif
+#endif
     
     SCB->SCR |= SCB_SCR_SEVONPEND_Msk;    
     while(1)
@@ -229,6 +782,18 @@ int main(void)
         __sev();
         __wfe();
         __wfe();
+        while ((p_record = sample_ring_peek()) != NULL)
+        {
+#if EEPROM_LOG_ENABLED
+            // Raw values, before batch_process patches and decodes them in place.
+            eeprom_log(p_record);
+#endif
+            batch_process(p_record);
+            sample_ring_release();
+        }
+#if (TWI_TRACE_ENABLED == 1) && !SAMPLE_STREAM_BINARY
+        twi_trace_export();
+#endif
         nrf_gpio_pin_toggle(18);
     }       
 }
@@ -1,4 +1,5 @@
 #include "mma7660.h"
+#include <string.h>
 
 typedef union __attribute__((__packed__)) 
 {
@@ -12,85 +13,308 @@ typedef union __attribute__((__packed__))
     uint8_t value;
 } mma7660_raw_data_t;    
 
-uint32_t mma7660_register_write(nrf_drv_twi_t const * const p_twi_instance, uint8_t reg, uint8_t val)
+static mma7660_batch_t m_init_batch; // Read by the driver after mma7660_init returns.
+static volatile uint32_t m_init_result = NRF_SUCCESS; // NRF_ERROR_BUSY while m_init_batch is on the bus.
+static bool m_init_failed;                           // A transfer of m_init_batch failed.
+
+static uint8_t                         m_xyz_regs[3] = {MMA7660_X, MMA7660_Y, MMA7660_Z}; // EasyDMA source, must stay in RAM.
+static mma7660_raw_data_t              m_xyz_raw[3];
+static volatile mma7660_xyz_handler_t  m_xyz_handler;          // Set while an asynchronous read is pending.
+static nrf_drv_twi_t const *           mp_xyz_twi;
+static uint8_t                         m_xyz_retries;          // ALERT re-reads left for the pending read.
+
+uint32_t mma7660_decode(int8_t * p_dst, uint8_t const * p_src, uint32_t count)
 {
-    ret_code_t err_code;
-    uint8_t tx_buf[2];
-    tx_buf[0] = reg;
-    tx_buf[1] = val;
+    uint32_t alerts = 0;
+    uint32_t i = 0;
     
-    do 
+    // Four values per word. Bit 5 is the sign, 0x20 * 7 = 0xE0 sets bits 7..5 without carrying
+    // into the next byte. The ALERT bits (bit 6) are summed by the multiply into the top byte.
+    for (; i + 4 <= count; i += 4)
     {
-        err_code = nrf_drv_twi_tx(p_twi_instance, MMA7660_DEFAULT_ADDRESS, tx_buf, sizeof(tx_buf), false);
-    } while (err_code == NRF_ERROR_BUSY);    
-    
+        uint32_t word;
+        memcpy(&word, &p_src[i], sizeof(word));
+        alerts += (((word >> 6) & 0x01010101) * 0x01010101) >> 24;
+        word &= 0x3F3F3F3F;
+        word |= (word & 0x20202020) * 7;
+        memcpy(&p_dst[i], &word, sizeof(word));
+    }
+    for (; i < count; i++)
+    {
+        uint8_t value = p_src[i];
+        alerts += (value >> 6) & 1;
+        value  &= 0x3F;
+        p_dst[i] = (int8_t)(value | ((value & 0x20) * 7));
+    }
+    return alerts;
+}
+
+static void xyz_decode(mma7660_raw_data_t const * p_raw, mma7660_accelerometer_data_t * p_data)
+{
+    (void)mma7660_decode((int8_t *)p_data, (uint8_t const *)p_raw, 3);
+}
+
+void mma7660_batch_init(mma7660_batch_t * p_batch)
+{
+    p_batch->xfer_count = 0;
+    p_batch->tx_length  = 0;
+}
+
+uint32_t mma7660_batch_write(mma7660_batch_t * p_batch, uint8_t reg, uint8_t val)
+{
+    if (p_batch->tx_length == MMA7660_BATCH_MAX_BYTES)
+        return NRF_ERROR_NO_MEM;
+
+    // Append to the previous write if it ends at the register just below, the address auto-increments.
+    if (p_batch->xfer_count != 0)
+    {
+        nrf_drv_twi_xfer_desc_t * p_last = &p_batch->xfers[p_batch->xfer_count - 1];
+        if ((p_last->type == NRF_DRV_TWI_XFER_TX) &&
+            (p_last->p_primary_buf + p_last->primary_length == &p_batch->tx_buf[p_batch->tx_length]) &&
+            (p_last->p_primary_buf[0] + p_last->primary_length - 1 == reg))
+        {
+            p_batch->tx_buf[p_batch->tx_length++] = val;
+            p_last->primary_length++;
+            return NRF_SUCCESS;
+        }
+    }
+
+    if ((p_batch->xfer_count == MMA7660_BATCH_MAX_XFERS) ||
+        (p_batch->tx_length + 2 > MMA7660_BATCH_MAX_BYTES))
+        return NRF_ERROR_NO_MEM;
+
+    uint8_t * p_tx = &p_batch->tx_buf[p_batch->tx_length];
+    p_tx[0] = reg;
+    p_tx[1] = val;
+    p_batch->tx_length += 2;
+    p_batch->xfers[p_batch->xfer_count++] = (nrf_drv_twi_xfer_desc_t)
+        NRF_DRV_TWI_XFER_DESC_TX(MMA7660_DEFAULT_ADDRESS, p_tx, 2);
+    return NRF_SUCCESS;
+}
+
+uint32_t mma7660_batch_read(mma7660_batch_t * p_batch, uint8_t reg, uint8_t *buf, uint8_t num_of_bytes)
+{
+    // Extend the previous read if it stops at this register and at this buffer.
+    if (p_batch->xfer_count != 0)
+    {
+        nrf_drv_twi_xfer_desc_t * p_last = &p_batch->xfers[p_batch->xfer_count - 1];
+        if ((p_last->type == NRF_DRV_TWI_XFER_TXRX) &&
+            (p_last->p_primary_buf[0] + p_last->secondary_length == reg) &&
+            (p_last->p_secondary_buf + p_last->secondary_length == buf))
+        {
+            p_last->secondary_length += num_of_bytes;
+            return NRF_SUCCESS;
+        }
+    }
+
+    if ((p_batch->xfer_count == MMA7660_BATCH_MAX_XFERS) ||
+        (p_batch->tx_length == MMA7660_BATCH_MAX_BYTES))
+        return NRF_ERROR_NO_MEM;
+
+    uint8_t * p_tx = &p_batch->tx_buf[p_batch->tx_length++];
+    *p_tx = reg;
+    p_batch->xfers[p_batch->xfer_count++] = (nrf_drv_twi_xfer_desc_t)
+        NRF_DRV_TWI_XFER_DESC_TXRX(MMA7660_DEFAULT_ADDRESS, p_tx, 1, buf, num_of_bytes);
+    return NRF_SUCCESS;
+}
+
+uint32_t mma7660_batch_submit(nrf_drv_twi_t const * const p_twi_instance, mma7660_batch_t * p_batch)
+{
+    uint32_t err_code = NRF_SUCCESS;
+#if (TWI_QUEUE_ENABLED == 1)
+    err_code = nrf_drv_twi_xfer_queue(p_twi_instance, p_batch->xfers, p_batch->xfer_count,
+                                      NRF_DRV_TWI_FLAGS_BATCH_EVT);
+#else
+    for (uint8_t i = 0; (i < p_batch->xfer_count) && (err_code == NRF_SUCCESS); i++)
+    {
+        err_code = nrf_drv_twi_xfer(p_twi_instance, &p_batch->xfers[i], 0);
+    }
+#endif
     return err_code;
 }
 
-uint32_t mma7660_register_read(nrf_drv_twi_t const * const p_twi_instance, uint8_t reg, uint8_t *buf, uint8_t num_of_bytes)
+// Queues m_init_batch, mma7660_twi_evt_handler sets the result after its last transfer.
+static uint32_t init_batch_submit(nrf_drv_twi_t const * const p_twi_instance)
 {
-    buf[0] = reg; // Ja, denne m inn. :)
-    uint32_t err_code = nrf_drv_twi_tx(p_twi_instance, MMA7660_DEFAULT_ADDRESS, buf, sizeof(uint8_t), true);
+    uint32_t err_code;
+#if (TWI_QUEUE_ENABLED == 1)
+    m_init_result = NRF_ERROR_BUSY;
+    err_code = mma7660_batch_submit(p_twi_instance, &m_init_batch);
     if (err_code != NRF_SUCCESS)
-        return err_code;
-    
-    err_code = nrf_drv_twi_rx(p_twi_instance, MMA7660_DEFAULT_ADDRESS, buf, num_of_bytes);            
+        m_init_result = NRF_SUCCESS;
+#else
+    // Blocking mode, the batch is done on return.
+    err_code = mma7660_batch_submit(p_twi_instance, &m_init_batch);
+    m_init_result = err_code;
+#endif
     return err_code;
 }
 
+uint32_t mma7660_init_result_get(void)
+{
+    return m_init_result;
+}
+
 uint32_t mma7660_init(nrf_drv_twi_t const * const p_twi_instance, mma7660_mode_t samples_per_second)
 {
     uint32_t err_code = NRF_ERROR_INVALID_STATE;
-    if (p_twi_instance != NULL)
+    if (m_init_result == NRF_ERROR_BUSY)
     {
-        // Clear the MODE register, maybe not needed.
-        err_code = mma7660_register_write(p_twi_instance, MMA7660_MODE, 0);
-        if (err_code != NRF_SUCCESS)
-            return err_code;
-
-        err_code = mma7660_register_write(p_twi_instance, MMA7660_SR, (uint8_t)samples_per_second);
-        if (err_code != NRF_SUCCESS)
-            return err_code;
+        // The driver still reads m_init_batch.
+        err_code = NRF_ERROR_BUSY;
+    }
+    else if (p_twi_instance != NULL)
+    {
+        // Standby, sample rate and active again: MODE and SR go out in one burst, then MODE.
+        mma7660_batch_init(&m_init_batch);
+        mma7660_batch_write(&m_init_batch, MMA7660_MODE, 0);
+        mma7660_batch_write(&m_init_batch, MMA7660_SR, (uint8_t)samples_per_second);
+        mma7660_batch_write(&m_init_batch, MMA7660_MODE, MMA7660_MODE_ACTIVE);
         
-        err_code = mma7660_register_write(p_twi_instance, MMA7660_MODE, 1);
+        err_code = init_batch_submit(p_twi_instance);
     }
     return err_code;           
 }
 
-uint32_t mma7660_read_xyz(nrf_drv_twi_t const * const p_twi_instance, mma7660_accelerometer_data_t * p_data)
+uint32_t mma7660_int_init(nrf_drv_twi_t const * const p_twi_instance, mma7660_mode_t samples_per_second,
+                          mma7660_int_config_t const * p_config)
+{
+    uint32_t err_code = NRF_ERROR_INVALID_STATE;
+    if (m_init_result == NRF_ERROR_BUSY)
+    {
+        err_code = NRF_ERROR_BUSY;
+    }
+    else if ((p_twi_instance != NULL) && (p_config != NULL))
+    {
+        // Standby first, the other registers are only written in standby. SPCNT to PD then go out
+        // in one burst, MODE included, and the last write makes the sensor active.
+        mma7660_batch_init(&m_init_batch);
+        mma7660_batch_write(&m_init_batch, MMA7660_MODE, 0);
+        mma7660_batch_write(&m_init_batch, MMA7660_SPCNT, p_config->spcnt);
+        mma7660_batch_write(&m_init_batch, MMA7660_INTSU, p_config->intsu);
+        mma7660_batch_write(&m_init_batch, MMA7660_MODE, 0);
+        mma7660_batch_write(&m_init_batch, MMA7660_SR, (uint8_t)samples_per_second | p_config->sr);
+        mma7660_batch_write(&m_init_batch, MMA7660_PDET, p_config->pdet);
+        mma7660_batch_write(&m_init_batch, MMA7660_PD, p_config->pd);
+        mma7660_batch_write(&m_init_batch, MMA7660_MODE, MMA7660_MODE_ACTIVE | p_config->mode);
+        
+        err_code = init_batch_submit(p_twi_instance);
+    }
+    return err_code;
+}
+
+// Reads count axes starting at first into m_xyz_raw, in one TXRX transfer.
+static uint32_t xyz_read_start(uint8_t first, uint8_t count)
+{
+    nrf_drv_twi_xfer_desc_t xfer = NRF_DRV_TWI_XFER_DESC_TXRX(MMA7660_DEFAULT_ADDRESS, &m_xyz_regs[first], 1,
+                                                              &m_xyz_raw[first].value, count);
+    return nrf_drv_twi_xfer(mp_xyz_twi, &xfer, 0);
+}
+
+uint32_t mma7660_read_xyz_async(nrf_drv_twi_t const * const p_twi_instance, mma7660_xyz_handler_t handler)
 {
     uint32_t err_code = NRF_ERROR_INVALID_STATE;
-    mma7660_raw_data_t buffer[3];
     
-    if (p_twi_instance != NULL)
+    if ((p_twi_instance != NULL) && (handler != NULL))
     {
-        err_code = mma7660_register_read(p_twi_instance, MMA7660_X, (uint8_t*)buffer, sizeof(buffer));
-        if (err_code != NRF_SUCCESS)
-            return err_code;
+        if (m_xyz_handler != NULL)
+            return NRF_ERROR_BUSY;
         
-        /*mma7660_raw_data_t *ptr = (mma7660_raw_data_t *) buffer;
-        // Verify received data.
-        for (int i = 0; i < sizeof(buffer); i++)
+        mp_xyz_twi    = p_twi_instance;
+        m_xyz_retries = MMA7660_ALERT_RETRIES;
+        m_xyz_handler = handler;
+        err_code = xyz_read_start(0, 3);
+        if (err_code != NRF_SUCCESS)
+            m_xyz_handler = NULL;
+    }
+    return err_code;
+}
+
+void mma7660_twi_evt_handler(nrf_drv_twi_evt_t const * p_event)
+{
+    mma7660_xyz_handler_t handler = m_xyz_handler;
+    mma7660_accelerometer_data_t data;
+    uint32_t result = NRF_ERROR_INTERNAL;
+    uint8_t axis;
+    
+    // The batch is queued with NRF_DRV_TWI_FLAGS_BATCH_EVT: an event for every transfer that
+    // failed and one after the last transfer.
+    if ((p_event->xfer_desc.p_primary_buf >= m_init_batch.tx_buf) &&
+        (p_event->xfer_desc.p_primary_buf < &m_init_batch.tx_buf[MMA7660_BATCH_MAX_BYTES]))
+    {
+        if (p_event->type != NRF_DRV_TWI_EVT_DONE)
+            m_init_failed = true;
+        if (p_event->xfer_desc.p_primary_buf == m_init_batch.xfers[m_init_batch.xfer_count - 1].p_primary_buf)
         {
-            // Check ALERT bit, re-read register and start over.
-            if (ptr->fields.alert)
-            {                
-                do
-                {
-                    err_code = mma7660_register_read(p_twi_instance, i, (uint8_t*)&buffer[i], 1);
-                    if (err_code != NRF_SUCCESS)
-                        return err_code;
-                } while (
-                if (i) i--;
+            m_init_result = m_init_failed ? NRF_ERROR_INTERNAL : NRF_SUCCESS;
+            m_init_failed = false;
+        }
+        return;
+    }
+    
+    if ((handler == NULL) ||
+        (p_event->xfer_desc.type != NRF_DRV_TWI_XFER_TXRX) ||
+        (p_event->xfer_desc.p_secondary_buf < &m_xyz_raw[0].value) ||
+        (p_event->xfer_desc.p_secondary_buf > &m_xyz_raw[2].value))
+        return;
+    
+    if (p_event->type == NRF_DRV_TWI_EVT_DONE)
+    {
+        // ALERT: the register was read while the sensor updated it, read only that axis again.
+        for (axis = 0; (axis < 3) && !m_xyz_raw[axis].fields.alert; axis++)
+        {
+        }
+        if (axis == 3)
+        {
+            m_xyz_handler = NULL;
+            xyz_decode(m_xyz_raw, &data);
+            handler(NRF_SUCCESS, &data);
+            return;
+        }
+        if ((m_xyz_retries-- != 0) && (xyz_read_start(axis, 1) == NRF_SUCCESS))
+            return;
+        result = NRF_ERROR_INVALID_DATA;
+    }
+    m_xyz_handler = NULL;
+    handler(result, NULL);
+}
+
+uint32_t mma7660_batch_patch(uint8_t * p_samples, uint32_t sample_count)
+{
+    uint32_t patched = 0;
+    
+    for (uint32_t i = 0; i < sample_count; i++)
+    {
+        bool sample_patched = false;
+        for (uint32_t axis = 0; axis < 3; axis++)
+        {
+            uint8_t * p_value = &p_samples[3 * i + axis];
+            if (!(*p_value & MMA7660_ALERT_Msk))
                 continue;
+            
+            // Hold the previous reading of the axis, already patched if it needed it. The first
+            // sample of the batch has none and takes the next good reading instead.
+            uint8_t const * p_src;
+            if (i != 0)
+            {
+                p_src = &p_samples[3 * (i - 1) + axis];
+            }
+            else
+            {
+                uint32_t j;
+                for (j = 1; (j < sample_count) && (p_samples[3 * j + axis] & MMA7660_ALERT_Msk); j++)
+                {
+                }
+                if (j == sample_count)
+                    continue;
+                p_src = &p_samples[3 * j + axis];
             }
-            // Increment ptr
-            ptr++;
-        }*/
-        // Pack the raw data into a more representable format and cast to int8_t (or with 0xE0, see MMA7660 data output values)
-        p_data->x.orientation_data = buffer[0].fields.sign ? (buffer[0].fields.orientation_data | 0xE0) : buffer[0].fields.orientation_data;        
-        p_data->y.orientation_data = buffer[1].fields.sign ? (buffer[1].fields.orientation_data | 0xE0) : buffer[1].fields.orientation_data;       
-        p_data->z.orientation_data = buffer[2].fields.sign ? (buffer[2].fields.orientation_data | 0xE0) : buffer[2].fields.orientation_data;
+            if (*p_src & MMA7660_ALERT_Msk)
+                continue;
+            *p_value = *p_src;
+            sample_patched = true;
+        }
+        patched += sample_patched ? 1 : 0;
     }
-    return err_code;
+    return patched;
 }
@@ -0,0 +1,99 @@
+/* Copyright (c) 2015 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+
+#include "rate_governor.h"
+
+#if GOVERNOR_IDLE_VAR > GOVERNOR_ACTIVE_VAR
+#error "GOVERNOR_IDLE_VAR must not be above GOVERNOR_ACTIVE_VAR."
+#endif
+
+static const uint8_t m_rate_hz[] = {120, 64, 32, 16, 8, 4, 2, 1}; // Indexed by mma7660_mode_t.
+
+static mma7660_mode_t m_rate_max;
+static mma7660_mode_t m_rate;
+static uint8_t        m_idle_batches;
+
+void rate_governor_init(mma7660_mode_t rate)
+{
+    m_rate_max     = rate;
+    m_rate         = rate;
+    m_idle_batches = 0;
+}
+
+bool rate_governor_update(uint8_t const * p_samples, uint32_t count)
+{
+    int32_t  sum[3]  = {0};
+    uint32_t sum2[3] = {0};
+    uint32_t spread  = 0;
+    int8_t   xyz[3];
+    uint32_t i;
+    mma7660_mode_t rate = m_rate;
+
+    if (count == 0)
+    {
+        return false;
+    }
+
+    for (i = 0; i < count; i++)
+    {
+        (void)mma7660_decode(xyz, &p_samples[3*i], 3);
+        for (uint8_t axis = 0; axis < 3; axis++)
+        {
+            sum[axis]  += xyz[axis];
+            sum2[axis] += xyz[axis] * xyz[axis];
+        }
+    }
+    // count * count times the variance, kept in integers: 6-bit values fit for any batch size here.
+    for (uint8_t axis = 0; axis < 3; axis++)
+    {
+        spread += count * sum2[axis] - (uint32_t)(sum[axis] * sum[axis]);
+    }
+
+    if (spread >= GOVERNOR_ACTIVE_VAR * count * count)
+    {
+        m_idle_batches = 0;
+        rate = m_rate_max;
+    }
+    else if (spread < GOVERNOR_IDLE_VAR * count * count)
+    {
+        if (++m_idle_batches >= GOVERNOR_IDLE_BATCHES)
+        {
+            m_idle_batches = 0;
+            if (rate < GOVERNOR_RATE_MIN)
+            {
+                rate++;
+            }
+        }
+    }
+    else
+    {
+        m_idle_batches = 0;
+    }
+
+    if (rate == m_rate)
+    {
+        return false;
+    }
+    m_rate = rate;
+    return true;
+}
+
+mma7660_mode_t rate_governor_rate_get(void)
+{
+    return m_rate;
+}
+
+uint32_t rate_governor_hz_get(void)
+{
+    return m_rate_hz[m_rate];
+}
@@ -0,0 +1,64 @@
+/* Copyright (c) 2015 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+
+#ifndef RATE_GOVERNOR_H__
+#define RATE_GOVERNOR_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "config.h"
+#include "mma7660.h"
+
+/**
+ * @defgroup rate_governor Sample rate governor
+ * @{
+ * @brief Picks the sample rate from the motion seen in each batch.
+ *
+ * The variance of the X, Y and Z values of a batch, summed over the axes, is the activity.
+ * A batch at or above @ref GOVERNOR_ACTIVE_VAR switches to the full rate right away. After
+ * @ref GOVERNOR_IDLE_BATCHES batches in a row below @ref GOVERNOR_IDLE_VAR the rate is halved,
+ * down to @ref GOVERNOR_RATE_MIN. Anything in between keeps the current rate.
+ *
+ * The rates are those of the MMA7660 SR register, so the sensor can be kept in step.
+ */
+
+/**
+ * @brief Function for setting the full rate and starting at it.
+ *
+ * @param[in] rate  Full rate, also the rate a burst of motion switches back to.
+ */
+void rate_governor_init(mma7660_mode_t rate);
+
+/**
+ * @brief Function for feeding a batch to the governor.
+ *
+ * @param[in] p_samples  Raw X, Y, Z register values, as read from the sensor.
+ * @param[in] count      Number of XYZ samples.
+ *
+ * @return True if the batch changed the rate.
+ */
+bool rate_governor_update(uint8_t const * p_samples, uint32_t count);
+
+/**
+ * @brief Function for getting the current rate.
+ */
+mma7660_mode_t rate_governor_rate_get(void);
+
+/**
+ * @brief Function for getting the current rate in samples per second.
+ */
+uint32_t rate_governor_hz_get(void);
+
+/** @} */
+
+#endif // RATE_GOVERNOR_H__
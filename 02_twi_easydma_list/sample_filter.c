@@ -0,0 +1,157 @@
+/* Copyright (c) 2015 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+
+#include "sample_filter.h"
+#include "sample_filter_coeffs.h"
+#include <string.h>
+
+#if !SAMPLE_FILTER_MEDIAN && !SAMPLE_FILTER_FIR && !SAMPLE_FILTER_IIR
+#error "Select at least one sample filter stage."
+#endif
+
+// Coefficients designed for other rates would move every cutoff with the ratio of the rates.
+#if (SAMPLE_FILTER_DESIGN_0_HZ != SAMPLE_PROFILE_0_HZ) || (SAMPLE_FILTER_DESIGN_1_HZ != SAMPLE_PROFILE_1_HZ) || \
+    (SAMPLE_FILTER_DESIGN_2_HZ != SAMPLE_PROFILE_2_HZ) || (SAMPLE_FILTER_DESIGN_3_HZ != SAMPLE_PROFILE_3_HZ)
+#error "sample_filter_coeffs.h is for other profile rates, run tools/sample_filter_coeffs.py again."
+#endif
+
+#define SAMPLE_MIN  (-32)
+#define SAMPLE_MAX  31
+#define IIR_FRAC    8   // Fraction bits of the biquad output history.
+
+typedef struct
+{
+#if SAMPLE_FILTER_MEDIAN
+    int8_t  median[2];                          // Two previous inputs, newest first.
+#endif
+#if SAMPLE_FILTER_FIR
+    int8_t  fir[SAMPLE_FILTER_FIR_TAPS - 1];    // Previous inputs, newest first.
+#endif
+#if SAMPLE_FILTER_IIR
+    int8_t  iir_x[2];                           // Previous inputs, newest first.
+    int32_t iir_y[2];                           // Previous outputs with IIR_FRAC fraction bits.
+#endif
+} axis_state_t;
+
+#if SAMPLE_FILTER_FIR
+static const int32_t m_fir[SAMPLE_FILTER_DESIGNS][SAMPLE_FILTER_FIR_TAPS] = SAMPLE_FILTER_FIR_COEFFS;
+#endif
+#if SAMPLE_FILTER_IIR
+static const int16_t m_iir_b[SAMPLE_FILTER_DESIGNS][3] = SAMPLE_FILTER_IIR_B;
+static const int16_t m_iir_a[SAMPLE_FILTER_DESIGNS][2] = SAMPLE_FILTER_IIR_A;
+#endif
+
+static axis_state_t m_state[3];
+
+#if SAMPLE_FILTER_FIR || SAMPLE_FILTER_IIR
+static int8_t clip(int32_t value)
+{
+    return (int8_t)((value < SAMPLE_MIN) ? SAMPLE_MIN : ((value > SAMPLE_MAX) ? SAMPLE_MAX : value));
+}
+#endif
+
+#if SAMPLE_FILTER_MEDIAN
+static int8_t median_step(axis_state_t * p_state, int8_t x)
+{
+    int8_t lo = p_state->median[1];
+    int8_t hi = p_state->median[0];
+    int8_t y;
+
+    if (lo > hi)
+    {
+        lo = p_state->median[0];
+        hi = p_state->median[1];
+    }
+    // The median is the new value clamped to the range of the two previous ones.
+    y = (x < lo) ? lo : ((x > hi) ? hi : x);
+
+    p_state->median[1] = p_state->median[0];
+    p_state->median[0] = x;
+    return y;
+}
+#endif
+
+#if SAMPLE_FILTER_FIR
+static int8_t fir_step(axis_state_t * p_state, int32_t const * p_fir, int8_t x)
+{
+    int32_t acc = p_fir[0] * x;
+    uint32_t k;
+
+    for (k = 1; k < SAMPLE_FILTER_FIR_TAPS; k++)
+    {
+        acc += p_fir[k] * p_state->fir[k - 1];
+    }
+    memmove(&p_state->fir[1], &p_state->fir[0], SAMPLE_FILTER_FIR_TAPS - 2);
+    p_state->fir[0] = x;
+
+    // Arithmetic shift rounds towards minus infinity, the offset makes it round to nearest.
+    return clip((acc + (1L << (SAMPLE_FILTER_FIR_SHIFT - 1))) >> SAMPLE_FILTER_FIR_SHIFT);
+}
+#endif
+
+#if SAMPLE_FILTER_IIR
+static int8_t iir_step(axis_state_t * p_state, int16_t const * p_b, int16_t const * p_a, int8_t x)
+{
+    int32_t acc;
+    int32_t y;
+
+    // Direct form I, inputs scaled to the output history: Q14 coefficients times Q8 values.
+    acc  = p_b[0] * ((int32_t)x << IIR_FRAC);
+    acc += p_b[1] * ((int32_t)p_state->iir_x[0] << IIR_FRAC);
+    acc += p_b[2] * ((int32_t)p_state->iir_x[1] << IIR_FRAC);
+    acc -= p_a[0] * p_state->iir_y[0];
+    acc -= p_a[1] * p_state->iir_y[1];
+    y = (acc + (1L << (SAMPLE_FILTER_IIR_SHIFT - 1))) >> SAMPLE_FILTER_IIR_SHIFT;
+
+    p_state->iir_x[1] = p_state->iir_x[0];
+    p_state->iir_x[0] = x;
+    p_state->iir_y[1] = p_state->iir_y[0];
+    p_state->iir_y[0] = y;
+
+    return clip((y + (1L << (IIR_FRAC - 1))) >> IIR_FRAC);
+}
+#endif
+
+void sample_filter_init(void)
+{
+    memset(m_state, 0, sizeof(m_state));
+}
+
+void sample_filter_run(int8_t * p_xyz, uint32_t count, uint32_t profile)
+{
+#if SAMPLE_FILTER_FIR
+    int32_t const * p_fir = m_fir[profile];
+#endif
+#if SAMPLE_FILTER_IIR
+    int16_t const * p_b   = m_iir_b[profile];
+    int16_t const * p_a   = m_iir_a[profile];
+#endif
+    uint32_t i;
+
+    for (i = 0; i < 3 * count; i++)
+    {
+        axis_state_t * p_state = &m_state[i % 3];
+        int8_t         value   = p_xyz[i];
+
+#if SAMPLE_FILTER_MEDIAN
+        value = median_step(p_state, value);
+#endif
+#if SAMPLE_FILTER_FIR
+        value = fir_step(p_state, p_fir, value);
+#endif
+#if SAMPLE_FILTER_IIR
+        value = iir_step(p_state, p_b, p_a, value);
+#endif
+        p_xyz[i] = value;
+    }
+}
@@ -0,0 +1,58 @@
+/* Copyright (c) 2015 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+
+#ifndef SAMPLE_FILTER_H__
+#define SAMPLE_FILTER_H__
+
+#include <stdint.h>
+#include "config.h"
+
+/**
+ * @defgroup sample_filter Sample filter chain
+ * @{
+ * @brief Fixed-point filters run in place on decoded X, Y, Z samples.
+ *
+ * Up to three stages, in this order, each one selected in config.h:
+ * - @ref SAMPLE_FILTER_MEDIAN: median of three, drops single-sample spikes such as a value read
+ *   during a sensor update. Delays the samples by one.
+ * - @ref SAMPLE_FILTER_FIR: FIR low-pass, delays the samples by half its length.
+ * - @ref SAMPLE_FILTER_IIR: biquad low-pass, its output is kept with 8 fraction bits between
+ *   samples so that slow signals are not stuck on a 6-bit step.
+ *
+ * The coefficients are in sample_filter_coeffs.h, generated by tools/sample_filter_coeffs.py with
+ * one set for the rate of each sample profile, so the cutoffs stay at the same frequency in every
+ * profile. sample_filter.c stops the build if the rates there do not match config.h. The filter
+ * state carries over from one call to the next, also across a profile switch, so consecutive
+ * batches are filtered as one stream. Results are rounded and clipped to the 6-bit sensor range,
+ * so they still pack into the binary stream frames.
+ */
+
+/**
+ * @brief Function for clearing the filter state.
+ *
+ * The first samples after this see an input history of zeros.
+ */
+void sample_filter_init(void);
+
+/**
+ * @brief Function for filtering samples in place.
+ *
+ * @param[in,out] p_xyz    X, Y, Z values in counts, as returned by mma7660_decode.
+ * @param[in]     count    Number of XYZ samples.
+ * @param[in]     profile  Sample profile the samples were taken with, selects the coefficients.
+ */
+void sample_filter_run(int8_t * p_xyz, uint32_t count, uint32_t profile);
+
+/** @} */
+
+#endif // SAMPLE_FILTER_H__
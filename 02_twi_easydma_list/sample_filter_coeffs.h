@@ -0,0 +1,48 @@
+/* Copyright (c) 2015 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+// Generated by tools/sample_filter_coeffs.py --fir-cutoff 15.0 --fir-taps 7 --fs 120,32,8 --iir-cutoff 10.0 --iir-q 0.7071
+// Do not edit, run the script again with other settings instead.
+
+#ifndef SAMPLE_FILTER_COEFFS_H__
+#define SAMPLE_FILTER_COEFFS_H__
+
+// Sample rates of the coefficient sets, the profile rates in config.h.
+#define SAMPLE_FILTER_DESIGNS     3
+#define SAMPLE_FILTER_DESIGN_0_HZ 120
+#define SAMPLE_FILTER_DESIGN_1_HZ 32
+#define SAMPLE_FILTER_DESIGN_2_HZ 8
+#define SAMPLE_FILTER_DESIGN_3_HZ 0
+
+// FIR low-pass, 15 Hz cutoff, Q15, taps sum to 32768.
+#define SAMPLE_FILTER_FIR_TAPS    7
+#define SAMPLE_FILTER_FIR_SHIFT   15
+#define SAMPLE_FILTER_FIR_COEFFS  { \
+    {278, 2286, 8029, 11582, 8029, 2286, 278}, \
+    {154, -616, 1559, 30574, 1559, -616, 154}, \
+    {0, 0, 0, 32768, 0, 0, 0}, \
+}
+
+// Biquad low-pass, 10 Hz cutoff, Q 0.7071, Q14, a0 = 1.
+#define SAMPLE_FILTER_IIR_SHIFT   14
+#define SAMPLE_FILTER_IIR_B       { \
+    {811, 1622, 811}, \
+    {6851, 13703, 6851}, \
+    {16384, 0, 0}, \
+}
+#define SAMPLE_FILTER_IIR_A       { \
+    {-20965, 7825}, \
+    {7585, 3436}, \
+    {0, 0}, \
+}
+
+#endif // SAMPLE_FILTER_COEFFS_H__
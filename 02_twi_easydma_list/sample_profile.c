@@ -0,0 +1,103 @@
+/* Copyright (c) 2015 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+#include "sample_profile.h"
+#include <stddef.h>
+#include "nrf_error.h"
+
+#if (SAMPLE_PROFILE_0_HZ < 1) || (SAMPLE_PROFILE_0_HZ > SAMPLE_PROFILE_MAX_HZ)
+#error "SAMPLE_PROFILE_0_HZ must be between 1 and SAMPLE_PROFILE_MAX_HZ."
+#endif
+#if (SAMPLE_PROFILE_1_HZ > SAMPLE_PROFILE_MAX_HZ) || (SAMPLE_PROFILE_2_HZ > SAMPLE_PROFILE_MAX_HZ) || \
+    (SAMPLE_PROFILE_3_HZ > SAMPLE_PROFILE_MAX_HZ)
+#error "A profile rate is above SAMPLE_PROFILE_MAX_HZ."
+#endif
+#if (SAMPLE_PROFILE_3_HZ && !SAMPLE_PROFILE_2_HZ) || (SAMPLE_PROFILE_2_HZ && !SAMPLE_PROFILE_1_HZ)
+#error "The profiles must be numbered without gaps."
+#endif
+
+#define SAMPLE_PROFILE_BATCH_OK(hz, ms) \
+    (((hz) == 0) || ((SAMPLE_PROFILE_BATCH(hz, ms) >= 1) && \
+                     (SAMPLE_PROFILE_BATCH(hz, ms) <= SAMPLE_RING_BATCH_SAMPLES)))
+
+#if !SAMPLE_PROFILE_BATCH_OK(SAMPLE_PROFILE_0_HZ, SAMPLE_PROFILE_0_MS) || \
+    !SAMPLE_PROFILE_BATCH_OK(SAMPLE_PROFILE_1_HZ, SAMPLE_PROFILE_1_MS) || \
+    !SAMPLE_PROFILE_BATCH_OK(SAMPLE_PROFILE_2_HZ, SAMPLE_PROFILE_2_MS) || \
+    !SAMPLE_PROFILE_BATCH_OK(SAMPLE_PROFILE_3_HZ, SAMPLE_PROFILE_3_MS)
+#error "A profile batch is empty or larger than SAMPLE_RING_BATCH_SAMPLES, change its rate or period."
+#endif
+
+// The TWI driver counts the transfers of an RX list half in a byte.
+#if SAMPLE_RING_BATCH_SAMPLES > 255
+#error "SAMPLE_RING_BATCH_SAMPLES must not exceed 255."
+#endif
+
+// A batch goes out as one binary frame, a larger one would be refused by sample_stream_send.
+#if SAMPLE_STREAM_BINARY && (SAMPLE_RING_BATCH_SAMPLES > SAMPLE_STREAM_MAX_SAMPLES)
+#error "SAMPLE_RING_BATCH_SAMPLES must not exceed SAMPLE_STREAM_MAX_SAMPLES."
+#endif
+
+#define PROFILE(hz, ms) {SAMPLE_PROFILE_CC(hz), SAMPLE_PROFILE_BATCH(hz, ms), hz}
+
+static const sample_profile_t m_profiles[SAMPLE_PROFILE_COUNT] =
+{
+    PROFILE(SAMPLE_PROFILE_0_HZ, SAMPLE_PROFILE_0_MS),
+#if SAMPLE_PROFILE_1_HZ
+    PROFILE(SAMPLE_PROFILE_1_HZ, SAMPLE_PROFILE_1_MS),
+#endif
+#if SAMPLE_PROFILE_2_HZ
+    PROFILE(SAMPLE_PROFILE_2_HZ, SAMPLE_PROFILE_2_MS),
+#endif
+#if SAMPLE_PROFILE_3_HZ
+    PROFILE(SAMPLE_PROFILE_3_HZ, SAMPLE_PROFILE_3_MS),
+#endif
+};
+
+static uint32_t          m_current;
+static volatile uint32_t m_requested; // Written by the application, read by the batch interrupt.
+
+uint32_t sample_profile_count(void)
+{
+    return SAMPLE_PROFILE_COUNT;
+}
+
+sample_profile_t const * sample_profile_get(uint32_t index)
+{
+    return &m_profiles[index];
+}
+
+uint32_t sample_profile_select(uint32_t index)
+{
+    if (index >= SAMPLE_PROFILE_COUNT)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+    m_requested = index;
+    return NRF_SUCCESS;
+}
+
+sample_profile_t const * sample_profile_pending_take(void)
+{
+    uint32_t requested = m_requested;
+
+    if (requested == m_current)
+    {
+        return NULL;
+    }
+    m_current = requested;
+    return &m_profiles[requested];
+}
+
+uint32_t sample_profile_current_get(void)
+{
+    return m_current;
+}
@@ -0,0 +1,131 @@
+/* Copyright (c) 2015 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+#ifndef SAMPLE_PROFILE_H__
+#define SAMPLE_PROFILE_H__
+
+#include <stdint.h>
+#include "config.h"
+#include "mma7660.h"
+
+/**
+ * @defgroup sample_profile Sample timing profiles
+ * @{
+ * @brief RTC0 compare values and batch sizes derived from a sample rate and a batch period.
+ *
+ * Up to four profiles are given in config.h, each as a sample rate SAMPLE_PROFILE_<n>_HZ and
+ * the time to fill one batch, SAMPLE_PROFILE_<n>_MS. Profile 0 is used from start-up. The
+ * RTC0 compare value, the number of samples per batch and the MMA7660 rate are derived from
+ * them at compile time, and sample_profile.c rejects with #error a profile that
+ * - is not between 1 Hz and the fastest MMA7660 rate, @ref SAMPLE_PROFILE_MAX_HZ,
+ * - has a batch of less than one sample or more than @ref SAMPLE_RING_BATCH_SAMPLES,
+ * - follows a profile that was left out.
+ *
+ * RTC0 runs with PRESCALER 0, which covers 1 Hz to 120 Hz in its 24-bit compare with less
+ * than 0.2 percent rate error. The sensor runs at the lowest MMA7660 rate that keeps up with
+ * the fastest profile, so switching profiles does not touch the sensor.
+ */
+
+#define SAMPLE_PROFILE_RTC_HZ       32768   /**< RTC0 tick rate. */
+#define SAMPLE_PROFILE_MAX_HZ       120     /**< Fastest MMA7660 rate. */
+
+/**@brief RTC0 compare value of a sample rate, in ticks per sample. */
+#define SAMPLE_PROFILE_CC(hz)           ((SAMPLE_PROFILE_RTC_HZ + (hz) / 2) / (hz))
+
+/**@brief Number of samples in a batch, rounded to the nearest. */
+#define SAMPLE_PROFILE_BATCH(hz, ms)    (((hz) * (ms) + 500) / 1000)
+
+#define SAMPLE_PROFILE_MAX_(a, b)       (((a) > (b)) ? (a) : (b))
+
+/**@brief Rate of the fastest profile. */
+#define SAMPLE_PROFILE_FASTEST_HZ                                                  \
+    SAMPLE_PROFILE_MAX_(SAMPLE_PROFILE_MAX_(SAMPLE_PROFILE_0_HZ, SAMPLE_PROFILE_1_HZ), \
+                        SAMPLE_PROFILE_MAX_(SAMPLE_PROFILE_2_HZ, SAMPLE_PROFILE_3_HZ))
+
+#define SAMPLE_PROFILE_COUNT \
+    (1 + (SAMPLE_PROFILE_1_HZ != 0) + (SAMPLE_PROFILE_2_HZ != 0) + (SAMPLE_PROFILE_3_HZ != 0))
+
+// MMA7660 rate set at start-up, and the same in samples per second.
+#if   SAMPLE_PROFILE_FASTEST_HZ > 64
+    #define SAMPLE_PROFILE_SENSOR_RATE  SAMPLES_PER_SEC_120
+    #define SAMPLE_PROFILE_SENSOR_HZ    120
+#elif SAMPLE_PROFILE_FASTEST_HZ > 32
+    #define SAMPLE_PROFILE_SENSOR_RATE  SAMPLES_PER_SEC_64
+    #define SAMPLE_PROFILE_SENSOR_HZ    64
+#elif SAMPLE_PROFILE_FASTEST_HZ > 16
+    #define SAMPLE_PROFILE_SENSOR_RATE  SAMPLES_PER_SEC_32
+    #define SAMPLE_PROFILE_SENSOR_HZ    32
+#elif SAMPLE_PROFILE_FASTEST_HZ > 8
+    #define SAMPLE_PROFILE_SENSOR_RATE  SAMPLES_PER_SEC_16
+    #define SAMPLE_PROFILE_SENSOR_HZ    16
+#elif SAMPLE_PROFILE_FASTEST_HZ > 4
+    #define SAMPLE_PROFILE_SENSOR_RATE  SAMPLES_PER_SEC_8
+    #define SAMPLE_PROFILE_SENSOR_HZ    8
+#elif SAMPLE_PROFILE_FASTEST_HZ > 2
+    #define SAMPLE_PROFILE_SENSOR_RATE  SAMPLES_PER_SEC_4
+    #define SAMPLE_PROFILE_SENSOR_HZ    4
+#elif SAMPLE_PROFILE_FASTEST_HZ > 1
+    #define SAMPLE_PROFILE_SENSOR_RATE  SAMPLES_PER_SEC_2
+    #define SAMPLE_PROFILE_SENSOR_HZ    2
+#else
+    #define SAMPLE_PROFILE_SENSOR_RATE  SAMPLES_PER_SEC_1
+    #define SAMPLE_PROFILE_SENSOR_HZ    1
+#endif
+
+typedef struct
+{
+    uint16_t rtc_cc;    //!< RTC0 compare value, ticks per sample.
+    uint8_t  batch;     //!< Number of samples per batch.
+    uint8_t  hz;        //!< Sample rate.
+} sample_profile_t;
+
+/**
+ * @brief Function for getting the number of profiles.
+ */
+uint32_t sample_profile_count(void);
+
+/**
+ * @brief Function for getting a profile.
+ *
+ * @param[in] index  Profile number, less than @ref sample_profile_count.
+ */
+sample_profile_t const * sample_profile_get(uint32_t index);
+
+/**
+ * @brief Function for switching to another profile.
+ *
+ * Only the request is recorded here. The RTC sampling picks it up with
+ * @ref sample_profile_pending_take at the end of the next full RX buffer, where the RTC0 compare,
+ * the batch TIMER and the RX list halves are changed in place. The PPI connections stay as they are.
+ *
+ * @param[in] index  Profile number.
+ *
+ * @retval NRF_SUCCESS             If the switch was requested.
+ * @retval NRF_ERROR_INVALID_PARAM If there is no such profile.
+ */
+uint32_t sample_profile_select(uint32_t index);
+
+/**
+ * @brief Function for taking a requested profile switch.
+ *
+ * @return The profile to switch to, or NULL if the current one stays.
+ */
+sample_profile_t const * sample_profile_pending_take(void);
+
+/**
+ * @brief Function for getting the number of the profile in use.
+ */
+uint32_t sample_profile_current_get(void);
+
+/** @} */
+
+#endif // SAMPLE_PROFILE_H__
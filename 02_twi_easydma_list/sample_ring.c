@@ -0,0 +1,64 @@
+/* Copyright (c) 2015 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+#include "sample_ring.h"
+#include "nrf.h"
+
+#if (SAMPLE_RING_SIZE & (SAMPLE_RING_SIZE - 1)) || (SAMPLE_RING_SIZE > 128)
+#error "SAMPLE_RING_SIZE must be a power of two not larger than 128."
+#endif
+
+#define SAMPLE_RING_MASK (SAMPLE_RING_SIZE - 1)
+
+static sample_record_t  m_records[SAMPLE_RING_SIZE];
+static volatile uint8_t m_head;     // Written by the producer only.
+static volatile uint8_t m_tail;     // Written by the consumer only.
+static uint32_t         m_overflow;
+
+sample_record_t * sample_ring_alloc(void)
+{
+    if ((uint8_t)(m_head - m_tail) == SAMPLE_RING_SIZE)
+    {
+        m_overflow++;
+        return NULL;
+    }
+    return &m_records[m_head & SAMPLE_RING_MASK];
+}
+
+void sample_ring_commit(void)
+{
+    // The record must be complete before the consumer can see it.
+    __DMB();
+    m_head++;
+}
+
+sample_record_t * sample_ring_peek(void)
+{
+    if (m_head == m_tail)
+    {
+        return NULL;
+    }
+    __DMB();
+    return &m_records[m_tail & SAMPLE_RING_MASK];
+}
+
+void sample_ring_release(void)
+{
+    // Done with the record before the producer may reuse it.
+    __DMB();
+    m_tail++;
+}
+
+uint32_t sample_ring_overflow_get(void)
+{
+    return m_overflow;
+}
@@ -0,0 +1,73 @@
+/* Copyright (c) 2015 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+#ifndef SAMPLE_RING_H__
+#define SAMPLE_RING_H__
+
+#include <stdint.h>
+#include "config.h"
+
+/**
+ * @defgroup sample_ring Timestamped sample ring
+ * @{
+ * @brief Single producer, single consumer ring of fixed-size batch records.
+ *
+ * The producer (the batch interrupt) fills a record in place between @ref sample_ring_alloc
+ * and @ref sample_ring_commit. The consumer (the main loop) reads it in place between
+ * @ref sample_ring_peek and @ref sample_ring_release. Neither side takes a lock, each index
+ * is written by one side only.
+ */
+
+/**@brief One batch of samples with the times it went through the pipeline. */
+typedef struct
+{
+    uint32_t timestamp;     //!< RTC1 counter when the batch was handed over.
+    uint32_t trigger_time;  //!< Latency TIMER capture of the RTC0 or INT trigger of the last sample.
+    uint32_t stopped_time;  //!< Latency TIMER capture of the TWIM STOPPED of the last sample.
+    uint32_t isr_time;      //!< Latency TIMER capture at batch interrupt entry.
+    uint8_t  count;         //!< Number of samples, a single one when sampling on the sensor INT.
+    uint8_t  profile;       //!< Sample profile the batch was taken with.
+    uint8_t  samples[3 * SAMPLE_RING_BATCH_SAMPLES]; //!< Raw X, Y, Z register values.
+} sample_record_t;
+
+/**
+ * @brief Function for getting the record to fill next.
+ *
+ * @return Pointer to the record, or NULL if the ring is full. An overflow is counted then.
+ */
+sample_record_t * sample_ring_alloc(void);
+
+/**
+ * @brief Function for handing the record from @ref sample_ring_alloc over to the consumer.
+ */
+void sample_ring_commit(void);
+
+/**
+ * @brief Function for getting the oldest committed record.
+ *
+ * @return Pointer to the record, or NULL if the ring is empty.
+ */
+sample_record_t * sample_ring_peek(void);
+
+/**
+ * @brief Function for returning the record from @ref sample_ring_peek to the producer.
+ */
+void sample_ring_release(void);
+
+/**
+ * @brief Function for getting the number of batches lost because the ring was full.
+ */
+uint32_t sample_ring_overflow_get(void);
+
+/** @} */
+
+#endif // SAMPLE_RING_H__
@@ -0,0 +1,172 @@
+/* Copyright (c) 2015 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+#include "sample_stream.h"
+#include "nrf.h"
+#include "nrf_error.h"
+#if SAMPLE_STREAM_CODEC
+#include "sample_codec.h"
+#endif
+
+static uint8_t  m_frame[SAMPLE_STREAM_FRAME_SIZE(SAMPLE_STREAM_MAX_SAMPLES)]; // EasyDMA source, must stay in RAM.
+static uint16_t m_sequence;
+static uint32_t m_dropped;
+static bool     m_tx_active;
+
+/**
+ * @brief CRC-16-CCITT, same algorithm as crc16_compute in the SDK.
+ */
+static uint16_t crc16_ccitt(uint8_t const * p_data, uint32_t size)
+{
+    uint16_t crc = 0xFFFF;
+    uint32_t i;
+
+    for (i = 0; i < size; i++)
+    {
+        crc  = (uint8_t)(crc >> 8) | (crc << 8);
+        crc ^= p_data[i];
+        crc ^= (uint8_t)(crc & 0xFF) >> 4;
+        crc ^= (crc << 8) << 4;
+        crc ^= ((crc & 0xFF) << 4) << 1;
+    }
+    return crc;
+}
+
+/**
+ * @brief Pack the 6-bit values LSB first, four values in three bytes.
+ *
+ * @return Number of bytes written.
+ */
+static uint32_t samples_pack(uint8_t * p_dst, uint8_t const * p_src, uint32_t values)
+{
+    uint8_t * p_start = p_dst;
+    uint32_t  acc = 0;
+    uint32_t  bits = 0;
+    uint32_t  i;
+
+    for (i = 0; i < values; i++)
+    {
+        acc  |= (uint32_t)(p_src[i] & 0x3F) << bits;
+        bits += 6;
+        while (bits >= 8)
+        {
+            *p_dst++ = (uint8_t)acc;
+            acc  >>= 8;
+            bits  -= 8;
+        }
+    }
+    if (bits > 0)
+    {
+        *p_dst++ = (uint8_t)acc;
+    }
+    return p_dst - p_start;
+}
+
+void sample_stream_init(uint32_t tx_pin, uint32_t rts_pin, uint32_t cts_pin, bool hwfc)
+{
+    NRF_GPIO->OUTSET = 1UL << tx_pin;
+    NRF_GPIO->DIRSET = 1UL << tx_pin;
+
+    NRF_UARTE0->PSEL.TXD = tx_pin;
+    NRF_UARTE0->PSEL.RXD = 0xFFFFFFFF;
+    if (hwfc)
+    {
+        NRF_UARTE0->PSEL.RTS = rts_pin;
+        NRF_UARTE0->PSEL.CTS = cts_pin;
+        NRF_UARTE0->CONFIG   = UARTE_CONFIG_HWFC_Enabled << UARTE_CONFIG_HWFC_Pos;
+    }
+    else
+    {
+        NRF_UARTE0->PSEL.RTS = 0xFFFFFFFF;
+        NRF_UARTE0->PSEL.CTS = 0xFFFFFFFF;
+        NRF_UARTE0->CONFIG   = 0;
+    }
+    NRF_UARTE0->BAUDRATE = UARTE_BAUDRATE_BAUDRATE_Baud460800 << UARTE_BAUDRATE_BAUDRATE_Pos;
+    NRF_UARTE0->INTENCLR = 0xFFFFFFFF;
+    NRF_UARTE0->ENABLE   = UARTE_ENABLE_ENABLE_Enabled << UARTE_ENABLE_ENABLE_Pos;
+
+    m_frame[0]  = SAMPLE_STREAM_SYNC_0;
+    m_frame[1]  = SAMPLE_STREAM_SYNC_1;
+    m_sequence  = 0;
+    m_dropped   = 0;
+    m_tx_active = false;
+}
+
+uint32_t sample_stream_send(uint8_t const * p_samples, uint8_t sample_count, uint32_t timestamp)
+{
+    uint32_t length;
+    uint16_t crc;
+    uint16_t sequence = m_sequence++;
+
+    if (sample_count > SAMPLE_STREAM_MAX_SAMPLES)
+    {
+        return NRF_ERROR_INVALID_LENGTH;
+    }
+
+    // No interrupt is used, completion is polled when the next frame is due.
+    if (m_tx_active && !NRF_UARTE0->EVENTS_ENDTX)
+    {
+        m_dropped++;
+        return NRF_ERROR_BUSY;
+    }
+
+    m_frame[2] = sample_count;
+    m_frame[3] = (uint8_t)sequence;
+    m_frame[4] = (uint8_t)(sequence >> 8);
+    m_frame[5] = (uint8_t)timestamp;
+    m_frame[6] = (uint8_t)(timestamp >> 8);
+    m_frame[7] = (uint8_t)(timestamp >> 16);
+    m_frame[8] = (uint8_t)(timestamp >> 24);
+    m_frame[9] = (uint8_t)m_dropped;
+    m_frame[10] = (uint8_t)(m_dropped >> 8);
+
+    length = SAMPLE_STREAM_HEADER_SIZE;
+#if SAMPLE_STREAM_CODEC
+    {
+        uint32_t packed_size = (18 * sample_count + 7) / 8;
+        uint32_t coded_size;
+
+        // Coded only if the whole batch fits in less than the packed payload, the frame never grows.
+        if ((sample_count > 0) &&
+            (sample_codec_encode(&m_frame[length + 1], packed_size - 1, &coded_size,
+                                 p_samples, sample_count) == sample_count))
+        {
+            m_frame[2]      |= SAMPLE_STREAM_CODED;
+            m_frame[length]  = (uint8_t)coded_size;
+            length          += 1 + coded_size;
+        }
+        else
+        {
+            length += samples_pack(&m_frame[length], p_samples, 3 * sample_count);
+        }
+    }
+#else
+    length += samples_pack(&m_frame[length], p_samples, 3 * sample_count);
+#endif
+
+    crc = crc16_ccitt(&m_frame[2], length - 2);
+    m_frame[length++] = (uint8_t)crc;
+    m_frame[length++] = (uint8_t)(crc >> 8);
+
+    NRF_UARTE0->EVENTS_ENDTX = 0;
+    NRF_UARTE0->TXD.PTR      = (uint32_t)m_frame;
+    NRF_UARTE0->TXD.MAXCNT   = length;
+    NRF_UARTE0->TASKS_STARTTX = 1;
+    m_tx_active = true;
+
+    return NRF_SUCCESS;
+}
+
+uint32_t sample_stream_dropped_get(void)
+{
+    return m_dropped;
+}
@@ -0,0 +1,91 @@
+/* Copyright (c) 2015 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+#ifndef SAMPLE_STREAM_H__
+#define SAMPLE_STREAM_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "config.h"
+
+/**
+ * @defgroup sample_stream Binary sample stream
+ * @{
+ * @brief Sends batches of MMA7660 samples as binary frames over UARTE EasyDMA.
+ *
+ * Frame layout, multi-byte fields little endian:
+ *
+ * | Offset | Size | Field                                                   |
+ * |--------|------|---------------------------------------------------------|
+ * | 0      | 2    | Sync, @ref SAMPLE_STREAM_SYNC_0 @ref SAMPLE_STREAM_SYNC_1 |
+ * | 2      | 1    | Number of XYZ samples N, @ref SAMPLE_STREAM_CODED set if coded |
+ * | 3      | 2    | Sequence number, incremented for dropped frames too    |
+ * | 5      | 4    | Timestamp in RTC ticks                                  |
+ * | 9      | 2    | Frames dropped so far because the UARTE was busy        |
+ * | 11     | P    | Payload                                                 |
+ * | 11+P   | 2    | CRC-16-CCITT (0x1021, init 0xFFFF) over offset 2 to 11+P |
+ *
+ * The payload is the 3*N 6-bit values packed LSB first, P = (18*N + 7)/8. With
+ * @ref SAMPLE_STREAM_CODEC it is a length byte L followed by an L byte sample_codec.h block
+ * instead, P = 1 + L, whenever that is shorter. The values are sent as read from the sensor,
+ * the host does the sign extension.
+ *
+ * A sequence gap with the same growth of the dropped count was dropped on the device, the rest
+ * of the gap was lost on the line.
+ */
+
+#define SAMPLE_STREAM_SYNC_0        0xA5
+#define SAMPLE_STREAM_SYNC_1        0x5A
+#define SAMPLE_STREAM_HEADER_SIZE   11
+#define SAMPLE_STREAM_CRC_SIZE      2
+#define SAMPLE_STREAM_CODED         0x80    //!< Count flag, the payload is a sample_codec.h block.
+
+/**@brief Size of a frame carrying @p samples XYZ samples. */
+#define SAMPLE_STREAM_FRAME_SIZE(samples) \
+    (SAMPLE_STREAM_HEADER_SIZE + ((18 * (samples)) + 7) / 8 + SAMPLE_STREAM_CRC_SIZE)
+
+/**
+ * @brief Function for configuring UARTE0 for the stream.
+ *
+ * UARTE0 shares its peripheral ID with UART0, so app_uart must not be in use.
+ *
+ * @param[in] tx_pin  TXD pin.
+ * @param[in] rts_pin RTS pin, only used with flow control.
+ * @param[in] cts_pin CTS pin, only used with flow control.
+ * @param[in] hwfc    True to enable hardware flow control.
+ */
+void sample_stream_init(uint32_t tx_pin, uint32_t rts_pin, uint32_t cts_pin, bool hwfc);
+
+/**
+ * @brief Function for sending a batch of samples.
+ *
+ * The frame is built in a RAM buffer and handed to EasyDMA without further copies.
+ * Frames are not queued: if the previous frame is still on the line, this one is dropped.
+ *
+ * @param[in] p_samples    Raw X, Y, Z register values, three bytes per sample.
+ * @param[in] sample_count Number of samples, at most @ref SAMPLE_STREAM_MAX_SAMPLES.
+ * @param[in] timestamp    Timestamp to put in the frame header.
+ *
+ * @retval NRF_SUCCESS              If the frame transmission was started.
+ * @retval NRF_ERROR_BUSY           If the previous frame is still being sent, the frame is dropped.
+ * @retval NRF_ERROR_INVALID_LENGTH If @p sample_count is too large.
+ */
+uint32_t sample_stream_send(uint8_t const * p_samples, uint8_t sample_count, uint32_t timestamp);
+
+/**
+ * @brief Function for getting the number of frames dropped because the UARTE was busy.
+ */
+uint32_t sample_stream_dropped_get(void);
+
+/** @} */
+
+#endif // SAMPLE_STREAM_H__
@@ -0,0 +1,174 @@
+#!/usr/bin/env python
+"""Generate sample_filter_coeffs.h, the coefficients of the sample filter chain (sample_filter.h).
+
+Usage:
+    sample_filter_coeffs.py [--fs HZ,HZ,...] [--fir-taps N] [--fir-cutoff HZ] [--iir-cutoff HZ]
+                            [--iir-q Q] [--out FILE]
+
+The FIR stage is a Hamming windowed sinc low-pass, quantized to Q15 with the rounding error
+moved to the center tap so that the DC gain is exactly one. The IIR stage is a second order
+low-pass (RBJ cookbook biquad) quantized to Q14.
+
+One set of coefficients is designed for each sample rate in --fs, the rates of the sample
+profiles in that order. By default they are read from SAMPLE_PROFILE_<n>_HZ in config.h, and
+sample_filter.c stops the build with #error if the header no longer matches config.h. The
+cutoffs are in Hz for every rate, a stage whose cutoff is at or above half the sample rate
+passes the samples through unchanged.
+
+The header is written to --out (sample_filter_coeffs.h next to this directory by default), and
+the magnitude response of the quantized coefficients is printed for checking.
+"""
+
+import math
+import os
+import re
+import sys
+
+DEFAULTS = dict(fs='', fir_taps=7, fir_cutoff=15.0, iir_cutoff=10.0, iir_q=0.7071)
+FIR_SHIFT = 15
+IIR_SHIFT = 14
+PROFILES_MAX = 4
+LICENSE = """/* Copyright (c) 2015 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+"""
+
+
+def fir_design(taps, cutoff, fs):
+    if 2 * cutoff >= fs:
+        return [0] * (taps // 2) + [1 << FIR_SHIFT] + [0] * (taps - 1 - taps // 2)
+    fc = cutoff / fs
+    mid = (taps - 1) / 2.0
+    h = []
+    for n in range(taps):
+        x = n - mid
+        sinc = 2 * fc if x == 0 else math.sin(2 * math.pi * fc * x) / (math.pi * x)
+        window = 0.54 - 0.46 * math.cos(2 * math.pi * n / (taps - 1)) if taps > 1 else 1.0
+        h.append(sinc * window)
+    total = sum(h)
+    q = [int(round(v / total * (1 << FIR_SHIFT))) for v in h]
+    q[taps // 2] += (1 << FIR_SHIFT) - sum(q)
+    return q
+
+
+def iir_design(cutoff, q, fs):
+    if 2 * cutoff >= fs:
+        return [1 << IIR_SHIFT, 0, 0], [0, 0]
+    w0 = 2 * math.pi * cutoff / fs
+    alpha = math.sin(w0) / (2 * q)
+    cosw = math.cos(w0)
+    a0 = 1 + alpha
+    b = [(1 - cosw) / 2 / a0, (1 - cosw) / a0, (1 - cosw) / 2 / a0]
+    a = [-2 * cosw / a0, (1 - alpha) / a0]
+    scale = 1 << IIR_SHIFT
+    bq = [int(round(v * scale)) for v in b]
+    aq = [int(round(v * scale)) for v in a]
+    # Unity DC gain after quantization: sum(b) == 1 + a1 + a2.
+    bq[1] += scale + aq[0] + aq[1] - sum(bq)
+    return bq, aq
+
+
+def response(b, a, f, fs, scale):
+    w = 2 * math.pi * f / fs
+    num = sum(complex(math.cos(-w * k), math.sin(-w * k)) * b[k] for k in range(len(b))) / scale
+    den = 1 + sum(complex(math.cos(-w * (k + 1)), math.sin(-w * (k + 1))) * a[k] for k in range(len(a))) / scale
+    return abs(num / den)
+
+
+def db(v):
+    return 20 * math.log10(v) if v > 0 else float('-inf')
+
+
+def profile_rates(config):
+    rates = []
+    with open(config) as f:
+        text = f.read()
+    for n in range(PROFILES_MAX):
+        m = re.search(r'#define\s+SAMPLE_PROFILE_%d_HZ\s+(\d+)' % n, text)
+        if m is None or int(m.group(1)) == 0:
+            break
+        rates.append(int(m.group(1)))
+    return rates
+
+
+def table(rows):
+    return ' \\\n'.join(['{'] + ['    {%s},' % ', '.join('%d' % c for c in row) for row in rows] + ['}'])
+
+
+def main():
+    p = dict(DEFAULTS)
+    out = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', 'sample_filter_coeffs.h')
+    args = sys.argv[1:]
+    while args:
+        if len(args) < 2 or not args[0].startswith('--'):
+            sys.stderr.write(__doc__)
+            return 1
+        key = args[0][2:].replace('-', '_')
+        if key == 'out':
+            out = args[1]
+        elif key in p:
+            p[key] = type(p[key])(args[1])
+        else:
+            sys.stderr.write(__doc__)
+            return 1
+        args = args[2:]
+
+    if p['fs']:
+        rates = [int(float(v)) for v in p['fs'].split(',')]
+    else:
+        rates = profile_rates(os.path.join(os.path.dirname(out), 'config.h'))
+    if not 1 <= len(rates) <= PROFILES_MAX:
+        sys.stderr.write('1 to %d sample rates needed, got %d\n' % (PROFILES_MAX, len(rates)))
+        return 1
+
+    firs = []
+    iirs = []
+    for fs in rates:
+        fir = fir_design(p['fir_taps'], p['fir_cutoff'], float(fs))
+        iir_b, iir_a = iir_design(p['iir_cutoff'], p['iir_q'], float(fs))
+        firs.append(fir)
+        iirs.append((iir_b, iir_a))
+
+        print('profile %d, %d Hz' % (len(firs) - 1, fs))
+        print('%8s %10s %10s' % ('f_hz', 'fir_db', 'iir_db'))
+        steps = 12
+        for i in range(steps + 1):
+            f = fs / 2.0 * i / steps
+            print('%8.2f %10.2f %10.2f' % (f, db(response(fir, [], f, fs, 1 << FIR_SHIFT)),
+                                            db(response(iir_b, iir_a, f, fs, 1 << IIR_SHIFT))))
+
+    p['fs'] = ','.join('%d' % fs for fs in rates)
+    cmd = ' '.join(['sample_filter_coeffs.py'] + ['--%s %s' % (k.replace('_', '-'), p[k]) for k in sorted(p)])
+    with open(out, 'w') as f:
+        f.write(LICENSE)
+        f.write('// Generated by tools/%s\n' % cmd)
+        f.write('// Do not edit, run the script again with other settings instead.\n\n')
+        f.write('#ifndef SAMPLE_FILTER_COEFFS_H__\n#define SAMPLE_FILTER_COEFFS_H__\n\n')
+        f.write('// Sample rates of the coefficient sets, the profile rates in config.h.\n')
+        f.write('#define SAMPLE_FILTER_DESIGNS     %d\n' % len(rates))
+        for n in range(PROFILES_MAX):
+            f.write('#define SAMPLE_FILTER_DESIGN_%d_HZ %d\n' % (n, rates[n] if n < len(rates) else 0))
+        f.write('\n// FIR low-pass, %g Hz cutoff, Q%d, taps sum to %d.\n' % (p['fir_cutoff'], FIR_SHIFT, 1 << FIR_SHIFT))
+        f.write('#define SAMPLE_FILTER_FIR_TAPS    %d\n' % len(firs[0]))
+        f.write('#define SAMPLE_FILTER_FIR_SHIFT   %d\n' % FIR_SHIFT)
+        f.write('#define SAMPLE_FILTER_FIR_COEFFS  %s\n\n' % table(firs))
+        f.write('// Biquad low-pass, %g Hz cutoff, Q %g, Q%d, a0 = 1.\n' % (p['iir_cutoff'], p['iir_q'], IIR_SHIFT))
+        f.write('#define SAMPLE_FILTER_IIR_SHIFT   %d\n' % IIR_SHIFT)
+        f.write('#define SAMPLE_FILTER_IIR_B       %s\n' % table([b for b, a in iirs]))
+        f.write('#define SAMPLE_FILTER_IIR_A       %s\n\n' % table([a for b, a in iirs]))
+        f.write('#endif // SAMPLE_FILTER_COEFFS_H__\n')
+    sys.stderr.write('wrote %s\n' % os.path.normpath(out))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
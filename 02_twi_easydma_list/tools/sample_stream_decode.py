@@ -0,0 +1,207 @@
+#!/usr/bin/env python
+"""Decode the binary sample frames sent by the TWI list demo (see sample_stream.h).
+
+Usage:
+    sample_stream_decode.py <capture file>           decode a raw capture
+    sample_stream_decode.py -                        decode from stdin, e.g. piped from a serial tool
+    sample_stream_decode.py --notify <hex file>      decode sample_codec.h blocks, one per line in hex,
+                                                     e.g. the notifications of the BLE LED sensor demo
+
+One line per XYZ sample is printed, prefixed with the frame sequence number and timestamp (the
+block number with --notify). CRC failures and sequence gaps are reported on stderr, split by the
+dropped count of the frame header into frames dropped on the device (UARTE still busy) and frames
+lost on the line, with the totals at the end. Frames with a delta coded payload (SAMPLE_STREAM_CODEC) are decoded as well,
+and a summary of the payload bits per sample is printed at the end against the 18 bits of the
+packed payload.
+"""
+
+import struct
+import sys
+
+SYNC = b'\xa5\x5a'
+HEADER_SIZE = 11
+CRC_SIZE = 2
+RTC_HZ = 32768.0
+CODED = 0x80
+CODEC_ESCAPE = 4
+
+
+def crc16_ccitt(data):
+    crc = 0xFFFF
+    for b in bytearray(data):
+        crc = ((crc >> 8) | (crc << 8)) & 0xFFFF
+        crc ^= b
+        crc ^= (crc & 0xFF) >> 4
+        crc ^= (crc << 12) & 0xFFFF
+        crc ^= ((crc & 0xFF) << 5) & 0xFFFF
+    return crc
+
+
+def payload_size(samples):
+    return (18 * samples + 7) // 8
+
+
+def unpack(payload, values):
+    acc = 0
+    bits = 0
+    out = []
+    it = iter(bytearray(payload))
+    while len(out) < values:
+        while bits < 6:
+            acc |= next(it) << bits
+            bits += 8
+        v = acc & 0x3F
+        out.append(v - 64 if v & 0x20 else v)
+        acc >>= 6
+        bits -= 6
+    return out
+
+
+def sign6(v):
+    return v - 64 if v & 0x20 else v
+
+
+class BitReader(object):
+    def __init__(self, data):
+        self.data = bytearray(data)
+        self.pos = 0
+
+    def bit(self):
+        b = (self.data[self.pos >> 3] >> (self.pos & 7)) & 1
+        self.pos += 1
+        return b
+
+    def bits(self, count):
+        v = 0
+        for n in range(count):
+            v |= self.bit() << n
+        return v
+
+
+def codec_decode(block):
+    """Decode a sample_codec.h block into a list of [x, y, z] samples."""
+    block = bytearray(block)
+    k = block[0] & 0x03
+    count = block[0] >> 2
+    if not count:
+        return []
+    r = BitReader(block[1:])
+    prev = [r.bits(6) for axis in range(3)]
+    out = [[sign6(v) for v in prev]]
+    for n in range(count - 1):
+        for axis in range(3):
+            q = 0
+            while q < CODEC_ESCAPE and r.bit():
+                q += 1
+            z = r.bits(6) if q == CODEC_ESCAPE else (q << k) | r.bits(k)
+            d = -((z + 1) >> 1) if z & 1 else z >> 1
+            prev[axis] = (prev[axis] + d) & 0x3F
+        out.append([sign6(v) for v in prev])
+    return out
+
+
+def frame_size(buf, start):
+    """Size of the frame at start, or None if its size is not in buf yet."""
+    header = bytearray(buf[start:start + HEADER_SIZE + 1])
+    if len(header) < HEADER_SIZE:
+        return None
+    if not header[2] & CODED:
+        return HEADER_SIZE + payload_size(header[2]) + CRC_SIZE
+    if len(header) < HEADER_SIZE + 1:
+        return None
+    return HEADER_SIZE + 1 + header[HEADER_SIZE] + CRC_SIZE
+
+
+def decode(buf):
+    """Return the list of (sequence, timestamp, samples) found in buf and the unconsumed tail."""
+    out = []
+    pos = 0
+    while True:
+        start = buf.find(SYNC, pos)
+        if start < 0:
+            # Keep a trailing first sync byte, the second one may be in the next chunk.
+            return out, buf[-1:] if buf[-1:] == SYNC[:1] else b''
+        size = frame_size(buf, start)
+        if size is None or len(buf) - start < size:
+            break
+        frame = buf[start:start + size]
+        crc, = struct.unpack_from('<H', frame, size - CRC_SIZE)
+        if crc != crc16_ccitt(frame[2:size - CRC_SIZE]):
+            sys.stderr.write('CRC error, resyncing\n')
+            pos = start + 1
+            continue
+        count, seq, timestamp, dropped = struct.unpack_from('<BHIH', frame, 2)
+        payload = frame[HEADER_SIZE:size - CRC_SIZE]
+        if count & CODED:
+            samples = codec_decode(payload[1:])
+            if len(samples) != count & ~CODED:
+                sys.stderr.write('coded payload holds %d samples, header says %d\n' %
+                                 (len(samples), count & ~CODED))
+        else:
+            values = unpack(payload, 3 * count)
+            samples = [values[i:i + 3] for i in range(0, len(values), 3)]
+        out.append((seq, timestamp, dropped, samples, len(payload)))
+        pos = start + size
+    return out, buf[start:]
+
+
+def ratio_print(samples, payload_bytes):
+    if samples:
+        sys.stderr.write('%d samples in %d payload bytes, %.2f bits per sample, %.2fx the packed payload\n' %
+                         (samples, payload_bytes, 8.0 * payload_bytes / samples,
+                          18.0 * samples / (8.0 * payload_bytes)))
+
+
+def notify_main(path):
+    src = sys.stdin if path == '-' else open(path, 'r')
+    total = size = 0
+    for number, line in enumerate(l for l in src if l.strip()):
+        block = bytearray.fromhex(line.strip().replace(':', ' ').replace('-', ' '))
+        samples = codec_decode(block)
+        total += len(samples)
+        size += len(block)
+        for x, y, z in samples:
+            sys.stdout.write('%5d %4d %4d %4d\n' % (number, x, y, z))
+    ratio_print(total, size)
+    return 0
+
+
+def main():
+    if len(sys.argv) == 3 and sys.argv[1] == '--notify':
+        return notify_main(sys.argv[2])
+    if len(sys.argv) != 2:
+        sys.stderr.write(__doc__)
+        return 1
+    src = sys.stdin if sys.argv[1] == '-' else open(sys.argv[1], 'rb')
+    src = getattr(src, 'buffer', src)
+
+    buf = b''
+    last_seq = last_dropped = None
+    total = size = device_drops = line_drops = 0
+    while True:
+        chunk = src.read(4096)
+        if not chunk:
+            break
+        buf += chunk
+        found, buf = decode(buf)
+        for seq, timestamp, dropped, samples, payload_bytes in found:
+            total += len(samples)
+            size += payload_bytes
+            if last_seq is not None:
+                gap = (seq - last_seq - 1) & 0xFFFF
+                on_device = min((dropped - last_dropped) & 0xFFFF, gap)
+                if gap:
+                    sys.stderr.write('%d frame(s) dropped on the device, %d lost on the line\n' %
+                                     (on_device, gap - on_device))
+                device_drops += on_device
+                line_drops += gap - on_device
+            last_seq, last_dropped = seq, dropped
+            for x, y, z in samples:
+                sys.stdout.write('%5d %10.5f %4d %4d %4d\n' % (seq, timestamp / RTC_HZ, x, y, z))
+    ratio_print(total, size)
+    sys.stderr.write('%d frame(s) dropped on the device, %d lost on the line\n' % (device_drops, line_drops))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
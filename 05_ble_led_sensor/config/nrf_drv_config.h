@@ -209,6 +209,20 @@
 
 #define TWI_COUNT                (TWI0_ENABLED+TWI1_ENABLED)
 
+#define TWI_QUEUE_SIZE           4    /* Transfers queued per instance, must be a power of two. */
+
+/* TWI driver features, disabled ones are compiled out. */
+#define TWI_BLOCKING_ENABLED     0    /* Blocking mode when no event handler is given. */
+#define TWI_LIST_ENABLED         0    /* TWIM TX/RX list post-increment. */
+#define TWI_REPEATED_ENABLED     0    /* Repeated and held transfers triggered over PPI. */
+#define TWI_QUEUE_ENABLED        1    /* Transfer queue. */
+#define TWI_SCAN_ENABLED         0    /* Multi-slave scan tables, needs TWI_LIST_ENABLED. */
+#define TWI_RECOVERY_ENABLED     1    /* Retries, bus clear and error counters. */
+
+#define TWI_RECOVERY_RETRIES          2    /* Retries of a failed transfer, up to 8. */
+#define TWI_RECOVERY_BACKOFF_US       100  /* Delay before the first blocking retry, doubled per retry. */
+#define TWI_RECOVERY_BUS_CLEAR_AFTER  3    /* Failed transfers in a row before the bus is cleared. */
+
 /* TWIS */
 #define TWIS0_ENABLED 0
 
@@ -30,7 +30,9 @@
 #include "math.h"
 #include "nrf_dummy_pwm.h"
 #include "mma7660.h"
-#include "nrf_drv_twi_dma.h"
+#include "nrf_drv_twi_mod.h"
+#include "motion_features.h"
+#include "sample_codec.h"
 
 #define IS_SRVC_CHANGED_CHARACT_PRESENT 0                                           /**< Include the service_changed characteristic. If not enabled, the server's database cannot be changed for the lifetime of the device. */
 
@@ -73,10 +75,31 @@ static ble_uuid_t                       m_adv_uuids[] = {{BLE_UUID_LSS_SERVICE,
 #define LED_SCALE_FACTOR_BLUE           1.0f
 
 #define LED_FADE_SAMPLE_NUM             64
+
+// Sensor reads summed up in one motion feature frame (motion_features.h) per notification.
+// 0 notifies every read as the raw X, Y, Z bytes, which is what the phone app expects.
+#define SENSOR_FEATURE_WINDOW           0
+// Sensor reads collected and sent delta coded (sample_codec.h), as many per notification as fit.
+// Reads that did not fit go first in the next notification. 0 notifies every read as it is.
+#define SENSOR_CODED_SAMPLES            0
 static uint16_t                         m_rgb_sample_buf[LED_FADE_SAMPLE_NUM][4];
 
 static app_timer_id_t                   m_sensor_sample_timer_id;
 static volatile bool                    m_update_sensor_flag = false;
+static mma7660_accelerometer_data_t     m_sensor_data;
+static volatile bool                    m_sensor_data_ready = false;
+#if SENSOR_FEATURE_WINDOW
+static motion_features_acc_t            m_features_acc;         // Zero is an empty window with no history.
+static uint8_t                          m_features_count;
+#endif
+#if SENSOR_CODED_SAMPLES
+static uint8_t                          m_coded_samples[3 * SENSOR_CODED_SAMPLES];
+static uint8_t                          m_coded_count;
+#endif
+
+#if SENSOR_FEATURE_WINDOW && SENSOR_CODED_SAMPLES
+#error "SENSOR_FEATURE_WINDOW and SENSOR_CODED_SAMPLES cannot be used together"
+#endif
 
 typedef struct
 {
@@ -490,6 +513,23 @@ static void rgb_led_init()
     pwm_run(true);
 }
 
+/**
+ * @brief Keep the sample for the main loop, the SoftDevice is not called from the TWI interrupt.
+ */
+static void sensor_read_handler(uint32_t result, mma7660_accelerometer_data_t const * p_data)
+{
+    if (result == NRF_SUCCESS)
+    {
+        m_sensor_data = *p_data;
+        m_sensor_data_ready = true;
+    }
+}
+
+static void twi_evt_handler(nrf_drv_twi_evt_t const * p_event, void * p_context)
+{
+    mma7660_twi_evt_handler(p_event);
+}
+
 /**
  * @brief Initialize the master TWI
  *
@@ -510,7 +550,7 @@ static ret_code_t twi_master_init(void)
 
     do
     {
-        ret = nrf_drv_twi_init(&m_twi_master, &config, NULL, NULL);
+        ret = nrf_drv_twi_init(&m_twi_master, &config, twi_evt_handler, NULL);
         if(NRF_SUCCESS != ret)
         {
             break;
@@ -550,16 +590,42 @@ int main(void)
     // Enter main loop.
     for (;;)
     {
+        if (m_sensor_data_ready)
+        {
+            m_sensor_data_ready = false;
+#if SENSOR_FEATURE_WINDOW
+            motion_features_add(&m_features_acc, (int8_t const *)&m_sensor_data, 1);
+            if (++m_features_count == SENSOR_FEATURE_WINDOW)
+            {
+                motion_features_t features;
+
+                m_features_count = 0;
+                motion_features_get(&m_features_acc, &features);
+                ble_lss_on_sensor_change(&m_lss, (uint8_t*)&features, sizeof(features));
+            }
+#elif SENSOR_CODED_SAMPLES
+            memcpy(&m_coded_samples[3 * m_coded_count], &m_sensor_data, sizeof(m_sensor_data));
+            if (++m_coded_count == SENSOR_CODED_SAMPLES)
+            {
+                uint8_t  block[BLE_LSS_MAX_DATA_LEN];
+                uint32_t length;
+                uint32_t sent;
+
+                sent = sample_codec_encode(block, sizeof(block), &length, m_coded_samples, m_coded_count);
+                ble_lss_on_sensor_change(&m_lss, block, length);
+                m_coded_count -= sent;
+                memmove(m_coded_samples, &m_coded_samples[3 * sent], 3 * m_coded_count);
+            }
+#else
+            ble_lss_on_sensor_change(&m_lss, (uint8_t*)&m_sensor_data, sizeof(m_sensor_data));
+#endif
+        }
         if(m_update_sensor_flag)
         {
             m_update_sensor_flag = false;
             
-            static mma7660_accelerometer_data_t xyz;        
-            uint32_t err_code = mma7660_read_xyz(&m_twi_master, &xyz);        
-            if (err_code == NRF_SUCCESS)
-            {
-                ble_lss_on_sensor_change(&m_lss, (uint8_t*)&xyz, sizeof(xyz));
-            }
+            // Returns right away, sensor_read_handler runs when the TXRX transfer is done.
+            (void)mma7660_read_xyz_async(&m_twi_master, sensor_read_handler);
         }
         sd_app_evt_wait();
     }
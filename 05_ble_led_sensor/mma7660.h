@@ -1,7 +1,7 @@
 #ifndef __MMA7660_H__
 #define __MMA7660_H__
 
-#include "nrf_drv_twi_dma.h"
+#include "nrf_drv_twi_mod.h"
 #include <stdint.h>
 #include <stdbool.h>
 
@@ -43,12 +43,108 @@ typedef struct __attribute__((__packed__))
     mma7660_orientation_output_t z;
 } mma7660_accelerometer_data_t;
 
-uint32_t mma7660_register_write(nrf_drv_twi_t const * const p_twi_instance, uint8_t reg, uint8_t val);
+#define MMA7660_MODE_ACTIVE       0x01 // MODE: active, 0 is standby.
+#define MMA7660_MODE_AWE          0x08 // MODE: auto-wake, back to the active rate on activity.
+#define MMA7660_MODE_ASE          0x10 // MODE: auto-sleep, to the auto-wake rate after SPCNT idle samples.
+#define MMA7660_MODE_IPP          0x40 // MODE: INT push-pull, open drain otherwise.
+#define MMA7660_MODE_IAH          0x80 // MODE: INT active high, active low otherwise.
+
+#define MMA7660_INTSU_FBINT       0x01 // Front/back change.
+#define MMA7660_INTSU_PLINT       0x02 // Up/down/left/right change.
+#define MMA7660_INTSU_PDINT       0x04 // Tap.
+#define MMA7660_INTSU_ASINT       0x08 // Exit from auto-sleep.
+#define MMA7660_INTSU_GINT        0x10 // Every measurement.
+#define MMA7660_INTSU_SHINTZ      0x20 // Shake on Z.
+#define MMA7660_INTSU_SHINTY      0x40 // Shake on Y.
+#define MMA7660_INTSU_SHINTX      0x80 // Shake on X.
+
+#define MMA7660_PDET_AXES_OFF     0xE0 // PDET: tap detection disabled on X, Y and Z.
+
+#define MMA7660_SR_AWSR_32        0x00 // SR: 32 samples/s while auto-sleeping.
+#define MMA7660_SR_AWSR_16        0x08
+#define MMA7660_SR_AWSR_8         0x10
+#define MMA7660_SR_AWSR_1         0x18
+
+#define MMA7660_ALERT_Msk         0x40 // Set in X, Y and Z when read while the sensor updated the register.
+#define MMA7660_ALERT_RETRIES     3    // Re-reads of an axis with the ALERT bit before giving up.
+
+#define MMA7660_BATCH_MAX_XFERS   4   // Transfers in one batch, after merging.
+#define MMA7660_BATCH_MAX_BYTES   16  // Register addresses and written values in one batch.
+#define MMA7660_WRITES_MAX        2   // Single register writes on the bus or queued at the same time.
+
+// Register accesses collected for one submission. Writes to consecutive registers are merged
+// into one auto-increment burst, and so are reads of consecutive registers into consecutive
+// memory. The batch is read by the driver until the transfers are done, so it must not be a
+// local variable when the instance works in non-blocking mode.
+typedef struct
+{
+    nrf_drv_twi_xfer_desc_t xfers[MMA7660_BATCH_MAX_XFERS];
+    uint8_t                 tx_buf[MMA7660_BATCH_MAX_BYTES];
+    uint8_t                 xfer_count;
+    uint8_t                 tx_length;
+} mma7660_batch_t;
+
+void mma7660_batch_init(mma7660_batch_t * p_batch);
+
+uint32_t mma7660_batch_write(mma7660_batch_t * p_batch, uint8_t reg, uint8_t val);
+
+uint32_t mma7660_batch_read(mma7660_batch_t * p_batch, uint8_t reg, uint8_t *buf, uint8_t num_of_bytes);
 
-uint32_t mma7660_register_read(nrf_drv_twi_t const * const p_twi_instance, uint8_t reg, uint8_t *buf, uint8_t num_of_bytes);
+// With the transfer queue the whole batch is queued at once, and the event handler is called
+// after the last transfer and for every transfer that failed. Without the queue the transfers
+// are done one after the other, which needs the instance in blocking mode.
+uint32_t mma7660_batch_submit(nrf_drv_twi_t const * const p_twi_instance, mma7660_batch_t * p_batch);
 
+// Non-blocking mode only. Queues a single register write and returns right away, the value is
+// copied to a block of a DMA pool that mma7660_twi_evt_handler frees when the write is done.
+// NRF_ERROR_NO_MEM while MMA7660_WRITES_MAX writes are pending.
+uint32_t mma7660_register_write(nrf_drv_twi_t const * const p_twi_instance, uint8_t reg, uint8_t val);
+
+// Both init functions share one batch of register writes: NRF_ERROR_BUSY while the writes of
+// the previous call are still queued, see mma7660_init_result_get.
 uint32_t mma7660_init(nrf_drv_twi_t const * const p_twi_instance, mma7660_mode_t samples_per_second);
 
-uint32_t mma7660_read_xyz(nrf_drv_twi_t const * const p_twi_instance, mma7660_accelerometer_data_t * p_data);
+// Converts count raw X, Y or Z register values to signed readings, p_dst may be the same as p_src.
+// Returns the number of values with the ALERT bit set, those were read while the sensor updated them.
+uint32_t mma7660_decode(int8_t * p_dst, uint8_t const * p_src, uint32_t count);
+
+typedef struct
+{
+    uint8_t intsu;  // MMA7660_INTSU_* sources driving the INT pin.
+    uint8_t spcnt;  // Auto-sleep count, 0 to stay active.
+    uint8_t pdet;   // Tap threshold and MMA7660_PDET_AXES_OFF bits.
+    uint8_t pd;     // Tap debounce count.
+    uint8_t mode;   // MMA7660_MODE_* bits added to MMA7660_MODE_ACTIVE, e.g. auto-sleep and auto-wake.
+    uint8_t sr;     // MMA7660_SR_AWSR_* rate, the active rate comes from samples_per_second.
+} mma7660_int_config_t;
+
+// Like mma7660_init, with the interrupt and auto-sleep registers set up as well. INT is active
+// low and open drain unless p_config->mode says otherwise, and stays asserted until TILT is read:
+// read four bytes from MMA7660_X to release it. The INTSU sources are also the activity that
+// resets the auto-sleep count and wakes the sensor up.
+uint32_t mma7660_int_init(nrf_drv_twi_t const * const p_twi_instance, mma7660_mode_t samples_per_second,
+                          mma7660_int_config_t const * p_config);
+
+// mma7660_init and mma7660_int_init only queue their register writes. NRF_ERROR_BUSY until the
+// last one is done, then NRF_ERROR_INTERNAL if one of them failed. The events come through
+// mma7660_twi_evt_handler.
+uint32_t mma7660_init_result_get(void);
+
+// Called from the TWI event handler. p_data is NULL if the read failed and only valid during the call.
+typedef void (* mma7660_xyz_handler_t)(uint32_t result, mma7660_accelerometer_data_t const * p_data);
+
+// Non-blocking mode only. Reads X, Y and Z in one TXRX transfer with a repeated start and returns
+// right away; the decoded values are passed to the handler. NRF_ERROR_BUSY while a read is pending.
+// An axis with the ALERT bit is read again on its own, NRF_ERROR_INVALID_DATA after
+// MMA7660_ALERT_RETRIES attempts.
+uint32_t mma7660_read_xyz_async(nrf_drv_twi_t const * const p_twi_instance, mma7660_xyz_handler_t handler);
+
+// To be called from the event handler of the instance, ignores events of other transfers.
+void mma7660_twi_evt_handler(nrf_drv_twi_evt_t const * p_event);
+
+// For batches read without the CPU (repeated transfers), where the register cannot be read again
+// in time: raw values with the ALERT bit take the previous good reading of the same axis, or the
+// next one at the start of the batch. Returns the number of samples with a patched axis.
+uint32_t mma7660_batch_patch(uint8_t * p_samples, uint32_t sample_count);
 
 #endif
@@ -0,0 +1,86 @@
+/* Copyright (c) 2015 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+#include "dma_pool.h"
+#include "nrf_assert.h"
+#include "app_util_platform.h"
+#include <stddef.h>
+
+void dma_pool_init(dma_pool_t const * p_pool)
+{
+    uint8_t * p_block = p_pool->p_memory;
+    uint16_t  i;
+
+    ASSERT(p_pool->block_count > 0);
+
+    for (i = 0; i < p_pool->block_count - 1; i++)
+    {
+        *(void **)p_block = p_block + p_pool->block_size;
+        p_block += p_pool->block_size;
+    }
+    *(void **)p_block = NULL;
+
+    p_pool->p_cb->p_free     = p_pool->p_memory;
+    p_pool->p_cb->in_use     = 0;
+    p_pool->p_cb->high_water = 0;
+    p_pool->p_cb->failed     = 0;
+}
+
+void * dma_pool_alloc(dma_pool_t const * p_pool)
+{
+    dma_pool_cb_t * p_cb = p_pool->p_cb;
+    void *          p_block;
+
+    CRITICAL_REGION_ENTER();
+    p_block = p_cb->p_free;
+    if (p_block != NULL)
+    {
+        p_cb->p_free = *(void **)p_block;
+        p_cb->in_use++;
+        if (p_cb->in_use > p_cb->high_water)
+        {
+            p_cb->high_water = p_cb->in_use;
+        }
+    }
+    else
+    {
+        p_cb->failed++;
+    }
+    CRITICAL_REGION_EXIT();
+
+    return p_block;
+}
+
+void dma_pool_free(dma_pool_t const * p_pool, void * p_block)
+{
+    dma_pool_cb_t * p_cb = p_pool->p_cb;
+    uint32_t        offset = (uint8_t *)p_block - p_pool->p_memory;
+
+    ASSERT((uint8_t *)p_block >= p_pool->p_memory);
+    ASSERT(offset < (uint32_t)p_pool->block_size * p_pool->block_count);
+    ASSERT((offset % p_pool->block_size) == 0);
+
+    CRITICAL_REGION_ENTER();
+    *(void **)p_block = p_cb->p_free;
+    p_cb->p_free = p_block;
+    p_cb->in_use--;
+    CRITICAL_REGION_EXIT();
+}
+
+void dma_pool_stats_get(dma_pool_t const * p_pool, dma_pool_stats_t * p_stats)
+{
+    CRITICAL_REGION_ENTER();
+    p_stats->in_use     = p_pool->p_cb->in_use;
+    p_stats->high_water = p_pool->p_cb->high_water;
+    p_stats->failed     = p_pool->p_cb->failed;
+    CRITICAL_REGION_EXIT();
+}
@@ -0,0 +1,105 @@
+/* Copyright (c) 2015 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+#ifndef DMA_POOL_H__
+#define DMA_POOL_H__
+
+#include <stdint.h>
+
+/**
+ * @defgroup dma_pool EasyDMA buffer pool
+ * @{
+ * @brief Fixed-block allocator for buffers handed to EasyDMA.
+ *
+ * The blocks are word aligned and live in a static array, so they are always in RAM
+ * where EasyDMA can reach them. Allocation and release are safe from any interrupt level.
+ */
+
+/**@brief Pool control block, @ref DMA_POOL_DEF creates one per pool. */
+typedef struct
+{
+    void *   p_free;        //!< First free block, each free block holds a pointer to the next.
+    uint16_t in_use;        //!< Number of blocks currently allocated.
+    uint16_t high_water;    //!< Largest number of blocks allocated at the same time.
+    uint32_t failed;        //!< Number of allocations that found the pool empty.
+} dma_pool_cb_t;
+
+/**@brief Pool instance. */
+typedef struct
+{
+    uint8_t *       p_memory;     //!< Block storage.
+    uint16_t        block_size;   //!< Size of one block in bytes, a multiple of four.
+    uint16_t        block_count;  //!< Number of blocks.
+    dma_pool_cb_t * p_cb;         //!< Control block.
+} dma_pool_t;
+
+/**@brief Pool usage statistics. */
+typedef struct
+{
+    uint16_t in_use;        //!< Number of blocks currently allocated.
+    uint16_t high_water;    //!< Largest number of blocks allocated at the same time.
+    uint32_t failed;        //!< Number of allocations that found the pool empty.
+} dma_pool_stats_t;
+
+/**@brief Words per block, a free block holds the link to the next one so it is at least a pointer. */
+#define DMA_POOL_BLOCK_WORDS(size) \
+    ((((size) > sizeof(void *) ? (size) : sizeof(void *)) + 3) / 4)
+
+/**
+ * @brief Macro for defining a pool of @p count blocks of at least @p size bytes.
+ */
+#define DMA_POOL_DEF(name, size, count)                                           \
+    static uint32_t      name##_memory[(count) * DMA_POOL_BLOCK_WORDS(size)];      \
+    static dma_pool_cb_t name##_cb;                                                \
+    static const dma_pool_t name =                                                 \
+    {                                                                              \
+        .p_memory    = (uint8_t *)name##_memory,                                   \
+        .block_size  = 4 * DMA_POOL_BLOCK_WORDS(size),                             \
+        .block_count = (count),                                                    \
+        .p_cb        = &name##_cb                                                  \
+    }
+
+/**
+ * @brief Function for initializing a pool, all blocks become free.
+ *
+ * @param[in] p_pool Pool instance.
+ */
+void dma_pool_init(dma_pool_t const * p_pool);
+
+/**
+ * @brief Function for allocating a block.
+ *
+ * @param[in] p_pool Pool instance.
+ *
+ * @return Pointer to the block, or NULL if all blocks are in use.
+ */
+void * dma_pool_alloc(dma_pool_t const * p_pool);
+
+/**
+ * @brief Function for returning a block to the pool.
+ *
+ * @param[in] p_pool  Pool instance.
+ * @param[in] p_block Block from @ref dma_pool_alloc on the same pool.
+ */
+void dma_pool_free(dma_pool_t const * p_pool, void * p_block);
+
+/**
+ * @brief Function for getting the usage statistics of a pool.
+ *
+ * @param[in]  p_pool  Pool instance.
+ * @param[out] p_stats Statistics.
+ */
+void dma_pool_stats_get(dma_pool_t const * p_pool, dma_pool_stats_t * p_stats);
+
+/** @} */
+
+#endif // DMA_POOL_H__
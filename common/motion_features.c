@@ -0,0 +1,161 @@
+/* Copyright (c) 2015 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+#include "motion_features.h"
+#include <stdlib.h>
+#include <string.h>
+
+static uint32_t isqrt(uint32_t value)
+{
+    uint32_t root = 0;
+    uint32_t bit  = 1UL << 12; // Largest power of four not above 3 * 32 * 32.
+
+    while (bit > value)
+    {
+        bit >>= 2;
+    }
+    while (bit != 0)
+    {
+        if (value >= root + bit)
+        {
+            value -= root + bit;
+            root   = (root >> 1) + bit;
+        }
+        else
+        {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return root;
+}
+
+static int8_t div_round(int32_t num, uint32_t den)
+{
+    return (int8_t)((num >= 0) ? (num + (int32_t)(den / 2)) / (int32_t)den
+                               : (num - (int32_t)(den / 2)) / (int32_t)den);
+}
+
+static uint8_t orientation_get(int8_t const * p_mean)
+{
+    uint8_t axis = 0;
+
+    for (uint8_t i = 1; i < 3; i++)
+    {
+        if (abs(p_mean[i]) > abs(p_mean[axis]))
+        {
+            axis = i;
+        }
+    }
+    if (abs(p_mean[axis]) < MOTION_ORIENTATION_COUNTS)
+    {
+        return MOTION_ORIENTATION_UNKNOWN;
+    }
+    return MOTION_ORIENTATION_X_UP + 2 * axis + ((p_mean[axis] < 0) ? 1 : 0);
+}
+
+void motion_features_init(motion_features_acc_t * p_acc)
+{
+    memset(p_acc, 0, sizeof(*p_acc));
+}
+
+void motion_features_add(motion_features_acc_t * p_acc, int8_t const * p_xyz, uint32_t count)
+{
+    uint32_t i;
+
+    if (count > (uint32_t)(UINT8_MAX - p_acc->count))
+    {
+        count = UINT8_MAX - p_acc->count;
+    }
+
+    for (i = 0; i < count; i++, p_xyz += 3)
+    {
+        uint32_t magnitude_sq = 0;
+
+        for (uint8_t axis = 0; axis < 3; axis++)
+        {
+            int32_t value = p_xyz[axis];
+            int32_t delta = value - p_acc->center[axis];
+
+            p_acc->sum[axis]    += value;
+            p_acc->sum_sq[axis] += value * value;
+            magnitude_sq        += value * value;
+
+            if ((value >= MOTION_SHAKE_COUNTS) || (value <= -MOTION_SHAKE_COUNTS))
+            {
+                p_acc->events |= MOTION_EVT_SHAKE;
+            }
+            if (p_acc->started && (abs(value - p_acc->last[axis]) >= MOTION_TAP_COUNTS))
+            {
+                p_acc->events |= MOTION_EVT_TAP;
+            }
+            p_acc->last[axis] = (int8_t)value;
+
+            if ((delta >= MOTION_ZC_HYSTERESIS) || (delta <= -MOTION_ZC_HYSTERESIS))
+            {
+                int8_t side = (delta > 0) ? 1 : -1;
+
+                if ((p_acc->side[axis] != 0) && (p_acc->side[axis] != side))
+                {
+                    p_acc->crossings[axis]++;
+                }
+                p_acc->side[axis] = side;
+            }
+        }
+        p_acc->magnitude_sum += isqrt(magnitude_sq);
+        p_acc->started = 1;
+        p_acc->count++;
+    }
+}
+
+void motion_features_get(motion_features_acc_t * p_acc, motion_features_t * p_features)
+{
+    uint32_t n = p_acc->count;
+
+    memset(p_features, 0, sizeof(*p_features));
+    p_features->count       = (uint8_t)n;
+    p_features->orientation = p_acc->orientation;
+    p_features->events      = p_acc->events;
+
+    if (n != 0)
+    {
+        for (uint8_t axis = 0; axis < 3; axis++)
+        {
+            // n * n times the variance, as integers: n * sum_sq - sum * sum.
+            uint32_t spread = n * p_acc->sum_sq[axis] - (uint32_t)(p_acc->sum[axis] * p_acc->sum[axis]);
+            uint32_t variance_q4 = (16 * spread + (n * n) / 2) / (n * n);
+
+            p_features->mean[axis]           = div_round(p_acc->sum[axis], n);
+            p_features->variance[axis]       = (variance_q4 > UINT16_MAX) ? UINT16_MAX : (uint16_t)variance_q4;
+            p_features->zero_crossings[axis] = p_acc->crossings[axis];
+        }
+        p_features->magnitude   = (uint8_t)((p_acc->magnitude_sum + n / 2) / n);
+        p_features->orientation = orientation_get(p_features->mean);
+        if (p_features->orientation != p_acc->orientation)
+        {
+            p_features->events |= MOTION_EVT_ORIENTATION;
+        }
+    }
+
+    // The next window starts empty, the history carries over.
+    memset(p_acc->sum, 0, sizeof(p_acc->sum));
+    memset(p_acc->sum_sq, 0, sizeof(p_acc->sum_sq));
+    memset(p_acc->crossings, 0, sizeof(p_acc->crossings));
+    p_acc->magnitude_sum = 0;
+    p_acc->events        = 0;
+    p_acc->count         = 0;
+    if (n != 0)
+    {
+        memcpy(p_acc->center, p_features->mean, sizeof(p_acc->center));
+        p_acc->orientation = p_features->orientation;
+    }
+}
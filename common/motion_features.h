@@ -0,0 +1,120 @@
+/* Copyright (c) 2015 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+#ifndef MOTION_FEATURES_H__
+#define MOTION_FEATURES_H__
+
+#include <stdint.h>
+
+/**
+ * @defgroup motion_features Accelerometer motion features
+ * @{
+ * @brief Reduces windows of X, Y, Z samples to one compact feature frame.
+ *
+ * Samples are fed as they come with @ref motion_features_add, in counts as returned by
+ * mma7660_decode (21.33 counts per g, -32 to 31). @ref motion_features_get then closes the
+ * window: the frame describes all samples added since the previous call. Everything is
+ * integer arithmetic on a fixed-size accumulator, nothing is allocated and no samples are kept.
+ *
+ * Zero crossings are counted around the mean of the previous window, with a hysteresis of
+ * @ref MOTION_ZC_HYSTERESIS counts, so that sensor noise at rest does not count.
+ */
+
+// Thresholds in counts, a demo can define its own before including this file.
+#ifndef MOTION_SHAKE_COUNTS
+    #define MOTION_SHAKE_COUNTS     28  // |value| on any axis that is a shake, about 1.3 g.
+#endif
+#ifndef MOTION_TAP_COUNTS
+    #define MOTION_TAP_COUNTS       16  // Change between two samples on any axis that is a tap, about 0.75 g.
+#endif
+#ifndef MOTION_ZC_HYSTERESIS
+    #define MOTION_ZC_HYSTERESIS     2  // Distance from the window center a crossing must reach.
+#endif
+#ifndef MOTION_ORIENTATION_COUNTS
+    #define MOTION_ORIENTATION_COUNTS 11 // Mean on the dominant axis needed for an orientation, about 0.5 g.
+#endif
+
+#define MOTION_EVT_SHAKE            0x01 /**< A sample reached @ref MOTION_SHAKE_COUNTS. */
+#define MOTION_EVT_TAP              0x02 /**< Two samples were @ref MOTION_TAP_COUNTS apart. */
+#define MOTION_EVT_ORIENTATION      0x04 /**< The orientation differs from the previous window. */
+
+/**@brief Axis pointing up, from the window mean. */
+typedef enum
+{
+    MOTION_ORIENTATION_UNKNOWN = 0, /**< No axis has @ref MOTION_ORIENTATION_COUNTS, the device is moving. */
+    MOTION_ORIENTATION_X_UP,
+    MOTION_ORIENTATION_X_DOWN,
+    MOTION_ORIENTATION_Y_UP,
+    MOTION_ORIENTATION_Y_DOWN,
+    MOTION_ORIENTATION_Z_UP,
+    MOTION_ORIENTATION_Z_DOWN,
+} motion_orientation_t;
+
+/**@brief Feature frame of one window, 16 bytes, multi-byte fields little endian. */
+typedef struct __attribute__((__packed__))
+{
+    uint8_t  count;             /**< Number of XYZ samples in the window. */
+    int8_t   mean[3];           /**< X, Y, Z mean in counts, rounded. */
+    uint16_t variance[3];       /**< X, Y, Z variance in counts squared, Q4 (1/16). */
+    uint8_t  magnitude;         /**< Mean of |a| over the window, in counts. */
+    uint8_t  zero_crossings[3]; /**< X, Y, Z crossings of the previous window mean. */
+    uint8_t  orientation;       /**< @ref motion_orientation_t. */
+    uint8_t  events;            /**< MOTION_EVT_* seen in the window. */
+} motion_features_t;
+
+/**@brief Window accumulator, only to be accessed through the functions below. */
+typedef struct
+{
+    int32_t  sum[3];
+    uint32_t sum_sq[3];
+    uint32_t magnitude_sum;
+    int8_t   last[3];       // Previous sample, for the tap detection.
+    int8_t   center[3];     // Mean of the previous window.
+    int8_t   side[3];       // Side of the center each axis was last seen on, 0 if not yet.
+    uint8_t  crossings[3];
+    uint8_t  events;
+    uint8_t  orientation;   // Of the previous window.
+    uint8_t  started;       // Set once last[] holds a sample.
+    uint8_t  count;
+} motion_features_acc_t;
+
+/**
+ * @brief Function for starting with an empty window and no history.
+ *
+ * @param[out] p_acc  Accumulator.
+ */
+void motion_features_init(motion_features_acc_t * p_acc);
+
+/**
+ * @brief Function for adding samples to the current window.
+ *
+ * A window holds at most 255 samples, the ones beyond are ignored.
+ *
+ * @param[in,out] p_acc  Accumulator.
+ * @param[in]     p_xyz  X, Y, Z values in counts, three per sample.
+ * @param[in]     count  Number of XYZ samples.
+ */
+void motion_features_add(motion_features_acc_t * p_acc, int8_t const * p_xyz, uint32_t count);
+
+/**
+ * @brief Function for closing the current window and starting the next one.
+ *
+ * An empty window gives a frame with a zero count and the previous orientation.
+ *
+ * @param[in,out] p_acc       Accumulator.
+ * @param[out]    p_features  Features of the window.
+ */
+void motion_features_get(motion_features_acc_t * p_acc, motion_features_t * p_features);
+
+/** @} */
+
+#endif // MOTION_FEATURES_H__
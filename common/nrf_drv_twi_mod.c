@@ -0,0 +1,2000 @@
+/* Copyright (c) 2015 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+#include "nrf_drv_twi_mod.h"
+#include "nrf_drv_common.h"
+#include "nrf_gpio.h"
+#include "nrf_assert.h"
+#include "app_util_platform.h"
+#include "nrf_delay.h"
+
+#include <stdio.h>
+
+#define TWI0_IRQ_HANDLER    SPI0_TWI0_IRQHandler
+#define TWI1_IRQ_HANDLER    SPI1_TWI1_IRQHandler
+
+#if (defined(TWIM_IN_USE) && defined(TWI_IN_USE))
+    // TWIM and TWI combined
+    #define CODE_FOR_TWIM(code) if (p_instance->use_easy_dma) { code }
+    #define CODE_FOR_TWI(code)  else { code }
+#elif (defined(TWIM_IN_USE) && !defined(TWI_IN_USE))
+    // TWIM only
+    #define CODE_FOR_TWIM(code) { code }
+    #define CODE_FOR_TWI(code)
+#elif (!defined(TWIM_IN_USE) && defined(TWI_IN_USE))
+    // TWI only
+    #define CODE_FOR_TWIM(code)
+    #define CODE_FOR_TWI(code)  { code }
+#else
+    #error "Wrong configuration."
+#endif
+
+// All interrupt flags
+#define DISABLE_ALL  0xFFFFFFFF
+
+#if (TWI_QUEUE_ENABLED == 1)
+    #if (TWI_QUEUE_SIZE & (TWI_QUEUE_SIZE - 1)) || (TWI_QUEUE_SIZE > 128)
+        #error "TWI_QUEUE_SIZE must be a power of two not greater than 128."
+    #endif
+    #define TWI_QUEUE_MASK  (TWI_QUEUE_SIZE - 1)
+#endif
+
+// Constant false when a feature is compiled out, so that the compiler drops the dead branches.
+#if (TWI_BLOCKING_ENABLED == 1)
+    #define BLOCKING_MODE(p_cb)  ((p_cb)->handler == NULL)
+#else
+    #define BLOCKING_MODE(p_cb)  false
+#endif
+#if (TWI_REPEATED_ENABLED == 1)
+    #define XFER_REPEATED(p_cb)  ((p_cb)->repeated)
+#else
+    #define XFER_REPEATED(p_cb)  false
+#endif
+
+// Internal flag - queued transfer that does not call the event handler when done.
+#define TWI_FLAG_QUEUE_SILENT (1UL << 31)
+// Internal flag - transfer started again by the recovery engine, keeps the retry budget.
+#define TWI_FLAG_RETRY        (1UL << 30)
+// Internal flag - transfer taken from the queue, its submit time was taken when queued.
+#define TWI_FLAG_QUEUED       (1UL << 29)
+
+#if (TWI_TRACE_ENABLED == 1)
+    #if (TWI_TRACE_SIZE & (TWI_TRACE_SIZE - 1)) || (TWI_TRACE_SIZE > 0x8000)
+        #error "TWI_TRACE_SIZE must be a power of two not greater than 0x8000."
+    #endif
+    #ifndef TWI_TRACE_TIMESTAMP
+        // CPU cycle counter, started at init.
+        #define TWI_TRACE_TIMESTAMP()  (DWT->CYCCNT)
+        #define TWI_TRACE_TIMESTAMP_HZ 64000000UL
+        #define TWI_TRACE_CYCCNT
+    #endif
+#endif
+
+#if (TWI_RECOVERY_ENABLED == 1)
+    #if (TWI_RECOVERY_RETRIES > 8) || (TWI_RECOVERY_BUS_CLEAR_AFTER == 0)
+        #error "TWI_RECOVERY_RETRIES must not exceed 8 and TWI_RECOVERY_BUS_CLEAR_AFTER must not be 0."
+    #endif
+#endif
+
+#define SCL_PIN_CONF        ((GPIO_PIN_CNF_SENSE_Disabled << GPIO_PIN_CNF_SENSE_Pos)    \
+                            | (GPIO_PIN_CNF_DRIVE_S0D1     << GPIO_PIN_CNF_DRIVE_Pos)   \
+                            | (GPIO_PIN_CNF_PULL_Pullup    << GPIO_PIN_CNF_PULL_Pos)    \
+                            | (GPIO_PIN_CNF_INPUT_Connect  << GPIO_PIN_CNF_INPUT_Pos)   \
+                            | (GPIO_PIN_CNF_DIR_Input      << GPIO_PIN_CNF_DIR_Pos))
+
+#define SDA_PIN_CONF        SCL_PIN_CONF
+
+#define SCL_PIN_CONF_CLR    ((GPIO_PIN_CNF_SENSE_Disabled << GPIO_PIN_CNF_SENSE_Pos)    \
+                            | (GPIO_PIN_CNF_DRIVE_S0D1     << GPIO_PIN_CNF_DRIVE_Pos)   \
+                            | (GPIO_PIN_CNF_PULL_Pullup    << GPIO_PIN_CNF_PULL_Pos)    \
+                            | (GPIO_PIN_CNF_INPUT_Connect  << GPIO_PIN_CNF_INPUT_Pos)   \
+                            | (GPIO_PIN_CNF_DIR_Output     << GPIO_PIN_CNF_DIR_Pos))
+
+#define SDA_PIN_CONF_CLR    SCL_PIN_CONF_CLR
+
+#if (TWI_QUEUE_ENABLED == 1)
+// Transfer queue entry.
+typedef struct
+{
+    nrf_drv_twi_xfer_desc_t xfer_desc;
+    uint32_t                flags;
+#if (TWI_TRACE_ENABLED == 1)
+    uint32_t                submit;
+#endif
+} twi_queue_entry_t;
+#endif
+
+#if (TWI_SCAN_ENABLED == 1)
+// Scan table state (TWIM only).
+typedef struct
+{
+    nrf_drv_twi_scan_entry_t const * p_table;  // NULL when no scan is active.
+    uint8_t *                        p_rx_buf;
+    uint16_t                         offset;   // Offset of the current entry data in p_rx_buf.
+    uint8_t                          entries;
+    uint8_t                          entry;
+    uint8_t                          cycles;
+    uint8_t                          cycle;
+    uint8_t                          regs[TWI_SCAN_TABLE_SIZE]; // TX list, one register per entry.
+} twi_scan_t;
+#endif
+
+// Control block - driver instance local data.
+typedef struct
+{
+    nrf_drv_twi_evt_handler_t handler;
+    void *                    p_context;
+    volatile uint32_t         int_mask;
+    nrf_drv_twi_xfer_desc_t   xfer_desc;
+    uint32_t                  flags;
+    uint8_t *                 p_curr_buf;
+    uint8_t                   curr_length;
+    bool                      curr_no_stop;
+    nrf_drv_state_t           state;
+    volatile bool             error;
+    bool                      busy;
+#if (TWI_REPEATED_ENABLED == 1)
+    bool                      repeated;
+#endif
+    uint8_t                   bytes_transferred;
+#if (TWI_QUEUE_ENABLED == 1)
+    twi_queue_entry_t         queue[TWI_QUEUE_SIZE];
+    volatile uint8_t          queue_head; // Written by nrf_drv_twi_xfer_queue, in a critical region.
+    volatile uint8_t          queue_tail; // Written only by the consumer (driver, TWI interrupt blocked).
+#endif
+#if (TWI_SCAN_ENABLED == 1)
+    twi_scan_t                scan;
+#endif
+#ifdef TWI_DOUBLE_BUFFER_IN_USE
+    uint8_t *                 p_rx_base;    // Start of the double-buffered RX list.
+    uint16_t                  rx_half_size; // Size of one half of the RX list, 0 if not double-buffered.
+#endif
+#if (TWI_RECOVERY_ENABLED == 1)
+    uint32_t                  scl;          // Pins kept for clearing the bus after init.
+    uint32_t                  sda;
+    uint8_t                   retries;      // Retries left for the current transfer.
+    uint8_t                   fail_streak;  // Transfers failed in a row after all retries.
+    nrf_drv_twi_error_stats_t stats;
+#endif
+#if (TWI_TRACE_ENABLED == 1)
+    nrf_drv_twi_trace_t       trace;        // Record of the transfer in progress.
+#endif
+} twi_control_block_t;
+
+static twi_control_block_t m_cb[TWI_COUNT];
+
+#if (TWI_TRACE_ENABLED == 1)
+nrf_drv_twi_trace_ring_t nrf_drv_twi_trace = {
+    .magic        = NRF_DRV_TWI_TRACE_MAGIC,
+    .timestamp_hz = TWI_TRACE_TIMESTAMP_HZ,
+    .size         = TWI_TRACE_SIZE,
+    .record_size  = sizeof(nrf_drv_twi_trace_t),
+};
+#endif
+
+static nrf_drv_twi_config_t const m_default_config[TWI_COUNT] = {
+#if (TWI0_ENABLED == 1)
+    NRF_DRV_TWI_DEFAULT_CONFIG(0),
+#endif
+#if (TWI1_ENABLED == 1)
+    NRF_DRV_TWI_DEFAULT_CONFIG(1),
+#endif
+};
+
+static void twi_clear_bus(uint32_t scl, uint32_t sda)
+{
+    NRF_GPIO->PIN_CNF[scl] = SCL_PIN_CONF;
+    NRF_GPIO->PIN_CNF[sda] = SDA_PIN_CONF;
+
+    nrf_gpio_pin_set(scl);
+    nrf_gpio_pin_set(sda);
+
+    NRF_GPIO->PIN_CNF[scl] = SCL_PIN_CONF_CLR;
+    NRF_GPIO->PIN_CNF[sda] = SDA_PIN_CONF_CLR;
+
+    nrf_delay_us(4);
+
+    for(int i = 0; i < 9; i++)
+    {
+        if (nrf_gpio_pin_read(sda))
+        {
+            if(i == 0)
+            {
+                return;
+            }
+            else
+            {
+                break;
+            }
+        }
+        nrf_gpio_pin_clear(scl);
+        nrf_delay_us(4);
+        nrf_gpio_pin_set(scl);
+        nrf_delay_us(4);
+    }
+    nrf_gpio_pin_clear(sda);
+    nrf_delay_us(4);
+    nrf_gpio_pin_set(sda);
+}
+
+#if (TWI_RECOVERY_ENABLED == 1)
+/**
+ * @brief Count a failed attempt by its cause. TWI and TWIM share the ERRORSRC layout.
+ */
+static void twi_error_count(twi_control_block_t * p_cb, uint32_t errorsrc)
+{
+    if (errorsrc & NRF_TWI_ERROR_ADDRESS_NACK)
+    {
+        p_cb->stats.address_nack++;
+    }
+    else if (errorsrc & NRF_TWI_ERROR_DATA_NACK)
+    {
+        p_cb->stats.data_nack++;
+    }
+    else if (errorsrc & TWI_ERRORSRC_OVERRUN_Msk)
+    {
+        p_cb->stats.overrun++;
+    }
+}
+
+/**
+ * @brief Account for the outcome of a transfer attempt.
+ *
+ * Repeated transfers are only counted: they are restarted by PPI and not by the driver. Held
+ * transfers wait for an external trigger, so they are reported instead of being set up again.
+ *
+ * @return True if the transfer is to be started again.
+ */
+static bool twi_recovery_check(twi_control_block_t * p_cb, uint32_t errorsrc)
+{
+    if (XFER_REPEATED(p_cb))
+    {
+        twi_error_count(p_cb, errorsrc);
+        return false;
+    }
+    if (errorsrc == 0)
+    {
+        p_cb->fail_streak = 0;
+        return false;
+    }
+
+    twi_error_count(p_cb, errorsrc);
+    if ((p_cb->retries != 0) &&
+        !(p_cb->flags & (NRF_DRV_TWI_FLAGS_NO_RETRY | NRF_DRV_TWI_FLAGS_HOLD_XFER)))
+    {
+        p_cb->retries--;
+        p_cb->stats.retries++;
+        return true;
+    }
+    p_cb->stats.failed++;
+    // A slave polled for the end of its write cycle answers with NACK until it is done, that
+    // does not point at a stuck bus.
+    if (!((p_cb->flags & NRF_DRV_TWI_FLAGS_NO_RETRY) && (errorsrc & NRF_TWI_ERROR_ADDRESS_NACK)))
+    {
+        p_cb->fail_streak++;
+    }
+    return false;
+}
+
+/**
+ * @brief Back-off before a blocking retry, doubled on every attempt of the same transfer.
+ */
+static void twi_recovery_backoff(twi_control_block_t const * p_cb)
+{
+    nrf_delay_us(TWI_RECOVERY_BACKOFF_US << (TWI_RECOVERY_RETRIES - 1 - p_cb->retries));
+}
+
+static void twi_recovery_clear_bus(twi_control_block_t * p_cb)
+{
+    twi_clear_bus(p_cb->scl, p_cb->sda);
+    NRF_GPIO->PIN_CNF[p_cb->scl] = SCL_PIN_CONF;
+    NRF_GPIO->PIN_CNF[p_cb->sda] = SDA_PIN_CONF;
+    p_cb->fail_streak = 0;
+    p_cb->stats.bus_clears++;
+}
+
+#ifdef TWIM_IN_USE
+static void twim_bus_clear(twi_control_block_t * p_cb, NRF_TWIM_Type * p_twim)
+{
+    // The pins are driven from GPIO only while the peripheral is disabled.
+    nrf_twim_disable(p_twim);
+    twi_recovery_clear_bus(p_cb);
+    if (p_cb->state == NRF_DRV_STATE_POWERED_ON)
+    {
+        nrf_twim_enable(p_twim);
+    }
+}
+
+static bool twim_recovery(twi_control_block_t * p_cb, NRF_TWIM_Type * p_twim, uint32_t errorsrc)
+{
+    bool retry = twi_recovery_check(p_cb, errorsrc);
+
+    if (p_cb->fail_streak >= TWI_RECOVERY_BUS_CLEAR_AFTER)
+    {
+        twim_bus_clear(p_cb, p_twim);
+    }
+    return retry;
+}
+#endif
+
+#ifdef TWI_IN_USE
+static void twi_bus_clear(twi_control_block_t * p_cb, NRF_TWI_Type * p_twi)
+{
+    // The pins are driven from GPIO only while the peripheral is disabled.
+    nrf_twi_disable(p_twi);
+    twi_recovery_clear_bus(p_cb);
+    if (p_cb->state == NRF_DRV_STATE_POWERED_ON)
+    {
+        nrf_twi_enable(p_twi);
+    }
+}
+
+static bool twi_recovery(twi_control_block_t * p_cb, NRF_TWI_Type * p_twi, uint32_t errorsrc)
+{
+    bool retry = twi_recovery_check(p_cb, errorsrc);
+
+    if (p_cb->fail_streak >= TWI_RECOVERY_BUS_CLEAR_AFTER)
+    {
+        twi_bus_clear(p_cb, p_twi);
+    }
+    return retry;
+}
+#endif
+#endif // (TWI_RECOVERY_ENABLED == 1)
+
+#if (TWI_TRACE_ENABLED == 1)
+static void twi_trace_begin(twi_control_block_t *           p_cb,
+                            nrf_drv_twi_xfer_desc_t const * p_xfer_desc,
+                            uint32_t                        flags)
+{
+    uint32_t now = TWI_TRACE_TIMESTAMP();
+
+    if (flags & TWI_FLAG_RETRY)
+    {
+        p_cb->trace.attempts++;
+        return;
+    }
+    if (!(flags & TWI_FLAG_QUEUED))
+    {
+        p_cb->trace.submit = now;
+    }
+    p_cb->trace.start    = now;
+    p_cb->trace.address  = p_xfer_desc->address;
+    p_cb->trace.type     = (uint8_t)p_xfer_desc->type;
+    p_cb->trace.instance = (uint8_t)(p_cb - m_cb);
+    p_cb->trace.attempts = 1;
+}
+
+/**
+ * @brief Take the record of the transfer that just ended.
+ *
+ * The record is copied out because the next transfer may start from the queue before
+ * the event handler is called.
+ */
+static void twi_trace_end(twi_control_block_t const * p_cb,
+                          nrf_drv_twi_trace_t *       p_record,
+                          uint32_t                    bytes,
+                          uint32_t                    errorsrc)
+{
+    *p_record          = p_cb->trace;
+    p_record->end      = TWI_TRACE_TIMESTAMP();
+    p_record->bytes    = (uint16_t)bytes;
+    p_record->errorsrc = (uint8_t)errorsrc;
+}
+
+static void twi_trace_commit(nrf_drv_twi_trace_t * p_record)
+{
+    p_record->done = TWI_TRACE_TIMESTAMP();
+
+    // Instances may end transfers at different interrupt levels.
+    CRITICAL_REGION_ENTER();
+    nrf_drv_twi_trace.records[nrf_drv_twi_trace.head & (TWI_TRACE_SIZE - 1)] = *p_record;
+    nrf_drv_twi_trace.head++;
+    CRITICAL_REGION_EXIT();
+}
+
+#ifdef TWIM_IN_USE
+static uint32_t twim_trace_bytes(twi_control_block_t const * p_cb, NRF_TWIM_Type * p_twim)
+{
+    // The AMOUNT register of the direction not used keeps the value of an older transfer.
+    switch (p_cb->xfer_desc.type)
+    {
+    case NRF_DRV_TWI_XFER_TX:
+        return nrf_twim_txd_amount_get(p_twim);
+    case NRF_DRV_TWI_XFER_RX:
+        return nrf_twim_rxd_amount_get(p_twim);
+    case NRF_DRV_TWI_XFER_TXRX:
+        return nrf_twim_txd_amount_get(p_twim) + nrf_twim_rxd_amount_get(p_twim);
+    default:
+        return p_cb->xfer_desc.primary_length + nrf_twim_txd_amount_get(p_twim);
+    }
+}
+#endif
+
+#ifdef TWI_IN_USE
+static uint32_t twi_trace_bytes(twi_control_block_t const * p_cb)
+{
+    bool two_parts = (p_cb->xfer_desc.type == NRF_DRV_TWI_XFER_TXRX) ||
+                     (p_cb->xfer_desc.type == NRF_DRV_TWI_XFER_TXTX);
+
+    if (!p_cb->error)
+    {
+        return p_cb->xfer_desc.primary_length + (two_parts ? p_cb->xfer_desc.secondary_length : 0);
+    }
+    return p_cb->bytes_transferred +
+        ((p_cb->p_curr_buf != p_cb->xfer_desc.p_primary_buf) ? p_cb->xfer_desc.primary_length : 0);
+}
+#endif
+#endif // (TWI_TRACE_ENABLED == 1)
+
+ret_code_t nrf_drv_twi_init(nrf_drv_twi_t const *        p_instance,
+                            nrf_drv_twi_config_t const * p_config,
+                            nrf_drv_twi_evt_handler_t    event_handler,
+                            void *                       p_context)
+{
+    twi_control_block_t * p_cb  = &m_cb[p_instance->drv_inst_idx];
+
+    if (p_cb->state != NRF_DRV_STATE_UNINITIALIZED)
+    {
+        return NRF_ERROR_INVALID_STATE;
+    }
+
+#if (TWI_BLOCKING_ENABLED != 1)
+    if (event_handler == NULL)
+    {
+        return NRF_ERROR_NOT_SUPPORTED;
+    }
+#endif
+
+    if (p_config == NULL)
+    {
+        p_config = &m_default_config[p_instance->drv_inst_idx];
+    }
+
+    p_cb->handler   = event_handler;
+    p_cb->p_context = p_context;
+    p_cb->int_mask  = 0;
+#if (TWI_REPEATED_ENABLED == 1)
+    p_cb->repeated             = false;
+#endif
+#if (TWI_QUEUE_ENABLED == 1)
+    p_cb->queue_head           = 0;
+    p_cb->queue_tail           = 0;
+#endif
+#if (TWI_SCAN_ENABLED == 1)
+    p_cb->scan.p_table         = NULL;
+#endif
+#ifdef TWI_DOUBLE_BUFFER_IN_USE
+    p_cb->rx_half_size         = 0;
+#endif
+#if (TWI_RECOVERY_ENABLED == 1)
+    p_cb->scl                  = p_config->scl;
+    p_cb->sda                  = p_config->sda;
+    p_cb->fail_streak          = 0;
+    p_cb->stats                = (nrf_drv_twi_error_stats_t){0};
+#endif
+
+#ifdef TWI_TRACE_CYCCNT
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL        |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+
+    twi_clear_bus(p_config->scl, p_config->sda);
+
+    /* To secure correct signal levels on the pins used by the TWI
+       master when the system is in OFF mode, and when the TWI master is
+       disabled, these pins must be configured in the GPIO peripheral.
+    */
+    NRF_GPIO->PIN_CNF[p_config->scl] = SCL_PIN_CONF;
+    NRF_GPIO->PIN_CNF[p_config->sda] = SDA_PIN_CONF;
+
+    CODE_FOR_TWIM
+    (
+        NRF_TWIM_Type * p_twim = p_instance->reg.p_twim;
+        nrf_twim_pins_set(p_twim, p_config->scl, p_config->sda);
+        nrf_twim_frequency_set(p_twim,
+            (nrf_twim_frequency_t)p_config->frequency);
+    )
+    CODE_FOR_TWI
+    (
+        NRF_TWI_Type * p_twi = p_instance->reg.p_twi;
+        nrf_twi_pins_set(p_twi, p_config->scl, p_config->sda);
+        nrf_twi_frequency_set(p_twi,
+            (nrf_twi_frequency_t)p_config->frequency);
+    )
+
+    if (!BLOCKING_MODE(p_cb))
+    {
+        CODE_FOR_TWIM
+        (
+            nrf_drv_common_irq_enable(nrf_drv_get_IRQn((void *)p_instance->reg.p_twim),
+                p_config->interrupt_priority);
+        )
+        CODE_FOR_TWI
+        (
+            nrf_drv_common_irq_enable(nrf_drv_get_IRQn((void *)p_instance->reg.p_twi),
+                p_config->interrupt_priority);
+        )
+    }
+
+    p_cb->state = NRF_DRV_STATE_INITIALIZED;
+
+    return NRF_SUCCESS;
+}
+
+void nrf_drv_twi_uninit(nrf_drv_twi_t const * p_instance)
+{
+    twi_control_block_t * p_cb = &m_cb[p_instance->drv_inst_idx];
+    ASSERT(p_cb->state != NRF_DRV_STATE_UNINITIALIZED);
+
+    if (!BLOCKING_MODE(p_cb))
+    {
+        CODE_FOR_TWIM
+        (
+            nrf_drv_common_irq_disable(nrf_drv_get_IRQn((void *)p_instance->reg.p_twim));
+        )
+        CODE_FOR_TWI
+        (
+            nrf_drv_common_irq_disable(nrf_drv_get_IRQn((void *)p_instance->reg.p_twi));
+        )
+    }
+    nrf_drv_twi_disable(p_instance);
+
+    p_cb->state = NRF_DRV_STATE_UNINITIALIZED;
+}
+
+void nrf_drv_twi_enable(nrf_drv_twi_t const * p_instance)
+{
+    twi_control_block_t * p_cb = &m_cb[p_instance->drv_inst_idx];
+    ASSERT(p_cb->state == NRF_DRV_STATE_INITIALIZED);
+
+    CODE_FOR_TWIM
+    (
+        NRF_TWIM_Type * p_twim = p_instance->reg.p_twim;
+
+        nrf_twim_enable(p_twim);
+    )
+    CODE_FOR_TWI
+    (
+        NRF_TWI_Type * p_twi = p_instance->reg.p_twi;
+
+        nrf_twi_enable(p_twi);
+    )
+
+    p_cb->state = NRF_DRV_STATE_POWERED_ON;
+}
+
+void nrf_drv_twi_disable(nrf_drv_twi_t const * p_instance)
+{
+    twi_control_block_t * p_cb = &m_cb[p_instance->drv_inst_idx];
+    ASSERT(p_cb->state != NRF_DRV_STATE_UNINITIALIZED);
+
+    CODE_FOR_TWIM
+    (
+        NRF_TWIM_Type * p_twim = p_instance->reg.p_twim;
+        p_cb->int_mask = 0;
+        nrf_twim_int_disable(p_twim, DISABLE_ALL);
+        nrf_twim_shorts_disable(p_twim, DISABLE_ALL);
+        nrf_twim_disable(p_twim);
+    )
+    CODE_FOR_TWI
+    (
+        NRF_TWI_Type * p_twi = p_instance->reg.p_twi;
+        nrf_twi_int_disable(p_twi, DISABLE_ALL);
+        nrf_twi_shorts_disable(p_twi, DISABLE_ALL);
+        nrf_twi_disable(p_twi);
+    )
+
+    p_cb->state = NRF_DRV_STATE_INITIALIZED;
+}
+
+#ifdef TWI_IN_USE
+static bool twi_send_byte(NRF_TWI_Type * p_twi,
+                          uint8_t * p_data,
+                          uint8_t length,
+                          uint8_t * p_bytes_transferred,
+                          bool no_stop)
+{
+    uint8_t bytes_transferred = *p_bytes_transferred;
+    if (bytes_transferred < length)
+    {
+        nrf_twi_txd_set(p_twi, p_data[bytes_transferred]);
+        ++bytes_transferred;
+    }
+    else
+    {
+        if (no_stop)
+        {
+            nrf_twi_task_trigger(p_twi, NRF_TWI_TASK_SUSPEND);
+            *p_bytes_transferred = bytes_transferred;
+            return false;
+        }
+        else
+        {
+            nrf_twi_task_trigger(p_twi, NRF_TWI_TASK_STOP);
+        }
+    }
+    *p_bytes_transferred = bytes_transferred;
+    return true;
+}
+
+static void twi_receive_byte(NRF_TWI_Type * p_twi,
+                             uint8_t      * p_data,
+                             uint8_t        length,
+                             uint8_t      * p_bytes_transferred)
+{
+    uint8_t bytes_transferred = *p_bytes_transferred;
+    if (bytes_transferred < length)
+    {
+        p_data[bytes_transferred] = nrf_twi_rxd_get(p_twi);
+
+        ++bytes_transferred;
+        *p_bytes_transferred = bytes_transferred;
+
+        if (bytes_transferred == length)
+        {
+            // The BB->STOP short set for this byte already ends the transfer.
+            return;
+        }
+        if (bytes_transferred == length-1)
+        {
+            nrf_twi_shorts_set(p_twi, NRF_TWI_SHORT_BB_STOP_MASK);
+        }
+
+        nrf_twi_task_trigger(p_twi, NRF_TWI_TASK_RESUME);
+    }
+}
+
+/**
+ * @brief Handle the pending TWI events of a transfer, one byte at a time.
+ *
+ * The events are checked once per call. Bytes are received with the BB->SUSPEND short and the
+ * last one with BB->STOP, so the only per-byte work is moving the data. The STOPPED event is
+ * checked after the byte is handled: when the stop condition is already on the bus by then,
+ * the transfer ends in the same interrupt instead of the next one.
+ *
+ * @return False when the transfer is over (stopped, or suspended after TX without stop).
+ */
+static bool twi_transfer(NRF_TWI_Type * p_twi,
+                         bool         * p_error,
+                         uint8_t      * p_bytes_transferred,
+                         uint8_t      * p_data,
+                         uint8_t        length,
+                         bool           no_stop)
+{
+    if (*p_error)
+    {
+        nrf_twi_event_clear(p_twi, NRF_TWI_EVENT_ERROR);
+        nrf_twi_event_clear(p_twi, NRF_TWI_EVENT_TXDSENT);
+        nrf_twi_event_clear(p_twi, NRF_TWI_EVENT_RXDREADY);
+    }
+    else if (nrf_twi_event_check(p_twi, NRF_TWI_EVENT_ERROR))
+    {
+        nrf_twi_event_clear(p_twi, NRF_TWI_EVENT_ERROR);
+        nrf_twi_task_trigger(p_twi, NRF_TWI_TASK_STOP);
+        *p_error = true;
+    }
+    else if (nrf_twi_event_check(p_twi, NRF_TWI_EVENT_TXDSENT))
+    {
+        nrf_twi_event_clear(p_twi, NRF_TWI_EVENT_TXDSENT);
+        if (!twi_send_byte(p_twi, p_data, length, p_bytes_transferred, no_stop))
+        {
+            return false;
+        }
+    }
+    else if (nrf_twi_event_check(p_twi, NRF_TWI_EVENT_RXDREADY))
+    {
+        nrf_twi_event_clear(p_twi, NRF_TWI_EVENT_RXDREADY);
+        twi_receive_byte(p_twi, p_data, length, p_bytes_transferred);
+    }
+
+    if ((*p_error || (*p_bytes_transferred == length)) &&
+        nrf_twi_event_check(p_twi, NRF_TWI_EVENT_STOPPED))
+    {
+        nrf_twi_event_clear(p_twi, NRF_TWI_EVENT_STOPPED);
+        return false;
+    }
+
+    return true;
+}
+
+static ret_code_t twi_tx_start_transfer(twi_control_block_t * p_cb,
+                                        NRF_TWI_Type *        p_twi,
+                                        uint8_t const *       p_data,
+                                        uint8_t               length,
+                                        bool                  no_stop)
+{
+    ret_code_t ret_code = NRF_SUCCESS;
+
+    nrf_twi_event_clear(p_twi, NRF_TWI_EVENT_STOPPED);
+    nrf_twi_event_clear(p_twi, NRF_TWI_EVENT_ERROR);
+    nrf_twi_event_clear(p_twi, NRF_TWI_EVENT_TXDSENT);
+    nrf_twi_event_clear(p_twi, NRF_TWI_EVENT_RXDREADY);
+    nrf_twi_shorts_set(p_twi, 0);
+
+    p_cb->bytes_transferred = 0;
+    p_cb->error             = false;
+
+    // In case TWI is suspended resume its operation.
+    nrf_twi_task_trigger(p_twi, NRF_TWI_TASK_RESUME);
+    nrf_twi_task_trigger(p_twi, NRF_TWI_TASK_STARTTX);
+
+    (void)twi_send_byte(p_twi, (uint8_t*)p_data, length, &p_cb->bytes_transferred, no_stop);
+
+    if (!BLOCKING_MODE(p_cb))
+    {
+        p_cb->int_mask = NRF_TWI_INT_STOPPED_MASK   |
+                        NRF_TWI_INT_ERROR_MASK     |
+                        NRF_TWI_INT_TXDSENT_MASK   |
+                        NRF_TWI_INT_RXDREADY_MASK;
+        nrf_twi_int_enable(p_twi, p_cb->int_mask);
+    }
+    else
+    {
+        while (twi_transfer(p_twi, (bool *)&p_cb->error, (uint8_t*)&p_cb->bytes_transferred, (uint8_t*)p_data, length, no_stop))
+        {}
+
+        if (p_cb->error)
+        {
+            ret_code = NRF_ERROR_INTERNAL;
+        }
+    }
+    return ret_code;
+}
+
+static ret_code_t twi_rx_start_transfer(twi_control_block_t * p_cb,
+                                        NRF_TWI_Type *        p_twi,
+                                        uint8_t const *       p_data,
+                                        uint8_t               length)
+{
+    ret_code_t ret_code = NRF_SUCCESS;
+
+    nrf_twi_event_clear(p_twi, NRF_TWI_EVENT_STOPPED);
+    nrf_twi_event_clear(p_twi, NRF_TWI_EVENT_ERROR);
+    nrf_twi_event_clear(p_twi, NRF_TWI_EVENT_TXDSENT);
+    nrf_twi_event_clear(p_twi, NRF_TWI_EVENT_RXDREADY);
+
+    p_cb->bytes_transferred = 0;
+    p_cb->error             = false;
+
+    if (length == 1)
+    {
+        nrf_twi_shorts_set(p_twi, NRF_TWI_SHORT_BB_STOP_MASK);
+    }
+    else
+    {
+        nrf_twi_shorts_set(p_twi, NRF_TWI_SHORT_BB_SUSPEND_MASK);
+    }
+    // In case TWI is suspended resume its operation.
+    nrf_twi_task_trigger(p_twi, NRF_TWI_TASK_RESUME);
+    nrf_twi_task_trigger(p_twi, NRF_TWI_TASK_STARTRX);
+
+    if (!BLOCKING_MODE(p_cb))
+    {
+        // A single byte is read at STOPPED, see irq_handler_twi.
+        p_cb->int_mask = NRF_TWI_INT_STOPPED_MASK   |
+                        NRF_TWI_INT_ERROR_MASK     |
+                        NRF_TWI_INT_TXDSENT_MASK   |
+                        ((length > 1) ? NRF_TWI_INT_RXDREADY_MASK : 0);
+        nrf_twi_int_disable(p_twi, NRF_TWI_INT_RXDREADY_MASK);
+        nrf_twi_int_enable(p_twi, p_cb->int_mask);
+    }
+    else
+    {
+        while (twi_transfer(p_twi, (bool *)&p_cb->error, (uint8_t*)&p_cb->bytes_transferred, (uint8_t*)p_data, length, false))
+        {}
+
+        if (p_cb->error)
+        {
+            ret_code = NRF_ERROR_INTERNAL;
+        }
+    }
+    return ret_code;
+}
+
+__STATIC_INLINE ret_code_t twi_xfer(twi_control_block_t     * p_cb,
+                                    NRF_TWI_Type            * p_twi,
+                                    nrf_drv_twi_xfer_desc_t * p_xfer_desc,
+                                    uint32_t                  flags)
+{
+    ret_code_t ret = NRF_SUCCESS;
+
+    
+    if (NRF_DRV_TWI_FLAGS_TX_POSTINC & flags)
+    {
+        return NRF_ERROR_NOT_SUPPORTED;
+    }
+
+    if (NRF_DRV_TWI_FLAGS_RX_POSTINC & flags)
+    {
+        return NRF_ERROR_NOT_SUPPORTED;
+    }
+
+    if (p_xfer_desc->type > NRF_DRV_TWI_XFER_TXTX)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+    
+    /* Block TWI interrupts to ensure that function is not interrupted by TWI interrupt. */
+    nrf_twi_int_disable(p_twi, DISABLE_ALL);
+
+    if (p_cb->busy)
+    {
+        nrf_twi_int_enable(p_twi, p_cb->int_mask);
+        return NRF_ERROR_BUSY;
+    }
+    else
+    {
+        p_cb->busy = (NRF_DRV_TWI_FLAGS_NO_XFER_EVT_HANDLER & flags) ? false : true;
+    }
+
+    if (flags & NRF_DRV_TWI_FLAGS_HOLD_XFER)
+    {
+        return NRF_ERROR_NOT_SUPPORTED;
+    }
+
+#if (TWI_RECOVERY_ENABLED == 1)
+    if (!(flags & TWI_FLAG_RETRY))
+    {
+        p_cb->retries = TWI_RECOVERY_RETRIES;
+    }
+#endif
+#if (TWI_TRACE_ENABLED == 1)
+    twi_trace_begin(p_cb, p_xfer_desc, flags);
+#endif
+    p_cb->flags       = flags;
+    p_cb->xfer_desc   = *p_xfer_desc;
+    p_cb->curr_length = p_xfer_desc->primary_length;
+    p_cb->p_curr_buf  = p_xfer_desc->p_primary_buf;
+    nrf_twi_address_set(p_twi, p_xfer_desc->address);
+
+    if (!(p_xfer_desc->type == NRF_DRV_TWI_XFER_RX))
+    {
+        p_cb->curr_no_stop = ((p_xfer_desc->type == NRF_DRV_TWI_XFER_TX) &&
+                             !(flags & NRF_DRV_TWI_FLAGS_TX_NO_STOP)) ? false : true;
+        ret = twi_tx_start_transfer(p_cb, p_twi, p_xfer_desc->p_primary_buf, p_xfer_desc->primary_length, p_cb->curr_no_stop);
+    }
+    else
+    {
+        p_cb->curr_no_stop = false;
+        ret = twi_rx_start_transfer(p_cb, p_twi, p_xfer_desc->p_primary_buf, p_xfer_desc->primary_length);
+    }
+    if (BLOCKING_MODE(p_cb))
+    {
+        p_cb->busy = false;
+#if (TWI_RECOVERY_ENABLED == 1) || (TWI_TRACE_ENABLED == 1)
+        uint32_t errorsrc = p_cb->error ? nrf_twi_errorsrc_get_and_clear(p_twi) : 0;
+#endif
+#if (TWI_RECOVERY_ENABLED == 1)
+        if (twi_recovery(p_cb, p_twi, errorsrc))
+        {
+            twi_recovery_backoff(p_cb);
+            return twi_xfer(p_cb, p_twi, p_xfer_desc, flags | TWI_FLAG_RETRY);
+        }
+#endif
+#if (TWI_TRACE_ENABLED == 1)
+        nrf_drv_twi_trace_t trace;
+        twi_trace_end(p_cb, &trace, twi_trace_bytes(p_cb), errorsrc);
+        twi_trace_commit(&trace);
+#endif
+    }
+    return ret;
+}
+#endif
+
+#ifdef TWIM_IN_USE
+/**
+ * @brief Sleep until the TWIM generates the given event, handling a bus error on the way.
+ *
+ * The interrupts in @p int_mask are enabled in the peripheral only, so a pending TWIM interrupt
+ * wakes the CPU from WFE (SEVONPEND) without the handler ever running. The pending bit is cleared
+ * before every sleep: it is set again at once while an enabled event is still up, otherwise the
+ * next event makes a fresh pending transition and a wake-up.
+ *
+ * The interrupt line is shared with SPI, so its NVIC enable and SEVONPEND are only changed for
+ * the wait and restored after it. An enabled SPI interrupt is held off until then.
+ */
+__STATIC_INLINE void twim_wait_for_event(NRF_TWIM_Type * p_twim, nrf_twim_event_t evt_to_wait, uint32_t int_mask)
+{
+    IRQn_Type irqn = nrf_drv_get_IRQn((void *)p_twim);
+    uint32_t  irq_bit = 1UL << ((uint32_t)irqn & 0x1F);
+    bool      irq_enabled = (NVIC->ISER[(uint32_t)irqn >> 5] & irq_bit) != 0;
+    uint32_t  sevonpend = SCB->SCR & SCB_SCR_SEVONPEND_Msk;
+
+    if (irq_enabled)
+    {
+        NVIC_DisableIRQ(irqn);
+    }
+    SCB->SCR |= SCB_SCR_SEVONPEND_Msk;
+    nrf_twim_int_enable(p_twim, int_mask | NRF_TWIM_INT_STOPPED_MASK);
+    while (!nrf_twim_event_check(p_twim, evt_to_wait))
+    {
+        if (nrf_twim_event_check(p_twim, NRF_TWIM_EVENT_ERROR))
+        {
+            nrf_twim_event_clear(p_twim, NRF_TWIM_EVENT_ERROR);
+            nrf_twim_task_trigger(p_twim, NRF_TWIM_TASK_RESUME);
+            nrf_twim_task_trigger(p_twim, NRF_TWIM_TASK_STOP);
+            evt_to_wait = NRF_TWIM_EVENT_STOPPED;
+        }
+        NVIC_ClearPendingIRQ(irqn);
+        if (!nrf_twim_event_check(p_twim, evt_to_wait))
+        {
+            __WFE();
+        }
+    }
+    nrf_twim_int_disable(p_twim, DISABLE_ALL);
+    NVIC_ClearPendingIRQ(irqn);
+    SCB->SCR = (SCB->SCR & ~SCB_SCR_SEVONPEND_Msk) | sevonpend;
+    if (irq_enabled)
+    {
+        NVIC_EnableIRQ(irqn);
+    }
+}
+
+__STATIC_INLINE ret_code_t twim_xfer(twi_control_block_t     * p_cb,
+                                     NRF_TWIM_Type           * p_twim,
+                                     nrf_drv_twi_xfer_desc_t * p_xfer_desc,
+                                     uint32_t                  flags)
+{
+    ret_code_t ret = NRF_SUCCESS;
+    nrf_twim_task_t  start_task = NRF_TWIM_TASK_STARTTX;
+    nrf_twim_event_t evt_to_wait = NRF_TWIM_EVENT_STOPPED;
+
+#if (TWI_LIST_ENABLED != 1)
+    if (flags & (NRF_DRV_TWI_FLAGS_TX_POSTINC | NRF_DRV_TWI_FLAGS_RX_POSTINC))
+    {
+        return NRF_ERROR_NOT_SUPPORTED;
+    }
+#endif
+#if (TWI_REPEATED_ENABLED != 1)
+    if (flags & (NRF_DRV_TWI_FLAGS_REPEATED_XFER | NRF_DRV_TWI_FLAGS_HOLD_XFER))
+    {
+        return NRF_ERROR_NOT_SUPPORTED;
+    }
+#endif
+    if ((p_xfer_desc->type == NRF_DRV_TWI_XFER_TXTX) &&
+        (flags & (NRF_DRV_TWI_FLAGS_TX_POSTINC | NRF_DRV_TWI_FLAGS_RX_POSTINC |
+                  NRF_DRV_TWI_FLAGS_NO_XFER_EVT_HANDLER)))
+    {
+        // The second buffer is chained from the interrupt handler.
+        return NRF_ERROR_NOT_SUPPORTED;
+    }
+    if (p_xfer_desc->type > NRF_DRV_TWI_XFER_TXTX)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+    if (!nrf_drv_is_in_RAM(p_xfer_desc->p_primary_buf) ||
+        (((p_xfer_desc->type == NRF_DRV_TWI_XFER_TXRX) || (p_xfer_desc->type == NRF_DRV_TWI_XFER_TXTX)) &&
+         !nrf_drv_is_in_RAM(p_xfer_desc->p_secondary_buf)))
+    {
+        return NRF_ERROR_INVALID_ADDR;
+    }
+    /* Block TWI interrupts to ensure that function is not interrupted by TWI interrupt. */
+    nrf_twim_int_disable(p_twim, DISABLE_ALL);
+    if (p_cb->busy)
+    {
+        nrf_twim_int_enable(p_twim, p_cb->int_mask);
+        return NRF_ERROR_BUSY;
+    }
+    else
+    {
+
+        p_cb->busy = ((NRF_DRV_TWI_FLAGS_NO_XFER_EVT_HANDLER & flags) ||
+                      (NRF_DRV_TWI_FLAGS_REPEATED_XFER & flags)) ? false: true;
+    }
+
+#if (TWI_RECOVERY_ENABLED == 1)
+    if (!(flags & TWI_FLAG_RETRY))
+    {
+        p_cb->retries = TWI_RECOVERY_RETRIES;
+    }
+#endif
+#if (TWI_TRACE_ENABLED == 1)
+    twi_trace_begin(p_cb, p_xfer_desc, flags);
+#endif
+    p_cb->xfer_desc = *p_xfer_desc;
+    p_cb->flags     = flags;
+#if (TWI_REPEATED_ENABLED == 1)
+    p_cb->repeated = (flags & NRF_DRV_TWI_FLAGS_REPEATED_XFER) ? true : false;
+#endif
+    nrf_twim_address_set(p_twim, p_xfer_desc->address);
+
+#if (TWI_LIST_ENABLED == 1)
+    if (flags & NRF_DRV_TWI_FLAGS_RX_POSTINC)
+    {
+        nrf_twim_rx_list_enable(p_twim);
+    }
+    else
+    {
+        nrf_twim_rx_list_disable(p_twim);
+    }
+    
+    if (flags & NRF_DRV_TWI_FLAGS_TX_POSTINC)
+    {
+        nrf_twim_tx_list_enable(p_twim);
+    }
+    else
+    {
+        nrf_twim_tx_list_disable(p_twim);
+    }
+#endif
+    
+    nrf_twim_event_clear(p_twim, NRF_TWIM_EVENT_STOPPED);
+    nrf_twim_event_clear(p_twim, NRF_TWIM_EVENT_ERROR);
+    switch (p_xfer_desc->type)
+    {
+    case NRF_DRV_TWI_XFER_TXTX:
+        // The bus is held after the first buffer, the interrupt handler sends the second one.
+        nrf_twim_shorts_set(p_twim, NRF_TWIM_SHORT_LASTTX_SUSPEND_MASK);
+        nrf_twim_tx_buffer_set(p_twim, p_xfer_desc->p_primary_buf, p_xfer_desc->primary_length);
+        nrf_twim_event_clear(p_twim, NRF_TWIM_EVENT_SUSPENDED);
+        nrf_twim_event_clear(p_twim, NRF_TWIM_EVENT_LASTTX);
+        nrf_twim_task_trigger(p_twim, NRF_TWIM_TASK_RESUME);
+        p_cb->int_mask = NRF_TWIM_INT_SUSPENDED_MASK | NRF_TWIM_INT_ERROR_MASK;
+        break;
+    case NRF_DRV_TWI_XFER_TXRX:
+        nrf_twim_tx_buffer_set(p_twim, p_xfer_desc->p_primary_buf, p_xfer_desc->primary_length);
+        nrf_twim_rx_buffer_set(p_twim, p_xfer_desc->p_secondary_buf, p_xfer_desc->secondary_length);
+        nrf_twim_shorts_set(p_twim, NRF_TWIM_SHORT_LASTTX_STARTRX_MASK |
+                                    NRF_TWIM_SHORT_LASTRX_STOP_MASK);
+        p_cb->int_mask = NRF_TWIM_INT_STOPPED_MASK | NRF_TWIM_INT_ERROR_MASK;
+        break;
+    case NRF_DRV_TWI_XFER_TX:
+        nrf_twim_tx_buffer_set(p_twim, p_xfer_desc->p_primary_buf, p_xfer_desc->primary_length);
+        if (NRF_DRV_TWI_FLAGS_TX_NO_STOP & flags)
+        {
+            nrf_twim_shorts_set(p_twim, NRF_TWIM_SHORT_LASTTX_SUSPEND_MASK);
+            p_cb->int_mask = NRF_TWIM_INT_SUSPENDED_MASK | NRF_TWIM_INT_ERROR_MASK;
+            nrf_twim_event_clear(p_twim, NRF_TWIM_EVENT_SUSPENDED);
+            evt_to_wait = NRF_TWIM_EVENT_SUSPENDED;
+        }
+        else
+        {
+            nrf_twim_shorts_set(p_twim, NRF_TWIM_SHORT_LASTTX_STOP_MASK);
+            p_cb->int_mask = NRF_TWIM_INT_STOPPED_MASK | NRF_TWIM_INT_ERROR_MASK;
+        }
+        nrf_twim_task_trigger(p_twim, NRF_TWIM_TASK_RESUME);
+        break;
+    case NRF_DRV_TWI_XFER_RX:
+        nrf_twim_rx_buffer_set(p_twim, p_xfer_desc->p_primary_buf, p_xfer_desc->primary_length);
+        nrf_twim_shorts_set(p_twim, NRF_TWIM_SHORT_LASTRX_STOP_MASK);
+        p_cb->int_mask = NRF_TWIM_INT_STOPPED_MASK | NRF_TWIM_INT_ERROR_MASK;
+        start_task = NRF_TWIM_TASK_STARTRX;
+        nrf_twim_task_trigger(p_twim, NRF_TWIM_TASK_RESUME);
+        break;
+    }
+
+    if (!(flags & NRF_DRV_TWI_FLAGS_HOLD_XFER))
+    {
+        nrf_twim_task_trigger(p_twim, start_task);
+    }
+
+    if (!BLOCKING_MODE(p_cb))
+    {
+        if (flags & NRF_DRV_TWI_FLAGS_NO_XFER_EVT_HANDLER)
+        {
+            p_cb->int_mask = NRF_TWIM_INT_ERROR_MASK;
+        }
+        nrf_twim_int_enable(p_twim, p_cb->int_mask);
+    }
+    else
+    {
+        twim_wait_for_event(p_twim, evt_to_wait, p_cb->int_mask);
+
+        uint32_t errorsrc =  nrf_twim_errorsrc_get_and_clear(p_twim);
+
+        p_cb->busy = false;
+
+        if (errorsrc)
+        {
+            ret = NRF_ERROR_INTERNAL;
+        }
+#if (TWI_RECOVERY_ENABLED == 1)
+        if (twim_recovery(p_cb, p_twim, errorsrc))
+        {
+            twi_recovery_backoff(p_cb);
+            return twim_xfer(p_cb, p_twim, p_xfer_desc, flags | TWI_FLAG_RETRY);
+        }
+#endif
+#if (TWI_TRACE_ENABLED == 1)
+        nrf_drv_twi_trace_t trace;
+        twi_trace_end(p_cb, &trace, twim_trace_bytes(p_cb, p_twim), errorsrc);
+        twi_trace_commit(&trace);
+#endif
+    }
+    return ret;
+}
+#endif
+
+#if (TWI_QUEUE_ENABLED == 1)
+/**
+ * @brief Report a queued transfer that could not be started.
+ *
+ * nrf_drv_twi_xfer_queue rejects the descriptors and flags the start functions refuse, so this
+ * is not expected. The entry still gets its error event, so that a batch waiting for its last
+ * event is not left hanging.
+ */
+static void twi_queue_start_failed(twi_control_block_t * p_cb, twi_queue_entry_t const * p_entry)
+{
+    nrf_drv_twi_evt_t event;
+
+    event.type      = NRF_DRV_TWI_EVT_XFER_ERROR;
+    event.xfer_desc = p_entry->xfer_desc;
+    p_cb->handler(&event, p_cb->p_context);
+}
+
+/**
+ * @brief Function for starting the next queued transfer.
+ *
+ * Must be called with the TWI interrupt blocked or from the TWI interrupt handler. Starts at
+ * most one transfer, which sets the instance busy until the interrupt handler is called again.
+ * An entry that cannot be started is reported and the next one is tried.
+ */
+#ifdef TWIM_IN_USE
+static void twim_queue_kick(twi_control_block_t * p_cb, NRF_TWIM_Type * p_twim)
+{
+    while (!p_cb->busy && (p_cb->queue_tail != p_cb->queue_head))
+    {
+        // Copy the entry before releasing the slot to the producer.
+        twi_queue_entry_t entry = p_cb->queue[p_cb->queue_tail & TWI_QUEUE_MASK];
+        p_cb->queue_tail++;
+#if (TWI_TRACE_ENABLED == 1)
+        p_cb->trace.submit = entry.submit;
+#endif
+        if (twim_xfer(p_cb, p_twim, &entry.xfer_desc, entry.flags) != NRF_SUCCESS)
+        {
+            twi_queue_start_failed(p_cb, &entry);
+        }
+    }
+}
+#endif
+
+#ifdef TWI_IN_USE
+static void twi_queue_kick(twi_control_block_t * p_cb, NRF_TWI_Type * p_twi)
+{
+    while (!p_cb->busy && (p_cb->queue_tail != p_cb->queue_head))
+    {
+        // Copy the entry before releasing the slot to the producer.
+        twi_queue_entry_t entry = p_cb->queue[p_cb->queue_tail & TWI_QUEUE_MASK];
+        p_cb->queue_tail++;
+#if (TWI_TRACE_ENABLED == 1)
+        p_cb->trace.submit = entry.submit;
+#endif
+        if (twi_xfer(p_cb, p_twi, &entry.xfer_desc, entry.flags) != NRF_SUCCESS)
+        {
+            twi_queue_start_failed(p_cb, &entry);
+        }
+    }
+}
+#endif
+
+ret_code_t nrf_drv_twi_xfer_queue(nrf_drv_twi_t const *           p_instance,
+                                  nrf_drv_twi_xfer_desc_t const * p_xfer_descs,
+                                  uint8_t                         count,
+                                  uint32_t                        flags)
+{
+    twi_control_block_t * p_cb = &m_cb[p_instance->drv_inst_idx];
+    uint8_t               head;
+    uint8_t               i;
+    bool                  full;
+
+    // Queued transfers are chained from the interrupt handler.
+    ASSERT(p_cb->handler);
+
+    if (flags & (NRF_DRV_TWI_FLAGS_HOLD_XFER     | NRF_DRV_TWI_FLAGS_REPEATED_XFER |
+                 NRF_DRV_TWI_FLAGS_TX_POSTINC    | NRF_DRV_TWI_FLAGS_RX_POSTINC))
+    {
+        return NRF_ERROR_NOT_SUPPORTED;
+    }
+
+    for (i = 0; i < count; i++)
+    {
+        nrf_drv_twi_xfer_desc_t const * p_desc = &p_xfer_descs[i];
+
+        if (p_desc->type > NRF_DRV_TWI_XFER_TXTX)
+        {
+            return NRF_ERROR_INVALID_PARAM;
+        }
+        if ((flags & NRF_DRV_TWI_FLAGS_TX_NO_STOP) && (p_desc->type != NRF_DRV_TWI_XFER_TX))
+        {
+            return NRF_ERROR_NOT_SUPPORTED;
+        }
+        CODE_FOR_TWIM
+        (
+            if (!nrf_drv_is_in_RAM(p_desc->p_primary_buf) ||
+                (((p_desc->type == NRF_DRV_TWI_XFER_TXRX) || (p_desc->type == NRF_DRV_TWI_XFER_TXTX)) &&
+                 !nrf_drv_is_in_RAM(p_desc->p_secondary_buf)))
+            {
+                return NRF_ERROR_INVALID_ADDR;
+            }
+        )
+    }
+
+    /* The event handler may queue transfers too, so the free space is checked, the entries are
+       filled and the head is moved in one go. */
+    CRITICAL_REGION_ENTER();
+    head = p_cb->queue_head;
+    full = (uint8_t)(TWI_QUEUE_SIZE - (uint8_t)(head - p_cb->queue_tail)) < count;
+    if (!full)
+    {
+        for (i = 0; i < count; i++)
+        {
+            twi_queue_entry_t * p_entry = &p_cb->queue[(uint8_t)(head + i) & TWI_QUEUE_MASK];
+
+            p_entry->xfer_desc = p_xfer_descs[i];
+            p_entry->flags     = flags & NRF_DRV_TWI_FLAGS_TX_NO_STOP;
+#if (TWI_TRACE_ENABLED == 1)
+            p_entry->flags    |= TWI_FLAG_QUEUED;
+            p_entry->submit    = TWI_TRACE_TIMESTAMP();
+#endif
+            if ((flags & NRF_DRV_TWI_FLAGS_NO_XFER_EVT_HANDLER) ||
+                ((flags & NRF_DRV_TWI_FLAGS_BATCH_EVT) && (i != count - 1)))
+            {
+                p_entry->flags |= TWI_FLAG_QUEUE_SILENT;
+            }
+        }
+        p_cb->queue_head = (uint8_t)(head + count);
+    }
+    CRITICAL_REGION_EXIT();
+
+    if (full)
+    {
+        return NRF_ERROR_NO_MEM;
+    }
+
+    /* Block TWI interrupts to ensure that function is not interrupted by TWI interrupt. */
+    CODE_FOR_TWIM
+    (
+        NRF_TWIM_Type * p_twim = p_instance->reg.p_twim;
+        nrf_twim_int_disable(p_twim, DISABLE_ALL);
+        if (!p_cb->busy && (p_cb->queue_tail != p_cb->queue_head))
+        {
+            twim_queue_kick(p_cb, p_twim);
+        }
+        else
+        {
+            nrf_twim_int_enable(p_twim, p_cb->int_mask);
+        }
+    )
+    CODE_FOR_TWI
+    (
+        NRF_TWI_Type * p_twi = p_instance->reg.p_twi;
+        nrf_twi_int_disable(p_twi, DISABLE_ALL);
+        if (!p_cb->busy && (p_cb->queue_tail != p_cb->queue_head))
+        {
+            twi_queue_kick(p_cb, p_twi);
+        }
+        else
+        {
+            nrf_twi_int_enable(p_twi, p_cb->int_mask);
+        }
+    )
+    return NRF_SUCCESS;
+}
+#endif // (TWI_QUEUE_ENABLED == 1)
+
+ret_code_t nrf_drv_twi_xfer(nrf_drv_twi_t const *     p_instance,
+                            nrf_drv_twi_xfer_desc_t * p_xfer_desc,
+                            uint32_t                  flags)
+{
+    ret_code_t ret = NRF_SUCCESS;
+
+
+    twi_control_block_t * p_cb = &m_cb[p_instance->drv_inst_idx];
+
+    // TXRX and TXTX transfers are support only in non-blocking mode.
+    ASSERT( !((p_cb->handler == NULL) && (p_xfer_desc->type == NRF_DRV_TWI_XFER_TXRX)));
+    ASSERT( !((p_cb->handler == NULL) && (p_xfer_desc->type == NRF_DRV_TWI_XFER_TXTX)));
+
+    CODE_FOR_TWIM
+    (
+        ret = twim_xfer(p_cb, (NRF_TWIM_Type *)p_instance->reg.p_twim, p_xfer_desc, flags);
+    )
+    CODE_FOR_TWI
+    (
+        ret = twi_xfer(p_cb, (NRF_TWI_Type  *)p_instance->reg.p_twi, p_xfer_desc, flags);
+    )
+    return ret;
+}
+
+ret_code_t nrf_drv_twi_tx(nrf_drv_twi_t const * p_instance,
+                          uint8_t               address,
+                          uint8_t const *       p_data,
+                          uint8_t               length,
+                          bool                  no_stop)
+{
+    nrf_drv_twi_xfer_desc_t xfer = NRF_DRV_TWI_XFER_DESC_TX(address, (uint8_t*)p_data, length);
+
+    return nrf_drv_twi_xfer(p_instance, &xfer, no_stop ? NRF_DRV_TWI_FLAGS_TX_NO_STOP : 0);
+}
+
+ret_code_t nrf_drv_twi_rx(nrf_drv_twi_t const * p_instance,
+                          uint8_t               address,
+                          uint8_t *             p_data,
+                          uint8_t               length)
+{
+    nrf_drv_twi_xfer_desc_t xfer = NRF_DRV_TWI_XFER_DESC_RX(address, p_data, length);
+    return nrf_drv_twi_xfer(p_instance, &xfer, 0);
+}
+
+#ifdef TWI_DOUBLE_BUFFER_IN_USE
+ret_code_t nrf_drv_twi_rx_double_buffer_xfer(nrf_drv_twi_t const *     p_instance,
+                                             nrf_drv_twi_xfer_desc_t * p_xfer_desc,
+                                             uint8_t                   xfers_per_half,
+                                             uint32_t                  flags)
+{
+    twi_control_block_t * p_cb = &m_cb[p_instance->drv_inst_idx];
+    ret_code_t            ret;
+
+    if ((xfers_per_half == 0) ||
+        ((p_xfer_desc->type != NRF_DRV_TWI_XFER_TXRX) && (p_xfer_desc->type != NRF_DRV_TWI_XFER_RX)))
+    {
+        return NRF_ERROR_NOT_SUPPORTED;
+    }
+
+    CODE_FOR_TWIM
+    (
+        p_cb->rx_half_size = 0;
+        ret = nrf_drv_twi_xfer(p_instance, p_xfer_desc,
+                               flags | NRF_DRV_TWI_FLAGS_REPEATED_XFER | NRF_DRV_TWI_FLAGS_RX_POSTINC);
+        if (ret == NRF_SUCCESS)
+        {
+            if (p_xfer_desc->type == NRF_DRV_TWI_XFER_TXRX)
+            {
+                p_cb->p_rx_base    = p_xfer_desc->p_secondary_buf;
+                p_cb->rx_half_size = (uint16_t)xfers_per_half * p_xfer_desc->secondary_length;
+            }
+            else
+            {
+                p_cb->p_rx_base    = p_xfer_desc->p_primary_buf;
+                p_cb->rx_half_size = (uint16_t)xfers_per_half * p_xfer_desc->primary_length;
+            }
+        }
+        return ret;
+    )
+    CODE_FOR_TWI
+    (
+        (void)p_cb;
+        (void)ret;
+        return NRF_ERROR_NOT_SUPPORTED;
+    )
+}
+
+uint8_t * nrf_drv_twi_rx_half_get(nrf_drv_twi_t const * p_instance)
+{
+    twi_control_block_t * p_cb = &m_cb[p_instance->drv_inst_idx];
+
+    ASSERT(p_cb->rx_half_size != 0);
+
+    CODE_FOR_TWIM
+    (
+        NRF_TWIM_Type * p_twim   = p_instance->reg.p_twim;
+        uint8_t *       p_next   = nrf_twim_rx_buffer_get(p_twim);
+        uint8_t *       p_second = p_cb->p_rx_base + p_cb->rx_half_size;
+
+        if (p_next >= p_second + p_cb->rx_half_size)
+        {
+            // Second half complete, next transfer goes to the first half again.
+            nrf_twim_rx_buffer_set(p_twim, p_cb->p_rx_base,
+                ((p_cb->xfer_desc.type == NRF_DRV_TWI_XFER_TXRX) ?
+                    p_cb->xfer_desc.secondary_length : p_cb->xfer_desc.primary_length));
+            return p_second;
+        }
+        else if (p_next >= p_second)
+        {
+            return p_cb->p_rx_base;
+        }
+        return NULL;
+    )
+    CODE_FOR_TWI
+    (
+        return NULL;
+    )
+}
+
+void nrf_drv_twi_rx_half_size_set(nrf_drv_twi_t const * p_instance, uint8_t xfers_per_half)
+{
+    twi_control_block_t * p_cb = &m_cb[p_instance->drv_inst_idx];
+
+    ASSERT((p_cb->rx_half_size != 0) && (xfers_per_half != 0));
+
+    p_cb->rx_half_size = (uint16_t)xfers_per_half *
+        ((p_cb->xfer_desc.type == NRF_DRV_TWI_XFER_TXRX) ?
+            p_cb->xfer_desc.secondary_length : p_cb->xfer_desc.primary_length);
+}
+#endif // TWI_DOUBLE_BUFFER_IN_USE
+
+#if (TWI_SCAN_ENABLED == 1)
+ret_code_t nrf_drv_twi_scan_setup(nrf_drv_twi_t const *            p_instance,
+                                  nrf_drv_twi_scan_entry_t const * p_table,
+                                  uint8_t                          entries,
+                                  uint8_t *                        p_rx_buf,
+                                  uint8_t                          cycles)
+{
+    twi_control_block_t * p_cb = &m_cb[p_instance->drv_inst_idx];
+
+    // Table cycles are chained from the interrupt handler.
+    ASSERT(p_cb->handler);
+
+    if ((entries == 0) || (entries > TWI_SCAN_TABLE_SIZE) || (cycles == 0))
+    {
+        return NRF_ERROR_NOT_SUPPORTED;
+    }
+
+    CODE_FOR_TWIM
+    (
+        NRF_TWIM_Type * p_twim = p_instance->reg.p_twim;
+        twi_scan_t    * p_scan = &p_cb->scan;
+
+        if (!nrf_drv_is_in_RAM(p_rx_buf))
+        {
+            return NRF_ERROR_INVALID_ADDR;
+        }
+
+        /* Block TWI interrupts to ensure that function is not interrupted by TWI interrupt. */
+        nrf_twim_int_disable(p_twim, DISABLE_ALL);
+        if (p_cb->busy)
+        {
+            nrf_twim_int_enable(p_twim, p_cb->int_mask);
+            return NRF_ERROR_BUSY;
+        }
+        p_cb->busy     = true;
+#if (TWI_REPEATED_ENABLED == 1)
+        p_cb->repeated = false;
+#endif
+        p_cb->flags    = 0;
+
+        for (uint8_t i = 0; i < entries; i++)
+        {
+            p_scan->regs[i] = p_table[i].reg;
+        }
+        p_scan->p_table  = p_table;
+        p_scan->p_rx_buf = p_rx_buf;
+        p_scan->offset   = 0;
+        p_scan->entries  = entries;
+        p_scan->entry    = 0;
+        p_scan->cycles   = cycles;
+        p_scan->cycle    = 0;
+
+        // One register byte per entry is taken from the TX list, the RX list is filled record by record.
+        nrf_twim_address_set(p_twim, p_table[0].address);
+        nrf_twim_tx_list_enable(p_twim);
+        nrf_twim_rx_list_enable(p_twim);
+        nrf_twim_tx_buffer_set(p_twim, p_scan->regs, 1);
+        nrf_twim_rx_buffer_set(p_twim, p_rx_buf, p_table[0].length);
+        nrf_twim_shorts_set(p_twim, NRF_TWIM_SHORT_LASTTX_STARTRX_MASK |
+                                    NRF_TWIM_SHORT_LASTRX_STOP_MASK);
+
+        nrf_twim_event_clear(p_twim, NRF_TWIM_EVENT_STOPPED);
+        nrf_twim_event_clear(p_twim, NRF_TWIM_EVENT_ERROR);
+        (void)nrf_twim_errorsrc_get_and_clear(p_twim);
+        nrf_twim_task_trigger(p_twim, NRF_TWIM_TASK_RESUME);
+
+        p_cb->int_mask = NRF_TWIM_INT_STOPPED_MASK | NRF_TWIM_INT_ERROR_MASK;
+        nrf_twim_int_enable(p_twim, p_cb->int_mask);
+        return NRF_SUCCESS;
+    )
+    CODE_FOR_TWI
+    (
+        return NRF_ERROR_NOT_SUPPORTED;
+    )
+}
+
+void nrf_drv_twi_scan_stop(nrf_drv_twi_t const * p_instance)
+{
+    twi_control_block_t * p_cb = &m_cb[p_instance->drv_inst_idx];
+
+    CODE_FOR_TWIM
+    (
+        NRF_TWIM_Type * p_twim = p_instance->reg.p_twim;
+
+        p_cb->int_mask = 0;
+        nrf_twim_int_disable(p_twim, DISABLE_ALL);
+        nrf_twim_shorts_set(p_twim, 0);
+        nrf_twim_tx_list_disable(p_twim);
+        nrf_twim_rx_list_disable(p_twim);
+        p_cb->scan.p_table = NULL;
+        p_cb->busy         = false;
+    )
+    CODE_FOR_TWI
+    (
+        (void)p_cb;
+    )
+}
+#endif // (TWI_SCAN_ENABLED == 1)
+
+uint32_t nrf_drv_twi_data_count_get(nrf_drv_twi_t const * const p_instance)
+{
+    CODE_FOR_TWIM
+    (
+        ASSERT(false);
+        return 0;
+    )
+    CODE_FOR_TWI
+    (
+        return m_cb[p_instance->drv_inst_idx].bytes_transferred;
+    )
+}
+uint32_t nrf_drv_twi_start_task_get(nrf_drv_twi_t const * p_instance, nrf_drv_twi_xfer_type_t xfer_type)
+{
+    CODE_FOR_TWIM
+    (
+        return (uint32_t)nrf_twim_task_address_get(p_instance->reg.p_twim,
+            (xfer_type != NRF_DRV_TWI_XFER_RX) ? NRF_TWIM_TASK_STARTTX : NRF_TWIM_TASK_STARTRX);
+    )
+    CODE_FOR_TWI
+    (
+        return (uint32_t)nrf_twi_task_address_get(p_instance->reg.p_twi,
+                (xfer_type != NRF_DRV_TWI_XFER_RX) ? NRF_TWI_TASK_STARTTX : NRF_TWI_TASK_STARTRX);
+    )
+}
+
+uint32_t nrf_drv_twi_stopped_event_get(nrf_drv_twi_t const * p_instance)
+{
+    CODE_FOR_TWIM
+    (
+        return (uint32_t)nrf_twim_event_address_get(p_instance->reg.p_twim, NRF_TWIM_EVENT_STOPPED);
+    )
+    CODE_FOR_TWI
+    (
+        return (uint32_t)nrf_twi_event_address_get(p_instance->reg.p_twi, NRF_TWI_EVENT_STOPPED);
+    )
+}
+
+#if (TWI_RECOVERY_ENABLED == 1)
+ret_code_t nrf_drv_twi_bus_recover(nrf_drv_twi_t const * p_instance)
+{
+    twi_control_block_t * p_cb = &m_cb[p_instance->drv_inst_idx];
+    ret_code_t            ret  = NRF_SUCCESS;
+
+    ASSERT(p_cb->state != NRF_DRV_STATE_UNINITIALIZED);
+
+    /* Block TWI interrupts to ensure that function is not interrupted by TWI interrupt. */
+    CODE_FOR_TWIM
+    (
+        NRF_TWIM_Type * p_twim = p_instance->reg.p_twim;
+        nrf_twim_int_disable(p_twim, DISABLE_ALL);
+        if (p_cb->busy)
+        {
+            ret = NRF_ERROR_BUSY;
+        }
+        else
+        {
+            twim_bus_clear(p_cb, p_twim);
+        }
+        nrf_twim_int_enable(p_twim, p_cb->int_mask);
+    )
+    CODE_FOR_TWI
+    (
+        NRF_TWI_Type * p_twi = p_instance->reg.p_twi;
+        nrf_twi_int_disable(p_twi, DISABLE_ALL);
+        if (p_cb->busy)
+        {
+            ret = NRF_ERROR_BUSY;
+        }
+        else
+        {
+            twi_bus_clear(p_cb, p_twi);
+        }
+        nrf_twi_int_enable(p_twi, p_cb->int_mask);
+    )
+    return ret;
+}
+
+void nrf_drv_twi_error_stats_get(nrf_drv_twi_t const *       p_instance,
+                                 nrf_drv_twi_error_stats_t * p_stats)
+{
+    CRITICAL_REGION_ENTER();
+    *p_stats = m_cb[p_instance->drv_inst_idx].stats;
+    CRITICAL_REGION_EXIT();
+}
+
+void nrf_drv_twi_error_stats_clear(nrf_drv_twi_t const * p_instance)
+{
+    CRITICAL_REGION_ENTER();
+    m_cb[p_instance->drv_inst_idx].stats = (nrf_drv_twi_error_stats_t){0};
+    CRITICAL_REGION_EXIT();
+}
+#endif // (TWI_RECOVERY_ENABLED == 1)
+
+#if (TWI_TRACE_ENABLED == 1)
+ret_code_t nrf_drv_twi_trace_read(uint32_t * p_cursor, nrf_drv_twi_trace_t * p_record)
+{
+    ret_code_t ret = NRF_SUCCESS;
+
+    CRITICAL_REGION_ENTER();
+    uint32_t head = nrf_drv_twi_trace.head;
+    if ((head - *p_cursor) > TWI_TRACE_SIZE)
+    {
+        *p_cursor = head - TWI_TRACE_SIZE;
+    }
+    if (*p_cursor == head)
+    {
+        ret = NRF_ERROR_NOT_FOUND;
+    }
+    else
+    {
+        *p_record = nrf_drv_twi_trace.records[*p_cursor & (TWI_TRACE_SIZE - 1)];
+        (*p_cursor)++;
+    }
+    CRITICAL_REGION_EXIT();
+    return ret;
+}
+#endif // (TWI_TRACE_ENABLED == 1)
+
+#ifdef TWIM_IN_USE
+#if (TWI_SCAN_ENABLED == 1)
+static void irq_handler_twim_scan(NRF_TWIM_Type * p_twim, twi_control_block_t * p_cb)
+{
+    twi_scan_t *                     p_scan  = &p_cb->scan;
+    nrf_drv_twi_scan_entry_t const * p_entry = &p_scan->p_table[p_scan->entry];
+    nrf_drv_twi_evt_t                event;
+    uint32_t                         errorsrc;
+    bool                             done = false;
+
+    if (nrf_twim_event_check(p_twim, NRF_TWIM_EVENT_ERROR))
+    {
+        nrf_twim_event_clear(p_twim, NRF_TWIM_EVENT_ERROR);
+        if (!nrf_twim_event_check(p_twim, NRF_TWIM_EVENT_STOPPED))
+        {
+            nrf_twim_task_trigger(p_twim, NRF_TWIM_TASK_RESUME);
+            nrf_twim_task_trigger(p_twim, NRF_TWIM_TASK_STOP);
+            return;
+        }
+    }
+    if (!nrf_twim_event_check(p_twim, NRF_TWIM_EVENT_STOPPED))
+    {
+        return;
+    }
+    nrf_twim_event_clear(p_twim, NRF_TWIM_EVENT_STOPPED);
+    nrf_twim_event_clear(p_twim, NRF_TWIM_EVENT_LASTTX);
+    nrf_twim_event_clear(p_twim, NRF_TWIM_EVENT_LASTRX);
+
+    errorsrc = nrf_twim_errorsrc_get_and_clear(p_twim);
+    if (errorsrc)
+    {
+#if (TWI_RECOVERY_ENABLED == 1)
+        twi_error_count(p_cb, errorsrc);
+#endif
+        event.type = (errorsrc & NRF_TWIM_ERROR_ADDRESS_NACK) ?
+            NRF_DRV_TWI_EVT_ADDRESS_NACK : NRF_DRV_TWI_EVT_DATA_NACK;
+        event.xfer_desc.type             = NRF_DRV_TWI_XFER_TXRX;
+        event.xfer_desc.address          = p_entry->address;
+        event.xfer_desc.primary_length   = 1;
+        event.xfer_desc.secondary_length = p_entry->length;
+        event.xfer_desc.p_primary_buf    = &p_scan->regs[p_scan->entry];
+        event.xfer_desc.p_secondary_buf  = &p_scan->p_rx_buf[p_scan->offset];
+    }
+    p_scan->offset += p_entry->length;
+
+    if (++p_scan->entry < p_scan->entries)
+    {
+        // Next entry of the same cycle is started right away.
+        p_entry++;
+        nrf_twim_address_set(p_twim, p_entry->address);
+        if (errorsrc)
+        {
+            // An aborted transfer does not post-increment the lists reliably, put them in place.
+            nrf_twim_tx_buffer_set(p_twim, &p_scan->regs[p_scan->entry], 1);
+            nrf_twim_rx_buffer_set(p_twim, &p_scan->p_rx_buf[p_scan->offset], p_entry->length);
+        }
+        else
+        {
+            nrf_twim_rx_length_set(p_twim, p_entry->length);
+        }
+        nrf_twim_task_trigger(p_twim, NRF_TWIM_TASK_STARTTX);
+    }
+    else
+    {
+        // Cycle finished, rewind the table and wait for the next external trigger.
+        p_scan->entry = 0;
+        if (++p_scan->cycle == p_scan->cycles)
+        {
+            p_scan->cycle  = 0;
+            p_scan->offset = 0;
+            done           = true;
+        }
+        p_entry = &p_scan->p_table[0];
+        nrf_twim_address_set(p_twim, p_entry->address);
+        nrf_twim_tx_buffer_set(p_twim, p_scan->regs, 1);
+        nrf_twim_rx_buffer_set(p_twim, &p_scan->p_rx_buf[p_scan->offset], p_entry->length);
+    }
+
+    if (errorsrc)
+    {
+        p_cb->handler(&event, p_cb->p_context);
+    }
+    if (done)
+    {
+        event.type                       = NRF_DRV_TWI_EVT_SCAN_DONE;
+        event.xfer_desc.type             = NRF_DRV_TWI_XFER_TXRX;
+        event.xfer_desc.address          = 0;
+        event.xfer_desc.primary_length   = p_scan->entries;
+        event.xfer_desc.secondary_length = 0;
+        event.xfer_desc.p_primary_buf    = p_scan->regs;
+        event.xfer_desc.p_secondary_buf  = p_scan->p_rx_buf;
+        for (uint8_t i = 0; i < p_scan->entries; i++)
+        {
+            event.xfer_desc.secondary_length += p_scan->p_table[i].length;
+        }
+        p_cb->handler(&event, p_cb->p_context);
+    }
+}
+#endif // (TWI_SCAN_ENABLED == 1)
+
+static void irq_handler_twim(NRF_TWIM_Type * p_twim, twi_control_block_t * p_cb)
+{
+    ASSERT(p_cb->handler);
+
+#if (TWI_SCAN_ENABLED == 1)
+    if (p_cb->scan.p_table != NULL)
+    {
+        irq_handler_twim_scan(p_twim, p_cb);
+        return;
+    }
+#endif
+
+    if (nrf_twim_event_check(p_twim, NRF_TWIM_EVENT_ERROR))
+    {
+        nrf_twim_event_clear(p_twim, NRF_TWIM_EVENT_ERROR);
+        if (!nrf_twim_event_check(p_twim, NRF_TWIM_EVENT_STOPPED))
+        {
+            nrf_twim_int_disable(p_twim, p_cb->int_mask);
+            p_cb->int_mask = NRF_TWIM_INT_STOPPED_MASK;
+            nrf_twim_int_enable(p_twim, p_cb->int_mask);
+
+            nrf_twim_task_trigger(p_twim, NRF_TWIM_TASK_RESUME);
+            nrf_twim_task_trigger(p_twim, NRF_TWIM_TASK_STOP);
+            return;
+        }
+    }
+
+    nrf_drv_twi_evt_t event;
+
+    if (nrf_twim_event_check(p_twim, NRF_TWIM_EVENT_STOPPED))
+    {
+        nrf_twim_event_clear(p_twim, NRF_TWIM_EVENT_STOPPED);
+        event.xfer_desc = p_cb->xfer_desc;
+        if (p_cb->error)
+        {
+
+            event.xfer_desc.primary_length = (p_cb->xfer_desc.type == NRF_DRV_TWI_XFER_RX) ?
+                (uint8_t)nrf_twim_rxd_amount_get(p_twim) : (uint8_t)nrf_twim_txd_amount_get(p_twim);
+            event.xfer_desc.secondary_length = (p_cb->xfer_desc.type == NRF_DRV_TWI_XFER_TXRX) ?
+                (uint8_t)nrf_twim_rxd_amount_get(p_twim) : (uint8_t)nrf_twim_txd_amount_get(p_twim);
+
+        }
+        nrf_twim_event_clear(p_twim, NRF_TWIM_EVENT_LASTTX);
+        nrf_twim_event_clear(p_twim, NRF_TWIM_EVENT_LASTRX);
+        if (!XFER_REPEATED(p_cb) || p_cb->error)
+        {
+            nrf_twim_shorts_set(p_twim, 0);
+            p_cb->int_mask = 0;
+            nrf_twim_int_disable(p_twim, DISABLE_ALL);
+        }
+        else if (p_cb->xfer_desc.type == NRF_DRV_TWI_XFER_TXTX)
+        {
+            // Rearm the first buffer for the next external trigger.
+            nrf_twim_tx_buffer_set(p_twim, p_cb->xfer_desc.p_primary_buf, p_cb->xfer_desc.primary_length);
+            nrf_twim_shorts_set(p_twim, NRF_TWIM_SHORT_LASTTX_SUSPEND_MASK);
+            p_cb->int_mask = NRF_TWIM_INT_SUSPENDED_MASK | NRF_TWIM_INT_ERROR_MASK;
+            nrf_twim_int_disable(p_twim, DISABLE_ALL);
+            nrf_twim_int_enable(p_twim, p_cb->int_mask);
+        }
+    }
+    else
+    {
+        nrf_twim_event_clear(p_twim, NRF_TWIM_EVENT_SUSPENDED);
+        if (p_cb->xfer_desc.type == NRF_DRV_TWI_XFER_TX)
+        {
+            event.xfer_desc = p_cb->xfer_desc;
+            if (!XFER_REPEATED(p_cb))
+            {
+                nrf_twim_shorts_set(p_twim, 0);
+                p_cb->int_mask = 0;
+                nrf_twim_int_disable(p_twim, DISABLE_ALL);
+            }
+        }
+        else
+        {
+            // TXTX: the first buffer is out and the bus is held, send the second one.
+            nrf_twim_tx_buffer_set(p_twim, p_cb->xfer_desc.p_secondary_buf, p_cb->xfer_desc.secondary_length);
+            nrf_twim_shorts_set(p_twim, NRF_TWIM_SHORT_LASTTX_STOP_MASK);
+            p_cb->int_mask = NRF_TWIM_INT_STOPPED_MASK | NRF_TWIM_INT_ERROR_MASK;
+            nrf_twim_int_disable(p_twim, DISABLE_ALL);
+            nrf_twim_int_enable(p_twim, p_cb->int_mask);
+            nrf_twim_task_trigger(p_twim, NRF_TWIM_TASK_STARTTX);
+            nrf_twim_task_trigger(p_twim, NRF_TWIM_TASK_RESUME);
+            return;
+        }
+    }
+
+    uint32_t errorsrc = nrf_twim_errorsrc_get_and_clear(p_twim);
+    if (errorsrc & NRF_TWIM_ERROR_ADDRESS_NACK)
+    {
+        event.type = NRF_DRV_TWI_EVT_ADDRESS_NACK;
+    }
+    else if (errorsrc & NRF_TWIM_ERROR_DATA_NACK)
+    {
+        event.type = NRF_DRV_TWI_EVT_DATA_NACK;
+    }
+    else
+    {
+        event.type = NRF_DRV_TWI_EVT_DONE;
+    }
+
+#if (TWI_RECOVERY_ENABLED == 1)
+    if (twim_recovery(p_cb, p_twim, errorsrc))
+    {
+        // Restarted right away, the time to stop the bus is the only back-off in interrupt context.
+        nrf_drv_twi_xfer_desc_t xfer_desc = p_cb->xfer_desc;
+
+        p_cb->busy = false;
+        if (twim_xfer(p_cb, p_twim, &xfer_desc, p_cb->flags | TWI_FLAG_RETRY) == NRF_SUCCESS)
+        {
+            return;
+        }
+    }
+#endif
+#if (TWI_TRACE_ENABLED == 1)
+    nrf_drv_twi_trace_t trace;
+    bool                traced = !XFER_REPEATED(p_cb);
+    if (traced)
+    {
+        twi_trace_end(p_cb, &trace, twim_trace_bytes(p_cb, p_twim), errorsrc);
+    }
+#endif
+
+    bool notify = !(p_cb->flags & TWI_FLAG_QUEUE_SILENT) || (event.type != NRF_DRV_TWI_EVT_DONE);
+
+    if (!XFER_REPEATED(p_cb))
+    {
+        p_cb->busy = false;
+#if (TWI_QUEUE_ENABLED == 1)
+        // Start the next transfer before calling the handler to keep the bus busy.
+        twim_queue_kick(p_cb, p_twim);
+#endif
+    }
+    if (notify)
+    {
+        p_cb->handler(&event, p_cb->p_context);
+    }
+#if (TWI_TRACE_ENABLED == 1)
+    if (traced)
+    {
+        twi_trace_commit(&trace);
+    }
+#endif
+}
+#endif // TWIM_IN_USE
+
+#ifdef TWI_IN_USE
+static void irq_handler_twi(NRF_TWI_Type * p_twi, twi_control_block_t * p_cb)
+{
+    ASSERT(p_cb->handler);
+
+    if (twi_transfer(p_twi, (bool *)&p_cb->error, &p_cb->bytes_transferred, p_cb->p_curr_buf, p_cb->curr_length, p_cb->curr_no_stop ))
+    {
+        if ((p_cb->bytes_transferred + 1 == p_cb->curr_length) && !p_cb->error &&
+            ((p_cb->xfer_desc.type == NRF_DRV_TWI_XFER_RX) ||
+             ((p_cb->xfer_desc.type == NRF_DRV_TWI_XFER_TXRX) &&
+              (p_cb->p_curr_buf == p_cb->xfer_desc.p_secondary_buf))))
+        {
+            // The last byte comes with the BB->STOP short, it is read at STOPPED without an
+            // interrupt of its own.
+            p_cb->int_mask &= ~NRF_TWI_INT_RXDREADY_MASK;
+            nrf_twi_int_disable(p_twi, NRF_TWI_INT_RXDREADY_MASK);
+        }
+        return;
+    }
+
+    if (((p_cb->xfer_desc.type == NRF_DRV_TWI_XFER_TXRX) ||
+        (p_cb->xfer_desc.type == NRF_DRV_TWI_XFER_TXTX)) &&
+         p_cb->p_curr_buf == p_cb->xfer_desc.p_primary_buf)
+    {
+        p_cb->p_curr_buf   = p_cb->xfer_desc.p_secondary_buf;
+        p_cb->curr_length  = p_cb->xfer_desc.secondary_length;
+        p_cb->curr_no_stop = (p_cb->flags & NRF_DRV_TWI_FLAGS_TX_NO_STOP);
+
+        if (p_cb->xfer_desc.type == NRF_DRV_TWI_XFER_TXTX)
+        {
+            (void)twi_tx_start_transfer(p_cb, p_twi, p_cb->p_curr_buf, p_cb->curr_length, p_cb->curr_no_stop);
+        }
+        else
+        {
+            (void)twi_rx_start_transfer(p_cb, p_twi, p_cb->p_curr_buf, p_cb->curr_length);
+        }
+    }
+    else
+    {
+        nrf_drv_twi_evt_t event;
+        uint32_t          errorsrc = 0;
+        event.xfer_desc = p_cb->xfer_desc;
+
+        if (p_cb->error)
+        {
+            errorsrc = nrf_twi_errorsrc_get_and_clear(p_twi);
+            if (errorsrc & NRF_TWI_ERROR_ADDRESS_NACK)
+            {
+                event.type = NRF_DRV_TWI_EVT_ADDRESS_NACK;
+            }
+            else if (errorsrc & NRF_TWI_ERROR_DATA_NACK)
+            {
+                event.type = NRF_DRV_TWI_EVT_DATA_NACK;
+            }
+        }
+        else
+        {
+            event.type = NRF_DRV_TWI_EVT_DONE;
+        }
+
+#if (TWI_RECOVERY_ENABLED == 1)
+        if (twi_recovery(p_cb, p_twi, errorsrc))
+        {
+            nrf_drv_twi_xfer_desc_t xfer_desc = p_cb->xfer_desc;
+
+            p_cb->busy = false;
+            if (twi_xfer(p_cb, p_twi, &xfer_desc, p_cb->flags | TWI_FLAG_RETRY) == NRF_SUCCESS)
+            {
+                return;
+            }
+        }
+#endif
+#if (TWI_TRACE_ENABLED == 1)
+        nrf_drv_twi_trace_t trace;
+        twi_trace_end(p_cb, &trace, twi_trace_bytes(p_cb), errorsrc);
+#endif
+
+        bool notify = !(p_cb->flags & (NRF_DRV_TWI_FLAGS_NO_XFER_EVT_HANDLER | TWI_FLAG_QUEUE_SILENT)) ||
+                      p_cb->error;
+
+        p_cb->busy = false;
+#if (TWI_QUEUE_ENABLED == 1)
+        // Start the next transfer before calling the handler to keep the bus busy.
+        twi_queue_kick(p_cb, p_twi);
+#endif
+
+        if (notify)
+        {
+            p_cb->handler(&event, p_cb->p_context);
+        }
+#if (TWI_TRACE_ENABLED == 1)
+        twi_trace_commit(&trace);
+#endif
+    }
+
+}
+#endif // TWI_IN_USE
+
+#if (TWI0_ENABLED == 1)
+void TWI0_IRQ_HANDLER(void)
+{
+    #if (TWI0_USE_EASY_DMA == 1) && defined(NRF52)
+        irq_handler_twim(NRF_TWIM0,
+    #else
+        irq_handler_twi(NRF_TWI0,
+    #endif
+            &m_cb[TWI0_INSTANCE_INDEX]);
+}
+#endif // (TWI0_ENABLED == 1)
+
+#if (TWI1_ENABLED == 1)
+void TWI1_IRQ_HANDLER(void)
+{
+    #if (TWI1_USE_EASY_DMA == 1)
+        irq_handler_twim(NRF_TWIM1,
+    #else
+        irq_handler_twi(NRF_TWI1,
+    #endif
+            &m_cb[TWI1_INSTANCE_INDEX]);
+}
+#endif // (SPI1_ENABLED == 1)
@@ -44,6 +44,38 @@
     #define TWI_IN_USE
 #endif
 
+// Optional driver features, selected in nrf_drv_config.h. Features left undefined are
+// enabled, except the transfer trace. A disabled feature is compiled out together with
+// its API functions.
+#ifndef TWI_BLOCKING_ENABLED
+    #define TWI_BLOCKING_ENABLED 1  // Blocking mode, used when no event handler is given.
+#endif
+#ifndef TWI_LIST_ENABLED
+    #define TWI_LIST_ENABLED     1  // TX/RX list post-increment (TWIM).
+#endif
+#ifndef TWI_REPEATED_ENABLED
+    #define TWI_REPEATED_ENABLED 1  // Repeated and held transfers triggered over PPI (TWIM).
+#endif
+#ifndef TWI_QUEUE_ENABLED
+    #define TWI_QUEUE_ENABLED    1  // Transfer queue, nrf_drv_twi_xfer_queue.
+#endif
+#ifndef TWI_SCAN_ENABLED
+    #define TWI_SCAN_ENABLED     1  // Multi-slave scan tables (TWIM).
+#endif
+#ifndef TWI_RECOVERY_ENABLED
+    #define TWI_RECOVERY_ENABLED 1  // Retries, bus clear and error counters.
+#endif
+#ifndef TWI_TRACE_ENABLED
+    #define TWI_TRACE_ENABLED    0  // Per-transfer timestamps in a trace ring.
+#endif
+
+#if (TWI_SCAN_ENABLED == 1) && (TWI_LIST_ENABLED != 1)
+    #error "TWI_SCAN_ENABLED requires TWI_LIST_ENABLED."
+#endif
+#if (TWI_LIST_ENABLED == 1) && (TWI_REPEATED_ENABLED == 1)
+    #define TWI_DOUBLE_BUFFER_IN_USE
+#endif
+
 #include "nrf_twi.h"
 #ifdef TWIM_IN_USE
     #include "nrf_twim.h"
@@ -130,6 +162,8 @@ typedef struct
 #define NRF_DRV_TWI_FLAGS_HOLD_XFER           (1UL << 3) /**< Setup but not start the transfer. */
 #define NRF_DRV_TWI_FLAGS_REPEATED_XFER       (1UL << 4) /**< Flag indicates that transfer will be executed multiple times. */
 #define NRF_DRV_TWI_FLAGS_TX_NO_STOP          (1UL << 5) /**< Flag indicates that TX transfer will not end with stop condition. */
+#define NRF_DRV_TWI_FLAGS_BATCH_EVT           (1UL << 6) /**< Only the last transfer of a queued batch calls the event handler. */
+#define NRF_DRV_TWI_FLAGS_NO_RETRY            (1UL << 7) /**< Transfer is not started again by the recovery engine after an error. */
 
 /**
  * @brief TWI master driver event types.
@@ -138,7 +172,9 @@ typedef enum
 {
     NRF_DRV_TWI_EVT_DONE,         ///< Transfer completed event.
     NRF_DRV_TWI_EVT_ADDRESS_NACK, ///< Error event - NACK received after sending the address.
-    NRF_DRV_TWI_EVT_DATA_NACK     ///< Error event - NACK received after sending a data byte.
+    NRF_DRV_TWI_EVT_DATA_NACK,    ///< Error event - NACK received after sending a data byte.
+    NRF_DRV_TWI_EVT_SCAN_DONE,    ///< Scan table completed the requested number of cycles.
+    NRF_DRV_TWI_EVT_XFER_ERROR    ///< Error event - queued transfer could not be started.
 } nrf_drv_twi_evt_type_t;
 
 /**
@@ -165,6 +201,81 @@ typedef struct
     uint8_t *               p_secondary_buf;  ///< Pointer to transferred data.
 } nrf_drv_twi_xfer_desc_t;
 
+#if (TWI_SCAN_ENABLED == 1)
+/**
+ * @brief Structure for a TWIM scan table entry.
+ *
+ * Each entry is read as a TXRX transfer: the register address is written and followed by
+ * a read of @ref length bytes with a repeated start.
+ */
+typedef struct
+{
+    uint8_t address; ///< Slave address.
+    uint8_t reg;     ///< Register address written before reading.
+    uint8_t length;  ///< Number of bytes read.
+} nrf_drv_twi_scan_entry_t;
+#endif
+
+#if (TWI_RECOVERY_ENABLED == 1)
+/**
+ * @brief Per-instance error counters kept by the recovery engine.
+ *
+ * Every failed attempt is counted by its cause, including attempts that are retried.
+ */
+typedef struct
+{
+    uint32_t address_nack; ///< Attempts ended by a NACK after the address.
+    uint32_t data_nack;    ///< Attempts ended by a NACK after a data byte.
+    uint32_t overrun;      ///< Attempts ended by a receive overrun.
+    uint32_t retries;      ///< Transfers started again after an error.
+    uint32_t failed;       ///< Transfers reported as failed after all retries.
+    uint32_t bus_clears;   ///< Bus clear sequences issued after init.
+} nrf_drv_twi_error_stats_t;
+#endif
+
+#if (TWI_TRACE_ENABLED == 1)
+/**
+ * @brief Structure for a transfer trace record.
+ *
+ * Timestamps are taken with TWI_TRACE_TIMESTAMP(), the CPU cycle counter unless the
+ * configuration provides another source. Queue time is @ref start - @ref submit, bus time
+ * @ref end - @ref start and handler time @ref done - @ref end.
+ */
+typedef struct
+{
+    uint32_t submit;   ///< Transfer handed to the driver, directly or through the queue.
+    uint32_t start;    ///< Transfer started on the bus (first attempt).
+    uint32_t end;      ///< End of the transfer handled by the driver.
+    uint32_t done;     ///< Event handler returned, or blocking call returning.
+    uint16_t bytes;    ///< Bytes moved on the bus by the last attempt.
+    uint8_t  address;  ///< Slave address.
+    uint8_t  type;     ///< Transfer type, @ref nrf_drv_twi_xfer_type_t.
+    uint8_t  instance; ///< Driver instance index.
+    uint8_t  attempts; ///< Attempts including retries.
+    uint8_t  errorsrc; ///< ERRORSRC of the last attempt, 0 on success.
+    uint8_t  reserved;
+} nrf_drv_twi_trace_t;
+
+#define NRF_DRV_TWI_TRACE_MAGIC 0x54495754UL ///< "TWIT", start of the trace ring in a memory dump.
+
+/**
+ * @brief Trace ring, laid out for a debugger memory dump.
+ *
+ * Records are written at index head % size and the oldest ones are overwritten.
+ */
+typedef struct
+{
+    uint32_t            magic;          ///< @ref NRF_DRV_TWI_TRACE_MAGIC.
+    uint32_t            timestamp_hz;   ///< Frequency of the timestamps.
+    uint16_t            size;           ///< Number of records in the ring.
+    uint16_t            record_size;    ///< sizeof(nrf_drv_twi_trace_t).
+    volatile uint32_t   head;           ///< Number of records written since init.
+    nrf_drv_twi_trace_t records[TWI_TRACE_SIZE];
+} nrf_drv_twi_trace_ring_t;
+
+extern nrf_drv_twi_trace_ring_t nrf_drv_twi_trace;
+#endif
+
 /**
  * @brief Structure for a TWI event.
  */
@@ -226,10 +337,16 @@ typedef void (* nrf_drv_twi_evt_handler_t)(nrf_drv_twi_evt_t const * p_event,
  * @param[in] p_instance      TWI instance.
  * @param[in] p_config        Initial configuration. If NULL, the default configuration is used.
  * @param[in] event_handler   Event handler provided by the user. If NULL, blocking mode is enabled.
+ *                            Must not be NULL if TWI_BLOCKING_ENABLED is 0. With EasyDMA,
+ *                            blocking transfers sleep on WFE until the transfer ends. For the
+ *                            length of each transfer SEVONPEND is set in SCB->SCR and the
+ *                            interrupt shared with SPI is disabled in the NVIC, both are
+ *                            restored afterwards.
  * @param[in] p_context       Context passed in event handler.
  *
  * @retval  NRF_SUCCESS If initialization was successful.
  * @retval  NRF_ERROR_INVALID_STATE If the driver is in invalid state.
+ * @retval  NRF_ERROR_NOT_SUPPORTED If no event handler is given and blocking mode is compiled out.
  */
 ret_code_t nrf_drv_twi_init(nrf_drv_twi_t const *        p_instance,
                             nrf_drv_twi_config_t const * p_config,
@@ -327,11 +444,14 @@ ret_code_t nrf_drv_twi_rx(nrf_drv_twi_t const * p_instance,
  *   driver is not setting the instance into busy state so it is user responsibility to ensure that next transfers are setup
  *   when TWIM is not active. Support by TWIM only.
  * - @ref NRF_DRV_TWI_FLAGS_TX_NO_STOP - No STOP condition after TX transfer.
+ * - @ref NRF_DRV_TWI_FLAGS_NO_RETRY - Report the first error instead of retrying (see @ref nrf_drv_twi_bus_recover).
  *
  * @note
  * Some flags combinations are invalid:
  * - @ref NRF_DRV_TWI_FLAGS_TX_NO_STOP with @ref nrf_drv_twi_xfer_desc_t::type different than @ref NRF_DRV_TWI_XFER_TX
- * - @ref NRF_DRV_TWI_FLAGS_REPEATED_XFER with @ref nrf_drv_twi_xfer_desc_t::type set to @ref NRF_DRV_TWI_XFER_TXTX
+ * - @ref NRF_DRV_TWI_FLAGS_NO_XFER_EVT_HANDLER, @ref NRF_DRV_TWI_FLAGS_TX_POSTINC or @ref NRF_DRV_TWI_FLAGS_RX_POSTINC
+ *   with @ref nrf_drv_twi_xfer_desc_t::type set to @ref NRF_DRV_TWI_XFER_TXTX (TWIM). The second buffer is
+ *   sent from the interrupt handler, which also rearms repeated and held TXTX transfers after each STOP.
  *
  * @note
  * If @ref nrf_drv_twi_xfer_desc_t::type is set to @ref NRF_DRV_TWI_XFER_TX and  @ref NRF_DRV_TWI_FLAGS_TX_NO_STOP, @ref NRF_DRV_TWI_FLAGS_REPEATED_XFER
@@ -353,6 +473,149 @@ ret_code_t nrf_drv_twi_xfer(nrf_drv_twi_t const *     p_instance,
                             nrf_drv_twi_xfer_desc_t * p_xfer_desc,
                             uint32_t                  flags);
 
+#if (TWI_QUEUE_ENABLED == 1)
+/**
+ * @brief Function for queuing a batch of TWI transfers.
+ *
+ * Descriptors are copied into the transfer queue of the instance. If the driver is idle the
+ * first transfer is started immediately, otherwise it is started from the interrupt handler
+ * as soon as the ongoing transfer is finished, without any involvement of the caller. The
+ * function never waits, so it can be called from the event handler as well.
+ *
+ * The queue is shared by all callers of the instance, in thread and interrupt context: the
+ * descriptors are copied with interrupts disabled, so that a batch queued from a higher priority
+ * interrupt cannot take the same queue entries. The data buffers must stay valid until
+ * the transfer is completed. If a transfer ends with an error, the error event is always
+ * passed to the event handler and the next queued transfer is started.
+ * Descriptors that could not be started are rejected here, none of the batch is queued then.
+ *
+ * Additional options are provided using @ref flags parameter and apply to all descriptors:
+ * - @ref NRF_DRV_TWI_FLAGS_NO_XFER_EVT_HANDLER - No event after successful transfers.
+ * - @ref NRF_DRV_TWI_FLAGS_BATCH_EVT - Only one event is generated, after the last transfer in the batch.
+ * - @ref NRF_DRV_TWI_FLAGS_TX_NO_STOP - No STOP condition after TX transfers.
+ *
+ * @note
+ * Function is intended to be used only if instance is configured to work in non-blocking mode.
+ * The repeated, hold and post-increment flags are not supported.
+ *
+ * @param[in] p_instance        TWI instance.
+ * @param[in] p_xfer_descs      Array of transfer descriptors.
+ * @param[in] count             Number of descriptors in the array.
+ * @param[in] flags             Transfer options. 0 for default settings.
+ *
+ * @retval NRF_SUCCESS             If the transfers were queued.
+ * @retval NRF_ERROR_NO_MEM        If there is not enough space in the queue for all descriptors.
+ * @retval NRF_ERROR_INVALID_PARAM If a descriptor has an unknown transfer type.
+ * @retval NRF_ERROR_INVALID_ADDR  If a buffer is not placed in the Data RAM region (TWIM only).
+ * @retval NRF_ERROR_NOT_SUPPORTED If provided parameters are not supported.
+ */
+ret_code_t nrf_drv_twi_xfer_queue(nrf_drv_twi_t const *           p_instance,
+                                  nrf_drv_twi_xfer_desc_t const * p_xfer_descs,
+                                  uint8_t                         count,
+                                  uint32_t                        flags);
+#endif
+
+#ifdef TWI_DOUBLE_BUFFER_IN_USE
+/**
+ * @brief Function for preparing a double-buffered (ping-pong) repeated transfer.
+ *
+ * The transfer is set up as with @ref nrf_drv_twi_xfer using the @ref NRF_DRV_TWI_FLAGS_REPEATED_XFER
+ * and @ref NRF_DRV_TWI_FLAGS_RX_POSTINC flags, with the RX buffer (secondary buffer for
+ * @ref NRF_DRV_TWI_XFER_TXRX, primary buffer for @ref NRF_DRV_TWI_XFER_RX) holding two halves of
+ * @p xfers_per_half transfers each. While EasyDMA fills one half, the application drains the other.
+ *
+ * The end of each half is detected outside of the driver, typically by counting the STOPPED
+ * event (see @ref nrf_drv_twi_stopped_event_get) with a TIMER in counter mode over PPI. At that
+ * point @ref nrf_drv_twi_rx_half_get returns the completed half and rewinds the RX list when
+ * the second half is complete. Supported by TWIM only.
+ *
+ * @param[in] p_instance        TWI instance.
+ * @param[in] p_xfer_desc       Pointer to transfer descriptor of a single transfer.
+ * @param[in] xfers_per_half    Number of transfers stored in each half of the buffer.
+ * @param[in] flags             Additional transfer options, see @ref nrf_drv_twi_xfer.
+ *
+ * @retval NRF_SUCCESS             If the procedure was successful.
+ * @retval NRF_ERROR_BUSY          If the driver is not ready for a new transfer.
+ * @retval NRF_ERROR_NOT_SUPPORTED If provided parameters are not supported.
+ */
+ret_code_t nrf_drv_twi_rx_double_buffer_xfer(nrf_drv_twi_t const *     p_instance,
+                                             nrf_drv_twi_xfer_desc_t * p_xfer_desc,
+                                             uint8_t                   xfers_per_half,
+                                             uint32_t                  flags);
+
+/**
+ * @brief Function for getting the completed half of a double-buffered RX list.
+ *
+ * Must be called once per completed half, before the next transfer starts. If the second
+ * half is complete, the RX list is rewound to the start of the buffer.
+ *
+ * @param[in] p_instance TWI instance.
+ *
+ * @return Pointer to the completed half, or NULL if the RX list is not at a half boundary.
+ */
+uint8_t * nrf_drv_twi_rx_half_get(nrf_drv_twi_t const * p_instance);
+
+/**
+ * @brief Function for changing the number of transfers in each half of a double-buffered RX list.
+ *
+ * Takes effect on the first half, so it must be called right after @ref nrf_drv_twi_rx_half_get
+ * returned the second half and before the next transfer completes. The buffer given to
+ * @ref nrf_drv_twi_rx_double_buffer_xfer must hold two halves of the new size.
+ *
+ * @param[in] p_instance     TWI instance.
+ * @param[in] xfers_per_half Number of transfers stored in each half of the buffer.
+ */
+void nrf_drv_twi_rx_half_size_set(nrf_drv_twi_t const * p_instance, uint8_t xfers_per_half);
+#endif
+
+#if (TWI_SCAN_ENABLED == 1)
+/**
+ * @brief Function for setting up a scan table of several slaves.
+ *
+ * The scan reads all entries of the table, in order, each time the start task is triggered
+ * externally (use @ref nrf_drv_twi_start_task_get with @ref NRF_DRV_TWI_XFER_TXRX, for example
+ * from an RTC compare event over PPI). The data is stored in @p p_rx_buf with RX list
+ * post-incrementation, so the buffer is an array of @p cycles records, each one holding the
+ * data of all table entries back to back in table order.
+ *
+ * Since TWIM has a single address register, the driver reprograms the address and starts
+ * the next entry from the STOPPED interrupt. The event handler is called only once all
+ * @p cycles records are filled (@ref NRF_DRV_TWI_EVT_SCAN_DONE, with
+ * @ref nrf_drv_twi_xfer_desc_t::p_secondary_buf pointing to the buffer and
+ * @ref nrf_drv_twi_xfer_desc_t::secondary_length set to the record size), or when an entry
+ * fails. The next cycle is then written to the start of the buffer again.
+ *
+ * The instance is busy until @ref nrf_drv_twi_scan_stop is called. Supported by TWIM only,
+ * in non-blocking mode.
+ *
+ * @param[in] p_instance TWI instance.
+ * @param[in] p_table    Scan table. Must stay valid while the scan is active.
+ * @param[in] entries    Number of entries in the table (up to TWI_SCAN_TABLE_SIZE).
+ * @param[in] p_rx_buf   Buffer for @p cycles records. Must be placed in the Data RAM region.
+ * @param[in] cycles     Number of table cycles stored in the buffer.
+ *
+ * @retval NRF_SUCCESS             If the scan was set up.
+ * @retval NRF_ERROR_BUSY          If the driver is not ready for a new transfer.
+ * @retval NRF_ERROR_INVALID_ADDR  If the buffer is not placed in the Data RAM region.
+ * @retval NRF_ERROR_NOT_SUPPORTED If provided parameters are not supported.
+ */
+ret_code_t nrf_drv_twi_scan_setup(nrf_drv_twi_t const *            p_instance,
+                                  nrf_drv_twi_scan_entry_t const * p_table,
+                                  uint8_t                          entries,
+                                  uint8_t *                        p_rx_buf,
+                                  uint8_t                          cycles);
+
+/**
+ * @brief Function for stopping a scan set up with @ref nrf_drv_twi_scan_setup.
+ *
+ * The external trigger must be disconnected and the last table cycle finished before
+ * the function is called.
+ *
+ * @param[in] p_instance TWI instance.
+ */
+void nrf_drv_twi_scan_stop(nrf_drv_twi_t const * p_instance);
+#endif
+
 /**
  * @brief Function for getting the transferred data count.
  *
@@ -388,6 +651,62 @@ uint32_t nrf_drv_twi_start_task_get(nrf_drv_twi_t const * p_instance, nrf_drv_tw
  * @return     STOPPED event address.
  */
 uint32_t nrf_drv_twi_stopped_event_get(nrf_drv_twi_t const * p_instance);
+
+#if (TWI_RECOVERY_ENABLED == 1)
+/**
+ * @brief Function for clearing a stuck bus.
+ *
+ * The peripheral is disabled while SCL is clocked up to nine times to make a slave release SDA,
+ * followed by a STOP condition. The driver does the same on its own after
+ * TWI_RECOVERY_BUS_CLEAR_AFTER transfers in a row failed after all retries. Address NACKs of
+ * @ref NRF_DRV_TWI_FLAGS_NO_RETRY transfers, as seen when polling a busy slave, do not count.
+ * Failed attempts of other transfers are started again up to TWI_RECOVERY_RETRIES times, unless
+ * @ref NRF_DRV_TWI_FLAGS_NO_RETRY is given. In blocking mode the retries are delayed by
+ * TWI_RECOVERY_BACKOFF_US, doubled on every attempt; from the interrupt handler they are started
+ * right away. Repeated and held transfers are never retried.
+ *
+ * @param[in]  p_instance  TWI instance.
+ *
+ * @retval NRF_SUCCESS     If the bus clear sequence was issued.
+ * @retval NRF_ERROR_BUSY  If a transfer is in progress.
+ */
+ret_code_t nrf_drv_twi_bus_recover(nrf_drv_twi_t const * p_instance);
+
+/**
+ * @brief Function for reading the error counters of an instance.
+ *
+ * @param[in]  p_instance  TWI instance.
+ * @param[out] p_stats     Copy of the counters.
+ */
+void nrf_drv_twi_error_stats_get(nrf_drv_twi_t const *       p_instance,
+                                 nrf_drv_twi_error_stats_t * p_stats);
+
+/**
+ * @brief Function for resetting the error counters of an instance.
+ *
+ * @param[in]  p_instance  TWI instance.
+ */
+void nrf_drv_twi_error_stats_clear(nrf_drv_twi_t const * p_instance);
+#endif
+
+#if (TWI_TRACE_ENABLED == 1)
+/**
+ * @brief Function for reading the next record from the transfer trace.
+ *
+ * A record is added when the driver handles the end of a transfer. Transfers that end without
+ * an interrupt (repeated transfers, @ref NRF_DRV_TWI_FLAGS_NO_XFER_EVT_HANDLER without error) and
+ * scan tables are not traced. If the reader falls behind by more than TWI_TRACE_SIZE records,
+ * @p p_cursor skips over the overwritten ones.
+ *
+ * @param[in,out] p_cursor  Index of the next record to read, start with 0.
+ * @param[out]    p_record  Copy of the record.
+ *
+ * @retval NRF_SUCCESS          If a record was read.
+ * @retval NRF_ERROR_NOT_FOUND  If there is no new record.
+ */
+ret_code_t nrf_drv_twi_trace_read(uint32_t * p_cursor, nrf_drv_twi_trace_t * p_record);
+#endif
+
 /**
  *@}
  **/
@@ -280,6 +280,28 @@ __STATIC_INLINE void nrf_twim_rx_buffer_set(NRF_TWIM_Type * p_twim,
                                             uint8_t * p_buffer,
                                             uint8_t   length);
 
+/**
+ * @brief Function for getting the receive buffer pointer.
+ *
+ * In list mode, the returned pointer reflects the post-incrementation done after each transfer.
+ *
+ * @param[in] p_twim   TWIM instance.
+ *
+ * @return Pointer to the location where the next received byte is written.
+ */
+__STATIC_INLINE uint8_t * nrf_twim_rx_buffer_get(NRF_TWIM_Type * p_twim);
+
+/**
+ * @brief Function for setting the receive length without changing the buffer pointer.
+ *
+ * Used in list mode, where the pointer is post-incremented by the peripheral.
+ *
+ * @param[in] p_twim   TWIM instance.
+ * @param[in] length   Maximum number of data bytes to receive.
+ */
+__STATIC_INLINE void nrf_twim_rx_length_set(NRF_TWIM_Type * p_twim,
+                                            uint8_t   length);
+
 __STATIC_INLINE void nrf_twim_shorts_set(NRF_TWIM_Type * p_twim,
                                          uint32_t shorts_mask);
 
@@ -414,6 +436,17 @@ __STATIC_INLINE void nrf_twim_rx_buffer_set(NRF_TWIM_Type * p_twim,
     p_twim->RXD.MAXCNT = length;
 }
 
+__STATIC_INLINE uint8_t * nrf_twim_rx_buffer_get(NRF_TWIM_Type * p_twim)
+{
+    return (uint8_t *)p_twim->RXD.PTR;
+}
+
+__STATIC_INLINE void nrf_twim_rx_length_set(NRF_TWIM_Type * p_twim,
+                                            uint8_t   length)
+{
+    p_twim->RXD.MAXCNT = length;
+}
+
 __STATIC_INLINE void nrf_twim_shorts_set(NRF_TWIM_Type * p_twim,
                                          uint32_t shorts_mask)
 {
@@ -0,0 +1,136 @@
+/* Copyright (c) 2015 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+#include "sample_codec.h"
+#include <string.h>
+
+#define HEADER_BITS     8
+#define RAW_BITS        6
+
+typedef struct
+{
+    uint8_t * p_buf;
+    uint32_t  bits;
+} bit_writer_t;
+
+static void bits_put(bit_writer_t * p_writer, uint32_t value, uint32_t count)
+{
+    for (; count != 0; count--, value >>= 1, p_writer->bits++)
+    {
+        if (value & 1)
+        {
+            p_writer->p_buf[p_writer->bits >> 3] |= (uint8_t)(1 << (p_writer->bits & 7));
+        }
+    }
+}
+
+static uint32_t zigzag_delta(uint8_t value, uint8_t previous)
+{
+    int32_t delta = (value - previous) & 0x3F;
+
+    if (delta & 0x20)
+    {
+        delta -= 64;
+    }
+    return (delta >= 0) ? (uint32_t)(2 * delta) : (uint32_t)(-2 * delta - 1);
+}
+
+static uint32_t code_bits(uint32_t z, uint32_t k)
+{
+    uint32_t q = z >> k;
+
+    return (q < SAMPLE_CODEC_ESCAPE) ? (q + 1 + k) : (SAMPLE_CODEC_ESCAPE + RAW_BITS);
+}
+
+static void code_put(bit_writer_t * p_writer, uint32_t z, uint32_t k)
+{
+    uint32_t q = z >> k;
+
+    if (q < SAMPLE_CODEC_ESCAPE)
+    {
+        bits_put(p_writer, (1UL << q) - 1, q + 1);  // q ones and the terminating zero.
+        bits_put(p_writer, z, k);
+    }
+    else
+    {
+        bits_put(p_writer, (1UL << SAMPLE_CODEC_ESCAPE) - 1, SAMPLE_CODEC_ESCAPE);
+        bits_put(p_writer, z, RAW_BITS);
+    }
+}
+
+static uint32_t sample_bits(uint8_t const * p_sample, uint32_t k)
+{
+    return code_bits(zigzag_delta(p_sample[0], p_sample[-3]), k) +
+           code_bits(zigzag_delta(p_sample[1], p_sample[-2]), k) +
+           code_bits(zigzag_delta(p_sample[2], p_sample[-1]), k);
+}
+
+uint32_t sample_codec_encode(uint8_t *       p_dst,
+                             uint32_t        dst_size,
+                             uint32_t *      p_length,
+                             uint8_t const * p_src,
+                             uint32_t        count)
+{
+    bit_writer_t writer = {p_dst, 0};
+    uint32_t     best_bits = UINT32_MAX;
+    uint32_t     k = 0;
+    uint32_t     i;
+
+    *p_length = 0;
+    if (count > SAMPLE_CODEC_MAX_SAMPLES)
+    {
+        count = SAMPLE_CODEC_MAX_SAMPLES;
+    }
+    if ((count == 0) || (8 * dst_size < HEADER_BITS + 3 * RAW_BITS))
+    {
+        return 0;
+    }
+
+    // Cheapest k over all samples, even those that may not fit in the end.
+    for (uint32_t candidate = 0; candidate < 4; candidate++)
+    {
+        uint32_t bits = 0;
+
+        for (i = 1; i < count; i++)
+        {
+            bits += sample_bits(&p_src[3*i], candidate);
+        }
+        if (bits < best_bits)
+        {
+            best_bits = bits;
+            k = candidate;
+        }
+    }
+
+    memset(p_dst, 0, dst_size);
+    writer.bits = HEADER_BITS;
+    bits_put(&writer, p_src[0], RAW_BITS);
+    bits_put(&writer, p_src[1], RAW_BITS);
+    bits_put(&writer, p_src[2], RAW_BITS);
+
+    for (i = 1; i < count; i++)
+    {
+        uint8_t const * p_sample = &p_src[3*i];
+
+        if (writer.bits + sample_bits(p_sample, k) > 8 * dst_size)
+        {
+            break;
+        }
+        code_put(&writer, zigzag_delta(p_sample[0], p_sample[-3]), k);
+        code_put(&writer, zigzag_delta(p_sample[1], p_sample[-2]), k);
+        code_put(&writer, zigzag_delta(p_sample[2], p_sample[-1]), k);
+    }
+
+    p_dst[0]  = (uint8_t)(k | (i << 2));
+    *p_length = (writer.bits + 7) / 8;
+    return i;
+}
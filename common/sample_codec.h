@@ -0,0 +1,67 @@
+/* Copyright (c) 2015 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+#ifndef SAMPLE_CODEC_H__
+#define SAMPLE_CODEC_H__
+
+#include <stdint.h>
+
+/**
+ * @defgroup sample_codec Accelerometer sample codec
+ * @{
+ * @brief Lossless delta coding of 6-bit X, Y, Z samples.
+ *
+ * A coded block stands on its own, a lost block does not affect the next one:
+ *
+ * | Bits        | Field                                                              |
+ * |-------------|--------------------------------------------------------------------|
+ * | 8           | Header, Rice parameter k in bits 0-1, sample count N in bits 2-7   |
+ * | 18          | First sample, X, Y and Z as 6-bit values                           |
+ * | variable    | 3*(N-1) codes, X, Y and Z of each following sample against the     |
+ * |             | same axis of the previous one                                      |
+ *
+ * The bits after the header are packed LSB first, like the raw 6-bit values of the binary
+ * sample stream. The difference to the previous value is taken modulo 64 and read as a
+ * signed 6-bit number d, zigzag mapped to z = 2d for d >= 0 and -2d-1 otherwise, and Rice
+ * coded: q = z >> k one bits, a zero bit and the k low bits of z. If q would reach
+ * @ref SAMPLE_CODEC_ESCAPE, the escape of that many one bits is sent instead, followed by
+ * z in 6 bits. The encoder picks the k that codes all given samples in the fewest bits.
+ *
+ * A still sensor costs 1 bit per value, against 6 bits packed and 8 bits as read.
+ */
+
+#define SAMPLE_CODEC_ESCAPE         4   /**< Unary length that switches to a raw 6-bit value. */
+#define SAMPLE_CODEC_MAX_SAMPLES    63  /**< Largest sample count of one block. */
+
+/**
+ * @brief Function for coding samples into a block.
+ *
+ * As many samples as fit in @p dst_size bytes are coded, possibly fewer than @p count.
+ *
+ * @param[out] p_dst     Block buffer.
+ * @param[in]  dst_size  Size of @p p_dst.
+ * @param[out] p_length  Number of bytes of the block.
+ * @param[in]  p_src     X, Y, Z values, three per sample. Only the low 6 bits are used, so
+ *                       values as read from the sensor and decoded ones give the same block.
+ * @param[in]  count     Number of XYZ samples, at most @ref SAMPLE_CODEC_MAX_SAMPLES are taken.
+ *
+ * @return Number of samples in the block, 0 if not even one fits.
+ */
+uint32_t sample_codec_encode(uint8_t *       p_dst,
+                             uint32_t        dst_size,
+                             uint32_t *      p_length,
+                             uint8_t const * p_src,
+                             uint32_t        count);
+
+/** @} */
+
+#endif // SAMPLE_CODEC_H__
@@ -0,0 +1,262 @@
+#!/usr/bin/env python
+"""Register model of the MMA7660 accelerometer replaying a recorded motion trace.
+
+Usage:
+    mma7660_model.py [--poll HZ] [--sr N] [--intsu MASK] [--mode MASK] [--spcnt N]
+                     [--read N] [--freq HZ] [--alert-us US] [--dump] <trace.csv>
+
+The trace holds one line per sample, "t_s,x_g,y_g,z_g"; other lines (headers, comments) are
+skipped. The model takes the register writes of mma7660_init()/mma7660_int_init() from the
+options (SR, INTSU, MODE bits ASE/AWE and SPCNT) and is then read the way the TWI list demo
+reads it: --read bytes from MMA7660_X (3 for the RTC poll, 4 to include TILT) at --poll
+samples per second. With --poll 0 the model is read only when INT is asserted, as with
+SAMPLE_TRIGGER_INT.
+
+Modelled:
+  - registers MMA7660_X (0x00) to MMA7660_PD (0x0A) with address auto-increment and wrap,
+  - X, Y, Z updated at the SR active rate, or the auto-wake rate while auto-sleeping,
+  - ALERT set in an output register that is read within --alert-us of its update,
+  - TILT: back/front, portrait/landscape and shake, INT on the INTSU sources, released by
+    reading TILT,
+  - auto-sleep after SPCNT samples without an INTSU event, auto-wake on the next one.
+Tap detection (PDET/PD) and the orientation debounce filter are not modelled.
+
+The trace is replayed as fast as the host runs. A summary of the reads, ALERTs, INT edges
+and the time spent auto-sleeping is printed; --dump also prints every read as
+"t_s,b0,b1,..." in raw register values, which is what the firmware sees.
+"""
+
+import sys
+
+X, Y, Z, TILT, SRST, SPCNT, INTSU, MODE, SR, PDET, PD = range(11)
+REG_COUNT = 11
+
+ALERT = 0x40
+SHAKE = 0x80
+COUNTS_PER_G = 21.33
+SHAKE_G = 1.3
+
+AMSR_HZ = (120, 64, 32, 16, 8, 4, 2, 1)
+AWSR_HZ = (32, 16, 8, 1)
+
+MODE_ACTIVE = 0x01
+MODE_AWE = 0x08
+MODE_ASE = 0x10
+
+INTSU_FBINT = 0x01
+INTSU_PLINT = 0x02
+INTSU_GINT = 0x10
+INTSU_SHINT = (0x80, 0x40, 0x20)  # X, Y, Z
+
+BAFRO_FRONT, BAFRO_BACK = 1, 2
+POLA_LEFT, POLA_RIGHT, POLA_DOWN, POLA_UP = 1, 2, 5, 6
+
+
+def to_reg(g):
+    counts = int(round(g * COUNTS_PER_G))
+    return max(-32, min(31, counts)) & 0x3F
+
+
+def tilt_of(xyz):
+    x, y, z = xyz
+    tilt = 0
+    if z > 0.3:
+        tilt |= BAFRO_FRONT
+    elif z < -0.3:
+        tilt |= BAFRO_BACK
+    if abs(z) < 0.8:
+        if abs(x) >= abs(y):
+            tilt |= (POLA_LEFT if x > 0 else POLA_RIGHT) << 2
+        else:
+            tilt |= (POLA_DOWN if y > 0 else POLA_UP) << 2
+    return tilt
+
+
+class Mma7660(object):
+    """MMA7660 register map driven by a trace of (t_s, x_g, y_g, z_g) tuples."""
+
+    def __init__(self, trace, alert_us):
+        self.trace = trace
+        self.pos = 0
+        self.alert_s = alert_us * 1e-6
+        self.regs = [0] * REG_COUNT
+        self.pointer = 0
+        self.next_update = None
+        self.last_update = -1.0
+        self.asleep = False
+        self.idle = 0
+        self.int_asserted = False
+        self.int_edges = 0
+        self.alerts = 0
+        self.sleep_s = 0.0
+        self.sleep_since = None
+
+    # Bus side.
+
+    def write(self, t, reg, data):
+        self.advance(t)
+        self.pointer = reg
+        for value in data:
+            self.regs[self.pointer] = value & 0xFF
+            if self.pointer == MODE and value & MODE_ACTIVE and self.next_update is None:
+                self.next_update = t
+            self.pointer = (self.pointer + 1) % REG_COUNT
+
+    def read(self, t, reg, count, byte_s):
+        """Read count bytes from reg, the first one at time t and the others byte_s apart."""
+        self.pointer = reg
+        data = []
+        for n in range(count):
+            now = t + n * byte_s
+            self.advance(now)
+            value = self.regs[self.pointer]
+            if self.pointer <= Z and now - self.last_update < self.alert_s:
+                value |= ALERT
+                self.alerts += 1
+            if self.pointer == TILT:
+                self.int_asserted = False
+            data.append(value)
+            self.pointer = (self.pointer + 1) % REG_COUNT
+        return data
+
+    # Sensor side.
+
+    def rate(self):
+        sr = self.regs[SR]
+        if self.asleep:
+            return AWSR_HZ[(sr >> 3) & 0x03]
+        return AMSR_HZ[sr & 0x07]
+
+    def sample_at(self, t):
+        while self.pos + 1 < len(self.trace) and self.trace[self.pos + 1][0] <= t:
+            self.pos += 1
+        return self.trace[self.pos][1:]
+
+    def advance(self, t):
+        while self.next_update is not None and self.next_update <= t:
+            self.update(self.next_update)
+            self.next_update += 1.0 / self.rate()
+
+    def update(self, t):
+        xyz = self.sample_at(t)
+        for axis in (X, Y, Z):
+            self.regs[axis] = to_reg(xyz[axis])
+        self.last_update = t
+
+        old = self.regs[TILT] & 0x1F
+        new = tilt_of(xyz)
+        intsu = self.regs[INTSU]
+        events = intsu & INTSU_GINT
+        if (old ^ new) & 0x03 and intsu & INTSU_FBINT:
+            events = True
+        if (old ^ new) & 0x1C and intsu & INTSU_PLINT:
+            events = True
+        shake = any(abs(xyz[axis]) > SHAKE_G and intsu & INTSU_SHINT[axis] for axis in (X, Y, Z))
+        if shake:
+            events = True
+            new |= SHAKE
+        self.regs[TILT] = new
+
+        if events and not self.int_asserted:
+            self.int_asserted = True
+            self.int_edges += 1
+
+        mode = self.regs[MODE]
+        if events:
+            self.idle = 0
+            if self.asleep and mode & MODE_AWE:
+                self.wake(t)
+        elif not self.asleep and mode & MODE_ASE and self.regs[SPCNT]:
+            self.idle += 1
+            if self.idle >= self.regs[SPCNT]:
+                self.asleep = True
+                self.sleep_since = t
+        self.regs[SRST] = 0x02 if self.asleep else 0x01
+
+    def wake(self, t):
+        self.asleep = False
+        self.idle = 0
+        self.sleep_s += t - self.sleep_since
+        self.sleep_since = None
+
+    def finish(self, t):
+        if self.asleep:
+            self.sleep_s += t - self.sleep_since
+
+
+def load_trace(path):
+    trace = []
+    src = sys.stdin if path == '-' else open(path, 'r')
+    for line in src:
+        try:
+            t, x, y, z = [float(v) for v in line.strip().split(',')[:4]]
+        except ValueError:
+            continue
+        trace.append((t, x, y, z))
+    return trace
+
+
+def main():
+    p = dict(poll=120.0, sr=0, intsu=0, mode=0, spcnt=0, read=3, freq=400000.0, alert_us=2.0)
+    dump = False
+    args = sys.argv[1:]
+    while len(args) > 1 and args[0].startswith('--'):
+        if args[0] == '--dump':
+            dump = True
+            args = args[1:]
+            continue
+        key = args[0][2:].replace('-', '_')
+        if key not in p:
+            sys.stderr.write(__doc__)
+            return 1
+        p[key] = type(p[key])(int(args[1], 0) if isinstance(p[key], int) else args[1])
+        args = args[2:]
+    if len(args) != 1:
+        sys.stderr.write(__doc__)
+        return 1
+
+    trace = load_trace(args[0])
+    if not trace:
+        sys.stderr.write('no samples found\n')
+        return 1
+
+    sensor = Mma7660(trace, p['alert_us'])
+    byte_s = 9.0 / p['freq']
+    # Set up as mma7660_int_init() does: standby, the settings, then active.
+    t = trace[0][0]
+    sensor.write(t, MODE, [0])
+    sensor.write(t, SPCNT, [p['spcnt'], p['intsu']])
+    sensor.write(t, SR, [p['sr'], 0, 0])
+    sensor.write(t, MODE, [MODE_ACTIVE | p['mode']])
+
+    end = trace[-1][0]
+    # The register bytes follow the address byte and the repeated START with the read address.
+    first_byte = 3 * byte_s
+    reads = 0
+    edges_seen = 0
+    while t < end:
+        if p['poll']:
+            t += 1.0 / p['poll']
+        else:
+            # INT sampling: step at the sensor rate until INT is asserted.
+            t += 1.0 / sensor.rate()
+            sensor.advance(t)
+            if sensor.int_edges == edges_seen:
+                continue
+            edges_seen = sensor.int_edges
+        data = sensor.read(t + first_byte, X, p['read'], byte_s)
+        reads += 1
+        if dump:
+            print('%.6f,%s' % (t, ','.join('%d' % b for b in data)))
+    sensor.advance(end)
+    sensor.finish(end)
+
+    total = end - trace[0][0]
+    sys.stderr.write('%.2f s, %d reads, %d bytes, %d ALERT, %d INT, asleep %.2f s (%.0f%%)\n' %
+                     (total, reads, reads * (p['read'] + 3), sensor.alerts, sensor.int_edges,
+                      sensor.sleep_s, 100.0 * sensor.sleep_s / total if total else 0))
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
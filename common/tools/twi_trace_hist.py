@@ -0,0 +1,151 @@
+#!/usr/bin/env python
+"""Latency histograms from the TWI driver transfer trace (TWI_TRACE_ENABLED, see nrf_drv_twi_mod.h).
+
+Usage:
+    twi_trace_hist.py [--hz N] <log file>     "TWI,..." lines printed by the demo, other lines are skipped
+    twi_trace_hist.py [--hz N] -              the same from stdin, e.g. piped from a serial tool
+    twi_trace_hist.py --dump <memory dump>    raw dump of the nrf_drv_twi_trace ring, e.g. taken with
+                                              nrfjprog --memrd at the address from the map file
+
+For each phase (queue: submit->start, bus: start->end, handler: end->done and total) a histogram
+with power of two buckets in microseconds is printed, followed by the bus throughput and the
+error counts. --hz gives the timestamp frequency of a text log, 64 MHz (CPU cycles) by default;
+a dump carries its own.
+"""
+
+import struct
+import sys
+
+MAGIC = 0x54495754
+HEADER = struct.Struct('<IIHHI')
+RECORD = struct.Struct('<IIIIHBBBBBB')
+TYPES = ('TX', 'RX', 'TXRX', 'TXTX')
+ERRORS = ((0x2, 'address NACK'), (0x4, 'data NACK'), (0x1, 'overrun'))
+BAR = 40
+
+
+def parse_log(lines):
+    """Return the records found in the text lines and the number of records missing in between."""
+    records = []
+    lost = 0
+    last = None
+    for line in lines:
+        line = line.strip()
+        if not line.startswith('TWI,'):
+            continue
+        try:
+            f = [int(v) for v in line.split(',')[1:]]
+        except ValueError:
+            continue
+        if len(f) != 11:
+            continue
+        if last is not None and f[0] != last + 1:
+            lost += (f[0] - last - 1) & 0xFFFFFFFF
+        last = f[0]
+        instance, address, xfer_type, attempts, errorsrc, nbytes, submit, start, end, done = f[1:]
+        records.append(dict(instance=instance, address=address, type=xfer_type, attempts=attempts,
+                            errorsrc=errorsrc, bytes=nbytes, submit=submit, start=start, end=end, done=done))
+    return records, lost
+
+
+def parse_dump(buf):
+    """Return the timestamp frequency and the records of a ring dump, oldest first."""
+    pos = buf.find(struct.pack('<I', MAGIC))
+    if pos < 0:
+        raise ValueError('trace ring magic not found')
+    _, hz, size, record_size, head = HEADER.unpack_from(buf, pos)
+    if record_size != RECORD.size:
+        raise ValueError('record size %d, expected %d' % (record_size, RECORD.size))
+    base = pos + HEADER.size
+    count = min(head, size)
+    records = []
+    for n in range(head - count, head):
+        submit, start, end, done, nbytes, address, xfer_type, instance, attempts, errorsrc, _ = \
+            RECORD.unpack_from(buf, base + (n % size) * RECORD.size)
+        records.append(dict(instance=instance, address=address, type=xfer_type, attempts=attempts,
+                            errorsrc=errorsrc, bytes=nbytes, submit=submit, start=start, end=end, done=done))
+    return hz, records
+
+
+def delta(a, b):
+    return (b - a) & 0xFFFFFFFF
+
+
+def histogram(name, values_us):
+    if not values_us:
+        return
+    values_us = sorted(values_us)
+    buckets = {}
+    for v in values_us:
+        top = 1
+        while top < v:
+            top *= 2
+        buckets[top] = buckets.get(top, 0) + 1
+    print('%s: n=%d min=%.1f median=%.1f max=%.1f us' %
+          (name, len(values_us), values_us[0], values_us[len(values_us) // 2], values_us[-1]))
+    peak = max(buckets.values())
+    for top in sorted(buckets):
+        n = buckets[top]
+        print('  <=%8d us %6d %s' % (top, n, '#' * max(1, n * BAR // peak)))
+
+
+def report(records, hz):
+    us = 1e6 / hz
+    phases = (('queue', 'submit', 'start'), ('bus', 'start', 'end'),
+              ('handler', 'end', 'done'), ('total', 'submit', 'done'))
+    for name, a, b in phases:
+        histogram(name, [delta(r[a], r[b]) * us for r in records])
+
+    bus_us = sum(delta(r['start'], r['end']) * us for r in records)
+    nbytes = sum(r['bytes'] for r in records)
+    if bus_us:
+        print('throughput: %d bytes in %.0f us of bus time, %.1f kB/s' % (nbytes, bus_us, nbytes * 1e3 / bus_us))
+
+    per_type = {}
+    for r in records:
+        per_type[r['type']] = per_type.get(r['type'], 0) + 1
+    print('transfers: ' + ', '.join('%s %d' % (TYPES[t] if t < len(TYPES) else t, n)
+                                    for t, n in sorted(per_type.items())))
+    failed = [r for r in records if r['errorsrc']]
+    retried = sum(1 for r in records if r['attempts'] > 1)
+    print('failed: %d, retried: %d' % (len(failed), retried))
+    for mask, text in ERRORS:
+        n = sum(1 for r in failed if r['errorsrc'] & mask)
+        if n:
+            print('  %s: %d' % (text, n))
+
+
+def main():
+    args = sys.argv[1:]
+    hz = 64e6
+    dump = False
+    while len(args) > 1:
+        if args[0] == '--hz':
+            hz = float(args[1])
+            args = args[2:]
+        elif args[0] == '--dump':
+            dump = True
+            args = args[1:]
+        else:
+            break
+    if len(args) != 1:
+        sys.stderr.write(__doc__)
+        return 1
+
+    if dump:
+        with open(args[0], 'rb') as f:
+            hz, records = parse_dump(f.read())
+    else:
+        src = sys.stdin if args[0] == '-' else open(args[0], 'r')
+        records, lost = parse_log(src)
+        if lost:
+            sys.stderr.write('%d record(s) overwritten before they were printed\n' % lost)
+    if not records:
+        sys.stderr.write('no trace records found\n')
+        return 1
+    report(records, hz)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,166 @@
+/* Copyright (c) 2015 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+
+/* DMA pool against malloc for the 2-byte register write buffers of the MMA7660 driver: host
+ * time per allocation or release, mean and 99.9th percentile, and the memory taken per buffer.
+ * The mean comes from an untimed loop, the percentile from timing each operation. malloc
+ * runs in the same critical region as the pool, which it would need for use from the TWI
+ * interrupt. The host times only rank the two, they are not the nRF52 times. */
+
+#include "sim.h"
+#include "dma_pool.h"
+#include "app_util_platform.h"
+#include <malloc.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define BLOCK_SIZE    2
+#define OUTSTANDING   8           // Buffers in flight at most, like writes queued on the bus.
+#define ROUNDS        2000000
+#define TIMED_ROUNDS  200000
+
+DMA_POOL_DEF(m_pool, BLOCK_SIZE, OUTSTANDING);
+
+typedef struct
+{
+    char const * name;
+    void *    (* alloc)(void);
+    void      (* free)(void * p_block);
+} allocator_t;
+
+static void * pool_alloc(void)
+{
+    return dma_pool_alloc(&m_pool);
+}
+
+static void pool_free(void * p_block)
+{
+    dma_pool_free(&m_pool, p_block);
+}
+
+static void * heap_alloc(void)
+{
+    void * p_block;
+
+    CRITICAL_REGION_ENTER();
+    p_block = malloc(BLOCK_SIZE);
+    CRITICAL_REGION_EXIT();
+    return p_block;
+}
+
+static void heap_free(void * p_block)
+{
+    CRITICAL_REGION_ENTER();
+    free(p_block);
+    CRITICAL_REGION_EXIT();
+}
+
+static uint64_t m_op_ns[TIMED_ROUNDS];
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static int ns_compare(void const * p_a, void const * p_b)
+{
+    uint64_t a = *(uint64_t const *)p_a;
+    uint64_t b = *(uint64_t const *)p_b;
+
+    return (a > b) - (a < b);
+}
+
+// Keeps up to OUTSTANDING buffers in flight and allocates or releases one in a pseudo random
+// slot, timing each operation into m_op_ns if asked.
+static void churn(allocator_t const * p_allocator, uint32_t rounds, bool timed)
+{
+    void *   p_blocks[OUTSTANDING] = { NULL };
+    uint32_t seed = 1;
+
+    for (uint32_t i = 0; i < rounds; i++)
+    {
+        uint32_t slot;
+        uint64_t t0 = 0;
+
+        seed = seed * 1103515245 + 12345;
+        slot = (seed >> 16) % OUTSTANDING;
+        if (timed)
+        {
+            t0 = now_ns();
+        }
+        if (p_blocks[slot] != NULL)
+        {
+            p_allocator->free(p_blocks[slot]);
+            p_blocks[slot] = NULL;
+        }
+        else
+        {
+            p_blocks[slot] = p_allocator->alloc();
+            SIM_CHECK(p_blocks[slot] != NULL);
+        }
+        if (timed)
+        {
+            m_op_ns[i] = now_ns() - t0;
+        }
+    }
+    for (uint32_t slot = 0; slot < OUTSTANDING; slot++)
+    {
+        if (p_blocks[slot] != NULL)
+        {
+            p_allocator->free(p_blocks[slot]);
+        }
+    }
+}
+
+static void run(allocator_t const * p_allocator)
+{
+    uint64_t t0 = now_ns();
+    uint64_t total;
+
+    churn(p_allocator, ROUNDS, false);
+    total = now_ns() - t0;
+    churn(p_allocator, TIMED_ROUNDS, true);
+    qsort(m_op_ns, TIMED_ROUNDS, sizeof(m_op_ns[0]), ns_compare);
+    printf("%-8s%14.1f%14u\n", p_allocator->name, (double)total / ROUNDS,
+           (unsigned)m_op_ns[TIMED_ROUNDS - TIMED_ROUNDS / 1000]);
+}
+
+int main(void)
+{
+    static allocator_t const allocators[] = {
+        { "pool",   pool_alloc, pool_free },
+        { "malloc", heap_alloc, heap_free },
+    };
+    void * p_block;
+
+    sim_reset();
+    dma_pool_init(&m_pool);
+    printf("%u-byte buffers, up to %u in flight, %u operations\n",
+           BLOCK_SIZE, OUTSTANDING, ROUNDS);
+    printf("          mean ns/op  99.9%% ns/op\n");
+    for (uint32_t i = 0; i < sizeof(allocators) / sizeof(allocators[0]); i++)
+    {
+        run(&allocators[i]);
+    }
+
+    p_block = malloc(BLOCK_SIZE);
+    printf("RAM per buffer: pool %u bytes (4 on the nRF52), malloc %u bytes usable plus its chunk header\n",
+           (unsigned)m_pool.block_size, (unsigned)malloc_usable_size(p_block));
+    free(p_block);
+    return 0;
+}
@@ -0,0 +1,148 @@
+/* Copyright (c) 2015 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+
+/* mma7660_decode(), four values per word, against the per-byte loop and the bitfield decode it
+ * replaced, on the raw values of the MMA7660 model replaying tests/traces/motion_30s.csv: host
+ * CPU time per value for one X/Y/Z sample and for the 16 sample batches of the TWI list demo.
+ * The host time only ranks the three, it is not the nRF52 time. */
+
+#include "sim.h"
+#include "sim_mma7660.h"
+#include "mma7660.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#define TRACE_PATH     "traces/motion_30s.csv"
+#define TRACE_MAX      2000
+#define BATCH_SAMPLES  16
+#define BATCH_MAX      256
+#define SAMPLE_NS      (1000000000ULL / 120)
+#define PASSES         2000
+
+typedef union __attribute__((__packed__))
+{
+    uint8_t raw;
+    struct __attribute__((__packed__))
+    {
+        uint8_t orientation_data : 5;
+        uint8_t sign             : 1;
+        uint8_t alert            : 1;
+        uint8_t                  : 1;
+    } fields;
+} raw_t;
+
+typedef uint32_t (*decode_t)(int8_t * p_dst, uint8_t const * p_src, uint32_t count);
+
+static sim_mma7660_sample_t m_trace[TRACE_MAX];
+static sim_mma7660_t        m_sensor;
+static uint8_t              m_raw[BATCH_MAX * 3 * BATCH_SAMPLES];
+static int8_t               m_out[BATCH_MAX * 3 * BATCH_SAMPLES];
+static int8_t               m_ref[BATCH_MAX * 3 * BATCH_SAMPLES];
+static uint32_t             m_values;
+static volatile uint32_t    m_alerts;
+
+static uint64_t cpu_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+// The per-byte loop of mma7660_decode(), without the word-at-a-time part.
+static uint32_t decode_bytes(int8_t * p_dst, uint8_t const * p_src, uint32_t count)
+{
+    uint32_t alerts = 0;
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        uint8_t value = p_src[i];
+        alerts += (value >> 6) & 1;
+        value  &= 0x3F;
+        p_dst[i] = (int8_t)(value | ((value & 0x20) * 7));
+    }
+    return alerts;
+}
+
+// The bitfield decode of xyz_decode before mma7660_decode(), with the ALERT count added.
+static uint32_t decode_fields(int8_t * p_dst, uint8_t const * p_src, uint32_t count)
+{
+    raw_t const * p_raw = (raw_t const *)p_src;
+    uint32_t      alerts = 0;
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        alerts  += p_raw[i].fields.alert;
+        p_dst[i] = p_raw[i].fields.sign ? (int8_t)(p_raw[i].fields.orientation_data | 0xE0)
+                                        : (int8_t)p_raw[i].fields.orientation_data;
+    }
+    return alerts;
+}
+
+// Host ns per value, decoding the recorded values in chunks of @p chunk.
+static double run(decode_t decode, uint32_t chunk)
+{
+    uint64_t t0 = cpu_ns();
+
+    for (uint32_t pass = 0; pass < PASSES; pass++)
+    {
+        for (uint32_t i = 0; i + chunk <= m_values; i += chunk)
+        {
+            m_alerts += decode(&m_out[i], &m_raw[i], chunk);
+        }
+    }
+    return (double)(cpu_ns() - t0) / PASSES / m_values;
+}
+
+int main(void)
+{
+    static struct
+    {
+        char const * p_name;
+        decode_t     decode;
+    } const decoders[] = {
+        { "mma7660_decode", mma7660_decode },
+        { "per-byte loop",  decode_bytes   },
+        { "bitfields",      decode_fields  },
+    };
+    uint32_t length = sim_mma7660_trace_load(TRACE_PATH, m_trace, TRACE_MAX, 0);
+    uint64_t t = 0;
+
+    sim_reset();
+    sim_mma7660_init(&m_sensor, m_trace, length, 0);
+    m_sensor.running = true;
+    while ((m_values < sizeof(m_raw)) && (t + SAMPLE_NS < m_trace[length - 1].t_ns))
+    {
+        t += SAMPLE_NS;
+        sim_mma7660_advance(&m_sensor, t);
+        memcpy(&m_raw[m_values], &m_sensor.regs[MMA7660_X], 3);
+        m_values += 3;
+    }
+
+    (void)decode_bytes(m_ref, m_raw, m_values);
+    printf("%u values                 ns/value, 3 per call   ns/value, %u per call\n",
+           (unsigned)m_values, 3 * BATCH_SAMPLES);
+    for (uint32_t d = 0; d < sizeof(decoders) / sizeof(decoders[0]); d++)
+    {
+        double xyz_ns;
+        double batch_ns;
+
+        memset(m_out, 0, sizeof(m_out));
+        xyz_ns   = run(decoders[d].decode, 3);
+        batch_ns = run(decoders[d].decode, 3 * BATCH_SAMPLES);
+        SIM_CHECK_EQ(memcmp(m_out, m_ref, m_values), 0);
+        printf("%-16s%24.2f%24.2f\n", decoders[d].p_name, xyz_ns, batch_ns);
+    }
+    return 0;
+}
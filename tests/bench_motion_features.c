@@ -0,0 +1,223 @@
+/* Copyright (c) 2015 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+
+/* Motion features of common/motion_features.c, fed sample by sample, against the features
+ * computed the straightforward way, in float from a stored window, on the MMA7660 model replaying
+ * tests/traces/motion_30s.csv at 120 Hz and on uniform noise: host CPU time and cycles per
+ * window, for the 16 sample batches of the TWI list demo and for longer windows, and the bytes
+ * of a frame against the raw samples. The cycles are those of the host time stamp counter.
+ * The host figures only rank the two, they are not the nRF52 cost. */
+
+#include "sim.h"
+#include "sim_mma7660.h"
+#include "mma7660.h"
+#include "motion_features.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define TRACE_PATH     "traces/motion_30s.csv"
+#define TRACE_MAX      2000
+#define SAMPLES_MAX    3600
+#define SAMPLE_NS      (1000000000ULL / 120)
+#define PASSES         200
+
+typedef void (*features_t)(int8_t const * p_xyz, uint32_t count, motion_features_t * p_features);
+
+static sim_mma7660_sample_t  m_trace[TRACE_MAX];
+static int8_t                m_xyz[3 * SAMPLES_MAX];
+static motion_features_acc_t m_acc;
+static float                 m_center[3];
+static int8_t                m_side[3];
+static int8_t                m_last[3];
+static uint8_t               m_orientation;
+static volatile uint32_t     m_sink;
+
+static uint64_t cpu_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static uint64_t cycles(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __builtin_ia32_rdtsc();
+#else
+    return 0;
+#endif
+}
+
+static void features_int(int8_t const * p_xyz, uint32_t count, motion_features_t * p_features)
+{
+    motion_features_add(&m_acc, p_xyz, count);
+    motion_features_get(&m_acc, p_features);
+}
+
+// The straightforward way: the window kept in a buffer, two passes in float and sqrtf().
+static void features_float(int8_t const * p_xyz, uint32_t count, motion_features_t * p_features)
+{
+    float mean[3] = {0};
+    float var[3]  = {0};
+    float magnitude = 0;
+    int   axis = 0;
+
+    memset(p_features, 0, sizeof(*p_features));
+    p_features->count = (uint8_t)count;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        float square = 0;
+
+        for (int a = 0; a < 3; a++)
+        {
+            mean[a] += p_xyz[3 * i + a];
+            square  += (float)p_xyz[3 * i + a] * p_xyz[3 * i + a];
+        }
+        magnitude += sqrtf(square);
+    }
+    for (int a = 0; a < 3; a++)
+    {
+        mean[a] /= count;
+    }
+    for (uint32_t i = 0; i < count; i++)
+    {
+        for (int a = 0; a < 3; a++)
+        {
+            int8_t value = p_xyz[3 * i + a];
+            float  delta = value - m_center[a];
+
+            var[a] += (value - mean[a]) * (value - mean[a]);
+            if (abs(value) >= MOTION_SHAKE_COUNTS)
+            {
+                p_features->events |= MOTION_EVT_SHAKE;
+            }
+            if (abs(value - m_last[a]) >= MOTION_TAP_COUNTS)
+            {
+                p_features->events |= MOTION_EVT_TAP;
+            }
+            m_last[a] = value;
+            if (fabsf(delta) >= MOTION_ZC_HYSTERESIS)
+            {
+                int8_t side = (delta > 0) ? 1 : -1;
+
+                p_features->zero_crossings[a] += (m_side[a] != 0) && (m_side[a] != side);
+                m_side[a] = side;
+            }
+        }
+    }
+    for (int a = 0; a < 3; a++)
+    {
+        p_features->mean[a]     = (int8_t)lroundf(mean[a]);
+        p_features->variance[a] = (uint16_t)lroundf(16 * var[a] / count);
+        m_center[a]             = p_features->mean[a];
+        if (fabsf(mean[a]) > fabsf(mean[axis]))
+        {
+            axis = a;
+        }
+    }
+    p_features->magnitude   = (uint8_t)lroundf(magnitude / count);
+    p_features->orientation = (fabsf(mean[axis]) < MOTION_ORIENTATION_COUNTS) ? MOTION_ORIENTATION_UNKNOWN :
+                              MOTION_ORIENTATION_X_UP + 2 * axis + ((mean[axis] < 0) ? 1 : 0);
+    if (p_features->orientation != m_orientation)
+    {
+        p_features->events |= MOTION_EVT_ORIENTATION;
+    }
+    m_orientation = p_features->orientation;
+}
+
+static void state_reset(void)
+{
+    motion_features_init(&m_acc);
+    memset(m_center, 0, sizeof(m_center));
+    memset(m_side, 0, sizeof(m_side));
+    memset(m_last, 0, sizeof(m_last));
+    m_orientation = MOTION_ORIENTATION_UNKNOWN;
+}
+
+// Host ns and cycles per window of @p window samples over the first @p count samples.
+static void run(features_t features, uint32_t count, uint32_t window, double * p_ns, double * p_cycles)
+{
+    motion_features_t frame;
+    uint32_t          windows = count / window;
+    uint64_t          t0;
+    uint64_t          c0;
+
+    state_reset();
+    t0 = cpu_ns();
+    c0 = cycles();
+    for (uint32_t pass = 0; pass < PASSES; pass++)
+    {
+        for (uint32_t w = 0; w < windows; w++)
+        {
+            features(&m_xyz[3 * window * w], window, &frame);
+            m_sink += frame.magnitude;
+        }
+    }
+    *p_cycles = (double)(cycles() - c0) / PASSES / windows;
+    *p_ns     = (double)(cpu_ns() - t0) / PASSES / windows;
+}
+
+static void print(char const * p_name, uint32_t count)
+{
+    static const uint32_t windows[] = {16, 64, 255};
+
+    for (uint32_t i = 0; i < sizeof(windows) / sizeof(windows[0]); i++)
+    {
+        double int_ns, int_cycles, float_ns, float_cycles;
+
+        run(features_int, count, windows[i], &int_ns, &int_cycles);
+        run(features_float, count, windows[i], &float_ns, &float_cycles);
+        printf("%-14s%7u%8u/%-4u%11.0f%9.0f%11.0f%9.0f%9.1f\n", p_name, (unsigned)windows[i],
+               (unsigned)sizeof(motion_features_t), (unsigned)(3 * windows[i]), int_cycles, int_ns,
+               float_cycles, float_ns, (double)int_ns / windows[i]);
+    }
+}
+
+int main(void)
+{
+    uint8_t       raw[3 * SAMPLES_MAX];
+    sim_mma7660_t sensor;
+    uint32_t      length = sim_mma7660_trace_load(TRACE_PATH, m_trace, TRACE_MAX, 0);
+    uint32_t      count  = 0;
+    uint64_t      t      = 0;
+    uint32_t      seed   = 1;
+
+    sim_reset();
+    sim_mma7660_init(&sensor, m_trace, length, 0);
+    sensor.running = true;
+    while ((count < SAMPLES_MAX) && (t + SAMPLE_NS < m_trace[length - 1].t_ns))
+    {
+        t += SAMPLE_NS;
+        sim_mma7660_advance(&sensor, t);
+        memcpy(&raw[3 * count], &sensor.regs[MMA7660_X], 3);
+        count++;
+    }
+    (void)mma7660_decode(m_xyz, raw, 3 * count);
+
+    printf("%-14s%7s%13s%20s%20s%9s\n", "", "window", "frame/raw", "motion_features", "float, stored",
+           "int ns");
+    printf("%-14s%7s%13s%11s%9s%11s%9s%9s\n", "", "samples", "bytes", "cycles", "ns", "cycles", "ns",
+           "/sample");
+    print("trace 120 Hz", count);
+    for (uint32_t v = 0; v < sizeof(m_xyz); v++)
+    {
+        seed     = seed * 1103515245 + 12345;
+        m_xyz[v] = (int8_t)((int32_t)((seed >> 16) & 0x3F) - 32);
+    }
+    print("uniform noise", SAMPLES_MAX);
+    return 0;
+}
@@ -0,0 +1,154 @@
+/* Copyright (c) 2015 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+
+/* Delta coded blocks against the 6-bit packing, on the MMA7660 model replaying
+ * tests/traces/motion_30s.csv at the profile rates of the TWI list demo, and on uniform noise
+ * as the worst case: payload bytes per sample in the 16 sample batches of the binary stream,
+ * where a batch is only coded when that is shorter than packed, in 20 byte BLE notifications
+ * as sent by the BLE LED sensor demo, and host CPU time per sample to code. The host time only
+ * ranks the cases, it is not the nRF52 time. */
+
+#include "sim.h"
+#include "sim_mma7660.h"
+#include "mma7660.h"
+#include "sample_codec.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#define TRACE_PATH     "traces/motion_30s.csv"
+#define TRACE_MAX      2000
+#define SAMPLES_MAX    3600
+#define BATCH_SAMPLES  16
+#define PACKED_SIZE    ((18 * BATCH_SAMPLES + 7) / 8)
+#define NOTIFY_SIZE    20  // BLE_LSS_MAX_DATA_LEN with the default ATT MTU.
+#define PASSES         200
+
+static sim_mma7660_sample_t m_trace[TRACE_MAX];
+static uint8_t              m_xyz[3 * SAMPLES_MAX];
+
+static uint64_t cpu_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+// Raw register values of the trace at hz.
+static uint32_t trace_samples(uint32_t length, uint32_t hz)
+{
+    sim_mma7660_t sensor;
+    uint64_t      t = 0;
+    uint32_t      count = 0;
+
+    sim_reset();
+    sim_mma7660_init(&sensor, m_trace, length, 0);
+    sensor.running = true;
+    while ((count < SAMPLES_MAX) && (t + 1000000000ULL / hz < m_trace[length - 1].t_ns))
+    {
+        t += 1000000000ULL / hz;
+        sim_mma7660_advance(&sensor, t);
+        memcpy(&m_xyz[3 * count], &sensor.regs[MMA7660_X], 3);
+        count++;
+    }
+    return count;
+}
+
+// Payload bytes of the stream batches, coded as sample_stream.c does: a length byte and the
+// block when the whole batch fits in less than the packed size, packed otherwise.
+static uint32_t stream_bytes(uint32_t count, uint32_t * p_coded_batches)
+{
+    uint8_t  block[PACKED_SIZE];
+    uint32_t bytes = 0;
+
+    *p_coded_batches = 0;
+    for (uint32_t i = 0; i + BATCH_SAMPLES <= count; i += BATCH_SAMPLES)
+    {
+        uint32_t length;
+
+        if (sample_codec_encode(block, PACKED_SIZE - 1, &length, &m_xyz[3 * i], BATCH_SAMPLES) == BATCH_SAMPLES)
+        {
+            bytes += 1 + length;
+            (*p_coded_batches)++;
+        }
+        else
+        {
+            bytes += PACKED_SIZE;
+        }
+    }
+    return bytes;
+}
+
+// Notification bytes and count, each notification carrying as many samples as fit.
+static uint32_t notify_bytes(uint32_t count, uint32_t * p_notifications)
+{
+    uint8_t  block[NOTIFY_SIZE];
+    uint32_t bytes = 0;
+    uint32_t i = 0;
+
+    *p_notifications = 0;
+    while (i < count)
+    {
+        uint32_t length;
+
+        i     += sample_codec_encode(block, sizeof(block), &length, &m_xyz[3 * i], count - i);
+        bytes += length;
+        (*p_notifications)++;
+    }
+    return bytes;
+}
+
+static void run(char const * p_name, uint32_t count)
+{
+    uint32_t coded_batches;
+    uint32_t notifications;
+    uint32_t batches = count / BATCH_SAMPLES;
+    uint32_t stream  = stream_bytes(count, &coded_batches);
+    uint32_t notify  = notify_bytes(count, &notifications);
+    uint64_t t0      = cpu_ns();
+
+    for (uint32_t pass = 0; pass < PASSES; pass++)
+    {
+        (void)stream_bytes(count, &coded_batches);
+    }
+    printf("%-14s%8u%10.2f%10.2f%9u/%-4u%10.2f%9.1f%14.1f\n", p_name, (unsigned)count,
+           (double)PACKED_SIZE / BATCH_SAMPLES, (double)stream / (batches * BATCH_SAMPLES),
+           (unsigned)coded_batches, (unsigned)batches, (double)notify / count,
+           (double)count / notifications, (double)(cpu_ns() - t0) / PASSES / (batches * BATCH_SAMPLES));
+}
+
+int main(void)
+{
+    static const uint32_t rates[] = {120, 32, 8};
+    uint32_t length = sim_mma7660_trace_load(TRACE_PATH, m_trace, TRACE_MAX, 0);
+    uint32_t seed = 1;
+    char     name[16];
+
+    printf("%-14s%8s%10s%10s%14s%10s%9s%14s\n", "", "samples", "packed", "stream", "coded",
+           "notify", "per BLE", "host ns");
+    printf("%-14s%8s%10s%10s%14s%10s%9s%14s\n", "", "", "B/sample", "B/sample", "batches",
+           "B/sample", "samples", "/sample");
+    for (uint32_t r = 0; r < sizeof(rates) / sizeof(rates[0]); r++)
+    {
+        snprintf(name, sizeof(name), "trace %u Hz", (unsigned)rates[r]);
+        run(name, trace_samples(length, rates[r]));
+    }
+    for (uint32_t v = 0; v < sizeof(m_xyz); v++)
+    {
+        seed     = seed * 1103515245 + 12345;
+        m_xyz[v] = (uint8_t)(seed >> 16);
+    }
+    run("uniform noise", SAMPLES_MAX);
+    return 0;
+}
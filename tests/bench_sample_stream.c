@@ -0,0 +1,134 @@
+/* Copyright (c) 2015 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+
+/* Binary frames against the text lines of the TWI list demo, on the batches of the MMA7660
+ * model replaying tests/traces/motion_30s.csv: bytes per sample, line time at 460800 baud and
+ * host CPU time per sample to build the output. The host time only ranks the two, it is not
+ * the nRF52 time. */
+
+#include "sim.h"
+#include "sim_mma7660.h"
+#include "mma7660.h"
+#include "sample_stream.h"
+#include "nrf_error.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#define TRACE_PATH     "traces/motion_30s.csv"
+#define TRACE_MAX      2000
+#define BATCH_SAMPLES  16
+#define BATCH_MAX      256
+#define SAMPLE_NS      (1000000000ULL / 120)
+#define PASSES         200
+#define LINE_BPS       453125.0 // Actual rate of the 460800 setting.
+
+static sim_mma7660_sample_t m_trace[TRACE_MAX];
+static sim_mma7660_t        m_sensor;
+static uint8_t              m_batches[BATCH_MAX][3 * BATCH_SAMPLES];
+static uint32_t             m_batch_count;
+static uint8_t              m_capture[64 * 1024];
+static char                 m_text[1024];
+
+static uint64_t cpu_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+// The text output of batch_process in main.c, into a buffer instead of app_uart.
+static uint32_t text_format(char * p_out, uint8_t const * p_batch)
+{
+    uint32_t length = 0;
+
+    for (uint32_t i = 0; i < BATCH_SAMPLES; i++)
+    {
+        int8_t xyz[3];
+
+        (void)mma7660_decode(xyz, &p_batch[3 * i], 3);
+        length += (uint32_t)sprintf(&p_out[length], "%4i %4i %4i \n\r", xyz[0], xyz[1], xyz[2]);
+    }
+    return length;
+}
+
+int main(void)
+{
+    uint32_t length = sim_mma7660_trace_load(TRACE_PATH, m_trace, TRACE_MAX, 0);
+    uint64_t t = 0;
+    uint64_t binary_ns;
+    uint64_t text_ns;
+    uint64_t t0;
+    uint32_t text_bytes = 0;
+    uint32_t samples;
+
+    sim_reset();
+    sim_mma7660_init(&m_sensor, m_trace, length, 0);
+    m_sensor.running = true;
+    while ((m_batch_count < BATCH_MAX) && (t + BATCH_SAMPLES * SAMPLE_NS < m_trace[length - 1].t_ns))
+    {
+        for (uint32_t i = 0; i < BATCH_SAMPLES; i++)
+        {
+            t += SAMPLE_NS;
+            sim_mma7660_advance(&m_sensor, t);
+            memcpy(&m_batches[m_batch_count][3 * i], &m_sensor.regs[MMA7660_X], 3);
+        }
+        m_batch_count++;
+    }
+    samples = m_batch_count * BATCH_SAMPLES;
+
+    // Binary, once on the simulated line for the size, then timed with ENDTX set by hand.
+    sim_reset();
+    sim_uarte_capture(m_capture, sizeof(m_capture));
+    sample_stream_init(6, 5, 7, true);
+    for (uint32_t b = 0; b < m_batch_count; b++)
+    {
+        SIM_CHECK_EQ(sample_stream_send(m_batches[b], BATCH_SAMPLES, b), NRF_SUCCESS);
+        sim_run(2000000);
+    }
+    t0 = cpu_ns();
+    for (uint32_t pass = 0; pass < PASSES; pass++)
+    {
+        for (uint32_t b = 0; b < m_batch_count; b++)
+        {
+            NRF_UARTE0->EVENTS_ENDTX = 1;
+            (void)sample_stream_send(m_batches[b], BATCH_SAMPLES, b);
+        }
+    }
+    binary_ns = cpu_ns() - t0;
+    SIM_CHECK_EQ(sample_stream_dropped_get(), 0);
+
+    t0 = cpu_ns();
+    for (uint32_t pass = 0; pass < PASSES; pass++)
+    {
+        text_bytes = 0;
+        for (uint32_t b = 0; b < m_batch_count; b++)
+        {
+            text_bytes += text_format(m_text, m_batches[b]);
+        }
+    }
+    text_ns = cpu_ns() - t0;
+
+    printf("%u samples in batches of %u      bytes/sample   line us/sample   host ns/sample\n",
+           (unsigned)samples, BATCH_SAMPLES);
+    printf("binary frames%24.2f%17.1f%17.1f\n",
+           (double)sim_uarte_captured() / samples,
+           10e6 * sim_uarte_captured() / LINE_BPS / samples,
+           (double)binary_ns / PASSES / samples);
+    printf("printf lines %24.2f%17.1f%17.1f\n",
+           (double)text_bytes / samples,
+           10e6 * text_bytes / LINE_BPS / samples,
+           (double)text_ns / PASSES / samples);
+    return 0;
+}
@@ -0,0 +1,1860 @@
+/* Copyright (c) 2015 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+#include "sim.h"
+#include "nrf_twim.h"
+#include "nrf_twi.h"
+#include "nrf_gpio.h"
+#include "nrf_delay.h"
+#include "nrf_drv_common.h"
+#include "nrf_drv_ppi.h"
+#include "nrf_assert.h"
+#include "app_util_platform.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define NS_NEVER          UINT64_MAX
+
+#define REG(p_mem, offset) (((uint32_t *)(p_mem))[(offset) / 4])
+
+// Register offsets shared by TWIM and TWI.
+#define TWI_TASK_STARTRX  0x000
+#define TWI_TASK_STARTTX  0x008
+#define TWI_TASK_STOP     0x014
+#define TWI_TASK_SUSPEND  0x01C
+#define TWI_TASK_RESUME   0x020
+#define TWI_EVT_STOPPED   0x104
+#define TWI_EVT_RXDREADY  0x108
+#define TWI_EVT_TXDSENT   0x11C
+#define TWI_EVT_ERROR     0x124
+#define TWI_EVT_BB        0x138
+#define TWI_EVT_SUSPENDED 0x148
+#define TWI_EVT_RXSTARTED 0x14C
+#define TWI_EVT_TXSTARTED 0x150
+#define TWI_EVT_LASTRX    0x15C
+#define TWI_EVT_LASTTX    0x160
+#define TWI_SHORTS        0x200
+#define TWI_INTEN         0x300
+#define TWI_ERRORSRC      0x4C4
+#define TWI_ENABLE        0x500
+#define TWI_PSEL_SCL      0x508
+#define TWI_PSEL_SDA      0x50C
+#define TWI_RXD           0x518
+#define TWI_TXD           0x51C
+#define TWI_FREQUENCY     0x524
+#define TWI_ADDRESS       0x588
+
+#define PPI_CHANNELS      20
+#define NVIC_LINES        32
+#define STACK_SIZE        (8UL << 20)
+
+typedef enum
+{
+    BUS_IDLE,      // Bus released.
+    BUS_ACTIVE,    // A phase is on the bus.
+    BUS_HELD,      // Bus owned after a transfer without STOP, or legacy TX waiting for TXD.
+    BUS_SUSPENDED,
+    BUS_ERROR,     // NACK received, waits for STOP.
+} bus_state_t;
+
+typedef enum
+{
+    PHASE_NONE,
+    PHASE_ADDRESS,
+    PHASE_BYTE,
+    PHASE_STOP,
+} bus_phase_t;
+
+typedef struct
+{
+    uint32_t *      p_mem;
+    sim_slave_t *   p_slaves;
+    sim_slave_t *   p_active;       // Slave addressed by the current transfer.
+    bus_state_t     state;
+    bus_phase_t     phase;
+    uint64_t        phase_end;
+    uint64_t        busy_since;
+    bool            read;
+    bool            stop_req;
+    bool            suspend_req;
+    int8_t          pending_start;  // -1 none, 0 STARTTX, 1 STARTRX, taken when the bus is free.
+    uint8_t *       p_txd;          // TWIM EasyDMA pointers, full width.
+    uint8_t *       p_rxd;
+    uint32_t        amount;         // Bytes of the current TWIM transfer.
+    uint8_t         txd;            // Legacy TWI registers.
+    bool            txd_full;
+    uint8_t         rxd;
+    uint32_t        nack_faults;
+    uint32_t        stuck_pulses;
+    sim_bus_stats_t stats;
+} sim_bus_t;
+
+typedef struct
+{
+    bool     running;
+    uint64_t t0;       // Time of the last start or clear.
+    uint32_t base;     // Counter value at t0.
+} sim_timer_t;
+
+typedef struct
+{
+    uint32_t eep;
+    uint32_t tep;
+    bool     allocated;
+    bool     enabled;
+} sim_ppi_t;
+
+uint32_t sim_periph_mem[SIM_PERIPH_COUNT][1024] __attribute__((aligned(4096)));
+
+static uint32_t       m_nvic_mem[0x200 / 4];
+static uint32_t       m_scb_mem[1];
+static uint32_t       m_dwt_mem[2];
+static uint32_t       m_coredebug_mem[1];
+
+NVIC_Type * const      NVIC      = (NVIC_Type *)m_nvic_mem;
+SCB_Type * const       SCB       = (SCB_Type *)m_scb_mem;
+DWT_Type * const       DWT       = (DWT_Type *)m_dwt_mem;
+CoreDebug_Type * const CoreDebug = (CoreDebug_Type *)m_coredebug_mem;
+
+extern void SPI0_TWI0_IRQHandler(void) __attribute__((weak));
+extern void SPI1_TWI1_IRQHandler(void) __attribute__((weak));
+
+static uint64_t        m_now;
+static sim_bus_t       m_bus[SIM_BUS_COUNT];
+static sim_timer_t     m_timer[5];
+static sim_ppi_t       m_ppi[PPI_CHANNELS];
+static uint32_t        m_pending;
+static bool            m_event_reg;
+static bool            m_in_isr;
+static uint32_t        m_mask_depth;
+static bool            m_wfe_disabled;
+static uint32_t        m_gpio_out;
+static uint32_t        m_dma_stack;
+static uintptr_t       m_stack_top;
+static sim_cpu_stats_t m_cpu;
+static bool            m_scanning;
+static uint64_t        m_uarte_end;      // End of the UARTE TX transfer on the line.
+static uint8_t *       mp_uarte_capture;
+static uint32_t        m_uarte_capture_size;
+static uint32_t        m_uarte_captured;
+
+static void advance_to(uint64_t t);
+static void tasks_scan(void);
+
+void sim_fail(char const * p_format, ...)
+{
+    va_list args;
+
+    fflush(stdout);
+    fprintf(stderr, "FAIL at %llu ns: ", (unsigned long long)m_now);
+    va_start(args, p_format);
+    vfprintf(stderr, p_format, args);
+    va_end(args);
+    fprintf(stderr, "\n");
+    exit(1);
+}
+
+void assert_nrf_callback(uint16_t line_num, const uint8_t * file_name)
+{
+    sim_fail("ASSERT at %s:%u", (char const *)file_name, line_num);
+}
+
+/* ---------------------------------------------------------------------------------------------
+ * CPU, NVIC and WFE
+ */
+
+static int periph_index(void const * p_reg)
+{
+    uintptr_t offset = (uintptr_t)p_reg - (uintptr_t)sim_periph_mem;
+
+    if (offset >= sizeof(sim_periph_mem))
+    {
+        return -1;
+    }
+    return (int)(offset / sizeof(sim_periph_mem[0]));
+}
+
+static bool event_word(uint32_t const * p_mem, uint32_t bit)
+{
+    return p_mem[(0x100 / 4) + bit] != 0;
+}
+
+static bool twi_line(uint32_t const * p_mem)
+{
+    uint32_t inten = p_mem[TWI_INTEN / 4];
+
+    for (uint32_t bit = 0; inten != 0; bit++, inten >>= 1)
+    {
+        if ((inten & 1) && event_word(p_mem, bit))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Latch the TWI interrupt lines into the NVIC pending bits.
+ *
+ * A line that is up makes its interrupt pending again as soon as the bit is cleared, like the
+ * level interrupts of the nRF52 peripherals. With SEVONPEND a new pending bit is a WFE wake-up.
+ */
+static void pending_update(void)
+{
+    static IRQn_Type const irqn[SIM_BUS_COUNT] = { SPI0_TWI0_IRQn, SPI1_TWI1_IRQn };
+
+    for (uint32_t i = 0; i < SIM_BUS_COUNT; i++)
+    {
+        if (twi_line(m_bus[i].p_mem))
+        {
+            uint32_t bit = 1UL << irqn[i];
+
+            if (!(m_pending & bit))
+            {
+                m_pending |= bit;
+                if (SCB->SCR & SCB_SCR_SEVONPEND_Msk)
+                {
+                    m_event_reg = true;
+                }
+            }
+        }
+    }
+    NVIC->ISPR[0] = m_pending;
+    NVIC->ICPR[0] = m_pending;
+}
+
+static void cpu_spend(uint64_t ns)
+{
+    m_cpu.active_ns += ns;
+    if (m_in_isr)
+    {
+        m_cpu.isr_ns += ns;
+    }
+    advance_to(m_now + ns);
+}
+
+static void dispatch(void)
+{
+    while (!m_in_isr && (m_mask_depth == 0))
+    {
+        uint32_t ready;
+        uint32_t irqn;
+
+        pending_update();
+        ready = m_pending & NVIC->ISER[0];
+        if (ready == 0)
+        {
+            return;
+        }
+        irqn = (uint32_t)__builtin_ctz(ready);
+        m_pending &= ~(1UL << irqn);
+        m_in_isr   = true;
+        m_event_reg = true;
+        m_cpu.isr_count++;
+        cpu_spend(SIM_ISR_NS);
+        if ((irqn == SPI0_TWI0_IRQn) && SPI0_TWI0_IRQHandler)
+        {
+            SPI0_TWI0_IRQHandler();
+        }
+        else if ((irqn == SPI1_TWI1_IRQn) && SPI1_TWI1_IRQHandler)
+        {
+            SPI1_TWI1_IRQHandler();
+        }
+        else
+        {
+            sim_fail("no handler for IRQ %u", (unsigned)irqn);
+        }
+        m_in_isr = false;
+        // Tasks the handler triggered by a plain register write, without a HAL call after it.
+        tasks_scan();
+    }
+}
+
+// One register access of the CPU, interrupts may be taken after it.
+static void sim_access(void)
+{
+    cpu_spend(SIM_ACCESS_NS);
+    tasks_scan();
+    dispatch();
+}
+
+static void irq_set(uint32_t irqn, bool enable)
+{
+    if (irqn >= NVIC_LINES)
+    {
+        return;
+    }
+    if (enable)
+    {
+        NVIC->ISER[0] |= 1UL << irqn;
+    }
+    else
+    {
+        NVIC->ISER[0] &= ~(1UL << irqn);
+    }
+    NVIC->ICER[0] = NVIC->ISER[0];
+}
+
+void NVIC_EnableIRQ(IRQn_Type irqn)
+{
+    irq_set((uint32_t)irqn, true);
+    sim_access();
+}
+
+void NVIC_DisableIRQ(IRQn_Type irqn)
+{
+    irq_set((uint32_t)irqn, false);
+    sim_access();
+}
+
+void NVIC_SetPendingIRQ(IRQn_Type irqn)
+{
+    m_pending |= 1UL << irqn;
+    sim_access();
+}
+
+void NVIC_ClearPendingIRQ(IRQn_Type irqn)
+{
+    m_pending &= ~(1UL << irqn);
+    pending_update();
+    sim_access();
+}
+
+uint32_t NVIC_GetPendingIRQ(IRQn_Type irqn)
+{
+    pending_update();
+    return (m_pending >> irqn) & 1;
+}
+
+void NVIC_SetPriority(IRQn_Type irqn, uint32_t priority)
+{
+    (void)irqn;
+    (void)priority;
+}
+
+void nrf_drv_common_irq_enable(IRQn_Type irqn, uint8_t priority)
+{
+    NVIC_SetPriority(irqn, priority);
+    NVIC_ClearPendingIRQ(irqn);
+    NVIC_EnableIRQ(irqn);
+}
+
+void nrf_drv_common_irq_disable(IRQn_Type irqn)
+{
+    NVIC_DisableIRQ(irqn);
+}
+
+IRQn_Type nrf_drv_get_IRQn(void const * const p_reg)
+{
+    static IRQn_Type const irqn[SIM_PERIPH_COUNT] = {
+        SPI0_TWI0_IRQn, SPI1_TWI1_IRQn, TIMER0_IRQn, TIMER1_IRQn,
+        TIMER2_IRQn, TIMER3_IRQn, TIMER4_IRQn, GPIOTE_IRQn, UARTE0_UART0_IRQn,
+    };
+    int index = periph_index(p_reg);
+
+    if (index < 0)
+    {
+        sim_fail("nrf_drv_get_IRQn: %p is not a peripheral", p_reg);
+    }
+    return irqn[index];
+}
+
+bool nrf_drv_is_in_RAM(void const * const ptr)
+{
+    // Also a point where the caller can be preempted, like any other call into the SDK.
+    sim_access();
+    return ptr != NULL;
+}
+
+void sim_critical_region_enter(void)
+{
+    m_mask_depth++;
+}
+
+void sim_critical_region_exit(void)
+{
+    ASSERT(m_mask_depth != 0);
+    if (--m_mask_depth == 0)
+    {
+        dispatch();
+    }
+}
+
+void __disable_irq(void)
+{
+    m_mask_depth++;
+}
+
+void __enable_irq(void)
+{
+    sim_critical_region_exit();
+}
+
+void __DMB(void)
+{
+    sim_access();
+}
+
+void __SEV(void)
+{
+    m_event_reg = true;
+    sim_access();
+}
+
+static uint64_t next_deadline(void);
+
+void __WFE(void)
+{
+    sim_access();
+    if (m_wfe_disabled)
+    {
+        return;
+    }
+    m_cpu.wfe_count++;
+    if (m_event_reg)
+    {
+        m_event_reg = false;
+        return;
+    }
+    for (;;)
+    {
+        uint64_t next = next_deadline();
+
+        if (next == NS_NEVER)
+        {
+            sim_fail("WFE with nothing left to wake the CPU up");
+        }
+        m_cpu.sleep_ns += next - m_now;
+        advance_to(next);
+        tasks_scan();
+        pending_update();
+        dispatch();
+        if (m_event_reg)
+        {
+            m_event_reg = false;
+            return;
+        }
+    }
+}
+
+void nrf_delay_us(uint32_t number_of_us)
+{
+    sim_cpu((uint64_t)number_of_us * 1000);
+}
+
+void nrf_delay_ms(uint32_t number_of_ms)
+{
+    sim_cpu((uint64_t)number_of_ms * 1000000);
+}
+
+/* ---------------------------------------------------------------------------------------------
+ * PPI
+ */
+
+static void event_raise(uint32_t * p_event)
+{
+    *p_event = 1;
+    for (uint32_t i = 0; i < PPI_CHANNELS; i++)
+    {
+        if (m_ppi[i].enabled && (m_ppi[i].eep == (uint32_t)(uintptr_t)p_event) && (m_ppi[i].tep != 0))
+        {
+            *(volatile uint32_t *)(uintptr_t)m_ppi[i].tep = 1;
+        }
+    }
+}
+
+uint32_t nrf_drv_ppi_init(void)
+{
+    return NRF_SUCCESS;
+}
+
+uint32_t nrf_drv_ppi_channel_alloc(nrf_ppi_channel_t * p_channel)
+{
+    for (uint32_t i = 0; i < PPI_CHANNELS; i++)
+    {
+        if (!m_ppi[i].allocated)
+        {
+            m_ppi[i]   = (sim_ppi_t){ .allocated = true };
+            *p_channel = (nrf_ppi_channel_t)i;
+            return NRF_SUCCESS;
+        }
+    }
+    return NRF_ERROR_NO_MEM;
+}
+
+uint32_t nrf_drv_ppi_channel_free(nrf_ppi_channel_t channel)
+{
+    m_ppi[channel] = (sim_ppi_t){ 0 };
+    return NRF_SUCCESS;
+}
+
+uint32_t nrf_drv_ppi_channel_assign(nrf_ppi_channel_t channel, uint32_t eep, uint32_t tep)
+{
+    ASSERT(m_ppi[channel].allocated);
+    m_ppi[channel].eep = eep;
+    m_ppi[channel].tep = tep;
+    return NRF_SUCCESS;
+}
+
+uint32_t nrf_drv_ppi_channel_enable(nrf_ppi_channel_t channel)
+{
+    ASSERT(m_ppi[channel].allocated);
+    m_ppi[channel].enabled = true;
+    return NRF_SUCCESS;
+}
+
+uint32_t nrf_drv_ppi_channel_disable(nrf_ppi_channel_t channel)
+{
+    m_ppi[channel].enabled = false;
+    return NRF_SUCCESS;
+}
+
+/* ---------------------------------------------------------------------------------------------
+ * TWI bus engine, shared by the TWIM and the legacy TWI model.
+ */
+
+static bool bus_is_twim(sim_bus_t const * p_bus)
+{
+    return REG(p_bus->p_mem, TWI_ENABLE) == TWIM_ENABLE_ENABLE_Enabled;
+}
+
+static bool bus_is_enabled(sim_bus_t const * p_bus)
+{
+    return REG(p_bus->p_mem, TWI_ENABLE) != 0;
+}
+
+static uint64_t bit_ns(sim_bus_t const * p_bus)
+{
+    switch (REG(p_bus->p_mem, TWI_FREQUENCY))
+    {
+        case TWIM_FREQUENCY_FREQUENCY_K250:
+            return 4000;
+        case TWIM_FREQUENCY_FREQUENCY_K400:
+        case NRF_TWI_FREQ_400K:
+            return 2500;
+        default:
+            return 10000;
+    }
+}
+
+static void bus_event(sim_bus_t * p_bus, uint32_t offset)
+{
+    event_raise(&REG(p_bus->p_mem, offset));
+}
+
+static void phase_start(sim_bus_t * p_bus, bus_phase_t phase, uint32_t bits)
+{
+    p_bus->state     = BUS_ACTIVE;
+    p_bus->phase     = phase;
+    p_bus->phase_end = m_now + bits * bit_ns(p_bus);
+}
+
+static void dma_check(void const * p)
+{
+    uintptr_t address = (uintptr_t)p;
+
+    if ((address < m_stack_top + 0x10000) && (address > m_stack_top - STACK_SIZE))
+    {
+        m_dma_stack++;
+    }
+}
+
+static void transfer_begin(sim_bus_t * p_bus, bool read)
+{
+    if (p_bus->busy_since == NS_NEVER)
+    {
+        p_bus->busy_since = m_now;
+    }
+    p_bus->read          = read;
+    p_bus->amount        = 0;
+    p_bus->pending_start = -1;
+    if (bus_is_twim(p_bus))
+    {
+        REG(p_bus->p_mem, read ? 0x534 + 8 : 0x544 + 8) = 0;
+        bus_event(p_bus, read ? TWI_EVT_RXSTARTED : TWI_EVT_TXSTARTED);
+    }
+    // START or repeated START, the address and the ACK bit.
+    phase_start(p_bus, PHASE_ADDRESS, 10);
+}
+
+static void stop_begin(sim_bus_t * p_bus)
+{
+    p_bus->stop_req    = false;
+    p_bus->suspend_req = false;
+    phase_start(p_bus, PHASE_STOP, 2);
+}
+
+static void bus_error(sim_bus_t * p_bus, uint32_t errorsrc)
+{
+    REG(p_bus->p_mem, TWI_ERRORSRC) |= errorsrc;
+    p_bus->state = BUS_ERROR;
+    p_bus->phase = PHASE_NONE;
+    bus_event(p_bus, TWI_EVT_ERROR);
+}
+
+static void bus_start_task(sim_bus_t * p_bus, bool read)
+{
+    if (!bus_is_enabled(p_bus))
+    {
+        return;
+    }
+    switch (p_bus->state)
+    {
+        case BUS_IDLE:
+        case BUS_HELD:
+            transfer_begin(p_bus, read);
+            break;
+        case BUS_ACTIVE:
+        case BUS_SUSPENDED:
+            // Taken when the current phase is over or after RESUME.
+            p_bus->pending_start = read ? 1 : 0;
+            break;
+        default:
+            break;
+    }
+}
+
+// Bus owned and nothing on it: a start task given meanwhile goes now.
+static void bus_hold(sim_bus_t * p_bus)
+{
+    p_bus->state = BUS_HELD;
+    p_bus->phase = PHASE_NONE;
+    if (p_bus->pending_start >= 0)
+    {
+        transfer_begin(p_bus, p_bus->pending_start == 1);
+    }
+}
+
+static void bus_suspend(sim_bus_t * p_bus)
+{
+    p_bus->suspend_req = false;
+    p_bus->state       = BUS_SUSPENDED;
+    p_bus->phase       = PHASE_NONE;
+    bus_event(p_bus, TWI_EVT_SUSPENDED);
+}
+
+static void bus_task(sim_bus_t * p_bus, uint32_t task)
+{
+    switch (task)
+    {
+        case TWI_TASK_STARTTX:
+            bus_start_task(p_bus, false);
+            break;
+        case TWI_TASK_STARTRX:
+            bus_start_task(p_bus, true);
+            break;
+        case TWI_TASK_STOP:
+            if (p_bus->state == BUS_ACTIVE)
+            {
+                if (p_bus->phase != PHASE_STOP)
+                {
+                    p_bus->stop_req = true;
+                }
+            }
+            else if (p_bus->state != BUS_IDLE)
+            {
+                stop_begin(p_bus);
+            }
+            break;
+        case TWI_TASK_SUSPEND:
+            if (p_bus->state == BUS_ACTIVE)
+            {
+                p_bus->suspend_req = true;
+            }
+            else if (p_bus->state == BUS_HELD)
+            {
+                bus_suspend(p_bus);
+            }
+            break;
+        case TWI_TASK_RESUME:
+            if (p_bus->state != BUS_SUSPENDED)
+            {
+                break;
+            }
+            if (!bus_is_twim(p_bus) && p_bus->read)
+            {
+                // Legacy TWI suspended between two received bytes.
+                phase_start(p_bus, PHASE_BYTE, 9);
+            }
+            else if (!bus_is_twim(p_bus) && p_bus->txd_full && (p_bus->p_active != NULL))
+            {
+                phase_start(p_bus, PHASE_BYTE, 9);
+            }
+            else
+            {
+                bus_hold(p_bus);
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+static sim_slave_t * slave_find(sim_bus_t * p_bus, uint8_t address)
+{
+    for (sim_slave_t * p_slave = p_bus->p_slaves; p_slave != NULL; p_slave = p_slave->p_next)
+    {
+        if (p_slave->address == address)
+        {
+            return p_slave;
+        }
+    }
+    return NULL;
+}
+
+static bool address_phase(sim_bus_t * p_bus)
+{
+    sim_slave_t * p_slave = slave_find(p_bus, (uint8_t)REG(p_bus->p_mem, TWI_ADDRESS));
+    bool          ack;
+
+    p_bus->stats.starts++;
+    if ((p_bus->stuck_pulses != 0) || (p_bus->nack_faults != 0))
+    {
+        if (p_bus->nack_faults != 0)
+        {
+            p_bus->nack_faults--;
+        }
+        ack = false;
+    }
+    else
+    {
+        ack = (p_slave != NULL) && p_slave->start(p_slave, p_bus->read, m_now);
+    }
+    p_bus->p_active = ack ? p_slave : NULL;
+    if (!ack)
+    {
+        p_bus->stats.address_nacks++;
+    }
+    return ack;
+}
+
+static void twim_tx_done(sim_bus_t * p_bus)
+{
+    uint32_t shorts = REG(p_bus->p_mem, TWI_SHORTS);
+
+    if (REG(p_bus->p_mem, 0x544 + 12))
+    {
+        p_bus->p_txd += REG(p_bus->p_mem, 0x544 + 4);
+        REG(p_bus->p_mem, 0x544) = (uint32_t)(uintptr_t)p_bus->p_txd;
+    }
+    bus_event(p_bus, TWI_EVT_LASTTX);
+    if (shorts & NRF_TWIM_SHORT_LASTTX_STARTRX_MASK)
+    {
+        transfer_begin(p_bus, true);
+    }
+    else if (shorts & NRF_TWIM_SHORT_LASTTX_SUSPEND_MASK)
+    {
+        bus_suspend(p_bus);
+    }
+    else if ((shorts & NRF_TWIM_SHORT_LASTTX_STOP_MASK) || p_bus->stop_req)
+    {
+        stop_begin(p_bus);
+    }
+    else
+    {
+        bus_hold(p_bus);
+    }
+}
+
+static void twim_rx_done(sim_bus_t * p_bus)
+{
+    uint32_t shorts = REG(p_bus->p_mem, TWI_SHORTS);
+
+    if (REG(p_bus->p_mem, 0x534 + 12))
+    {
+        p_bus->p_rxd += REG(p_bus->p_mem, 0x534 + 4);
+        REG(p_bus->p_mem, 0x534) = (uint32_t)(uintptr_t)p_bus->p_rxd;
+    }
+    bus_event(p_bus, TWI_EVT_LASTRX);
+    if (shorts & NRF_TWIM_SHORT_LASTRX_STARTTX_MASK)
+    {
+        transfer_begin(p_bus, false);
+    }
+    else if ((shorts & NRF_TWIM_SHORT_LASTRX_STOP_MASK) || p_bus->stop_req)
+    {
+        stop_begin(p_bus);
+    }
+    else
+    {
+        bus_hold(p_bus);
+    }
+}
+
+// The next TWIM byte, or the end of the transfer.
+static void twim_next(sim_bus_t * p_bus)
+{
+    uint32_t maxcnt = REG(p_bus->p_mem, (p_bus->read ? 0x534 : 0x544) + 4);
+
+    if (p_bus->amount == maxcnt)
+    {
+        if (p_bus->read)
+        {
+            twim_rx_done(p_bus);
+        }
+        else
+        {
+            twim_tx_done(p_bus);
+        }
+    }
+    else if (p_bus->stop_req)
+    {
+        stop_begin(p_bus);
+    }
+    else if (p_bus->suspend_req)
+    {
+        bus_suspend(p_bus);
+    }
+    else
+    {
+        phase_start(p_bus, PHASE_BYTE, 9);
+    }
+}
+
+static void twim_byte_done(sim_bus_t * p_bus)
+{
+    sim_slave_t * p_slave = p_bus->p_active;
+
+    if (p_bus->read)
+    {
+        uint32_t maxcnt = REG(p_bus->p_mem, 0x534 + 4);
+        bool     last   = (p_bus->amount + 1 == maxcnt);
+        uint8_t  data   = p_slave->read(p_slave, !last, m_now);
+
+        dma_check(&p_bus->p_rxd[p_bus->amount]);
+        p_bus->p_rxd[p_bus->amount] = data;
+        p_bus->amount++;
+        REG(p_bus->p_mem, 0x534 + 8) = p_bus->amount;
+        p_bus->stats.bytes++;
+    }
+    else
+    {
+        uint8_t data;
+
+        dma_check(&p_bus->p_txd[p_bus->amount]);
+        data = p_bus->p_txd[p_bus->amount];
+        p_bus->amount++;
+        REG(p_bus->p_mem, 0x544 + 8) = p_bus->amount;
+        p_bus->stats.bytes++;
+        if (!p_slave->write(p_slave, data, m_now))
+        {
+            p_bus->stats.data_nacks++;
+            bus_error(p_bus, NRF_TWIM_ERROR_DATA_NACK);
+            return;
+        }
+    }
+    twim_next(p_bus);
+}
+
+static void twi_byte_done(sim_bus_t * p_bus)
+{
+    sim_slave_t * p_slave = p_bus->p_active;
+    uint32_t      shorts  = REG(p_bus->p_mem, TWI_SHORTS);
+
+    p_bus->stats.bytes++;
+    if (p_bus->read)
+    {
+        bool last = (shorts & NRF_TWI_SHORT_BB_STOP_MASK) || p_bus->stop_req;
+
+        p_bus->rxd = p_slave->read(p_slave, !last, m_now);
+        REG(p_bus->p_mem, TWI_RXD) = p_bus->rxd;
+        bus_event(p_bus, TWI_EVT_BB);
+        bus_event(p_bus, TWI_EVT_RXDREADY);
+        if (last)
+        {
+            stop_begin(p_bus);
+        }
+        else if ((shorts & NRF_TWI_SHORT_BB_SUSPEND_MASK) || p_bus->suspend_req)
+        {
+            bus_suspend(p_bus);
+        }
+        else
+        {
+            phase_start(p_bus, PHASE_BYTE, 9);
+        }
+        return;
+    }
+
+    p_bus->txd_full = false;
+    if (!p_slave->write(p_slave, p_bus->txd, m_now))
+    {
+        p_bus->stats.data_nacks++;
+        bus_error(p_bus, NRF_TWI_ERROR_DATA_NACK);
+        return;
+    }
+    bus_event(p_bus, TWI_EVT_BB);
+    bus_event(p_bus, TWI_EVT_TXDSENT);
+    if ((shorts & NRF_TWI_SHORT_BB_STOP_MASK) || p_bus->stop_req)
+    {
+        stop_begin(p_bus);
+    }
+    else if ((shorts & NRF_TWI_SHORT_BB_SUSPEND_MASK) || p_bus->suspend_req)
+    {
+        bus_suspend(p_bus);
+    }
+    else if (p_bus->txd_full)
+    {
+        phase_start(p_bus, PHASE_BYTE, 9);
+    }
+    else
+    {
+        // Clock stretched until TXD is written.
+        p_bus->state = BUS_HELD;
+        p_bus->phase = PHASE_NONE;
+    }
+}
+
+static void phase_done(sim_bus_t * p_bus)
+{
+    bus_phase_t phase = p_bus->phase;
+
+    p_bus->phase = PHASE_NONE;
+    switch (phase)
+    {
+        case PHASE_ADDRESS:
+            if (!address_phase(p_bus))
+            {
+                bus_error(p_bus, NRF_TWIM_ERROR_ADDRESS_NACK);
+            }
+            else if (p_bus->stop_req)
+            {
+                stop_begin(p_bus);
+            }
+            else if (bus_is_twim(p_bus))
+            {
+                twim_next(p_bus);
+            }
+            else if (p_bus->read || p_bus->txd_full)
+            {
+                phase_start(p_bus, PHASE_BYTE, 9);
+            }
+            else
+            {
+                p_bus->state = BUS_HELD;
+            }
+            break;
+
+        case PHASE_BYTE:
+            if (bus_is_twim(p_bus))
+            {
+                twim_byte_done(p_bus);
+            }
+            else
+            {
+                twi_byte_done(p_bus);
+            }
+            break;
+
+        case PHASE_STOP:
+            if (p_bus->p_active && p_bus->p_active->stop)
+            {
+                p_bus->p_active->stop(p_bus->p_active, m_now);
+            }
+            p_bus->p_active = NULL;
+            p_bus->stats.stops++;
+            p_bus->stats.busy_ns += m_now - p_bus->busy_since;
+            p_bus->busy_since     = NS_NEVER;
+            p_bus->state          = BUS_IDLE;
+            bus_event(p_bus, TWI_EVT_STOPPED);
+            if (p_bus->pending_start >= 0)
+            {
+                transfer_begin(p_bus, p_bus->pending_start == 1);
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+
+static void bus_disable(sim_bus_t * p_bus)
+{
+    // The pins go back to GPIO, whatever was on the bus is cut off.
+    if (p_bus->busy_since != NS_NEVER)
+    {
+        p_bus->stats.busy_ns += m_now - p_bus->busy_since;
+        p_bus->busy_since     = NS_NEVER;
+    }
+    p_bus->state         = BUS_IDLE;
+    p_bus->phase         = PHASE_NONE;
+    p_bus->p_active      = NULL;
+    p_bus->stop_req      = false;
+    p_bus->suspend_req   = false;
+    p_bus->pending_start = -1;
+    p_bus->txd_full      = false;
+}
+
+/* ---------------------------------------------------------------------------------------------
+ * TIMER
+ */
+
+static NRF_TIMER_Type * timer_regs(uint32_t i)
+{
+    return (NRF_TIMER_Type *)sim_periph_mem[SIM_PERIPH_TIMER0 + i];
+}
+
+static uint32_t timer_mask(NRF_TIMER_Type const * p_regs)
+{
+    static uint32_t const masks[4] = { 0xFFFF, 0xFF, 0xFFFFFF, 0xFFFFFFFF };
+    return masks[p_regs->BITMODE & 3];
+}
+
+static uint32_t timer_counter(uint32_t i)
+{
+    NRF_TIMER_Type * p_regs = timer_regs(i);
+    sim_timer_t *    p_tim  = &m_timer[i];
+
+    if (!p_tim->running || (p_regs->MODE != TIMER_MODE_MODE_Timer))
+    {
+        return p_tim->base;
+    }
+    return (uint32_t)((p_tim->base + (((m_now - p_tim->t0) * 16 / 1000) >> p_regs->PRESCALER)) &
+                      timer_mask(p_regs));
+}
+
+// Time at which the counter reaches the next compare value, NS_NEVER if stopped.
+static uint64_t timer_deadline(uint32_t i, uint32_t * p_cc)
+{
+    NRF_TIMER_Type * p_regs = timer_regs(i);
+    sim_timer_t *    p_tim  = &m_timer[i];
+    uint64_t         best   = NS_NEVER;
+
+    if (!p_tim->running || (p_regs->MODE != TIMER_MODE_MODE_Timer))
+    {
+        return NS_NEVER;
+    }
+    for (uint32_t cc = 0; cc < 6; cc++)
+    {
+        uint64_t elapsed = ((m_now - p_tim->t0) * 16 / 1000) >> p_regs->PRESCALER;
+        uint64_t target  = (p_regs->CC[cc] - p_tim->base) & timer_mask(p_regs);
+        uint64_t t;
+
+        if (target <= elapsed)
+        {
+            target += (uint64_t)timer_mask(p_regs) + 1;
+        }
+        // First nanosecond at which the prescaled counter reaches the target.
+        t = p_tim->t0 + ((target << p_regs->PRESCALER) * 1000 + 15) / 16;
+        if (t < best)
+        {
+            best  = t;
+            *p_cc = cc;
+        }
+    }
+    return best;
+}
+
+static void timer_compare(uint32_t i, uint32_t cc)
+{
+    NRF_TIMER_Type * p_regs = timer_regs(i);
+    sim_timer_t *    p_tim  = &m_timer[i];
+
+    event_raise((uint32_t *)&p_regs->EVENTS_COMPARE[cc]);
+    if (p_regs->SHORTS & (1UL << cc))
+    {
+        p_tim->base = 0;
+        p_tim->t0   = m_now;
+    }
+    if (p_regs->SHORTS & (1UL << (cc + 8)))
+    {
+        p_tim->base    = timer_counter(i);
+        p_tim->running = false;
+    }
+    if (!(p_regs->SHORTS & (0x101UL << cc)))
+    {
+        // Not cleared nor stopped: step past the compare value.
+        p_tim->base = timer_counter(i);
+        p_tim->t0   = m_now;
+    }
+}
+
+static void timer_tasks(uint32_t i)
+{
+    NRF_TIMER_Type * p_regs = timer_regs(i);
+    sim_timer_t *    p_tim  = &m_timer[i];
+
+    if (p_regs->TASKS_STOP)
+    {
+        p_regs->TASKS_STOP = 0;
+        p_tim->base        = timer_counter(i);
+        p_tim->running     = false;
+    }
+    if (p_regs->TASKS_START)
+    {
+        p_regs->TASKS_START = 0;
+        if (!p_tim->running)
+        {
+            p_tim->running = true;
+            p_tim->t0      = m_now;
+        }
+    }
+    if (p_regs->TASKS_CLEAR)
+    {
+        p_regs->TASKS_CLEAR = 0;
+        p_tim->base         = 0;
+        p_tim->t0           = m_now;
+    }
+    if (p_regs->TASKS_COUNT)
+    {
+        p_regs->TASKS_COUNT = 0;
+        if (p_tim->running && (p_regs->MODE != TIMER_MODE_MODE_Timer))
+        {
+            p_tim->base = (p_tim->base + 1) & timer_mask(p_regs);
+            for (uint32_t cc = 0; cc < 6; cc++)
+            {
+                if (p_regs->CC[cc] == p_tim->base)
+                {
+                    timer_compare(i, cc);
+                }
+            }
+        }
+    }
+    for (uint32_t cc = 0; cc < 6; cc++)
+    {
+        if (p_regs->TASKS_CAPTURE[cc])
+        {
+            p_regs->TASKS_CAPTURE[cc] = 0;
+            p_regs->CC[cc]            = timer_counter(i);
+        }
+    }
+}
+
+/* ---------------------------------------------------------------------------------------------
+ * UARTE0, TX only: the bytes go to the capture buffer and ENDTX comes after their line time,
+ * 10 bits per byte.
+ */
+
+static void uarte_starttx(void)
+{
+    NRF_UARTE_Type * p_regs = NRF_UARTE0;
+    uint8_t const *  p_data = (uint8_t const *)(uintptr_t)p_regs->TXD.PTR;
+    uint64_t         bps    = ((uint64_t)p_regs->BAUDRATE * 16000000) >> 32;
+    uint32_t         count  = p_regs->TXD.MAXCNT;
+
+    if ((p_regs->ENABLE != UARTE_ENABLE_ENABLE_Enabled) || (bps == 0))
+    {
+        return;
+    }
+    if (m_uarte_end != NS_NEVER)
+    {
+        sim_fail("UARTE STARTTX while a transfer is on the line");
+    }
+    dma_check(p_data);
+    for (uint32_t i = 0; (i < count) && (m_uarte_captured < m_uarte_capture_size); i++)
+    {
+        mp_uarte_capture[m_uarte_captured++] = p_data[i];
+    }
+    m_uarte_end = m_now + (10ULL * count * 1000000000ULL + bps - 1) / bps;
+}
+
+static void uarte_endtx(void)
+{
+    m_uarte_end = NS_NEVER;
+    *(uint32_t *)&NRF_UARTE0->TXD.AMOUNT = NRF_UARTE0->TXD.MAXCNT;
+    event_raise((uint32_t *)&NRF_UARTE0->EVENTS_ENDTX);
+}
+
+void sim_uarte_capture(uint8_t * p_buf, uint32_t size)
+{
+    mp_uarte_capture     = p_buf;
+    m_uarte_capture_size = size;
+    m_uarte_captured     = 0;
+}
+
+uint32_t sim_uarte_captured(void)
+{
+    return m_uarte_captured;
+}
+
+/* ---------------------------------------------------------------------------------------------
+ * Time
+ */
+
+// Task registers written by the CPU or by PPI since the last scan.
+static void tasks_scan(void)
+{
+    static uint32_t const twi_tasks[] = {
+        TWI_TASK_STOP, TWI_TASK_SUSPEND, TWI_TASK_RESUME, TWI_TASK_STARTTX, TWI_TASK_STARTRX
+    };
+    bool found;
+
+    if (m_scanning)
+    {
+        return;
+    }
+    m_scanning = true;
+    do
+    {
+        found = false;
+        for (uint32_t i = 0; i < 5; i++)
+        {
+            uint32_t * p_words = (uint32_t *)timer_regs(i);
+
+            for (uint32_t w = 0; w < 0x58 / 4; w++)
+            {
+                if (p_words[w])
+                {
+                    timer_tasks(i);
+                    found = true;
+                    break;
+                }
+            }
+        }
+        for (uint32_t b = 0; b < SIM_BUS_COUNT; b++)
+        {
+            for (uint32_t t = 0; t < sizeof(twi_tasks) / sizeof(twi_tasks[0]); t++)
+            {
+                if (REG(m_bus[b].p_mem, twi_tasks[t]))
+                {
+                    REG(m_bus[b].p_mem, twi_tasks[t]) = 0;
+                    bus_task(&m_bus[b], twi_tasks[t]);
+                    found = true;
+                }
+            }
+        }
+        if (NRF_UARTE0->TASKS_STARTTX)
+        {
+            NRF_UARTE0->TASKS_STARTTX = 0;
+            uarte_starttx();
+            found = true;
+        }
+    } while (found);
+    m_scanning = false;
+}
+
+static uint64_t next_deadline(void)
+{
+    uint64_t next = NS_NEVER;
+    uint32_t cc;
+
+    for (uint32_t b = 0; b < SIM_BUS_COUNT; b++)
+    {
+        if ((m_bus[b].phase != PHASE_NONE) && (m_bus[b].phase_end < next))
+        {
+            next = m_bus[b].phase_end;
+        }
+    }
+    for (uint32_t i = 0; i < 5; i++)
+    {
+        uint64_t t = timer_deadline(i, &cc);
+        if (t < next)
+        {
+            next = t;
+        }
+    }
+    if (m_uarte_end < next)
+    {
+        next = m_uarte_end;
+    }
+    return next;
+}
+
+// Runs the peripherals up to t, in time order.
+static void advance_to(uint64_t t)
+{
+    for (;;)
+    {
+        uint64_t next    = NS_NEVER;
+        int      bus     = -1;
+        int      timer   = -1;
+        uint32_t cc      = 0;
+
+        for (uint32_t b = 0; b < SIM_BUS_COUNT; b++)
+        {
+            if ((m_bus[b].phase != PHASE_NONE) && (m_bus[b].phase_end < next))
+            {
+                next = m_bus[b].phase_end;
+                bus  = (int)b;
+            }
+        }
+        for (uint32_t i = 0; i < 5; i++)
+        {
+            uint32_t c;
+            uint64_t d = timer_deadline(i, &c);
+            if (d < next)
+            {
+                next  = d;
+                timer = (int)i;
+                bus   = -1;
+                cc    = c;
+            }
+        }
+        if (m_uarte_end < next)
+        {
+            next  = m_uarte_end;
+            timer = -1;
+            bus   = -1;
+        }
+        if (next > t)
+        {
+            break;
+        }
+        m_now = next;
+        if (bus >= 0)
+        {
+            phase_done(&m_bus[bus]);
+        }
+        else if (timer >= 0)
+        {
+            timer_compare((uint32_t)timer, cc);
+        }
+        else
+        {
+            uarte_endtx();
+        }
+        tasks_scan();
+    }
+    if (t > m_now)
+    {
+        m_now = t;
+    }
+}
+
+uint64_t sim_now(void)
+{
+    return m_now;
+}
+
+void sim_cpu(uint64_t ns)
+{
+    // In slices, so that interrupts preempt the busy thread close to when they come up.
+    while (ns != 0)
+    {
+        uint64_t step = (ns > 1000) ? 1000 : ns;
+
+        cpu_spend(step);
+        tasks_scan();
+        dispatch();
+        ns -= step;
+    }
+}
+
+void sim_run(uint64_t ns)
+{
+    uint64_t end = m_now + ns;
+
+    ASSERT(!m_in_isr);
+    tasks_scan();
+    dispatch();
+    while (m_now < end)
+    {
+        uint64_t next = next_deadline();
+
+        if (next > end)
+        {
+            next = end;
+        }
+        m_cpu.sleep_ns += next - m_now;
+        advance_to(next);
+        tasks_scan();
+        dispatch();
+    }
+}
+
+bool sim_run_until(bool (* cond)(void), uint64_t timeout_ns)
+{
+    uint64_t end = m_now + timeout_ns;
+
+    ASSERT(!m_in_isr);
+    tasks_scan();
+    dispatch();
+    while (!cond())
+    {
+        uint64_t next = next_deadline();
+
+        if (m_now >= end)
+        {
+            return false;
+        }
+        if (next > end)
+        {
+            next = end;
+        }
+        m_cpu.sleep_ns += next - m_now;
+        advance_to(next);
+        tasks_scan();
+        dispatch();
+    }
+    return true;
+}
+
+void sim_task_trigger(uint32_t task_address)
+{
+    *(volatile uint32_t *)(uintptr_t)task_address = 1;
+    tasks_scan();
+    dispatch();
+}
+
+void sim_event_raise(volatile uint32_t * p_event)
+{
+    event_raise((uint32_t *)p_event);
+    tasks_scan();
+    dispatch();
+}
+
+void sim_wfe_disable(bool disable)
+{
+    m_wfe_disabled = disable;
+}
+
+void sim_reset(void)
+{
+    memset(sim_periph_mem, 0, sizeof(sim_periph_mem));
+    memset(m_nvic_mem, 0, sizeof(m_nvic_mem));
+    memset(m_timer, 0, sizeof(m_timer));
+    memset(m_ppi, 0, sizeof(m_ppi));
+    m_scb_mem[0]   = 0;
+    m_now          = 0;
+    m_pending      = 0;
+    m_event_reg    = false;
+    m_in_isr       = false;
+    m_mask_depth   = 0;
+    m_wfe_disabled = false;
+    m_gpio_out     = 0;
+    m_dma_stack    = 0;
+    m_cpu          = (sim_cpu_stats_t){ 0 };
+    m_uarte_end    = NS_NEVER;
+    mp_uarte_capture     = NULL;
+    m_uarte_capture_size = 0;
+    m_uarte_captured     = 0;
+    m_stack_top    = (uintptr_t)__builtin_frame_address(0);
+    for (uint32_t b = 0; b < SIM_BUS_COUNT; b++)
+    {
+        m_bus[b]               = (sim_bus_t){ 0 };
+        m_bus[b].p_mem         = sim_periph_mem[SIM_PERIPH_TWI0 + b];
+        m_bus[b].busy_since    = NS_NEVER;
+        m_bus[b].pending_start = -1;
+    }
+}
+
+void sim_slave_attach(uint8_t bus, sim_slave_t * p_slave)
+{
+    ASSERT(bus < SIM_BUS_COUNT);
+    p_slave->p_next      = m_bus[bus].p_slaves;
+    m_bus[bus].p_slaves  = p_slave;
+}
+
+void sim_fault_address_nack(uint8_t bus, uint32_t count)
+{
+    m_bus[bus].nack_faults = count;
+}
+
+void sim_fault_sda_stuck(uint8_t bus, uint32_t scl_pulses)
+{
+    m_bus[bus].stuck_pulses = scl_pulses;
+}
+
+bool sim_sda_stuck(uint8_t bus)
+{
+    return m_bus[bus].stuck_pulses != 0;
+}
+
+void sim_cpu_stats_get(sim_cpu_stats_t * p_stats)
+{
+    *p_stats = m_cpu;
+}
+
+void sim_bus_stats_get(uint8_t bus, sim_bus_stats_t * p_stats)
+{
+    *p_stats = m_bus[bus].stats;
+}
+
+uint32_t sim_dma_stack_accesses(void)
+{
+    return m_dma_stack;
+}
+
+/* ---------------------------------------------------------------------------------------------
+ * GPIO, with SDA of a bus held low by a stuck slave until enough SCL pulses.
+ */
+
+static sim_bus_t * bus_of_pin(uint32_t pin, uint32_t offset)
+{
+    for (uint32_t b = 0; b < SIM_BUS_COUNT; b++)
+    {
+        if (REG(m_bus[b].p_mem, offset) == pin)
+        {
+            return &m_bus[b];
+        }
+    }
+    return NULL;
+}
+
+void nrf_gpio_pin_set(uint32_t pin_number)
+{
+    sim_bus_t * p_bus = bus_of_pin(pin_number, TWI_PSEL_SCL);
+
+    if ((p_bus != NULL) && !bus_is_enabled(p_bus) && !(m_gpio_out & (1UL << pin_number)))
+    {
+        p_bus->stats.scl_pulses++;
+        if (p_bus->stuck_pulses != 0)
+        {
+            p_bus->stuck_pulses--;
+        }
+    }
+    m_gpio_out |= 1UL << pin_number;
+    sim_access();
+}
+
+void nrf_gpio_pin_clear(uint32_t pin_number)
+{
+    m_gpio_out &= ~(1UL << pin_number);
+    sim_access();
+}
+
+void nrf_gpio_pin_toggle(uint32_t pin_number)
+{
+    if (m_gpio_out & (1UL << pin_number))
+    {
+        nrf_gpio_pin_clear(pin_number);
+    }
+    else
+    {
+        nrf_gpio_pin_set(pin_number);
+    }
+}
+
+uint32_t nrf_gpio_pin_read(uint32_t pin_number)
+{
+    sim_bus_t * p_bus = bus_of_pin(pin_number, TWI_PSEL_SDA);
+
+    sim_access();
+    if ((p_bus != NULL) && (p_bus->stuck_pulses != 0))
+    {
+        return 0;
+    }
+    return (m_gpio_out >> pin_number) & 1;
+}
+
+void nrf_gpio_cfg_output(uint32_t pin_number)
+{
+    (void)pin_number;
+    sim_access();
+}
+
+/* ---------------------------------------------------------------------------------------------
+ * TWIM HAL
+ */
+
+static sim_bus_t * twim_bus(void const * p_reg)
+{
+    int index = periph_index(p_reg);
+
+    if ((index < SIM_PERIPH_TWI0) || (index > SIM_PERIPH_TWI1))
+    {
+        sim_fail("%p is not a TWI peripheral", p_reg);
+    }
+    return &m_bus[index - SIM_PERIPH_TWI0];
+}
+
+void nrf_twim_task_trigger(NRF_TWIM_Type * p_twim, nrf_twim_task_t task)
+{
+    REG(p_twim, task) = 1;
+    sim_access();
+}
+
+uint32_t * nrf_twim_task_address_get(NRF_TWIM_Type * p_twim, nrf_twim_task_t task)
+{
+    return &REG(p_twim, task);
+}
+
+void nrf_twim_event_clear(NRF_TWIM_Type * p_twim, nrf_twim_event_t event)
+{
+    REG(p_twim, event) = 0;
+    sim_access();
+}
+
+bool nrf_twim_event_check(NRF_TWIM_Type * p_twim, nrf_twim_event_t event)
+{
+    sim_access();
+    return REG(p_twim, event) != 0;
+}
+
+uint32_t * nrf_twim_event_address_get(NRF_TWIM_Type * p_twim, nrf_twim_event_t event)
+{
+    return &REG(p_twim, event);
+}
+
+void nrf_twim_shorts_enable(NRF_TWIM_Type * p_twim, uint32_t shorts_mask)
+{
+    p_twim->SHORTS |= shorts_mask;
+    sim_access();
+}
+
+void nrf_twim_shorts_disable(NRF_TWIM_Type * p_twim, uint32_t shorts_mask)
+{
+    p_twim->SHORTS &= ~shorts_mask;
+    sim_access();
+}
+
+void nrf_twim_shorts_set(NRF_TWIM_Type * p_twim, uint32_t shorts_mask)
+{
+    p_twim->SHORTS = shorts_mask;
+    sim_access();
+}
+
+void nrf_twim_int_enable(NRF_TWIM_Type * p_twim, uint32_t int_mask)
+{
+    p_twim->INTEN |= int_mask;
+    sim_access();
+}
+
+void nrf_twim_int_disable(NRF_TWIM_Type * p_twim, uint32_t int_mask)
+{
+    p_twim->INTEN &= ~int_mask;
+    sim_access();
+}
+
+bool nrf_twim_int_enable_check(NRF_TWIM_Type * p_twim, nrf_twim_int_mask_t int_mask)
+{
+    sim_access();
+    return (p_twim->INTEN & int_mask) != 0;
+}
+
+void nrf_twim_enable(NRF_TWIM_Type * p_twim)
+{
+    p_twim->ENABLE = TWIM_ENABLE_ENABLE_Enabled;
+    sim_access();
+}
+
+void nrf_twim_disable(NRF_TWIM_Type * p_twim)
+{
+    p_twim->ENABLE = TWIM_ENABLE_ENABLE_Disabled;
+    bus_disable(twim_bus(p_twim));
+    sim_access();
+}
+
+void nrf_twim_pins_set(NRF_TWIM_Type * p_twim, uint32_t scl_pin, uint32_t sda_pin)
+{
+    p_twim->PSEL.SCL = scl_pin;
+    p_twim->PSEL.SDA = sda_pin;
+    sim_access();
+}
+
+void nrf_twim_frequency_set(NRF_TWIM_Type * p_twim, nrf_twim_frequency_t frequency)
+{
+    p_twim->FREQUENCY = frequency;
+    sim_access();
+}
+
+uint32_t nrf_twim_errorsrc_get_and_clear(NRF_TWIM_Type * p_twim)
+{
+    uint32_t errorsrc = p_twim->ERRORSRC;
+
+    p_twim->ERRORSRC = 0;
+    sim_access();
+    return errorsrc;
+}
+
+void nrf_twim_address_set(NRF_TWIM_Type * p_twim, uint8_t address)
+{
+    p_twim->ADDRESS = address;
+    sim_access();
+}
+
+void nrf_twim_tx_buffer_set(NRF_TWIM_Type * p_twim, uint8_t const * p_buffer, uint8_t length)
+{
+    sim_bus_t * p_bus = twim_bus(p_twim);
+
+    p_bus->p_txd      = (uint8_t *)p_buffer;
+    p_twim->TXD.PTR    = (uint32_t)(uintptr_t)p_buffer;
+    p_twim->TXD.MAXCNT = length;
+    sim_access();
+}
+
+void nrf_twim_rx_buffer_set(NRF_TWIM_Type * p_twim, uint8_t * p_buffer, uint8_t length)
+{
+    sim_bus_t * p_bus = twim_bus(p_twim);
+
+    p_bus->p_rxd      = p_buffer;
+    p_twim->RXD.PTR    = (uint32_t)(uintptr_t)p_buffer;
+    p_twim->RXD.MAXCNT = length;
+    sim_access();
+}
+
+uint8_t * nrf_twim_rx_buffer_get(NRF_TWIM_Type * p_twim)
+{
+    sim_access();
+    return twim_bus(p_twim)->p_rxd;
+}
+
+void nrf_twim_rx_length_set(NRF_TWIM_Type * p_twim, uint8_t length)
+{
+    p_twim->RXD.MAXCNT = length;
+    sim_access();
+}
+
+uint32_t nrf_twim_txd_amount_get(NRF_TWIM_Type * p_twim)
+{
+    sim_access();
+    return p_twim->TXD.AMOUNT;
+}
+
+uint32_t nrf_twim_rxd_amount_get(NRF_TWIM_Type * p_twim)
+{
+    sim_access();
+    return p_twim->RXD.AMOUNT;
+}
+
+void nrf_twim_rx_list_enable(NRF_TWIM_Type * p_twim)
+{
+    p_twim->RXD.LIST = 1;
+    sim_access();
+}
+
+void nrf_twim_rx_list_disable(NRF_TWIM_Type * p_twim)
+{
+    p_twim->RXD.LIST = 0;
+    sim_access();
+}
+
+void nrf_twim_tx_list_enable(NRF_TWIM_Type * p_twim)
+{
+    p_twim->TXD.LIST = 1;
+    sim_access();
+}
+
+void nrf_twim_tx_list_disable(NRF_TWIM_Type * p_twim)
+{
+    p_twim->TXD.LIST = 0;
+    sim_access();
+}
+
+/* ---------------------------------------------------------------------------------------------
+ * Legacy TWI HAL
+ */
+
+void nrf_twi_task_trigger(NRF_TWI_Type * p_twi, nrf_twi_task_t task)
+{
+    REG(p_twi, task) = 1;
+    sim_access();
+}
+
+uint32_t * nrf_twi_task_address_get(NRF_TWI_Type * p_twi, nrf_twi_task_t task)
+{
+    return &REG(p_twi, task);
+}
+
+void nrf_twi_event_clear(NRF_TWI_Type * p_twi, nrf_twi_event_t event)
+{
+    REG(p_twi, event) = 0;
+    sim_access();
+}
+
+bool nrf_twi_event_check(NRF_TWI_Type * p_twi, nrf_twi_event_t event)
+{
+    sim_access();
+    return REG(p_twi, event) != 0;
+}
+
+uint32_t * nrf_twi_event_address_get(NRF_TWI_Type * p_twi, nrf_twi_event_t event)
+{
+    return &REG(p_twi, event);
+}
+
+void nrf_twi_shorts_set(NRF_TWI_Type * p_twi, uint32_t shorts_mask)
+{
+    REG(p_twi, TWI_SHORTS) = shorts_mask;
+    sim_access();
+}
+
+void nrf_twi_shorts_enable(NRF_TWI_Type * p_twi, uint32_t shorts_mask)
+{
+    REG(p_twi, TWI_SHORTS) |= shorts_mask;
+    sim_access();
+}
+
+void nrf_twi_shorts_disable(NRF_TWI_Type * p_twi, uint32_t shorts_mask)
+{
+    REG(p_twi, TWI_SHORTS) &= ~shorts_mask;
+    sim_access();
+}
+
+void nrf_twi_int_enable(NRF_TWI_Type * p_twi, uint32_t int_mask)
+{
+    REG(p_twi, TWI_INTEN) |= int_mask;
+    sim_access();
+}
+
+void nrf_twi_int_disable(NRF_TWI_Type * p_twi, uint32_t int_mask)
+{
+    REG(p_twi, TWI_INTEN) &= ~int_mask;
+    sim_access();
+}
+
+bool nrf_twi_int_enable_check(NRF_TWI_Type * p_twi, nrf_twi_int_mask_t int_mask)
+{
+    sim_access();
+    return (REG(p_twi, TWI_INTEN) & int_mask) != 0;
+}
+
+uint32_t nrf_twi_errorsrc_get_and_clear(NRF_TWI_Type * p_twi)
+{
+    uint32_t errorsrc = REG(p_twi, TWI_ERRORSRC);
+
+    REG(p_twi, TWI_ERRORSRC) = 0;
+    sim_access();
+    return errorsrc;
+}
+
+void nrf_twi_enable(NRF_TWI_Type * p_twi)
+{
+    REG(p_twi, TWI_ENABLE) = TWI_ENABLE_ENABLE_Enabled;
+    sim_access();
+}
+
+void nrf_twi_disable(NRF_TWI_Type * p_twi)
+{
+    REG(p_twi, TWI_ENABLE) = 0;
+    bus_disable(twim_bus(p_twi));
+    sim_access();
+}
+
+void nrf_twi_pins_set(NRF_TWI_Type * p_twi, uint32_t scl_pin, uint32_t sda_pin)
+{
+    REG(p_twi, TWI_PSEL_SCL) = scl_pin;
+    REG(p_twi, TWI_PSEL_SDA) = sda_pin;
+    sim_access();
+}
+
+void nrf_twi_frequency_set(NRF_TWI_Type * p_twi, nrf_twi_frequency_t frequency)
+{
+    REG(p_twi, TWI_FREQUENCY) = frequency;
+    sim_access();
+}
+
+uint8_t nrf_twi_rxd_get(NRF_TWI_Type * p_twi)
+{
+    sim_access();
+    return (uint8_t)REG(p_twi, TWI_RXD);
+}
+
+void nrf_twi_txd_set(NRF_TWI_Type * p_twi, uint8_t data)
+{
+    sim_bus_t * p_bus = twim_bus(p_twi);
+
+    p_bus->txd      = data;
+    p_bus->txd_full = true;
+    REG(p_twi, TWI_TXD) = data;
+    if ((p_bus->state == BUS_HELD) && !p_bus->read && (p_bus->p_active != NULL))
+    {
+        phase_start(p_bus, PHASE_BYTE, 9);
+    }
+    sim_access();
+}
+
+void nrf_twi_address_set(NRF_TWI_Type * p_twi, uint8_t address)
+{
+    REG(p_twi, TWI_ADDRESS) = address;
+    sim_access();
+}
@@ -0,0 +1,187 @@
+/* Copyright (c) 2015 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+#ifndef SIM_H__
+#define SIM_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "nrf.h"
+
+/**
+ * @defgroup sim Host simulator of the TWI peripherals
+ * @{
+ * @brief Runs the TWI driver and the demo modules on the host, against modelled slaves.
+ *
+ * The simulator implements the TWIM and legacy TWI HAL, TIMER, PPI, the GPIO pins, the NVIC and
+ * WFE/SEV on a nanosecond clock. The bus is modelled one phase at a time: address, data byte or
+ * stop, each taking its number of bit times at the configured frequency. Slaves are C models
+ * attached to a bus by address.
+ *
+ * CPU time is counted per peripheral register access (@ref SIM_ACCESS_NS) and per interrupt
+ * entry and exit (@ref SIM_ISR_NS), not per instruction. Code between two register accesses is
+ * free. Pending interrupts are taken at every register access, critical region exit and __DMB,
+ * which are the only points where the interrupted code can be preempted.
+ *
+ * UARTE0 sends from EasyDMA into a capture buffer, ENDTX comes after the line time of the bytes.
+ *
+ * The TWI interrupt handlers of the driver are called by the NVIC model. Other interrupts are not
+ * modelled, tests raise their events with @ref sim_event_raise instead.
+ */
+
+#define SIM_ACCESS_NS   47   //!< CPU time of one peripheral register access, 3 cycles at 64 MHz.
+#define SIM_ISR_NS      375  //!< CPU time of an interrupt entry and exit, 24 cycles at 64 MHz.
+
+#define SIM_BUS_COUNT   2    //!< Buses, one per TWI peripheral ID (TWIM0/TWI0 and TWIM1/TWI1).
+
+typedef struct sim_slave_s sim_slave_t;
+
+/**
+ * @brief I2C slave model.
+ *
+ * Each callback gets the time of the end of the bus phase. A START or repeated START with
+ * the slave address calls start(), then write() for every byte the master sends or read() for
+ * every byte it takes, and stop() at the STOP condition.
+ */
+struct sim_slave_s
+{
+    uint8_t       address;                                                      //!< 7-bit address.
+    bool       (* start)(sim_slave_t * p_slave, bool read, uint64_t t_ns);      //!< True to ACK the address.
+    bool       (* write)(sim_slave_t * p_slave, uint8_t data, uint64_t t_ns);   //!< True to ACK the byte.
+    uint8_t    (* read)(sim_slave_t * p_slave, bool ack, uint64_t t_ns);        //!< @p ack false on the last byte.
+    void       (* stop)(sim_slave_t * p_slave, uint64_t t_ns);
+    sim_slave_t * p_next;
+};
+
+typedef struct
+{
+    uint64_t active_ns; //!< Thread and interrupt time, including @ref SIM_ISR_NS per interrupt.
+    uint64_t isr_ns;    //!< Part of active_ns spent in interrupt handlers.
+    uint64_t sleep_ns;  //!< Time in WFE or in @ref sim_run.
+    uint32_t isr_count;
+    uint32_t wfe_count;
+} sim_cpu_stats_t;
+
+typedef struct
+{
+    uint64_t busy_ns;      //!< Time between START and the end of STOP.
+    uint32_t starts;       //!< START and repeated START conditions.
+    uint32_t bytes;        //!< Data bytes, not counting the address.
+    uint32_t address_nacks;
+    uint32_t data_nacks;
+    uint32_t stops;
+    uint32_t scl_pulses;   //!< SCL pulses driven from GPIO, by a bus clear.
+} sim_bus_stats_t;
+
+/**
+ * @brief Function for resetting the clock, the peripherals, the NVIC, the PPI and the statistics.
+ *
+ * Slaves are detached. The driver keeps its own state, uninitialize it first.
+ */
+void sim_reset(void);
+
+uint64_t sim_now(void);
+
+/**
+ * @brief Function for letting the thread sleep for @p ns, with interrupts taken on the way.
+ */
+void sim_run(uint64_t ns);
+
+/**
+ * @brief Function for sleeping until @p cond returns true or @p timeout_ns passed.
+ *
+ * @return Value of @p cond at the end.
+ */
+bool sim_run_until(bool (* cond)(void), uint64_t timeout_ns);
+
+/**
+ * @brief Function for keeping the thread busy for @p ns, interrupts may preempt it.
+ */
+void sim_cpu(uint64_t ns);
+
+/**
+ * @brief Function for triggering a task the way a PPI channel does, by its address.
+ */
+void sim_task_trigger(uint32_t task_address);
+
+/**
+ * @brief Function for raising an event of a peripheral that is not modelled, e.g. an RTC
+ *        compare. PPI channels connected to it trigger their task.
+ */
+void sim_event_raise(volatile uint32_t * p_event);
+
+/**
+ * @brief Function for turning WFE into a no-op, which makes a WFE loop a busy-poll loop.
+ */
+void sim_wfe_disable(bool disable);
+
+void sim_slave_attach(uint8_t bus, sim_slave_t * p_slave);
+
+/**
+ * @brief Function for collecting the bytes sent by UARTE0 in @p p_buf, up to @p size bytes.
+ */
+void sim_uarte_capture(uint8_t * p_buf, uint32_t size);
+
+uint32_t sim_uarte_captured(void);
+
+/**
+ * @brief Function for making the next @p count address phases on @p bus end in NACK.
+ */
+void sim_fault_address_nack(uint8_t bus, uint32_t count);
+
+/**
+ * @brief Function for holding SDA of @p bus low until SCL was pulsed @p scl_pulses times from
+ *        GPIO. Every START fails with an address NACK meanwhile.
+ */
+void sim_fault_sda_stuck(uint8_t bus, uint32_t scl_pulses);
+
+bool sim_sda_stuck(uint8_t bus);
+
+void sim_cpu_stats_get(sim_cpu_stats_t * p_stats);
+
+void sim_bus_stats_get(uint8_t bus, sim_bus_stats_t * p_stats);
+
+/**
+ * @brief Function for getting the number of bytes EasyDMA took from or put on the stack of
+ *        the thread. A transfer that outlives the function that set it up does that.
+ */
+uint32_t sim_dma_stack_accesses(void);
+
+/**
+ * @brief Test failure: prints the message and the simulated time and exits with status 1.
+ */
+void sim_fail(char const * p_format, ...) __attribute__((noreturn, format(printf, 1, 2)));
+
+#define SIM_CHECK(expr)                                                     \
+    do                                                                      \
+    {                                                                       \
+        if (!(expr))                                                        \
+        {                                                                   \
+            sim_fail("%s:%d: check failed: %s", __FILE__, __LINE__, #expr); \
+        }                                                                   \
+    } while (0)
+
+#define SIM_CHECK_EQ(a, b)                                                  \
+    do                                                                      \
+    {                                                                       \
+        long long sim_a__ = (long long)(a);                                 \
+        long long sim_b__ = (long long)(b);                                 \
+        if (sim_a__ != sim_b__)                                             \
+        {                                                                   \
+            sim_fail("%s:%d: %s == %lld, expected %s == %lld", __FILE__,    \
+                     __LINE__, #a, sim_a__, #b, sim_b__);                   \
+        }                                                                   \
+    } while (0)
+
+/** @} */
+
+#endif // SIM_H__
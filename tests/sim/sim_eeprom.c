@@ -0,0 +1,108 @@
+/* Copyright (c) 2015 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+
+#include "sim_eeprom.h"
+#include <string.h>
+
+static void page_drop(sim_eeprom_t * p_eeprom)
+{
+    if (p_eeprom->page_bytes != 0)
+    {
+        p_eeprom->aborted++;
+    }
+    p_eeprom->page_bytes = 0;
+    memset(p_eeprom->page_written, 0, sizeof(p_eeprom->page_written));
+}
+
+static bool eeprom_start(sim_slave_t * p_slave, bool read, uint64_t t_ns)
+{
+    sim_eeprom_t * p_eeprom = (sim_eeprom_t *)p_slave;
+
+    (void)read;
+    if (t_ns < p_eeprom->busy_until_ns)
+    {
+        p_eeprom->busy_nacks++;
+        return false;
+    }
+    page_drop(p_eeprom);
+    p_eeprom->addressed = false;
+    return true;
+}
+
+static bool eeprom_write(sim_slave_t * p_slave, uint8_t data, uint64_t t_ns)
+{
+    sim_eeprom_t * p_eeprom = (sim_eeprom_t *)p_slave;
+    uint8_t        offset;
+
+    (void)t_ns;
+    if (!p_eeprom->addressed)
+    {
+        p_eeprom->addressed = true;
+        p_eeprom->pointer   = (uint8_t)(data % p_eeprom->size);
+        p_eeprom->page_base = (uint8_t)(p_eeprom->pointer & ~(p_eeprom->page_size - 1));
+        return true;
+    }
+    offset = (uint8_t)(p_eeprom->pointer - p_eeprom->page_base);
+    p_eeprom->page[offset]         = data;
+    p_eeprom->page_written[offset] = 1;
+    p_eeprom->pointer = (uint8_t)(p_eeprom->page_base + ((offset + 1) & (p_eeprom->page_size - 1)));
+    p_eeprom->page_bytes++;
+    return true;
+}
+
+static uint8_t eeprom_read(sim_slave_t * p_slave, bool ack, uint64_t t_ns)
+{
+    sim_eeprom_t * p_eeprom = (sim_eeprom_t *)p_slave;
+    uint8_t        data     = p_eeprom->memory[p_eeprom->pointer];
+
+    (void)ack;
+    (void)t_ns;
+    p_eeprom->pointer = (uint8_t)((p_eeprom->pointer + 1) % p_eeprom->size);
+    return data;
+}
+
+static void eeprom_stop(sim_slave_t * p_slave, uint64_t t_ns)
+{
+    sim_eeprom_t * p_eeprom = (sim_eeprom_t *)p_slave;
+
+    if (p_eeprom->page_bytes == 0)
+    {
+        return;
+    }
+    for (uint32_t i = 0; i < p_eeprom->page_size; i++)
+    {
+        if (p_eeprom->page_written[i])
+        {
+            p_eeprom->memory[p_eeprom->page_base + i] = p_eeprom->page[i];
+        }
+    }
+    p_eeprom->page_bytes = 0;
+    memset(p_eeprom->page_written, 0, sizeof(p_eeprom->page_written));
+    p_eeprom->page_writes++;
+    p_eeprom->busy_until_ns = t_ns + p_eeprom->write_cycle_ns;
+}
+
+void sim_eeprom_init(sim_eeprom_t * p_eeprom, uint8_t address, uint16_t size, uint8_t page_size,
+                     uint64_t write_cycle_ns)
+{
+    memset(p_eeprom, 0, sizeof(*p_eeprom));
+    memset(p_eeprom->memory, 0xFF, sizeof(p_eeprom->memory));
+    p_eeprom->slave.address  = address;
+    p_eeprom->slave.start    = eeprom_start;
+    p_eeprom->slave.write    = eeprom_write;
+    p_eeprom->slave.read     = eeprom_read;
+    p_eeprom->slave.stop     = eeprom_stop;
+    p_eeprom->size           = size;
+    p_eeprom->page_size      = page_size;
+    p_eeprom->write_cycle_ns = write_cycle_ns;
+}
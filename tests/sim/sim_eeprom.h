@@ -0,0 +1,58 @@
+/* Copyright (c) 2015 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+
+#ifndef SIM_EEPROM_H__
+#define SIM_EEPROM_H__
+
+#include "sim.h"
+
+/**
+ * @defgroup sim_eeprom I2C EEPROM model
+ * @ingroup sim
+ * @{
+ * @brief 24Cxx style EEPROM with page writes and a write cycle.
+ *
+ * Every START begins a new access. The first byte of a write sets the memory address, the
+ * following ones go to the page buffer, wrapping at the end of the page. A STOP after at least
+ * one data byte commits the page and starts the write cycle, during which the address is not
+ * acknowledged. A repeated START drops the page buffer, so a write split by one stores its data
+ * at the address given by the first data byte. A read returns the memory from the address on.
+ */
+
+#define SIM_EEPROM_SIZE_MAX 256
+
+typedef struct
+{
+    sim_slave_t slave;
+    uint8_t     memory[SIM_EEPROM_SIZE_MAX];
+    uint16_t    size;            //!< Memory size in bytes, at most @ref SIM_EEPROM_SIZE_MAX.
+    uint8_t     page_size;       //!< Page size in bytes, a power of two.
+    uint64_t    write_cycle_ns;  //!< Time from the STOP of a page write to the next ACK.
+    uint64_t    busy_until_ns;
+    uint8_t     pointer;
+    bool        addressed;       //!< Memory address byte of the current write received.
+    uint8_t     page[SIM_EEPROM_SIZE_MAX];
+    uint8_t     page_written[SIM_EEPROM_SIZE_MAX]; //!< Page buffer bytes received, by offset.
+    uint32_t    page_bytes;      //!< Data bytes of the current write.
+    uint8_t     page_base;       //!< Page of the current write.
+    uint32_t    page_writes;     //!< Committed page writes.
+    uint32_t    busy_nacks;      //!< Addresses refused during a write cycle.
+    uint32_t    aborted;         //!< Page buffers dropped by a repeated START.
+} sim_eeprom_t;
+
+void sim_eeprom_init(sim_eeprom_t * p_eeprom, uint8_t address, uint16_t size, uint8_t page_size,
+                     uint64_t write_cycle_ns);
+
+/** @} */
+
+#endif // SIM_EEPROM_H__
@@ -0,0 +1,303 @@
+/* Copyright (c) 2015 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+
+#include "sim_mma7660.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define REG_X      0
+#define REG_Y      1
+#define REG_Z      2
+#define REG_TILT   3
+#define REG_SRST   4
+#define REG_SPCNT  5
+#define REG_INTSU  6
+#define REG_MODE   7
+#define REG_SR     8
+
+#define ALERT        0x40
+#define SHAKE        0x80
+#define COUNTS_PER_G 21.33f
+#define SHAKE_G      1.3f
+
+#define MODE_ACTIVE  0x01
+#define MODE_AWE     0x08
+#define MODE_ASE     0x10
+
+#define INTSU_FBINT  0x01
+#define INTSU_PLINT  0x02
+#define INTSU_GINT   0x10
+
+#define BAFRO_FRONT  1
+#define BAFRO_BACK   2
+#define POLA_LEFT    1
+#define POLA_RIGHT   2
+#define POLA_DOWN    5
+#define POLA_UP      6
+
+static const uint16_t m_amsr_hz[] = { 120, 64, 32, 16, 8, 4, 2, 1 };
+static const uint16_t m_awsr_hz[] = { 32, 16, 8, 1 };
+static const uint8_t  m_intsu_shint[] = { 0x80, 0x40, 0x20 }; // X, Y, Z
+
+static uint8_t to_reg(float g)
+{
+    int counts = (int)lroundf(g * COUNTS_PER_G);
+
+    counts = (counts < -32) ? -32 : (counts > 31) ? 31 : counts;
+    return (uint8_t)(counts & 0x3F);
+}
+
+static uint8_t tilt_of(float const * p_xyz)
+{
+    float   x    = p_xyz[0];
+    float   y    = p_xyz[1];
+    float   z    = p_xyz[2];
+    uint8_t tilt = 0;
+
+    if (z > 0.3f)
+    {
+        tilt |= BAFRO_FRONT;
+    }
+    else if (z < -0.3f)
+    {
+        tilt |= BAFRO_BACK;
+    }
+    if (fabsf(z) < 0.8f)
+    {
+        if (fabsf(x) >= fabsf(y))
+        {
+            tilt |= ((x > 0) ? POLA_LEFT : POLA_RIGHT) << 2;
+        }
+        else
+        {
+            tilt |= ((y > 0) ? POLA_DOWN : POLA_UP) << 2;
+        }
+    }
+    return tilt;
+}
+
+uint32_t sim_mma7660_rate(sim_mma7660_t const * p_sensor)
+{
+    uint8_t sr = p_sensor->regs[REG_SR];
+
+    if (p_sensor->asleep)
+    {
+        return m_awsr_hz[(sr >> 3) & 0x03];
+    }
+    return m_amsr_hz[sr & 0x07];
+}
+
+static float const * sample_at(sim_mma7660_t * p_sensor, uint64_t t_ns)
+{
+    while ((p_sensor->pos + 1 < p_sensor->trace_length) &&
+           (p_sensor->p_trace[p_sensor->pos + 1].t_ns <= t_ns))
+    {
+        p_sensor->pos++;
+    }
+    return p_sensor->p_trace[p_sensor->pos].xyz;
+}
+
+static void wake(sim_mma7660_t * p_sensor, uint64_t t_ns)
+{
+    p_sensor->asleep    = false;
+    p_sensor->idle      = 0;
+    p_sensor->sleep_ns += t_ns - p_sensor->sleep_since;
+}
+
+static void update(sim_mma7660_t * p_sensor, uint64_t t_ns)
+{
+    float const * p_xyz  = sample_at(p_sensor, t_ns);
+    uint8_t       old    = p_sensor->regs[REG_TILT] & 0x1F;
+    uint8_t       tilt   = tilt_of(p_xyz);
+    uint8_t       intsu  = p_sensor->regs[REG_INTSU];
+    uint8_t       mode   = p_sensor->regs[REG_MODE];
+    bool          events = (intsu & INTSU_GINT) != 0;
+
+    for (uint32_t axis = 0; axis < 3; axis++)
+    {
+        p_sensor->regs[REG_X + axis] = to_reg(p_xyz[axis]);
+    }
+    p_sensor->last_update = t_ns;
+    p_sensor->updates++;
+
+    if (((old ^ tilt) & 0x03) && (intsu & INTSU_FBINT))
+    {
+        events = true;
+    }
+    if (((old ^ tilt) & 0x1C) && (intsu & INTSU_PLINT))
+    {
+        events = true;
+    }
+    for (uint32_t axis = 0; axis < 3; axis++)
+    {
+        if ((fabsf(p_xyz[axis]) > SHAKE_G) && (intsu & m_intsu_shint[axis]))
+        {
+            events = true;
+            tilt  |= SHAKE;
+        }
+    }
+    p_sensor->regs[REG_TILT] = tilt;
+
+    if (events && !p_sensor->int_asserted)
+    {
+        p_sensor->int_asserted = true;
+        p_sensor->int_edges++;
+    }
+
+    if (events)
+    {
+        p_sensor->idle = 0;
+        if (p_sensor->asleep && (mode & MODE_AWE))
+        {
+            wake(p_sensor, t_ns);
+        }
+    }
+    else if (!p_sensor->asleep && (mode & MODE_ASE) && p_sensor->regs[REG_SPCNT])
+    {
+        if (++p_sensor->idle >= p_sensor->regs[REG_SPCNT])
+        {
+            p_sensor->asleep      = true;
+            p_sensor->sleep_since = t_ns;
+        }
+    }
+    p_sensor->regs[REG_SRST] = p_sensor->asleep ? 0x02 : 0x01;
+}
+
+void sim_mma7660_advance(sim_mma7660_t * p_sensor, uint64_t t_ns)
+{
+    while (p_sensor->running && (p_sensor->next_update <= t_ns))
+    {
+        update(p_sensor, p_sensor->next_update);
+        p_sensor->next_update += 1000000000ULL / sim_mma7660_rate(p_sensor);
+    }
+}
+
+void sim_mma7660_finish(sim_mma7660_t * p_sensor, uint64_t t_ns)
+{
+    sim_mma7660_advance(p_sensor, t_ns);
+    if (p_sensor->asleep)
+    {
+        p_sensor->sleep_ns   += t_ns - p_sensor->sleep_since;
+        p_sensor->sleep_since = t_ns;
+    }
+}
+
+static bool mma7660_start(sim_slave_t * p_slave, bool read, uint64_t t_ns)
+{
+    sim_mma7660_t * p_sensor = (sim_mma7660_t *)p_slave;
+
+    (void)read;
+    sim_mma7660_advance(p_sensor, t_ns);
+    p_sensor->addressed = false;
+    return true;
+}
+
+static bool mma7660_write(sim_slave_t * p_slave, uint8_t data, uint64_t t_ns)
+{
+    sim_mma7660_t * p_sensor = (sim_mma7660_t *)p_slave;
+
+    sim_mma7660_advance(p_sensor, t_ns);
+    if (!p_sensor->addressed)
+    {
+        p_sensor->addressed = true;
+        p_sensor->pointer   = data % SIM_MMA7660_REG_COUNT;
+        return true;
+    }
+    p_sensor->regs[p_sensor->pointer] = data;
+    if ((p_sensor->pointer == REG_MODE) && (data & MODE_ACTIVE) && !p_sensor->running)
+    {
+        p_sensor->running     = true;
+        p_sensor->next_update = t_ns;
+    }
+    p_sensor->pointer = (p_sensor->pointer + 1) % SIM_MMA7660_REG_COUNT;
+    return true;
+}
+
+static uint8_t mma7660_read(sim_slave_t * p_slave, bool ack, uint64_t t_ns)
+{
+    sim_mma7660_t * p_sensor = (sim_mma7660_t *)p_slave;
+    uint8_t         value;
+
+    (void)ack;
+    sim_mma7660_advance(p_sensor, t_ns);
+    value = p_sensor->regs[p_sensor->pointer];
+    if ((p_sensor->pointer <= REG_Z) && p_sensor->updates &&
+        (t_ns - p_sensor->last_update < p_sensor->alert_ns))
+    {
+        value |= ALERT;
+        p_sensor->alerts++;
+    }
+    if (p_sensor->pointer == REG_TILT)
+    {
+        p_sensor->int_asserted = false;
+    }
+    p_sensor->pointer = (p_sensor->pointer + 1) % SIM_MMA7660_REG_COUNT;
+    return value;
+}
+
+void sim_mma7660_init(sim_mma7660_t *              p_sensor,
+                      sim_mma7660_sample_t const * p_trace,
+                      uint32_t                     trace_length,
+                      uint64_t                     alert_ns)
+{
+    memset(p_sensor, 0, sizeof(*p_sensor));
+    p_sensor->slave.address = 0x4C;
+    p_sensor->slave.start   = mma7660_start;
+    p_sensor->slave.write   = mma7660_write;
+    p_sensor->slave.read    = mma7660_read;
+    p_sensor->p_trace       = p_trace;
+    p_sensor->trace_length  = trace_length;
+    p_sensor->alert_ns      = alert_ns;
+}
+
+uint32_t sim_mma7660_trace_load(char const *           p_path,
+                                sim_mma7660_sample_t * p_trace,
+                                uint32_t               max_length,
+                                uint64_t               t0_ns)
+{
+    FILE *   p_file = fopen(p_path, "r");
+    char     line[128];
+    uint32_t length = 0;
+    double   t_first = -1.0;
+
+    if (p_file == NULL)
+    {
+        sim_fail("cannot open %s", p_path);
+    }
+    while ((length < max_length) && fgets(line, sizeof(line), p_file))
+    {
+        double t, x, y, z;
+
+        if (sscanf(line, "%lf,%lf,%lf,%lf", &t, &x, &y, &z) != 4)
+        {
+            continue;
+        }
+        if (t_first < 0)
+        {
+            t_first = t;
+        }
+        p_trace[length].t_ns   = t0_ns + (uint64_t)llround((t - t_first) * 1e9);
+        p_trace[length].xyz[0] = (float)x;
+        p_trace[length].xyz[1] = (float)y;
+        p_trace[length].xyz[2] = (float)z;
+        length++;
+    }
+    fclose(p_file);
+    if (length == 0)
+    {
+        sim_fail("no samples in %s", p_path);
+    }
+    return length;
+}
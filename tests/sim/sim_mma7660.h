@@ -0,0 +1,99 @@
+/* Copyright (c) 2015 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+
+#ifndef SIM_MMA7660_H__
+#define SIM_MMA7660_H__
+
+#include "sim.h"
+
+/**
+ * @defgroup sim_mma7660 MMA7660 model
+ * @ingroup sim
+ * @{
+ * @brief C port of common/tools/mma7660_model.py as a slave of the simulator.
+ *
+ * Same registers and behaviour as the Python model: X, Y, Z updated from the trace at the SR
+ * active rate or the auto-wake rate, ALERT on a read within alert_ns of an update, TILT with
+ * back/front, portrait/landscape and shake, INT on the INTSU sources released by reading TILT,
+ * auto-sleep after SPCNT idle samples and auto-wake. Tap detection is not modelled.
+ *
+ * The sensor runs on the simulator clock: the registers are brought up to date on every bus
+ * access and by @ref sim_mma7660_advance, which the tests call to follow the INT pin.
+ */
+
+#define SIM_MMA7660_REG_COUNT 11
+
+typedef struct
+{
+    uint64_t t_ns;
+    float    xyz[3]; //!< Acceleration in g.
+} sim_mma7660_sample_t;
+
+typedef struct
+{
+    sim_slave_t                  slave;
+    sim_mma7660_sample_t const * p_trace;
+    uint32_t                     trace_length;
+    uint32_t                     pos;
+    uint64_t                     alert_ns;
+    uint8_t                      regs[SIM_MMA7660_REG_COUNT];
+    uint8_t                      pointer;
+    bool                         addressed;
+    bool                         running;       //!< Updates scheduled, MODE was made active.
+    uint64_t                     next_update;
+    uint64_t                     last_update;
+    bool                         asleep;
+    uint32_t                     idle;
+    bool                         int_asserted;
+    uint32_t                     int_edges;
+    uint32_t                     alerts;
+    uint32_t                     updates;
+    uint64_t                     sleep_ns;
+    uint64_t                     sleep_since;
+} sim_mma7660_t;
+
+/**
+ * @brief Function for loading a trace, one "t_s,x_g,y_g,z_g" sample per line.
+ *
+ * Other lines (headers, comments) are skipped. The times are shifted to start at @p t0_ns.
+ *
+ * @return Number of samples loaded, the test fails if there are none or the file is missing.
+ */
+uint32_t sim_mma7660_trace_load(char const *           p_path,
+                                sim_mma7660_sample_t * p_trace,
+                                uint32_t               max_length,
+                                uint64_t               t0_ns);
+
+void sim_mma7660_init(sim_mma7660_t *              p_sensor,
+                      sim_mma7660_sample_t const * p_trace,
+                      uint32_t                     trace_length,
+                      uint64_t                     alert_ns);
+
+/**
+ * @brief Function for running the sensor up to @p t_ns.
+ */
+void sim_mma7660_advance(sim_mma7660_t * p_sensor, uint64_t t_ns);
+
+/**
+ * @brief Function for getting the sensor rate in samples per second, auto-sleep included.
+ */
+uint32_t sim_mma7660_rate(sim_mma7660_t const * p_sensor);
+
+/**
+ * @brief Function for adding the time spent asleep until @p t_ns to the total.
+ */
+void sim_mma7660_finish(sim_mma7660_t * p_sensor, uint64_t t_ns);
+
+/** @} */
+
+#endif // SIM_MMA7660_H__
@@ -0,0 +1,77 @@
+/* Copyright (c) 2015 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+
+#include "sim_reg_slave.h"
+#include <string.h>
+
+static sim_reg_slave_access_t * access_current(sim_reg_slave_t * p_reg_slave)
+{
+    return &p_reg_slave->log[(p_reg_slave->access_count - 1) % SIM_REG_SLAVE_LOG_SIZE];
+}
+
+static bool reg_slave_start(sim_slave_t * p_slave, bool read, uint64_t t_ns)
+{
+    sim_reg_slave_t *        p_reg_slave = (sim_reg_slave_t *)p_slave;
+    sim_reg_slave_access_t * p_access;
+
+    p_reg_slave->access_count++;
+    p_reg_slave->addressed = false;
+    p_access               = access_current(p_reg_slave);
+    p_access->t_ns         = t_ns;
+    p_access->reg          = p_reg_slave->pointer;
+    p_access->length       = 0;
+    p_access->read         = read;
+    return true;
+}
+
+static bool reg_slave_write(sim_slave_t * p_slave, uint8_t data, uint64_t t_ns)
+{
+    sim_reg_slave_t *        p_reg_slave = (sim_reg_slave_t *)p_slave;
+    sim_reg_slave_access_t * p_access    = access_current(p_reg_slave);
+
+    (void)t_ns;
+    if (!p_reg_slave->addressed)
+    {
+        p_reg_slave->addressed = true;
+        p_reg_slave->pointer   = data;
+        p_access->reg          = data;
+        return true;
+    }
+    if (p_reg_slave->nack_writes != 0)
+    {
+        p_reg_slave->nack_writes--;
+        return false;
+    }
+    p_reg_slave->regs[p_reg_slave->pointer++] = data;
+    p_access->length++;
+    return true;
+}
+
+static uint8_t reg_slave_read(sim_slave_t * p_slave, bool ack, uint64_t t_ns)
+{
+    sim_reg_slave_t * p_reg_slave = (sim_reg_slave_t *)p_slave;
+
+    (void)ack;
+    (void)t_ns;
+    access_current(p_reg_slave)->length++;
+    return p_reg_slave->regs[p_reg_slave->pointer++];
+}
+
+void sim_reg_slave_init(sim_reg_slave_t * p_reg_slave, uint8_t address)
+{
+    memset(p_reg_slave, 0, sizeof(*p_reg_slave));
+    p_reg_slave->slave.address = address;
+    p_reg_slave->slave.start   = reg_slave_start;
+    p_reg_slave->slave.write   = reg_slave_write;
+    p_reg_slave->slave.read    = reg_slave_read;
+}
@@ -0,0 +1,55 @@
+/* Copyright (c) 2015 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+
+#ifndef SIM_REG_SLAVE_H__
+#define SIM_REG_SLAVE_H__
+
+#include "sim.h"
+
+/**
+ * @defgroup sim_reg_slave Register slave model
+ * @ingroup sim
+ * @{
+ * @brief Slave with a 256-byte register map and an auto-incremented register pointer.
+ *
+ * The first byte of a write sets the pointer, the following ones are stored at it. A read
+ * returns the registers from the pointer on. Every access is logged, which is what the tests
+ * check the bus traffic with.
+ */
+
+#define SIM_REG_SLAVE_LOG_SIZE 64
+
+typedef struct
+{
+    uint64_t t_ns;     //!< End of the START and address phase.
+    uint8_t  reg;      //!< Register pointer at the START.
+    uint8_t  length;   //!< Bytes written after the register address, or read.
+    bool     read;
+} sim_reg_slave_access_t;
+
+typedef struct
+{
+    sim_slave_t            slave;
+    uint8_t                regs[256];
+    uint8_t                pointer;
+    bool                   addressed;  //!< Register address byte of the current write received.
+    uint32_t               nack_writes; //!< Data bytes to NACK, e.g. a write-protected register.
+    uint32_t               access_count;
+    sim_reg_slave_access_t log[SIM_REG_SLAVE_LOG_SIZE];
+} sim_reg_slave_t;
+
+void sim_reg_slave_init(sim_reg_slave_t * p_reg_slave, uint8_t address);
+
+/** @} */
+
+#endif // SIM_REG_SLAVE_H__
@@ -0,0 +1,31 @@
+/* Copyright (c) 2015 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/* Host build of app_util_platform.h. The critical region masks the simulated interrupts, the
+ * interrupts that became pending meanwhile are taken when it ends. */
+
+#ifndef APP_UTIL_PLATFORM_H__
+#define APP_UTIL_PLATFORM_H__
+
+#include <stdint.h>
+#include "nrf.h"
+
+#define APP_IRQ_PRIORITY_HIGH 1
+#define APP_IRQ_PRIORITY_LOW  3
+
+void sim_critical_region_enter(void);
+void sim_critical_region_exit(void);
+
+#define CRITICAL_REGION_ENTER() { sim_critical_region_enter();
+#define CRITICAL_REGION_EXIT()    sim_critical_region_exit(); }
+
+#endif // APP_UTIL_PLATFORM_H__
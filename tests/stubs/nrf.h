@@ -0,0 +1,358 @@
+/* Copyright (c) 2015 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/* Host build of nrf.h: the register blocks used by the demos, backed by simulator memory
+ * (sim/sim.c), and the Cortex-M intrinsics as simulator calls. The register layouts follow
+ * nrf52.h, the HAL enums in nrf_twim.h are offsets into them. */
+
+#ifndef NRF_H
+#define NRF_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#define NRF52
+
+#define __I  volatile const
+#define __O  volatile
+#define __IO volatile
+
+// The HAL functions are compiled with SUPPRESS_INLINE_IMPLEMENTATION, sim.c implements them.
+#define __STATIC_INLINE
+
+typedef enum
+{
+    UARTE0_UART0_IRQn = 2,
+    SPI0_TWI0_IRQn = 3,
+    SPI1_TWI1_IRQn = 4,
+    GPIOTE_IRQn    = 6,
+    TIMER0_IRQn    = 8,
+    TIMER1_IRQn    = 9,
+    TIMER2_IRQn    = 10,
+    RTC0_IRQn      = 11,
+    TIMER3_IRQn    = 26,
+    TIMER4_IRQn    = 27,
+} IRQn_Type;
+
+typedef struct
+{
+    __IO uint32_t ISER[8];
+    uint32_t      RESERVED0[24];
+    __IO uint32_t ICER[8];
+    uint32_t      RESERVED1[24];
+    __IO uint32_t ISPR[8];
+    uint32_t      RESERVED2[24];
+    __IO uint32_t ICPR[8];
+} NVIC_Type;
+
+typedef struct
+{
+    __IO uint32_t SCR;
+} SCB_Type;
+
+#define SCB_SCR_SEVONPEND_Msk        (1UL << 4)
+
+extern NVIC_Type * const NVIC;
+extern SCB_Type *  const SCB;
+
+void NVIC_EnableIRQ(IRQn_Type irqn);
+void NVIC_DisableIRQ(IRQn_Type irqn);
+void NVIC_SetPendingIRQ(IRQn_Type irqn);
+void NVIC_ClearPendingIRQ(IRQn_Type irqn);
+uint32_t NVIC_GetPendingIRQ(IRQn_Type irqn);
+void NVIC_SetPriority(IRQn_Type irqn, uint32_t priority);
+
+void __WFE(void);
+void __SEV(void);
+void __DMB(void);
+void __disable_irq(void);
+void __enable_irq(void);
+
+#define __wfe() __WFE()
+#define __sev() __SEV()
+
+typedef struct
+{
+    __IO uint32_t TASKS_STARTRX;
+    uint32_t      RESERVED0;
+    __IO uint32_t TASKS_STARTTX;
+    uint32_t      RESERVED1[2];
+    __IO uint32_t TASKS_STOP;
+    uint32_t      RESERVED2;
+    __IO uint32_t TASKS_SUSPEND;
+    __IO uint32_t TASKS_RESUME;
+    uint32_t      RESERVED3[56];
+    __IO uint32_t EVENTS_STOPPED;
+    uint32_t      RESERVED4[7];
+    __IO uint32_t EVENTS_ERROR;
+    uint32_t      RESERVED5[8];
+    __IO uint32_t EVENTS_SUSPENDED;
+    __IO uint32_t EVENTS_RXSTARTED;
+    __IO uint32_t EVENTS_TXSTARTED;
+    uint32_t      RESERVED6[2];
+    __IO uint32_t EVENTS_LASTRX;
+    __IO uint32_t EVENTS_LASTTX;
+    uint32_t      RESERVED7[39];
+    __IO uint32_t SHORTS;
+    uint32_t      RESERVED8[63];
+    __IO uint32_t INTEN;
+    __IO uint32_t INTENSET;
+    __IO uint32_t INTENCLR;
+    uint32_t      RESERVED9[110];
+    __IO uint32_t ERRORSRC;
+    uint32_t      RESERVED10[14];
+    __IO uint32_t ENABLE;
+    uint32_t      RESERVED11;
+    struct
+    {
+        __IO uint32_t SCL;
+        __IO uint32_t SDA;
+    } PSEL;
+    uint32_t      RESERVED12[5];
+    __IO uint32_t FREQUENCY;
+    uint32_t      RESERVED13[3];
+    struct
+    {
+        __IO uint32_t PTR;
+        __IO uint32_t MAXCNT;
+        __I  uint32_t AMOUNT;
+        __IO uint32_t LIST;
+    } RXD;
+    struct
+    {
+        __IO uint32_t PTR;
+        __IO uint32_t MAXCNT;
+        __I  uint32_t AMOUNT;
+        __IO uint32_t LIST;
+    } TXD;
+    uint32_t      RESERVED14[13];
+    __IO uint32_t ADDRESS;
+} NRF_TWIM_Type;
+
+_Static_assert(offsetof(NRF_TWIM_Type, EVENTS_STOPPED)   == 0x104, "TWIM layout");
+_Static_assert(offsetof(NRF_TWIM_Type, EVENTS_ERROR)     == 0x124, "TWIM layout");
+_Static_assert(offsetof(NRF_TWIM_Type, EVENTS_SUSPENDED) == 0x148, "TWIM layout");
+_Static_assert(offsetof(NRF_TWIM_Type, EVENTS_LASTTX)    == 0x160, "TWIM layout");
+_Static_assert(offsetof(NRF_TWIM_Type, SHORTS)           == 0x200, "TWIM layout");
+_Static_assert(offsetof(NRF_TWIM_Type, INTEN)            == 0x300, "TWIM layout");
+_Static_assert(offsetof(NRF_TWIM_Type, ERRORSRC)         == 0x4C4, "TWIM layout");
+_Static_assert(offsetof(NRF_TWIM_Type, ENABLE)           == 0x500, "TWIM layout");
+_Static_assert(offsetof(NRF_TWIM_Type, FREQUENCY)        == 0x524, "TWIM layout");
+_Static_assert(offsetof(NRF_TWIM_Type, RXD)              == 0x534, "TWIM layout");
+_Static_assert(offsetof(NRF_TWIM_Type, TXD)              == 0x544, "TWIM layout");
+_Static_assert(offsetof(NRF_TWIM_Type, ADDRESS)          == 0x588, "TWIM layout");
+
+// Legacy TWI, only accessed through the HAL in nrf_twi.h.
+typedef struct
+{
+    __IO uint32_t REG[0x600 / 4];
+} NRF_TWI_Type;
+
+typedef struct
+{
+    __IO uint32_t TASKS_START;
+    __IO uint32_t TASKS_STOP;
+    __IO uint32_t TASKS_COUNT;
+    __IO uint32_t TASKS_CLEAR;
+    __IO uint32_t TASKS_SHUTDOWN;
+    uint32_t      RESERVED0[11];
+    __IO uint32_t TASKS_CAPTURE[6];
+    uint32_t      RESERVED1[58];
+    __IO uint32_t EVENTS_COMPARE[6];
+    uint32_t      RESERVED2[42];
+    __IO uint32_t SHORTS;
+    uint32_t      RESERVED3[64];
+    __IO uint32_t INTENSET;
+    __IO uint32_t INTENCLR;
+    uint32_t      RESERVED4[126];
+    __IO uint32_t MODE;
+    __IO uint32_t BITMODE;
+    uint32_t      RESERVED5;
+    __IO uint32_t PRESCALER;
+    uint32_t      RESERVED6[11];
+    __IO uint32_t CC[6];
+} NRF_TIMER_Type;
+
+_Static_assert(offsetof(NRF_TIMER_Type, TASKS_CAPTURE)  == 0x040, "TIMER layout");
+_Static_assert(offsetof(NRF_TIMER_Type, EVENTS_COMPARE) == 0x140, "TIMER layout");
+_Static_assert(offsetof(NRF_TIMER_Type, SHORTS)         == 0x200, "TIMER layout");
+_Static_assert(offsetof(NRF_TIMER_Type, INTENSET)       == 0x304, "TIMER layout");
+_Static_assert(offsetof(NRF_TIMER_Type, MODE)           == 0x504, "TIMER layout");
+_Static_assert(offsetof(NRF_TIMER_Type, PRESCALER)      == 0x510, "TIMER layout");
+_Static_assert(offsetof(NRF_TIMER_Type, CC)             == 0x540, "TIMER layout");
+
+typedef struct
+{
+    uint32_t      RESERVED0[321];
+    __IO uint32_t OUT;
+    __IO uint32_t OUTSET;
+    __IO uint32_t OUTCLR;
+    __I  uint32_t IN;
+    __IO uint32_t DIR;
+    __IO uint32_t DIRSET;
+    __IO uint32_t DIRCLR;
+    uint32_t      RESERVED1[120];
+    __IO uint32_t PIN_CNF[32];
+} NRF_GPIO_Type;
+
+_Static_assert(offsetof(NRF_GPIO_Type, OUT)     == 0x504, "GPIO layout");
+_Static_assert(offsetof(NRF_GPIO_Type, PIN_CNF) == 0x700, "GPIO layout");
+
+// UARTE0, TX only.
+typedef struct
+{
+    __IO uint32_t TASKS_STARTRX;
+    __IO uint32_t TASKS_STOPRX;
+    __IO uint32_t TASKS_STARTTX;
+    __IO uint32_t TASKS_STOPTX;
+    uint32_t      RESERVED0[68];
+    __IO uint32_t EVENTS_ENDTX;
+    uint32_t      RESERVED1[119];
+    __IO uint32_t INTEN;
+    __IO uint32_t INTENSET;
+    __IO uint32_t INTENCLR;
+    uint32_t      RESERVED2[125];
+    __IO uint32_t ENABLE;
+    uint32_t      RESERVED3;
+    struct
+    {
+        __IO uint32_t RTS;
+        __IO uint32_t TXD;
+        __IO uint32_t CTS;
+        __IO uint32_t RXD;
+    } PSEL;
+    uint32_t      RESERVED4[3];
+    __IO uint32_t BAUDRATE;
+    uint32_t      RESERVED5[7];
+    struct
+    {
+        __IO uint32_t PTR;
+        __IO uint32_t MAXCNT;
+        __I  uint32_t AMOUNT;
+    } TXD;
+    uint32_t      RESERVED6[7];
+    __IO uint32_t CONFIG;
+} NRF_UARTE_Type;
+
+_Static_assert(offsetof(NRF_UARTE_Type, EVENTS_ENDTX) == 0x120, "UARTE layout");
+_Static_assert(offsetof(NRF_UARTE_Type, INTENCLR)     == 0x308, "UARTE layout");
+_Static_assert(offsetof(NRF_UARTE_Type, ENABLE)       == 0x500, "UARTE layout");
+_Static_assert(offsetof(NRF_UARTE_Type, PSEL)         == 0x508, "UARTE layout");
+_Static_assert(offsetof(NRF_UARTE_Type, BAUDRATE)     == 0x524, "UARTE layout");
+_Static_assert(offsetof(NRF_UARTE_Type, TXD)          == 0x544, "UARTE layout");
+_Static_assert(offsetof(NRF_UARTE_Type, CONFIG)       == 0x56C, "UARTE layout");
+
+#define UARTE_CONFIG_HWFC_Pos                (0UL)
+#define UARTE_CONFIG_HWFC_Enabled            (1UL)
+#define UARTE_BAUDRATE_BAUDRATE_Pos          (0UL)
+#define UARTE_BAUDRATE_BAUDRATE_Baud460800   (0x07400000UL)
+#define UARTE_ENABLE_ENABLE_Pos              (0UL)
+#define UARTE_ENABLE_ENABLE_Enabled          (8UL)
+
+typedef struct
+{
+    __IO uint32_t CTRL;
+    __IO uint32_t CYCCNT;
+} DWT_Type;
+
+typedef struct
+{
+    __IO uint32_t DEMCR;
+} CoreDebug_Type;
+
+#define CoreDebug_DEMCR_TRCENA_Msk (1UL << 24)
+#define DWT_CTRL_CYCCNTENA_Msk     (1UL << 0)
+
+extern DWT_Type * const       DWT;
+extern CoreDebug_Type * const CoreDebug;
+
+// One 4 kB block per peripheral ID, as on the chip: TWIM0 and TWI0 share theirs.
+#define SIM_PERIPH_TWI0    0
+#define SIM_PERIPH_TWI1    1
+#define SIM_PERIPH_TIMER0  2
+#define SIM_PERIPH_TIMER1  3
+#define SIM_PERIPH_TIMER2  4
+#define SIM_PERIPH_TIMER3  5
+#define SIM_PERIPH_TIMER4  6
+#define SIM_PERIPH_GPIO    7
+#define SIM_PERIPH_UARTE0  8
+#define SIM_PERIPH_COUNT   9
+
+extern uint32_t sim_periph_mem[SIM_PERIPH_COUNT][1024];
+
+#define NRF_TWIM0  ((NRF_TWIM_Type *)sim_periph_mem[SIM_PERIPH_TWI0])
+#define NRF_TWIM1  ((NRF_TWIM_Type *)sim_periph_mem[SIM_PERIPH_TWI1])
+#define NRF_TWI0   ((NRF_TWI_Type *)sim_periph_mem[SIM_PERIPH_TWI0])
+#define NRF_TWI1   ((NRF_TWI_Type *)sim_periph_mem[SIM_PERIPH_TWI1])
+#define NRF_TIMER0 ((NRF_TIMER_Type *)sim_periph_mem[SIM_PERIPH_TIMER0])
+#define NRF_TIMER1 ((NRF_TIMER_Type *)sim_periph_mem[SIM_PERIPH_TIMER1])
+#define NRF_TIMER2 ((NRF_TIMER_Type *)sim_periph_mem[SIM_PERIPH_TIMER2])
+#define NRF_TIMER3 ((NRF_TIMER_Type *)sim_periph_mem[SIM_PERIPH_TIMER3])
+#define NRF_TIMER4 ((NRF_TIMER_Type *)sim_periph_mem[SIM_PERIPH_TIMER4])
+#define NRF_GPIO   ((NRF_GPIO_Type *)sim_periph_mem[SIM_PERIPH_GPIO])
+#define NRF_UARTE0 ((NRF_UARTE_Type *)sim_periph_mem[SIM_PERIPH_UARTE0])
+
+#define TWIM_ENABLE_ENABLE_Pos         (0UL)
+#define TWIM_ENABLE_ENABLE_Disabled    (0UL)
+#define TWIM_ENABLE_ENABLE_Enabled     (6UL)
+#define TWI_ENABLE_ENABLE_Enabled      (5UL)
+
+#define TWIM_ERRORSRC_ANACK_Msk        (1UL << 1)
+#define TWIM_ERRORSRC_DNACK_Msk        (1UL << 2)
+#define TWI_ERRORSRC_OVERRUN_Msk       (1UL << 0)
+
+#define TWIM_FREQUENCY_FREQUENCY_K100  (0x01980000UL)
+#define TWIM_FREQUENCY_FREQUENCY_K250  (0x04000000UL)
+#define TWIM_FREQUENCY_FREQUENCY_K400  (0x06400000UL)
+
+#define TWIM_INTENSET_STOPPED_Msk      (1UL << 1)
+#define TWIM_INTENSET_ERROR_Msk        (1UL << 9)
+#define TWIM_INTENSET_RXSTARTED_Msk    (1UL << 19)
+#define TWIM_INTENSET_TXSTARTED_Msk    (1UL << 20)
+#define TWIM_INTENSET_LASTRX_Msk       (1UL << 23)
+#define TWIM_INTENSET_LASTTX_Msk       (1UL << 24)
+
+#define TWIM_SHORTS_LASTTX_STARTRX_Msk (1UL << 7)
+#define TWIM_SHORTS_LASTTX_SUSPEND_Msk (1UL << 8)
+#define TWIM_SHORTS_LASTTX_STOP_Msk    (1UL << 9)
+#define TWIM_SHORTS_LASTRX_STARTTX_Msk (1UL << 10)
+#define TWIM_SHORTS_LASTRX_STOP_Msk    (1UL << 12)
+
+#define TIMER_MODE_MODE_Pos            (0UL)
+#define TIMER_MODE_MODE_Timer          (0UL)
+#define TIMER_MODE_MODE_Counter        (1UL)
+#define TIMER_BITMODE_BITMODE_Pos      (0UL)
+#define TIMER_BITMODE_BITMODE_16Bit    (0UL)
+#define TIMER_BITMODE_BITMODE_08Bit    (1UL)
+#define TIMER_BITMODE_BITMODE_24Bit    (2UL)
+#define TIMER_BITMODE_BITMODE_32Bit    (3UL)
+#define TIMER_SHORTS_COMPARE0_CLEAR_Msk (1UL << 0)
+#define TIMER_SHORTS_COMPARE1_CLEAR_Msk (1UL << 1)
+#define TIMER_SHORTS_COMPARE0_STOP_Msk (1UL << 8)
+#define TIMER_SHORTS_COMPARE1_STOP_Msk (1UL << 9)
+#define TIMER_INTENSET_COMPARE0_Msk    (1UL << 16)
+#define TIMER_INTENSET_COMPARE1_Msk    (1UL << 17)
+
+#define GPIO_PIN_CNF_DIR_Pos           (0UL)
+#define GPIO_PIN_CNF_DIR_Input         (0UL)
+#define GPIO_PIN_CNF_DIR_Output        (1UL)
+#define GPIO_PIN_CNF_INPUT_Pos         (1UL)
+#define GPIO_PIN_CNF_INPUT_Connect     (0UL)
+#define GPIO_PIN_CNF_PULL_Pos          (2UL)
+#define GPIO_PIN_CNF_PULL_Pullup       (3UL)
+#define GPIO_PIN_CNF_DRIVE_Pos         (8UL)
+#define GPIO_PIN_CNF_DRIVE_S0D1        (6UL)
+#define GPIO_PIN_CNF_SENSE_Pos         (16UL)
+#define GPIO_PIN_CNF_SENSE_Disabled    (0UL)
+
+#endif // NRF_H
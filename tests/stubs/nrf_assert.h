@@ -0,0 +1,31 @@
+/* Copyright (c) 2015 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/* Host build of nrf_assert.h, a failed assertion fails the test. */
+
+#ifndef NRF_ASSERT_H_
+#define NRF_ASSERT_H_
+
+#include <stdint.h>
+
+void assert_nrf_callback(uint16_t line_num, const uint8_t * file_name);
+
+#define ASSERT(expr)                                                   \
+    do                                                                 \
+    {                                                                  \
+        if (!(expr))                                                   \
+        {                                                              \
+            assert_nrf_callback((uint16_t)__LINE__, (uint8_t *)__FILE__); \
+        }                                                              \
+    } while (0)
+
+#endif // NRF_ASSERT_H_
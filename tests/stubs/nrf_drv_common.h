@@ -0,0 +1,36 @@
+/* Copyright (c) 2015 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/* Host build of nrf_drv_common.h. */
+
+#ifndef NRF_DRV_COMMON_H__
+#define NRF_DRV_COMMON_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "nrf.h"
+#include "sdk_errors.h"
+#include "nrf_drv_config.h"
+
+typedef enum
+{
+    NRF_DRV_STATE_UNINITIALIZED,
+    NRF_DRV_STATE_INITIALIZED,
+    NRF_DRV_STATE_POWERED_ON
+} nrf_drv_state_t;
+
+void      nrf_drv_common_irq_enable(IRQn_Type irqn, uint8_t priority);
+void      nrf_drv_common_irq_disable(IRQn_Type irqn);
+IRQn_Type nrf_drv_get_IRQn(void const * const p_reg);
+bool      nrf_drv_is_in_RAM(void const * const ptr);
+
+#endif // NRF_DRV_COMMON_H__
@@ -0,0 +1,73 @@
+/* Copyright (c) 2015 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/* Driver configuration of the host tests: TWI0 is a TWIM, TWI1 a legacy TWI, and every
+ * optional driver feature is compiled in. The transfer trace is only built in test_twi_trace. */
+
+#ifndef NRF_DRV_CONFIG_H
+#define NRF_DRV_CONFIG_H
+
+#define TWI0_ENABLED 1
+#define TWI0_USE_EASY_DMA 1
+
+#if (TWI0_ENABLED == 1)
+#define TWI0_CONFIG_FREQUENCY    NRF_TWI_FREQ_100K
+#define TWI0_CONFIG_SCL          3
+#define TWI0_CONFIG_SDA          4
+#define TWI0_CONFIG_IRQ_PRIORITY APP_IRQ_PRIORITY_HIGH
+
+#define TWI0_INSTANCE_INDEX      0
+#endif
+
+#define TWI1_ENABLED 1
+#define TWI1_USE_EASY_DMA 0
+
+#if (TWI1_ENABLED == 1)
+#define TWI1_CONFIG_FREQUENCY    NRF_TWI_FREQ_400K
+#define TWI1_CONFIG_SCL          5
+#define TWI1_CONFIG_SDA          6
+#define TWI1_CONFIG_IRQ_PRIORITY APP_IRQ_PRIORITY_HIGH
+
+#define TWI1_INSTANCE_INDEX      (TWI0_ENABLED)
+#endif
+
+#define TWI_COUNT                (TWI0_ENABLED+TWI1_ENABLED)
+
+#define TWI_QUEUE_SIZE           8    /* Transfers queued per instance, must be a power of two. */
+#define TWI_SCAN_TABLE_SIZE      5    /* Maximum number of entries in a TWIM scan table. */
+
+/* TWI driver features, disabled ones are compiled out. */
+#define TWI_BLOCKING_ENABLED     1    /* Blocking mode when no event handler is given. */
+#define TWI_LIST_ENABLED         1    /* TWIM TX/RX list post-increment. */
+#define TWI_REPEATED_ENABLED     1    /* Repeated and held transfers triggered over PPI. */
+#define TWI_QUEUE_ENABLED        1    /* Transfer queue. */
+#define TWI_SCAN_ENABLED         1    /* Multi-slave scan tables, needs TWI_LIST_ENABLED. */
+#define TWI_RECOVERY_ENABLED     1    /* Retries, bus clear and error counters. */
+
+#define TWI_RECOVERY_RETRIES          2    /* Retries of a failed transfer, up to 8. */
+#define TWI_RECOVERY_BACKOFF_US       100  /* Delay before the first blocking retry, doubled per retry. */
+#define TWI_RECOVERY_BUS_CLEAR_AFTER  3    /* Failed transfers in a row before the bus is cleared. */
+
+#ifndef TWI_TRACE_ENABLED
+#define TWI_TRACE_ENABLED        0    /* Per-transfer timestamps in a trace ring, on in test_twi_trace. */
+#endif
+#define TWI_TRACE_SIZE           32   /* Records in the trace ring, must be a power of two. */
+
+#if (TWI_TRACE_ENABLED == 1)
+#include <stdint.h>
+uint64_t sim_now(void);
+/* The simulator clock in ns instead of the DWT cycle counter. */
+#define TWI_TRACE_TIMESTAMP()    ((uint32_t)sim_now())
+#define TWI_TRACE_TIMESTAMP_HZ   1000000000UL
+#endif
+
+#endif // NRF_DRV_CONFIG_H
@@ -0,0 +1,33 @@
+/* Copyright (c) 2015 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/* Host build of nrf_drv_ppi.h, the channels are modelled by the simulator (sim/sim.c). */
+
+#ifndef NRF_DRV_PPI_H__
+#define NRF_DRV_PPI_H__
+
+#include <stdint.h>
+#include "sdk_errors.h"
+
+typedef enum
+{
+    NRF_PPI_CHANNEL0 = 0,
+} nrf_ppi_channel_t;
+
+uint32_t nrf_drv_ppi_init(void);
+uint32_t nrf_drv_ppi_channel_alloc(nrf_ppi_channel_t * p_channel);
+uint32_t nrf_drv_ppi_channel_free(nrf_ppi_channel_t channel);
+uint32_t nrf_drv_ppi_channel_assign(nrf_ppi_channel_t channel, uint32_t eep, uint32_t tep);
+uint32_t nrf_drv_ppi_channel_enable(nrf_ppi_channel_t channel);
+uint32_t nrf_drv_ppi_channel_disable(nrf_ppi_channel_t channel);
+
+#endif // NRF_DRV_PPI_H__
@@ -0,0 +1,27 @@
+/* Copyright (c) 2015 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/* Host build of nrf_gpio.h, the pins are modelled by the simulator (sim/sim.c). */
+
+#ifndef NRF_GPIO_H__
+#define NRF_GPIO_H__
+
+#include <stdint.h>
+#include "nrf.h"
+
+void     nrf_gpio_pin_set(uint32_t pin_number);
+void     nrf_gpio_pin_clear(uint32_t pin_number);
+void     nrf_gpio_pin_toggle(uint32_t pin_number);
+uint32_t nrf_gpio_pin_read(uint32_t pin_number);
+void     nrf_gpio_cfg_output(uint32_t pin_number);
+
+#endif // NRF_GPIO_H__
@@ -0,0 +1,90 @@
+/* Copyright (c) 2015 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/* Host build of the legacy TWI HAL, implemented by the simulator (sim/sim.c). */
+
+#ifndef NRF_TWI_H__
+#define NRF_TWI_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "nrf.h"
+
+typedef enum
+{
+    NRF_TWI_TASK_STARTRX = 0x000,
+    NRF_TWI_TASK_STARTTX = 0x008,
+    NRF_TWI_TASK_STOP    = 0x014,
+    NRF_TWI_TASK_SUSPEND = 0x01C,
+    NRF_TWI_TASK_RESUME  = 0x020,
+} nrf_twi_task_t;
+
+typedef enum
+{
+    NRF_TWI_EVENT_STOPPED      = 0x104,
+    NRF_TWI_EVENT_RXDREADY     = 0x108,
+    NRF_TWI_EVENT_TXDSENT      = 0x11C,
+    NRF_TWI_EVENT_ERROR        = 0x124,
+    NRF_TWI_EVENT_BYTEBOUNDARY = 0x138,
+    NRF_TWI_EVENT_SUSPENDED    = 0x148,
+} nrf_twi_event_t;
+
+typedef enum
+{
+    NRF_TWI_SHORT_BB_SUSPEND_MASK = (1UL << 0),
+    NRF_TWI_SHORT_BB_STOP_MASK    = (1UL << 1),
+} nrf_twi_short_mask_t;
+
+typedef enum
+{
+    NRF_TWI_INT_STOPPED_MASK   = (1UL << 1),
+    NRF_TWI_INT_RXDREADY_MASK  = (1UL << 2),
+    NRF_TWI_INT_TXDSENT_MASK   = (1UL << 7),
+    NRF_TWI_INT_ERROR_MASK     = (1UL << 9),
+    NRF_TWI_INT_BB_MASK        = (1UL << 14),
+    NRF_TWI_INT_SUSPENDED_MASK = (1UL << 18),
+} nrf_twi_int_mask_t;
+
+typedef enum
+{
+    NRF_TWI_ERROR_ADDRESS_NACK = (1UL << 1),
+    NRF_TWI_ERROR_DATA_NACK    = (1UL << 2),
+} nrf_twi_error_t;
+
+typedef enum
+{
+    NRF_TWI_FREQ_100K = 0x01980000UL,
+    NRF_TWI_FREQ_250K = 0x04000000UL,
+    NRF_TWI_FREQ_400K = 0x06680000UL,
+} nrf_twi_frequency_t;
+
+void       nrf_twi_task_trigger(NRF_TWI_Type * p_twi, nrf_twi_task_t task);
+uint32_t * nrf_twi_task_address_get(NRF_TWI_Type * p_twi, nrf_twi_task_t task);
+void       nrf_twi_event_clear(NRF_TWI_Type * p_twi, nrf_twi_event_t event);
+bool       nrf_twi_event_check(NRF_TWI_Type * p_twi, nrf_twi_event_t event);
+uint32_t * nrf_twi_event_address_get(NRF_TWI_Type * p_twi, nrf_twi_event_t event);
+void       nrf_twi_shorts_set(NRF_TWI_Type * p_twi, uint32_t shorts_mask);
+void       nrf_twi_shorts_enable(NRF_TWI_Type * p_twi, uint32_t shorts_mask);
+void       nrf_twi_shorts_disable(NRF_TWI_Type * p_twi, uint32_t shorts_mask);
+void       nrf_twi_int_enable(NRF_TWI_Type * p_twi, uint32_t int_mask);
+void       nrf_twi_int_disable(NRF_TWI_Type * p_twi, uint32_t int_mask);
+bool       nrf_twi_int_enable_check(NRF_TWI_Type * p_twi, nrf_twi_int_mask_t int_mask);
+uint32_t   nrf_twi_errorsrc_get_and_clear(NRF_TWI_Type * p_twi);
+void       nrf_twi_enable(NRF_TWI_Type * p_twi);
+void       nrf_twi_disable(NRF_TWI_Type * p_twi);
+void       nrf_twi_pins_set(NRF_TWI_Type * p_twi, uint32_t scl_pin, uint32_t sda_pin);
+void       nrf_twi_frequency_set(NRF_TWI_Type * p_twi, nrf_twi_frequency_t frequency);
+uint8_t    nrf_twi_rxd_get(NRF_TWI_Type * p_twi);
+void       nrf_twi_txd_set(NRF_TWI_Type * p_twi, uint8_t data);
+void       nrf_twi_address_set(NRF_TWI_Type * p_twi, uint8_t address);
+
+#endif // NRF_TWI_H__
@@ -0,0 +1,42 @@
+/* Copyright (c) 2015 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+/* Host build of sdk_errors.h and nrf_error.h. */
+
+#ifndef SDK_ERRORS_H__
+#define SDK_ERRORS_H__
+
+#include <stdint.h>
+
+typedef uint32_t ret_code_t;
+
+#define NRF_ERROR_BASE_NUM                 (0x0)
+#define NRF_SUCCESS                        (NRF_ERROR_BASE_NUM + 0)
+#define NRF_ERROR_SVC_HANDLER_MISSING      (NRF_ERROR_BASE_NUM + 1)
+#define NRF_ERROR_SOFTDEVICE_NOT_ENABLED   (NRF_ERROR_BASE_NUM + 2)
+#define NRF_ERROR_INTERNAL                 (NRF_ERROR_BASE_NUM + 3)
+#define NRF_ERROR_NO_MEM                   (NRF_ERROR_BASE_NUM + 4)
+#define NRF_ERROR_NOT_FOUND                (NRF_ERROR_BASE_NUM + 5)
+#define NRF_ERROR_NOT_SUPPORTED            (NRF_ERROR_BASE_NUM + 6)
+#define NRF_ERROR_INVALID_PARAM            (NRF_ERROR_BASE_NUM + 7)
+#define NRF_ERROR_INVALID_STATE            (NRF_ERROR_BASE_NUM + 8)
+#define NRF_ERROR_INVALID_LENGTH           (NRF_ERROR_BASE_NUM + 9)
+#define NRF_ERROR_INVALID_FLAGS            (NRF_ERROR_BASE_NUM + 10)
+#define NRF_ERROR_INVALID_DATA             (NRF_ERROR_BASE_NUM + 11)
+#define NRF_ERROR_DATA_SIZE                (NRF_ERROR_BASE_NUM + 12)
+#define NRF_ERROR_TIMEOUT                  (NRF_ERROR_BASE_NUM + 13)
+#define NRF_ERROR_NULL                     (NRF_ERROR_BASE_NUM + 14)
+#define NRF_ERROR_FORBIDDEN                (NRF_ERROR_BASE_NUM + 15)
+#define NRF_ERROR_INVALID_ADDR             (NRF_ERROR_BASE_NUM + 16)
+#define NRF_ERROR_BUSY                     (NRF_ERROR_BASE_NUM + 17)
+
+#endif // SDK_ERRORS_H__
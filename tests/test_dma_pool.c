@@ -0,0 +1,240 @@
+/* Copyright (c) 2015 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+
+/* EasyDMA buffer pool: blocks, statistics, use from the TWI interrupt, and the register writes
+ * of the BLE LED sensor demo, which take their TX buffer from a pool. */
+
+#include "sim.h"
+#include "sim_reg_slave.h"
+#include "dma_pool.h"
+#include "nrf_drv_twi_mod.h"
+#include "../05_ble_led_sensor/mma7660.h"
+#include <stdio.h>
+#include <string.h>
+
+#define BLOCK_SIZE   6
+#define BLOCK_COUNT  4
+
+DMA_POOL_DEF(m_pool, BLOCK_SIZE, BLOCK_COUNT);
+
+static const nrf_drv_twi_t m_twim = NRF_DRV_TWI_INSTANCE(0);
+static bool                m_twim_init;
+static sim_reg_slave_t     m_sensor;
+static uint8_t             m_tx[2];
+static uint32_t            m_isr_allocs;
+static uint32_t            m_events;
+static uint32_t            m_events_wanted;
+
+// Blocks are word aligned and rounded up, distinct, and the pool runs dry after block_count.
+static void test_blocks(void)
+{
+    uint8_t *        p_blocks[BLOCK_COUNT];
+    dma_pool_stats_t stats;
+
+    sim_reset();
+    dma_pool_init(&m_pool);
+    SIM_CHECK_EQ(m_pool.block_size, 8);
+    for (uint32_t i = 0; i < BLOCK_COUNT; i++)
+    {
+        p_blocks[i] = dma_pool_alloc(&m_pool);
+        SIM_CHECK(p_blocks[i] != NULL);
+        SIM_CHECK_EQ((uintptr_t)p_blocks[i] % 4, 0);
+        SIM_CHECK(p_blocks[i] >= m_pool.p_memory);
+        SIM_CHECK(p_blocks[i] + m_pool.block_size <= m_pool.p_memory + sizeof(m_pool_memory));
+        memset(p_blocks[i], 0xA0 + i, m_pool.block_size);
+        for (uint32_t j = 0; j < i; j++)
+        {
+            SIM_CHECK(p_blocks[i] != p_blocks[j]);
+        }
+    }
+    SIM_CHECK(dma_pool_alloc(&m_pool) == NULL);
+    SIM_CHECK(dma_pool_alloc(&m_pool) == NULL);
+    for (uint32_t i = 0; i < BLOCK_COUNT; i++)
+    {
+        // A block is not touched by the other allocations.
+        SIM_CHECK_EQ(p_blocks[i][m_pool.block_size - 1], 0xA0 + i);
+    }
+
+    dma_pool_stats_get(&m_pool, &stats);
+    SIM_CHECK_EQ(stats.in_use, BLOCK_COUNT);
+    SIM_CHECK_EQ(stats.high_water, BLOCK_COUNT);
+    SIM_CHECK_EQ(stats.failed, 2);
+
+    // Last freed is the next allocated.
+    dma_pool_free(&m_pool, p_blocks[1]);
+    dma_pool_free(&m_pool, p_blocks[3]);
+    SIM_CHECK(dma_pool_alloc(&m_pool) == p_blocks[3]);
+    SIM_CHECK(dma_pool_alloc(&m_pool) == p_blocks[1]);
+    for (uint32_t i = 0; i < BLOCK_COUNT; i++)
+    {
+        dma_pool_free(&m_pool, p_blocks[i]);
+    }
+    dma_pool_stats_get(&m_pool, &stats);
+    SIM_CHECK_EQ(stats.in_use, 0);
+    SIM_CHECK_EQ(stats.high_water, BLOCK_COUNT);
+
+    dma_pool_init(&m_pool);
+    dma_pool_stats_get(&m_pool, &stats);
+    SIM_CHECK_EQ(stats.high_water, 0);
+    SIM_CHECK_EQ(stats.failed, 0);
+}
+
+// Allocates and frees a block on every TWI event, while the thread does the same.
+static void isr_handler(nrf_drv_twi_evt_t const * p_event, void * p_context)
+{
+    nrf_drv_twi_xfer_desc_t xfer = NRF_DRV_TWI_XFER_DESC_TX(0x4C, m_tx, 2);
+    uint8_t * p_block = dma_pool_alloc(&m_pool);
+
+    (void)p_context;
+    if (p_block != NULL)
+    {
+        m_isr_allocs++;
+        dma_pool_free(&m_pool, p_block);
+    }
+    if (++m_events < 200)
+    {
+        SIM_CHECK_EQ(nrf_drv_twi_xfer(&m_twim, &xfer, 0), NRF_SUCCESS);
+    }
+}
+
+static void setup(nrf_drv_twi_evt_handler_t handler)
+{
+    if (m_twim_init)
+    {
+        nrf_drv_twi_uninit(&m_twim);
+    }
+    sim_reset();
+    sim_reg_slave_init(&m_sensor, 0x4C);
+    sim_slave_attach(0, &m_sensor.slave);
+    SIM_CHECK_EQ(nrf_drv_twi_init(&m_twim, NULL, handler, NULL), NRF_SUCCESS);
+    nrf_drv_twi_enable(&m_twim);
+    m_twim_init = true;
+}
+
+static bool events_done(void)
+{
+    return m_events >= 200;
+}
+
+// The free list stays whole when the interrupt allocates in the middle of a thread allocation.
+static void test_isr(void)
+{
+    nrf_drv_twi_xfer_desc_t xfer = NRF_DRV_TWI_XFER_DESC_TX(0x4C, m_tx, 2);
+    uint8_t *               p_blocks[BLOCK_COUNT];
+    dma_pool_stats_t        stats;
+    uint32_t                thread_allocs = 0;
+
+    setup(isr_handler);
+    dma_pool_init(&m_pool);
+    SIM_CHECK_EQ(nrf_drv_twi_xfer(&m_twim, &xfer, 0), NRF_SUCCESS);
+    while (!events_done())
+    {
+        uint32_t count = 0;
+
+        while ((count < BLOCK_COUNT - 1) && ((p_blocks[count] = dma_pool_alloc(&m_pool)) != NULL))
+        {
+            count++;
+            sim_cpu(1000);
+        }
+        thread_allocs += count;
+        while (count != 0)
+        {
+            dma_pool_free(&m_pool, p_blocks[--count]);
+            sim_cpu(1000);
+        }
+    }
+    dma_pool_stats_get(&m_pool, &stats);
+    SIM_CHECK_EQ(stats.in_use, 0);
+    SIM_CHECK(stats.high_water <= BLOCK_COUNT);
+    SIM_CHECK(m_isr_allocs > 0);
+    SIM_CHECK(thread_allocs > 0);
+
+    // All blocks still reachable, and each once.
+    for (uint32_t i = 0; i < BLOCK_COUNT; i++)
+    {
+        p_blocks[i] = dma_pool_alloc(&m_pool);
+        SIM_CHECK(p_blocks[i] != NULL);
+        for (uint32_t j = 0; j < i; j++)
+        {
+            SIM_CHECK(p_blocks[i] != p_blocks[j]);
+        }
+    }
+    SIM_CHECK(dma_pool_alloc(&m_pool) == NULL);
+}
+
+static void sensor_handler(nrf_drv_twi_evt_t const * p_event, void * p_context)
+{
+    (void)p_context;
+    m_events++;
+    mma7660_twi_evt_handler(p_event);
+}
+
+static bool events_reached(void)
+{
+    return m_events >= m_events_wanted;
+}
+
+// Runs until the pending transfers gave @p count events.
+static void events_wait(uint32_t count, uint64_t timeout_ns)
+{
+    m_events_wanted = count;
+    SIM_CHECK(sim_run_until(events_reached, timeout_ns));
+    m_events = 0;
+}
+
+// mma7660_register_write of the BLE LED sensor demo: the value outlives the call, the block is
+// back in the pool after the event, and the pool bounds the writes in flight.
+static void test_register_write(void)
+{
+    setup(sensor_handler);
+    m_events = 0;
+    SIM_CHECK_EQ(mma7660_init(&m_twim, SAMPLES_PER_SEC_32), NRF_SUCCESS);
+    SIM_CHECK_EQ(mma7660_init(&m_twim, SAMPLES_PER_SEC_32), NRF_ERROR_BUSY);
+    events_wait(1, 10000000);
+    SIM_CHECK_EQ(mma7660_init_result_get(), NRF_SUCCESS);
+    SIM_CHECK_EQ(mma7660_register_write(&m_twim, MMA7660_MODE, 0), NRF_SUCCESS);
+    SIM_CHECK_EQ(mma7660_register_write(&m_twim, MMA7660_SPCNT, 0x55), NRF_SUCCESS);
+    SIM_CHECK_EQ(mma7660_register_write(&m_twim, MMA7660_PD, 0x11), NRF_ERROR_NO_MEM);
+    events_wait(2, 10000000);
+    SIM_CHECK_EQ(m_sensor.regs[MMA7660_MODE], 0);
+    SIM_CHECK_EQ(m_sensor.regs[MMA7660_SPCNT], 0x55);
+    SIM_CHECK_EQ(m_sensor.regs[MMA7660_PD], 0);
+    SIM_CHECK_EQ(sim_dma_stack_accesses(), 0);
+
+    SIM_CHECK_EQ(mma7660_register_write(&m_twim, MMA7660_PD, 0x11), NRF_SUCCESS);
+    SIM_CHECK_EQ(mma7660_register_write(&m_twim, MMA7660_MODE, MMA7660_MODE_ACTIVE), NRF_SUCCESS);
+    events_wait(2, 10000000);
+    SIM_CHECK_EQ(m_sensor.regs[MMA7660_PD], 0x11);
+    SIM_CHECK_EQ(m_sensor.regs[MMA7660_MODE], MMA7660_MODE_ACTIVE);
+
+    // A failed write gives its block back too.
+    sim_fault_address_nack(0, 100);
+    SIM_CHECK_EQ(mma7660_register_write(&m_twim, MMA7660_MODE, 0), NRF_SUCCESS);
+    SIM_CHECK_EQ(mma7660_register_write(&m_twim, MMA7660_MODE, 0), NRF_SUCCESS);
+    events_wait(2, 100000000);
+    sim_fault_address_nack(0, 0);
+    SIM_CHECK_EQ(mma7660_register_write(&m_twim, MMA7660_SPCNT, 0x66), NRF_SUCCESS);
+    SIM_CHECK_EQ(mma7660_register_write(&m_twim, MMA7660_PD, 0x22), NRF_SUCCESS);
+    events_wait(2, 10000000);
+    SIM_CHECK_EQ(m_sensor.regs[MMA7660_SPCNT], 0x66);
+    SIM_CHECK_EQ(m_sensor.regs[MMA7660_PD], 0x22);
+}
+
+int main(void)
+{
+    test_blocks();
+    test_isr();
+    test_register_write();
+    printf("test_dma_pool: OK\n");
+    return 0;
+}
@@ -0,0 +1,187 @@
+/* Copyright (c) 2015 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+
+/* EEPROM page writer of the TWI list demo against the C model of a 24Cxx EEPROM: page split,
+ * one START per page attempt, ACK polling when the write cycle outlasts EEPROM_WRITE_CYCLE_US,
+ * and the effective write speed for a few write cycle times. */
+
+#include "sim.h"
+#include "sim_eeprom.h"
+#include "eeprom_writer.h"
+#include <stdio.h>
+#include <string.h>
+
+#define TWIM_BUS 0
+
+static const nrf_drv_twi_t m_twim = NRF_DRV_TWI_INSTANCE(0);
+static const uint8_t       m_flash_data[EEPROM_SIM_SIZE] = { [0] = 0xC3, [EEPROM_SIM_SIZE - 1] = 0x3C };
+
+static sim_eeprom_t        m_eeprom;
+static bool                m_init;
+static uint8_t             m_data[EEPROM_SIM_SIZE];
+static volatile bool       m_done;
+static ret_code_t          m_result;
+static uint16_t            m_written;
+
+static void write_handler(ret_code_t result, uint16_t written)
+{
+    m_result  = result;
+    m_written = written;
+    m_done    = true;
+}
+
+static void twi_handler(nrf_drv_twi_evt_t const * p_event, void * p_context)
+{
+    (void)p_context;
+    eeprom_writer_twi_evt_handler(p_event);
+}
+
+static bool write_done(void)
+{
+    return m_done;
+}
+
+static void setup(uint64_t write_cycle_ns)
+{
+    if (m_init)
+    {
+        nrf_drv_twi_uninit(&m_twim);
+    }
+    sim_reset();
+    sim_eeprom_init(&m_eeprom, EEPROM_SIM_ADDR, EEPROM_SIM_SIZE, EEPROM_SIM_SEQ_WRITE_MAX,
+                    write_cycle_ns);
+    sim_slave_attach(TWIM_BUS, &m_eeprom.slave);
+    SIM_CHECK_EQ(nrf_drv_twi_init(&m_twim, NULL, twi_handler, NULL), NRF_SUCCESS);
+    nrf_drv_twi_enable(&m_twim);
+    SIM_CHECK_EQ(eeprom_writer_init(&m_twim), NRF_SUCCESS);
+    m_init = true;
+    for (uint32_t i = 0; i < sizeof(m_data); i++)
+    {
+        m_data[i] = (uint8_t)(i * 7 + 1);
+    }
+}
+
+static void write_run(uint16_t address, uint8_t const * p_data, uint16_t length)
+{
+    m_done = false;
+    SIM_CHECK_EQ(eeprom_writer_write(address, p_data, length, write_handler), NRF_SUCCESS);
+    SIM_CHECK(sim_run_until(write_done, 1000000000ULL));
+}
+
+// Pages split at the boundaries, each one a single START with the address in front of the data.
+static void test_pages(void)
+{
+    sim_bus_stats_t bus;
+    sim_cpu_stats_t cpu;
+    uint32_t        polls = eeprom_writer_polls_get();
+
+    setup((EEPROM_WRITE_CYCLE_US - 200) * 1000ULL);
+    write_run(5, m_data, 40);
+    SIM_CHECK_EQ(m_result, NRF_SUCCESS);
+    SIM_CHECK_EQ(m_written, 40);
+    SIM_CHECK_EQ(memcmp(&m_eeprom.memory[5], m_data, 40), 0);
+    SIM_CHECK_EQ(m_eeprom.memory[4], 0xFF);
+    SIM_CHECK_EQ(m_eeprom.memory[45], 0xFF);
+
+    // 3 + 8 + 8 + 8 + 8 + 5 bytes, and the write cycle is over before every next page.
+    SIM_CHECK_EQ(m_eeprom.page_writes, 6);
+    SIM_CHECK_EQ(eeprom_writer_polls_get(), polls);
+    sim_bus_stats_get(TWIM_BUS, &bus);
+    SIM_CHECK_EQ(bus.starts, 6);
+    SIM_CHECK_EQ(bus.bytes, 6 + 40);
+    SIM_CHECK_EQ(m_eeprom.aborted, 0);
+    sim_cpu_stats_get(&cpu);
+    SIM_CHECK_EQ(cpu.isr_count, 6);
+
+    SIM_CHECK_EQ(eeprom_writer_write(120, m_data, 9, write_handler), NRF_ERROR_INVALID_LENGTH);
+    SIM_CHECK_EQ(eeprom_writer_write(0, m_data, 0, write_handler), NRF_ERROR_INVALID_LENGTH);
+    SIM_CHECK_EQ(eeprom_writer_write(0, m_data, 8, write_handler), NRF_SUCCESS);
+    SIM_CHECK_EQ(eeprom_writer_write(0, m_data, 8, write_handler), NRF_ERROR_BUSY);
+    m_done = false;
+    SIM_CHECK(sim_run_until(write_done, 1000000000ULL));
+    SIM_CHECK_EQ(m_result, NRF_SUCCESS);
+
+    // Whole memory from flash, the pages are copied so the source can be anywhere.
+    write_run(0, m_flash_data, EEPROM_SIM_SIZE);
+    SIM_CHECK_EQ(m_result, NRF_SUCCESS);
+    SIM_CHECK_EQ(memcmp(m_eeprom.memory, m_flash_data, EEPROM_SIM_SIZE), 0);
+}
+
+// A write cycle longer than EEPROM_WRITE_CYCLE_US: each page is retried until it is taken.
+static void test_polls(void)
+{
+    sim_bus_stats_t bus;
+    sim_cpu_stats_t cpu;
+    uint32_t        polls;
+
+    setup((EEPROM_WRITE_CYCLE_US + 1200) * 1000ULL);
+    polls = eeprom_writer_polls_get();
+    write_run(16, m_data, 32);
+    SIM_CHECK_EQ(m_result, NRF_SUCCESS);
+    SIM_CHECK_EQ(memcmp(&m_eeprom.memory[16], m_data, 32), 0);
+    SIM_CHECK_EQ(m_eeprom.page_writes, 4);
+    SIM_CHECK(m_eeprom.busy_nacks > 0);
+    SIM_CHECK_EQ(eeprom_writer_polls_get() - polls, m_eeprom.busy_nacks);
+    sim_bus_stats_get(TWIM_BUS, &bus);
+    SIM_CHECK_EQ(bus.address_nacks, m_eeprom.busy_nacks);
+    SIM_CHECK_EQ(bus.stops, 4 + m_eeprom.busy_nacks);
+    sim_cpu_stats_get(&cpu);
+    // ERROR and then STOPPED for each refused attempt.
+    SIM_CHECK_EQ(cpu.isr_count, 4 + 2 * m_eeprom.busy_nacks);
+
+    // An EEPROM that never comes back is given up after EEPROM_POLL_MAX polls.
+    setup(1000000000ULL);
+    write_run(0, m_data, 16);
+    SIM_CHECK_EQ(m_result, NRF_ERROR_TIMEOUT);
+    SIM_CHECK_EQ(m_written, 8);
+    SIM_CHECK_EQ(m_eeprom.busy_nacks, EEPROM_POLL_MAX + 1);
+    SIM_CHECK_EQ(memcmp(m_eeprom.memory, m_data, 8), 0);
+    SIM_CHECK_EQ(m_eeprom.memory[8], 0xFF);
+}
+
+// Effective write speed of the whole memory against the EEPROM write cycle time.
+static void test_speed(void)
+{
+    static const uint32_t cycle_us[] = { 3000, 5000, 6000, 10000 };
+
+    printf("%u bytes, pages of %u, next page after %u us, polls every %u us\n",
+           EEPROM_SIM_SIZE, EEPROM_SIM_SEQ_WRITE_MAX, EEPROM_WRITE_CYCLE_US, EEPROM_POLL_INTERVAL_US);
+    for (uint32_t i = 0; i < sizeof(cycle_us) / sizeof(cycle_us[0]); i++)
+    {
+        uint64_t start;
+        uint64_t elapsed;
+        uint32_t polls;
+
+        // The second write starts in the write cycle of the first one, like back to back writes.
+        setup(cycle_us[i] * 1000ULL);
+        write_run(0, m_data, EEPROM_SIM_SIZE);
+        start = sim_now();
+        polls = eeprom_writer_polls_get();
+        write_run(0, m_data, EEPROM_SIM_SIZE);
+        elapsed = sim_now() - start;
+        polls   = eeprom_writer_polls_get() - polls;
+        SIM_CHECK_EQ(m_result, NRF_SUCCESS);
+        SIM_CHECK_EQ(memcmp(m_eeprom.memory, m_data, EEPROM_SIM_SIZE), 0);
+        printf("  write cycle %5u us: %6.0f bytes/s, %2u polls\n", (unsigned)cycle_us[i],
+               EEPROM_SIM_SIZE * 1e9 / elapsed, (unsigned)polls);
+    }
+}
+
+int main(void)
+{
+    test_pages();
+    test_polls();
+    test_speed();
+    printf("test_eeprom_writer: OK\n");
+    return 0;
+}
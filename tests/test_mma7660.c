@@ -0,0 +1,271 @@
+/* Copyright (c) 2015 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+
+/* MMA7660 module against the C model of the sensor, replaying tests/traces/motion_30s.csv. */
+
+#include "sim.h"
+#include "sim_mma7660.h"
+#include "mma7660.h"
+#include <stdio.h>
+#include <string.h>
+
+#define TWIM_BUS    0
+#define TRACE_PATH  "traces/motion_30s.csv"
+#define TRACE_MAX   2000
+#define TRACE_T0_NS 5000000ULL // After the init writes.
+#define DECODE_MAX  67
+
+static const nrf_drv_twi_t m_twim = NRF_DRV_TWI_INSTANCE(0);
+
+static sim_mma7660_sample_t m_trace[TRACE_MAX];
+static uint32_t             m_trace_length;
+static sim_mma7660_t        m_sensor;
+
+static volatile uint32_t    m_event_count;
+static nrf_drv_twi_evt_t    m_event;
+static uint8_t              m_reg_x = MMA7660_X;
+static uint8_t              m_data[4];
+static bool                 m_init;
+
+static void twi_handler(nrf_drv_twi_evt_t const * p_event, void * p_context)
+{
+    (void)p_context;
+    mma7660_twi_evt_handler(p_event);
+    m_event = *p_event;
+    m_event_count++;
+}
+
+static bool event_done(void)
+{
+    return m_event_count != 0;
+}
+
+static void setup(uint64_t alert_ns)
+{
+    if (m_init)
+    {
+        nrf_drv_twi_uninit(&m_twim);
+    }
+    sim_reset();
+    sim_mma7660_init(&m_sensor, m_trace, m_trace_length, alert_ns);
+    sim_slave_attach(TWIM_BUS, &m_sensor.slave);
+    SIM_CHECK_EQ(nrf_drv_twi_init(&m_twim, NULL, twi_handler, NULL), NRF_SUCCESS);
+    nrf_drv_twi_enable(&m_twim);
+    m_init        = true;
+    m_event_count = 0;
+}
+
+// Reads X, Y, Z and TILT when length is 4, which releases INT.
+static void read_xyz(uint8_t length)
+{
+    nrf_drv_twi_xfer_desc_t xfer = NRF_DRV_TWI_XFER_DESC_TXRX(MMA7660_DEFAULT_ADDRESS, &m_reg_x, 1,
+                                                              m_data, length);
+    m_event_count = 0;
+    SIM_CHECK_EQ(nrf_drv_twi_xfer(&m_twim, &xfer, 0), NRF_SUCCESS);
+    SIM_CHECK(sim_run_until(event_done, 10000000));
+    SIM_CHECK_EQ(m_event.type, NRF_DRV_TWI_EVT_DONE);
+}
+
+/* mma7660_int_init() settings land in the registers, and INT-driven reads follow the Python
+ * model on the same trace:
+ *   mma7660_model.py --poll 0 --read 4 --intsu 0xE3 --mode 0x18 --spcnt 160 --sr 0x10
+ *   30.00 s, 263 reads, 1841 bytes, 0 ALERT, 263 INT, asleep 21.54 s (72%) */
+static void test_int_replay(void)
+{
+    static const mma7660_int_config_t config = {
+        .intsu = MMA7660_INTSU_SHINTX | MMA7660_INTSU_SHINTY | MMA7660_INTSU_SHINTZ |
+                 MMA7660_INTSU_FBINT  | MMA7660_INTSU_PLINT,
+        .spcnt = 160,
+        .pdet  = MMA7660_PDET_AXES_OFF,
+        .mode  = MMA7660_MODE_ASE | MMA7660_MODE_AWE,
+        .sr    = MMA7660_SR_AWSR_8,
+    };
+    uint64_t t;
+    uint64_t end   = m_trace[m_trace_length - 1].t_ns;
+    uint32_t reads = 0;
+    uint32_t seen  = 0;
+
+    setup(2000);
+    SIM_CHECK_EQ(mma7660_int_init(&m_twim, SAMPLES_PER_SEC_120, &config), NRF_SUCCESS);
+    SIM_CHECK(sim_run_until(event_done, 10000000));
+    SIM_CHECK_EQ(m_event.type, NRF_DRV_TWI_EVT_DONE);
+    SIM_CHECK_EQ(m_sensor.regs[MMA7660_SPCNT], 160);
+    SIM_CHECK_EQ(m_sensor.regs[MMA7660_INTSU], 0xE3);
+    SIM_CHECK_EQ(m_sensor.regs[MMA7660_SR], SAMPLES_PER_SEC_120 | MMA7660_SR_AWSR_8);
+    SIM_CHECK_EQ(m_sensor.regs[MMA7660_PDET], MMA7660_PDET_AXES_OFF);
+    SIM_CHECK_EQ(m_sensor.regs[MMA7660_MODE], MMA7660_MODE_ACTIVE | MMA7660_MODE_ASE | MMA7660_MODE_AWE);
+    SIM_CHECK(m_sensor.running);
+    SIM_CHECK(sim_now() < TRACE_T0_NS);
+
+    // As the Python model: step at the sensor rate and read when INT went up.
+    for (t = TRACE_T0_NS; t < end; )
+    {
+        t += 1000000000ULL / sim_mma7660_rate(&m_sensor);
+        if (t > sim_now())
+        {
+            sim_run(t - sim_now());
+        }
+        sim_mma7660_advance(&m_sensor, t);
+        if (m_sensor.int_edges == seen)
+        {
+            continue;
+        }
+        seen = m_sensor.int_edges;
+        read_xyz(4);
+        SIM_CHECK(!m_sensor.int_asserted);
+        reads++;
+    }
+    sim_mma7660_finish(&m_sensor, end);
+    printf("INT replay: %u reads, %u INT, asleep %.2f s of %.2f s\n", (unsigned)reads,
+           (unsigned)m_sensor.int_edges, m_sensor.sleep_ns / 1e9, (end - TRACE_T0_NS) / 1e9);
+    SIM_CHECK(reads >= 253 && reads <= 273);
+    SIM_CHECK(m_sensor.sleep_ns > 21300000000ULL && m_sensor.sleep_ns < 21800000000ULL);
+}
+
+// Per-byte reference of mma7660_decode(): bit 6 is ALERT, bits 5..0 a two's complement value.
+static uint32_t decode_ref(int8_t * p_dst, uint8_t const * p_src, uint32_t count)
+{
+    uint32_t alerts = 0;
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        alerts  += (p_src[i] >> 6) & 1;
+        p_dst[i] = (int8_t)((p_src[i] & 0x1F) - (p_src[i] & 0x20));
+    }
+    return alerts;
+}
+
+// mma7660_decode() against the reference: every byte value at every source and destination
+// alignment, random buffers of every length up to DECODE_MAX, and in place. Bytes past count
+// are left alone.
+static void test_decode(void)
+{
+    static uint8_t src[256 + 8];
+    static int8_t  dst[256 + 8];
+    static int8_t  ref[256 + 8];
+    uint32_t       seed = 1;
+    uint32_t       alerts = 0;
+
+    for (uint32_t offset = 0; offset < 4; offset++)
+    {
+        for (uint32_t i = 0; i < 256; i++)
+        {
+            src[offset + i] = (uint8_t)i;
+        }
+        for (uint32_t dst_offset = 0; dst_offset < 4; dst_offset++)
+        {
+            memset(dst, 0x55, sizeof(dst));
+            SIM_CHECK_EQ(mma7660_decode(&dst[dst_offset], &src[offset], 256), 128);
+            SIM_CHECK_EQ(decode_ref(ref, &src[offset], 256), 128);
+            SIM_CHECK_EQ(memcmp(&dst[dst_offset], ref, 256), 0);
+            SIM_CHECK_EQ(dst[dst_offset + 256], 0x55);
+        }
+    }
+    SIM_CHECK_EQ(ref[0x1F], 31);
+    SIM_CHECK_EQ(ref[0x20], -32);
+    SIM_CHECK_EQ(ref[0x7F], -1);
+    SIM_CHECK_EQ(ref[0xC0], 0);
+
+    for (uint32_t round = 0; round < 2000; round++)
+    {
+        uint32_t count  = round % (DECODE_MAX + 1);
+        uint32_t offset = (round / (DECODE_MAX + 1)) % 4;
+        uint32_t ref_alerts;
+
+        for (uint32_t i = 0; i < DECODE_MAX + 4; i++)
+        {
+            seed   = seed * 1103515245 + 12345;
+            src[i] = (uint8_t)(seed >> 16);
+        }
+        memset(dst, 0x55, sizeof(dst));
+        ref_alerts = decode_ref(ref, &src[offset], count);
+        SIM_CHECK_EQ(mma7660_decode(&dst[offset], &src[offset], count), ref_alerts);
+        SIM_CHECK_EQ(memcmp(&dst[offset], ref, count), 0);
+        SIM_CHECK_EQ(dst[offset + count], 0x55);
+
+        SIM_CHECK_EQ(mma7660_decode((int8_t *)&src[offset], &src[offset], count), ref_alerts);
+        SIM_CHECK_EQ(memcmp(&src[offset], ref, count), 0);
+        alerts += ref_alerts;
+    }
+    SIM_CHECK(alerts > 0);
+}
+
+// Polled at 97 Hz, drifting against the 120 Hz updates, with a wide ALERT window:
+// mma7660_decode() flags every ALERT the model set, and the decoded values follow the trace.
+static void test_poll_alert(void)
+{
+    uint32_t decoded_alerts = 0;
+    int8_t   xyz[3];
+    int8_t   x_min = 0;
+    int8_t   x_max = 0;
+
+    setup(600000);
+    SIM_CHECK_EQ(mma7660_init(&m_twim, SAMPLES_PER_SEC_120), NRF_SUCCESS);
+    SIM_CHECK(sim_run_until(event_done, 10000000));
+    for (uint32_t i = 0; i < 97 * 30; i++)
+    {
+        sim_run(TRACE_T0_NS + (i + 1) * (1000000000ULL / 97) - sim_now());
+        read_xyz(3);
+        decoded_alerts += mma7660_decode(xyz, m_data, 3);
+        x_min = (xyz[0] < x_min) ? xyz[0] : x_min;
+        x_max = (xyz[0] > x_max) ? xyz[0] : x_max;
+        if (sim_now() < 9000000000ULL)
+        {
+            SIM_CHECK_EQ(xyz[2], 21);
+        }
+    }
+    printf("97 Hz poll: %u ALERT set, %u decoded, X %d..%d\n", (unsigned)m_sensor.alerts,
+           (unsigned)decoded_alerts, x_min, x_max);
+    SIM_CHECK(m_sensor.alerts > 0);
+    SIM_CHECK_EQ(decoded_alerts, m_sensor.alerts);
+    SIM_CHECK_EQ(x_min, -32);
+    SIM_CHECK_EQ(x_max, 31);
+}
+
+// The init functions share their batch: a second call while the first one is queued is refused
+// and leaves the queued writes alone.
+static void test_init_busy(void)
+{
+    static const mma7660_int_config_t config = {
+        .intsu = MMA7660_INTSU_PLINT,
+        .spcnt = 20,
+    };
+
+    setup(0);
+    SIM_CHECK_EQ(mma7660_init(&m_twim, SAMPLES_PER_SEC_32), NRF_SUCCESS);
+    SIM_CHECK_EQ(mma7660_init_result_get(), NRF_ERROR_BUSY);
+    SIM_CHECK_EQ(mma7660_int_init(&m_twim, SAMPLES_PER_SEC_120, &config), NRF_ERROR_BUSY);
+    SIM_CHECK_EQ(mma7660_init(&m_twim, SAMPLES_PER_SEC_120), NRF_ERROR_BUSY);
+    SIM_CHECK(sim_run_until(event_done, 10000000));
+    SIM_CHECK_EQ(mma7660_init_result_get(), NRF_SUCCESS);
+    SIM_CHECK_EQ(m_sensor.regs[MMA7660_SR], SAMPLES_PER_SEC_32);
+    SIM_CHECK_EQ(m_sensor.regs[MMA7660_SPCNT], 0);
+
+    m_event_count = 0;
+    SIM_CHECK_EQ(mma7660_int_init(&m_twim, SAMPLES_PER_SEC_120, &config), NRF_SUCCESS);
+    SIM_CHECK(sim_run_until(event_done, 10000000));
+    SIM_CHECK_EQ(mma7660_init_result_get(), NRF_SUCCESS);
+    SIM_CHECK_EQ(m_sensor.regs[MMA7660_SR], SAMPLES_PER_SEC_120);
+    SIM_CHECK_EQ(m_sensor.regs[MMA7660_SPCNT], 20);
+}
+
+int main(void)
+{
+    m_trace_length = sim_mma7660_trace_load(TRACE_PATH, m_trace, TRACE_MAX, TRACE_T0_NS);
+    test_decode();
+    test_int_replay();
+    test_poll_alert();
+    test_init_busy();
+    printf("test_mma7660: OK\n");
+    return 0;
+}
@@ -0,0 +1,301 @@
+/* Copyright (c) 2015 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+
+/* Motion features of common/motion_features.c on windows with known results: mean and Q4
+ * variance, the integer square root of the magnitude against sqrt() over the whole sample
+ * range, zero crossings around the previous window mean with the hysteresis, the orientation
+ * classes, and the shake, tap and orientation change bits at their thresholds. */
+
+#include "sim.h"
+#include "motion_features.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#define WINDOW_MAX 300
+
+static motion_features_acc_t m_acc;
+static int8_t                m_xyz[3 * WINDOW_MAX];
+
+// Window of count copies of one sample.
+static void window_fill(int8_t x, int8_t y, int8_t z, uint32_t count)
+{
+    for (uint32_t i = 0; i < count; i++)
+    {
+        m_xyz[3 * i]     = x;
+        m_xyz[3 * i + 1] = y;
+        m_xyz[3 * i + 2] = z;
+    }
+}
+
+static void window_close(int8_t const * p_xyz, uint32_t count, motion_features_t * p_features)
+{
+    motion_features_add(&m_acc, p_xyz, count);
+    motion_features_get(&m_acc, p_features);
+}
+
+static void test_frame(void)
+{
+    motion_features_t features;
+
+    SIM_CHECK_EQ(sizeof(motion_features_t), 16);
+
+    // Lying flat and still.
+    motion_features_init(&m_acc);
+    window_fill(0, 0, 21, 16);
+    window_close(m_xyz, 16, &features);
+    SIM_CHECK_EQ(features.count, 16);
+    SIM_CHECK(features.mean[0] == 0 && features.mean[1] == 0 && features.mean[2] == 21);
+    SIM_CHECK(features.variance[0] == 0 && features.variance[1] == 0 && features.variance[2] == 0);
+    SIM_CHECK_EQ(features.magnitude, 21);
+    SIM_CHECK(features.zero_crossings[0] == 0 && features.zero_crossings[1] == 0 &&
+              features.zero_crossings[2] == 0);
+    SIM_CHECK_EQ(features.orientation, MOTION_ORIENTATION_Z_UP);
+    SIM_CHECK_EQ(features.events, MOTION_EVT_ORIENTATION);
+
+    // The same again: no event, the orientation is that of the previous window.
+    window_close(m_xyz, 16, &features);
+    SIM_CHECK_EQ(features.events, 0);
+
+    // An empty window keeps the orientation and has nothing else.
+    window_close(m_xyz, 0, &features);
+    SIM_CHECK_EQ(features.count, 0);
+    SIM_CHECK_EQ(features.orientation, MOTION_ORIENTATION_Z_UP);
+    SIM_CHECK_EQ(features.events, 0);
+    SIM_CHECK(features.mean[2] == 0 && features.magnitude == 0);
+
+    // At most 255 samples in a window, over several adds.
+    window_fill(0, 0, 21, WINDOW_MAX);
+    motion_features_add(&m_acc, m_xyz, 200);
+    window_close(m_xyz, WINDOW_MAX - 200, &features);
+    SIM_CHECK_EQ(features.count, 255);
+    SIM_CHECK_EQ(features.mean[2], 21);
+}
+
+static void test_mean_variance(void)
+{
+    motion_features_t features;
+
+    motion_features_init(&m_acc);
+    // X alternates 0 and 1, Y -3 and 0, Z 4 and -4: variances 1/4, 9/4 and 16 counts squared.
+    for (uint32_t i = 0; i < 16; i++)
+    {
+        m_xyz[3 * i]     = (int8_t)(i & 1);
+        m_xyz[3 * i + 1] = (int8_t)((i & 1) ? 0 : -3);
+        m_xyz[3 * i + 2] = (int8_t)((i & 1) ? -4 : 4);
+    }
+    window_close(m_xyz, 16, &features);
+    SIM_CHECK_EQ(features.variance[0], 4);
+    SIM_CHECK_EQ(features.variance[1], 36);
+    SIM_CHECK_EQ(features.variance[2], 256);
+    // Means 1/2, -3/2 and 0, rounded half away from zero.
+    SIM_CHECK_EQ(features.mean[0], 1);
+    SIM_CHECK_EQ(features.mean[1], -2);
+    SIM_CHECK_EQ(features.mean[2], 0);
+
+    // Q4 rounds to the nearest sixteenth: three samples 0, 0, 1 have a variance of 2/9.
+    window_fill(0, 0, 0, 3);
+    m_xyz[6] = 1;
+    window_close(m_xyz, 3, &features);
+    SIM_CHECK_EQ(features.variance[0], 4);
+    SIM_CHECK_EQ(features.mean[0], 0);
+
+    // Full scale swings saturate nothing: -32 and 31 give 63^2 / 4 counts squared.
+    for (uint32_t i = 0; i < 255; i++)
+    {
+        m_xyz[3 * i]     = (int8_t)((i & 1) ? 31 : -32);
+        m_xyz[3 * i + 1] = 0;
+        m_xyz[3 * i + 2] = 0;
+    }
+    window_close(m_xyz, 254, &features);
+    SIM_CHECK_EQ(features.variance[0], 63 * 63 * 16 / 4);
+}
+
+// Every sample the MMA7660 can give, as a window of one.
+static void test_magnitude(void)
+{
+    motion_features_t features;
+    int8_t            xyz[3];
+
+    motion_features_init(&m_acc);
+    for (int32_t x = -32; x < 32; x++)
+    {
+        for (int32_t y = -32; y < 32; y++)
+        {
+            for (int32_t z = -32; z < 32; z++)
+            {
+                xyz[0] = (int8_t)x;
+                xyz[1] = (int8_t)y;
+                xyz[2] = (int8_t)z;
+                window_close(xyz, 1, &features);
+                SIM_CHECK_EQ(features.magnitude, (uint32_t)floor(sqrt((double)(x * x + y * y + z * z))));
+            }
+        }
+    }
+
+    // The window value is the rounded mean of the sample magnitudes: 5 and 6.
+    xyz[0] = 3; xyz[1] = 4; xyz[2] = 0;
+    motion_features_add(&m_acc, xyz, 1);
+    xyz[0] = 0; xyz[1] = 6; xyz[2] = 0;
+    window_close(xyz, 1, &features);
+    SIM_CHECK_EQ(features.magnitude, 6);
+}
+
+static void test_zero_crossings(void)
+{
+    static const int8_t x_noise[]  = {0, 1, -1, 1, -1, 1, 0, -1};
+    static const int8_t x_swing[]  = {2, 1, -1, 1, -2, 0, 2, -3, -1, 3};
+    static const int8_t x_offset[] = {-12, -11, -9, -11, -8, -9, -12, -10};
+    motion_features_t   features;
+
+    motion_features_init(&m_acc);
+    window_fill(0, 0, 21, 8);
+    window_close(m_xyz, 8, &features);
+
+    // Within the hysteresis of the mean 0: no crossing.
+    window_fill(0, 0, 21, 8);
+    for (uint32_t i = 0; i < sizeof(x_noise); i++)
+    {
+        m_xyz[3 * i] = x_noise[i];
+    }
+    window_close(m_xyz, sizeof(x_noise), &features);
+    SIM_CHECK_EQ(features.zero_crossings[0], 0);
+    SIM_CHECK_EQ(features.zero_crossings[1], 0);
+    SIM_CHECK_EQ(features.zero_crossings[2], 0);
+
+    // A crossing counts when the other side reaches the hysteresis: 2, -2, 2, -3, 3.
+    window_fill(0, 0, 21, sizeof(x_swing));
+    for (uint32_t i = 0; i < sizeof(x_swing); i++)
+    {
+        m_xyz[3 * i] = x_swing[i];
+    }
+    window_close(m_xyz, sizeof(x_swing), &features);
+    SIM_CHECK_EQ(features.zero_crossings[0], 4);
+
+    // The side carries over to the next window: the swing ended above, -10 is a crossing.
+    window_fill(-10, 0, 21, 4);
+    window_close(m_xyz, 4, &features);
+    SIM_CHECK_EQ(features.zero_crossings[0], 1);
+    // Then around the mean of the previous window, -10: -8 and -12 cross it.
+    window_fill(-10, 0, 21, sizeof(x_offset));
+    for (uint32_t i = 0; i < sizeof(x_offset); i++)
+    {
+        m_xyz[3 * i] = x_offset[i];
+    }
+    window_close(m_xyz, sizeof(x_offset), &features);
+    SIM_CHECK_EQ(features.zero_crossings[0], 2);
+}
+
+static void test_orientation(void)
+{
+    static const struct
+    {
+        int8_t  xyz[3];
+        uint8_t orientation;
+    } windows[] =
+    {
+        {{  21,   0,   0 }, MOTION_ORIENTATION_X_UP},
+        {{ -21,   0,   0 }, MOTION_ORIENTATION_X_DOWN},
+        {{   0,  21,   0 }, MOTION_ORIENTATION_Y_UP},
+        {{   0, -21,   0 }, MOTION_ORIENTATION_Y_DOWN},
+        {{   0,   0,  21 }, MOTION_ORIENTATION_Z_UP},
+        {{   0,   0, -21 }, MOTION_ORIENTATION_Z_DOWN},
+        {{  10, -10,  10 }, MOTION_ORIENTATION_UNKNOWN},
+        {{   0,   0, MOTION_ORIENTATION_COUNTS }, MOTION_ORIENTATION_Z_UP},
+        {{ -15,  14,   3 }, MOTION_ORIENTATION_X_DOWN},
+        {{   4, -16,  15 }, MOTION_ORIENTATION_Y_DOWN},
+    };
+    motion_features_t features;
+    uint8_t           previous = MOTION_ORIENTATION_UNKNOWN;
+
+    motion_features_init(&m_acc);
+    for (uint32_t w = 0; w < sizeof(windows) / sizeof(windows[0]); w++)
+    {
+        window_fill(windows[w].xyz[0], windows[w].xyz[1], windows[w].xyz[2], 8);
+        window_close(m_xyz, 8, &features);
+        SIM_CHECK_EQ(features.orientation, windows[w].orientation);
+        SIM_CHECK_EQ(features.events & MOTION_EVT_ORIENTATION,
+                     (windows[w].orientation != previous) ? MOTION_EVT_ORIENTATION : 0);
+        previous = windows[w].orientation;
+    }
+}
+
+static void test_events(void)
+{
+    motion_features_t features;
+
+    motion_features_init(&m_acc);
+    window_fill(0, 0, 21, 8);
+    window_close(m_xyz, 8, &features);
+
+    // Shake at MOTION_SHAKE_COUNTS on any axis and sign, not one count below.
+    window_fill(0, 0, 21, 8);
+    m_xyz[3 * 4] = MOTION_SHAKE_COUNTS - 1;
+    window_close(m_xyz, 8, &features);
+    SIM_CHECK_EQ(features.events & MOTION_EVT_SHAKE, 0);
+    for (uint32_t axis = 0; axis < 3; axis++)
+    {
+        window_fill(0, 0, 0, 8);
+        m_xyz[3 * 4 + axis] = (axis == 1) ? -MOTION_SHAKE_COUNTS : MOTION_SHAKE_COUNTS;
+        window_close(m_xyz, 8, &features);
+        SIM_CHECK(features.events & MOTION_EVT_SHAKE);
+    }
+
+    // Tap on a change of MOTION_TAP_COUNTS between two samples, not one count less.
+    window_fill(0, 0, 21, 8);
+    window_close(m_xyz, 8, &features);
+    window_fill(0, 0, 21, 8);
+    m_xyz[3 * 3 + 1] = MOTION_TAP_COUNTS - 1;
+    window_close(m_xyz, 8, &features);
+    SIM_CHECK_EQ(features.events, 0);
+    window_fill(0, 0, 21, 8);
+    m_xyz[3 * 3 + 2] = 21 - MOTION_TAP_COUNTS;
+    window_close(m_xyz, 8, &features);
+    SIM_CHECK_EQ(features.events, MOTION_EVT_TAP);
+
+    // The first sample of a window is compared with the last one of the previous window.
+    window_fill(0, 0, 21, 8);
+    m_xyz[3 * 7] = MOTION_TAP_COUNTS;
+    window_close(m_xyz, 8, &features);
+    SIM_CHECK_EQ(features.events, MOTION_EVT_TAP);
+    window_fill(0, 0, 21, 8);
+    window_close(m_xyz, 8, &features);
+    SIM_CHECK_EQ(features.events, MOTION_EVT_TAP);
+
+    // The bits are per window.
+    window_close(m_xyz, 8, &features);
+    SIM_CHECK_EQ(features.events, 0);
+
+    // A hard hit on the edge is all three at once.
+    window_fill(0, 0, 21, 8);
+    for (uint32_t i = 2; i < 8; i++)
+    {
+        m_xyz[3 * i]     = -30;
+        m_xyz[3 * i + 2] = (i < 4) ? 21 : 0;
+    }
+    window_close(m_xyz, 8, &features);
+    SIM_CHECK_EQ(features.orientation, MOTION_ORIENTATION_X_DOWN);
+    SIM_CHECK_EQ(features.events, MOTION_EVT_SHAKE | MOTION_EVT_TAP | MOTION_EVT_ORIENTATION);
+}
+
+int main(void)
+{
+    test_frame();
+    test_mean_variance();
+    test_magnitude();
+    test_zero_crossings();
+    test_orientation();
+    test_events();
+    printf("test_motion_features: OK\n");
+    return 0;
+}
@@ -0,0 +1,207 @@
+/* Copyright (c) 2015 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+
+/* Rate governor on the MMA7660 model replaying tests/traces/motion_30s.csv, set up as the TWI
+ * list demo does with SAMPLE_RATE_GOVERNOR: the sensor keeps SENSOR_POLL_RATE with auto-sleep
+ * to its auto-wake rate and auto-wake on orientation and shake changes, and only the RTC0
+ * period follows the governor, read in batches of the start-up profile. The same run at the
+ * fixed RTC0 rate is the reference. Each read is checked against the sensor updates: a read
+ * with no update since the previous one repeats a sample, updates between two reads are
+ * missed samples. The bus current is estimated from the TWI bytes per second, weighted by the
+ * time the sensor spends in active mode, where it draws the most. */
+
+#include "sim.h"
+#include "sim_mma7660.h"
+#include "rate_governor.h"
+#include "sample_profile.h"
+#include <stdio.h>
+#include <string.h>
+
+#define TRACE_PATH     "traces/motion_30s.csv"
+#define TRACE_MAX      2000
+#define BATCH_SAMPLES  SAMPLE_PROFILE_BATCH(SAMPLE_PROFILE_0_HZ, SAMPLE_PROFILE_0_MS)
+#define READ_BYTES     6   // Address, register pointer, address again and X, Y, Z.
+#define SLEEP_HZ       8   // MMA7660_SR_AWSR_8 of main.c.
+#define SHAKE_START    10000000000ULL
+#define SHAKE_END      14000000000ULL
+
+typedef struct
+{
+    uint32_t reads;
+    uint32_t repeated;
+    uint32_t missed;
+    uint32_t shake_reads;
+    uint32_t shake_missed;
+    uint32_t changes;
+    uint32_t lowest_hz;      // Lowest governor rate before the shake.
+    uint64_t full_rate_at;   // First time at the full rate again after the shake started, 0 if never.
+    uint64_t end;
+    uint64_t active_ns;      // Sensor time in active mode, not auto-sleeping.
+    uint64_t time_at_hz[8];
+} run_stats_t;
+
+static sim_mma7660_sample_t m_trace[TRACE_MAX];
+static sim_mma7660_t        m_sensor;
+
+// RTC0 read period of a rate, from the compare value the demo sets.
+static uint64_t rtc_period_ns(uint32_t hz)
+{
+    return (uint64_t)SAMPLE_PROFILE_CC(hz) * 1000000000ULL / SAMPLE_PROFILE_RTC_HZ;
+}
+
+static void run(uint32_t length, bool governor, run_stats_t * p_stats)
+{
+    uint64_t end = m_trace[length - 1].t_ns;
+    uint64_t t   = 0;
+    uint32_t updates_seen = 0;
+    uint8_t  batch[3 * BATCH_SAMPLES];
+
+    memset(p_stats, 0, sizeof(*p_stats));
+    p_stats->lowest_hz = SAMPLE_PROFILE_SENSOR_HZ;
+
+    // mma7660_int_init() with the sleep_config of main.c.
+    sim_mma7660_init(&m_sensor, m_trace, length, 0);
+    m_sensor.regs[MMA7660_INTSU] = MMA7660_INTSU_FBINT | MMA7660_INTSU_PLINT |
+                                   MMA7660_INTSU_SHINTX | MMA7660_INTSU_SHINTY | MMA7660_INTSU_SHINTZ;
+    m_sensor.regs[MMA7660_SPCNT] = MMA7660_SLEEP_COUNT;
+    m_sensor.regs[MMA7660_SR]    = SAMPLE_PROFILE_SENSOR_RATE | MMA7660_SR_AWSR_8;
+    m_sensor.regs[MMA7660_MODE]  = MMA7660_MODE_ACTIVE | MMA7660_MODE_ASE | MMA7660_MODE_AWE;
+    m_sensor.running = true;
+    rate_governor_init(SAMPLE_PROFILE_SENSOR_RATE);
+
+    while (t < end)
+    {
+        uint32_t hz     = governor ? rate_governor_hz_get() : SAMPLE_PROFILE_SENSOR_HZ;
+        uint64_t period = rtc_period_ns(hz);
+        uint64_t start  = t;
+
+        for (uint32_t i = 0; i < BATCH_SAMPLES; i++)
+        {
+            uint32_t new_updates;
+
+            t += period;
+            sim_mma7660_advance(&m_sensor, t);
+            batch[3 * i]     = m_sensor.regs[MMA7660_X];
+            batch[3 * i + 1] = m_sensor.regs[MMA7660_Y];
+            batch[3 * i + 2] = m_sensor.regs[MMA7660_Z];
+
+            new_updates  = m_sensor.updates - updates_seen;
+            updates_seen = m_sensor.updates;
+            p_stats->reads++;
+            if (new_updates == 0)
+            {
+                p_stats->repeated++;
+            }
+            else
+            {
+                p_stats->missed += new_updates - 1;
+            }
+            if ((t > SHAKE_START) && (t <= SHAKE_END))
+            {
+                p_stats->shake_reads++;
+                p_stats->shake_missed += (new_updates > 1) ? (new_updates - 1) : 0;
+            }
+        }
+        p_stats->time_at_hz[rate_governor_rate_get()] += t - start;
+        if (!governor)
+        {
+            continue;
+        }
+        if ((t <= SHAKE_START) && (hz < p_stats->lowest_hz))
+        {
+            p_stats->lowest_hz = hz;
+        }
+        p_stats->changes += rate_governor_update(batch, BATCH_SAMPLES) ? 1 : 0;
+        if ((t > SHAKE_START) && (p_stats->full_rate_at == 0) &&
+            (rate_governor_rate_get() == SAMPLE_PROFILE_SENSOR_RATE))
+        {
+            p_stats->full_rate_at = t;
+        }
+    }
+    sim_mma7660_finish(&m_sensor, t);
+    p_stats->end       = t;
+    p_stats->active_ns = t - m_sensor.sleep_ns;
+}
+
+static double bus_bytes_per_s(run_stats_t const * p_stats)
+{
+    return (double)p_stats->reads * READ_BYTES * 1e9 / p_stats->end;
+}
+
+// Bus bytes per second, weighted by the share of the run with the sensor in active mode.
+static double current_proxy(run_stats_t const * p_stats)
+{
+    return bus_bytes_per_s(p_stats) * p_stats->active_ns / p_stats->end;
+}
+
+static void print(char const * p_name, run_stats_t const * p_stats)
+{
+    printf("%-10s%8u%10u%9u%12u/%-5u%10.0f%9.1f%10.0f\n", p_name, (unsigned)p_stats->reads,
+           (unsigned)p_stats->repeated, (unsigned)p_stats->missed, (unsigned)p_stats->shake_missed,
+           (unsigned)p_stats->shake_reads, bus_bytes_per_s(p_stats), p_stats->active_ns / 1e9,
+           current_proxy(p_stats));
+}
+
+int main(void)
+{
+    uint32_t    length = sim_mma7660_trace_load(TRACE_PATH, m_trace, TRACE_MAX, 0);
+    run_stats_t fixed;
+    run_stats_t governed;
+
+    run(length, false, &fixed);
+    run(length, true, &governed);
+
+    printf("%u samples per batch, sensor at %u Hz, %u Hz asleep\n", (unsigned)BATCH_SAMPLES,
+           (unsigned)SAMPLE_PROFILE_SENSOR_HZ, SLEEP_HZ);
+    printf("%-10s%8s%10s%9s%18s%10s%9s%10s\n", "", "reads", "repeated", "missed", "shake missed",
+           "bus B/s", "active s", "proxy");
+    print("fixed", &fixed);
+    print("governor", &governed);
+    printf("governor: %u rate changes, lowest %u Hz before the shake, full rate %.2f s into it, "
+           "time per rate:", (unsigned)governed.changes, (unsigned)governed.lowest_hz,
+           (governed.full_rate_at - SHAKE_START) / 1e9);
+    for (uint32_t i = 0; i < 8; i++)
+    {
+        printf(" %.1f", governed.time_at_hz[i] / 1e9);
+    }
+    printf(" s\n");
+
+    // The sensor runs the same in both, its auto-sleep does not depend on the reads.
+    SIM_CHECK_EQ(fixed.active_ns, governed.active_ns);
+    SIM_CHECK(governed.active_ns < governed.end / 2);
+
+    // At the fixed rate the reads only repeat samples, those of the auto-wake rate and a few
+    // from the RTC0 rate being a little above the sensor rate.
+    SIM_CHECK_EQ(fixed.missed, 0);
+    SIM_CHECK(fixed.repeated > fixed.reads / 2);
+
+    // Still for 10 s: down to the auto-wake rate of the sleeping sensor by then, so hardly a
+    // read repeats a sample.
+    SIM_CHECK(governed.lowest_hz <= SLEEP_HZ);
+    SIM_CHECK(governed.repeated < fixed.repeated / 10);
+
+    // The shake brings the full rate back within the batch under way when it starts, from then
+    // on no sample of the shake is missed, and the still tail brings the rate down again.
+    SIM_CHECK(governed.full_rate_at != 0);
+    SIM_CHECK(governed.full_rate_at - SHAKE_START <= BATCH_SAMPLES * rtc_period_ns(governed.lowest_hz));
+    SIM_CHECK(governed.full_rate_at < SHAKE_END);
+    SIM_CHECK(governed.shake_missed <= (governed.full_rate_at - SHAKE_START) * SAMPLE_PROFILE_SENSOR_HZ / 1000000000ULL + 1);
+    SIM_CHECK(rate_governor_hz_get() <= 4);
+    SIM_CHECK(governed.time_at_hz[SAMPLE_PROFILE_SENSOR_RATE] < 6000000000ULL);
+
+    // The bus cost follows: at most a third of the bytes and of the proxy of the fixed rate.
+    SIM_CHECK(3 * bus_bytes_per_s(&governed) < bus_bytes_per_s(&fixed));
+    SIM_CHECK(3 * current_proxy(&governed) < current_proxy(&fixed));
+    printf("test_rate_governor: OK\n");
+    return 0;
+}
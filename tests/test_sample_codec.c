@@ -0,0 +1,248 @@
+/* Copyright (c) 2015 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+
+/* Delta codec of common/sample_codec.c: blocks of pseudo random sample sequences, from a still
+ * sensor to full scale jumps, with any count and block buffer size, are decoded back by a plain
+ * bitwise reference of sample_codec.h and must give the samples, the fewest bits over k, and as
+ * many samples as fit. */
+
+#include "sim.h"
+#include "sample_codec.h"
+#include <stdio.h>
+#include <string.h>
+
+#define ROUNDS      200000
+#define SAMPLES_MAX 70
+#define DST_MAX     64
+#define GUARD       8
+
+typedef struct
+{
+    uint8_t const * p_buf;
+    uint32_t        bits;
+} bit_reader_t;
+
+static uint32_t m_seed = 1;
+
+static uint32_t random_get(void)
+{
+    m_seed = m_seed * 1103515245 + 12345;
+    return m_seed >> 16;
+}
+
+static uint32_t bits_get(bit_reader_t * p_reader, uint32_t count)
+{
+    uint32_t value = 0;
+
+    for (uint32_t i = 0; i < count; i++, p_reader->bits++)
+    {
+        value |= (uint32_t)((p_reader->p_buf[p_reader->bits >> 3] >> (p_reader->bits & 7)) & 1) << i;
+    }
+    return value;
+}
+
+static int32_t delta_get(uint8_t value, uint8_t previous)
+{
+    int32_t delta = (value - previous) & 0x3F;
+
+    return (delta & 0x20) ? (delta - 64) : delta;
+}
+
+// Bits of one value coded with k, from the description in sample_codec.h.
+static uint32_t value_bits(uint8_t value, uint8_t previous, uint32_t k)
+{
+    int32_t  d = delta_get(value, previous);
+    uint32_t z = (d >= 0) ? (uint32_t)(2 * d) : (uint32_t)(-2 * d - 1);
+
+    return ((z >> k) < SAMPLE_CODEC_ESCAPE) ? ((z >> k) + 1 + k) : (SAMPLE_CODEC_ESCAPE + 6);
+}
+
+static uint32_t sample_bits(uint8_t const * p_sample, uint32_t k)
+{
+    return value_bits(p_sample[0], p_sample[-3], k) + value_bits(p_sample[1], p_sample[-2], k) +
+           value_bits(p_sample[2], p_sample[-1], k);
+}
+
+// Decodes a block of length bytes into p_xyz, returns the sample count and the k of the header.
+static uint32_t block_decode(uint8_t const * p_block, uint32_t length, uint8_t * p_xyz, uint32_t * p_k)
+{
+    bit_reader_t reader = {p_block, 8};
+    uint32_t     count  = p_block[0] >> 2;
+
+    *p_k = p_block[0] & 3;
+    SIM_CHECK(count >= 1);
+    for (uint32_t v = 0; v < 3; v++)
+    {
+        p_xyz[v] = (uint8_t)bits_get(&reader, 6);
+    }
+    for (uint32_t v = 3; v < 3 * count; v++)
+    {
+        uint32_t q = 0;
+        uint32_t z;
+        int32_t  d;
+
+        while ((q < SAMPLE_CODEC_ESCAPE) && bits_get(&reader, 1))
+        {
+            q++;
+        }
+        z = (q == SAMPLE_CODEC_ESCAPE) ? bits_get(&reader, 6) : ((q << *p_k) | bits_get(&reader, *p_k));
+        SIM_CHECK(z < 64);
+        d = (z & 1) ? -(int32_t)((z + 1) / 2) : (int32_t)(z / 2);
+        p_xyz[v] = (uint8_t)((p_xyz[v - 3] + d) & 0x3F);
+        SIM_CHECK(reader.bits <= 8 * length);
+    }
+    SIM_CHECK_EQ((reader.bits + 7) / 8, length);
+    // The padding of the last byte is zero.
+    SIM_CHECK(bits_get(&reader, 8 * length - reader.bits) == 0);
+    return count;
+}
+
+// Sequences of the kinds the sensor gives: still, slow and fast motion, noise, and jumps
+// between the ends of the range. The top two bits are ALERT and garbage, the codec ignores them.
+static void sequence_make(uint8_t * p_xyz, uint32_t count)
+{
+    uint32_t kind = random_get() % 5;
+    uint32_t step = 1 + random_get() % 8;
+
+    for (uint32_t v = 0; v < 3; v++)
+    {
+        p_xyz[v] = (uint8_t)random_get();
+    }
+    for (uint32_t v = 3; v < 3 * count; v++)
+    {
+        uint8_t previous = p_xyz[v - 3];
+
+        switch (kind)
+        {
+            case 0:
+                p_xyz[v] = previous;
+                break;
+            case 1:
+                p_xyz[v] = (uint8_t)(previous + random_get() % 3 - 1);
+                break;
+            case 2:
+                p_xyz[v] = (uint8_t)(previous + random_get() % (2 * step + 1) - step);
+                break;
+            case 3:
+                p_xyz[v] = (uint8_t)random_get();
+                break;
+            default:
+                p_xyz[v] = (uint8_t)(previous + 32 + random_get() % 3 - 1);
+                break;
+        }
+        p_xyz[v] = (uint8_t)((p_xyz[v] & 0x3F) | (random_get() & 0xC0));
+    }
+}
+
+static void test_round_trip(void)
+{
+    uint8_t  src[3 * SAMPLES_MAX];
+    uint8_t  block[DST_MAX + GUARD];
+    uint8_t  xyz[3 * SAMPLE_CODEC_MAX_SAMPLES];
+    uint32_t samples = 0;
+    uint32_t bytes = 0;
+    uint32_t partial = 0;
+    uint32_t escapes = 0;
+
+    for (uint32_t round = 0; round < ROUNDS; round++)
+    {
+        uint32_t count    = random_get() % (SAMPLES_MAX + 1);
+        uint32_t dst_size = random_get() % (DST_MAX + 1);
+        uint32_t taken    = (count < SAMPLE_CODEC_MAX_SAMPLES) ? count : SAMPLE_CODEC_MAX_SAMPLES;
+        uint32_t length   = 0xFFFFFFFF;
+        uint32_t coded;
+        uint32_t bits;
+        uint32_t k;
+
+        sequence_make(src, (count != 0) ? count : 1);
+        memset(block, 0xA5, sizeof(block));
+        coded = sample_codec_encode(block, dst_size, &length, src, count);
+        for (uint32_t i = dst_size; i < sizeof(block); i++)
+        {
+            SIM_CHECK_EQ(block[i], 0xA5);
+        }
+        if ((count == 0) || (8 * dst_size < 8 + 18))
+        {
+            SIM_CHECK_EQ(coded, 0);
+            SIM_CHECK_EQ(length, 0);
+            continue;
+        }
+
+        SIM_CHECK(coded >= 1 && coded <= taken);
+        SIM_CHECK(length <= dst_size);
+        SIM_CHECK_EQ(block_decode(block, length, xyz, &k), coded);
+        for (uint32_t v = 0; v < 3 * coded; v++)
+        {
+            SIM_CHECK_EQ(xyz[v], src[v] & 0x3F);
+        }
+
+        bits = 8 + 18;
+        for (uint32_t i = 1; i < coded; i++)
+        {
+            bits += sample_bits(&src[3 * i], k);
+            escapes += (value_bits(src[3 * i], src[3 * i - 3], k) == SAMPLE_CODEC_ESCAPE + 6) ? 1 : 0;
+        }
+        SIM_CHECK_EQ(length, (bits + 7) / 8);
+        if (coded < taken)
+        {
+            // Stopped at the first sample that does not fit.
+            SIM_CHECK(bits + sample_bits(&src[3 * coded], k) > 8 * dst_size);
+            partial++;
+        }
+        else
+        {
+            // No other k codes the whole block in fewer bits.
+            for (uint32_t other = 0; other < 4; other++)
+            {
+                uint32_t other_bits = 8 + 18;
+
+                for (uint32_t i = 1; i < coded; i++)
+                {
+                    other_bits += sample_bits(&src[3 * i], other);
+                }
+                SIM_CHECK(other_bits >= bits);
+            }
+        }
+        samples += coded;
+        bytes   += length;
+    }
+    printf("%u blocks: %u samples in %u bytes, %u blocks cut to the buffer, %u escaped values\n",
+           ROUNDS, (unsigned)samples, (unsigned)bytes, (unsigned)partial, (unsigned)escapes);
+    SIM_CHECK(partial > 0);
+    SIM_CHECK(escapes > 0);
+}
+
+// A still sensor costs 1 bit per value after the first sample.
+static void test_still(void)
+{
+    uint8_t  src[3 * SAMPLE_CODEC_MAX_SAMPLES];
+    uint8_t  block[DST_MAX];
+    uint32_t length;
+
+    for (uint32_t v = 0; v < sizeof(src); v++)
+    {
+        src[v] = (uint8_t)(v % 3 + 20);
+    }
+    SIM_CHECK_EQ(sample_codec_encode(block, sizeof(block), &length, src, SAMPLE_CODEC_MAX_SAMPLES),
+                 SAMPLE_CODEC_MAX_SAMPLES);
+    SIM_CHECK_EQ(length, (8 + 18 + 3 * (SAMPLE_CODEC_MAX_SAMPLES - 1) + 7) / 8);
+    SIM_CHECK_EQ(block[0] & 3, 0);
+}
+
+int main(void)
+{
+    test_still();
+    test_round_trip();
+    printf("test_sample_codec: OK\n");
+    return 0;
+}
@@ -0,0 +1,278 @@
+/* Copyright (c) 2015 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+
+/* Sample filter chain of the TWI list demo with the stages selected in config.h: coefficient
+ * sets against the profile rates, the frequency response in Hz of each set, and the fixed-point
+ * chain against a double precision reference on the MMA7660 model replaying
+ * tests/traces/motion_30s.csv. */
+
+#include "sim.h"
+#include "sim_mma7660.h"
+#include "mma7660.h"
+#include "sample_filter.h"
+#include "sample_filter_coeffs.h"
+#include "sample_profile.h"
+#include <math.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#define TRACE_PATH    "traces/motion_30s.csv"
+#define TRACE_MAX     2000
+#define SAMPLES_MAX   3600
+#define PASS_HZ       5.0   // Below both cutoffs, passed by every profile that samples fast enough.
+#define STOP_HZ       40.0  // Above both cutoffs, stopped by the 120 Hz profile.
+#define AMPLITUDE     24
+
+static const int32_t m_fir[SAMPLE_FILTER_DESIGNS][SAMPLE_FILTER_FIR_TAPS] = SAMPLE_FILTER_FIR_COEFFS;
+static const int32_t m_iir_b[SAMPLE_FILTER_DESIGNS][3] = SAMPLE_FILTER_IIR_B;
+static const int32_t m_iir_a[SAMPLE_FILTER_DESIGNS][2] = SAMPLE_FILTER_IIR_A;
+
+static sim_mma7660_sample_t m_trace[TRACE_MAX];
+static int8_t               m_in[3 * SAMPLES_MAX];
+static int8_t               m_out[3 * SAMPLES_MAX];
+
+// Magnitude of the quantized coefficients at f Hz, an FIR if p_a is NULL.
+static double gain(int32_t const * p_b, uint32_t b_count, int32_t const * p_a, int shift, double f, double fs)
+{
+    double w  = 2 * M_PI * f / fs;
+    double nr = 0;
+    double ni = 0;
+    double dr = 1;
+    double di = 0;
+
+    for (uint32_t k = 0; k < b_count; k++)
+    {
+        nr += p_b[k] * cos(w * k) / (1 << shift);
+        ni -= p_b[k] * sin(w * k) / (1 << shift);
+    }
+    for (uint32_t k = 0; (p_a != NULL) && (k < 2); k++)
+    {
+        dr += p_a[k] * cos(w * (k + 1)) / (1 << shift);
+        di -= p_a[k] * sin(w * (k + 1)) / (1 << shift);
+    }
+    return sqrt((nr * nr + ni * ni) / (dr * dr + di * di));
+}
+
+// One coefficient set per profile, at its rate: unity DC gain, the pass band in Hz kept in
+// every profile, and the stop band of the fastest one.
+static void test_tables(void)
+{
+    static const uint32_t design_hz[] = {SAMPLE_FILTER_DESIGN_0_HZ, SAMPLE_FILTER_DESIGN_1_HZ,
+                                         SAMPLE_FILTER_DESIGN_2_HZ, SAMPLE_FILTER_DESIGN_3_HZ};
+
+    SIM_CHECK_EQ(SAMPLE_FILTER_DESIGNS, sample_profile_count());
+    for (uint32_t d = 0; d < SAMPLE_FILTER_DESIGNS; d++)
+    {
+        double fs   = sample_profile_get(d)->hz;
+        double pass = (PASS_HZ < fs / 4) ? PASS_HZ : fs / 4;
+        int32_t sum = 0;
+
+        SIM_CHECK_EQ(design_hz[d], sample_profile_get(d)->hz);
+        for (uint32_t k = 0; k < SAMPLE_FILTER_FIR_TAPS; k++)
+        {
+            sum += m_fir[d][k];
+        }
+        SIM_CHECK_EQ(sum, 1 << SAMPLE_FILTER_FIR_SHIFT);
+        SIM_CHECK_EQ(m_iir_b[d][0] + m_iir_b[d][1] + m_iir_b[d][2],
+                     (1 << SAMPLE_FILTER_IIR_SHIFT) + m_iir_a[d][0] + m_iir_a[d][1]);
+
+        printf("profile %u, %3u Hz: FIR %6.2f dB, IIR %6.2f dB at %.1f Hz", (unsigned)d, (unsigned)fs,
+               20 * log10(gain(m_fir[d], SAMPLE_FILTER_FIR_TAPS, NULL, SAMPLE_FILTER_FIR_SHIFT, pass, fs)),
+               20 * log10(gain(m_iir_b[d], 3, m_iir_a[d], SAMPLE_FILTER_IIR_SHIFT, pass, fs)), pass);
+        SIM_CHECK(gain(m_fir[d], SAMPLE_FILTER_FIR_TAPS, NULL, SAMPLE_FILTER_FIR_SHIFT, pass, fs) > 0.89);
+        SIM_CHECK(gain(m_iir_b[d], 3, m_iir_a[d], SAMPLE_FILTER_IIR_SHIFT, pass, fs) > 0.89);
+        if (STOP_HZ < fs / 2)
+        {
+            printf(", FIR %6.2f dB, IIR %6.2f dB at %.1f Hz",
+                   20 * log10(gain(m_fir[d], SAMPLE_FILTER_FIR_TAPS, NULL, SAMPLE_FILTER_FIR_SHIFT, STOP_HZ, fs)),
+                   20 * log10(gain(m_iir_b[d], 3, m_iir_a[d], SAMPLE_FILTER_IIR_SHIFT, STOP_HZ, fs)), STOP_HZ);
+            SIM_CHECK(gain(m_fir[d], SAMPLE_FILTER_FIR_TAPS, NULL, SAMPLE_FILTER_FIR_SHIFT, STOP_HZ, fs) < 0.1);
+            SIM_CHECK(gain(m_iir_b[d], 3, m_iir_a[d], SAMPLE_FILTER_IIR_SHIFT, STOP_HZ, fs) < 0.1);
+        }
+        printf("\n");
+    }
+}
+
+static int8_t clip(double value)
+{
+    value = floor(value + 0.5);
+    return (int8_t)((value < -32) ? -32 : ((value > 31) ? 31 : value));
+}
+
+// The configured stages in double precision, over count samples of one axis with a stride of 3.
+static void reference_run(int8_t * p_out, int8_t const * p_in, uint32_t count, uint32_t profile)
+{
+    double iir_x[2] = {0};
+    double iir_y[2] = {0};
+    int8_t hist[3 + SAMPLE_FILTER_FIR_TAPS] = {0};
+    int8_t med[3] = {0};
+
+    (void)iir_x;
+    (void)iir_y;
+    (void)hist;
+    (void)med;
+    for (uint32_t n = 0; n < count; n++)
+    {
+        int8_t x = p_in[3 * n];
+
+#if SAMPLE_FILTER_MEDIAN
+        med[2] = med[1];
+        med[1] = med[0];
+        med[0] = x;
+        x = (int8_t)(med[0] + med[1] + med[2] - fmin(med[0], fmin(med[1], med[2])) -
+                     fmax(med[0], fmax(med[1], med[2])));
+#endif
+#if SAMPLE_FILTER_FIR
+        {
+            double acc = 0;
+
+            memmove(&hist[1], &hist[0], SAMPLE_FILTER_FIR_TAPS - 1);
+            hist[0] = x;
+            for (uint32_t k = 0; k < SAMPLE_FILTER_FIR_TAPS; k++)
+            {
+                acc += m_fir[profile][k] * hist[k];
+            }
+            x = clip(acc / (1 << SAMPLE_FILTER_FIR_SHIFT));
+        }
+#endif
+#if SAMPLE_FILTER_IIR
+        {
+            double y = (m_iir_b[profile][0] * x + m_iir_b[profile][1] * iir_x[0] + m_iir_b[profile][2] * iir_x[1] -
+                        m_iir_a[profile][0] * iir_y[0] - m_iir_a[profile][1] * iir_y[1]) /
+                       (1 << SAMPLE_FILTER_IIR_SHIFT);
+
+            iir_x[1] = iir_x[0];
+            iir_x[0] = x;
+            iir_y[1] = iir_y[0];
+            iir_y[0] = y;
+            x = clip(y);
+        }
+#endif
+        p_out[3 * n] = x;
+    }
+}
+
+// Decoded samples of the trace at the rate of the profile.
+static uint32_t trace_samples(uint32_t length, uint32_t hz)
+{
+    sim_mma7660_t sensor;
+    uint64_t      t = 0;
+    uint32_t      count = 0;
+
+    sim_reset();
+    sim_mma7660_init(&sensor, m_trace, length, 0);
+    sensor.running = true;
+    while ((count < SAMPLES_MAX) && (t + 1000000000ULL / hz < m_trace[length - 1].t_ns))
+    {
+        t += 1000000000ULL / hz;
+        sim_mma7660_advance(&sensor, t);
+        (void)mma7660_decode(&m_in[3 * count], &sensor.regs[MMA7660_X], 3);
+        count++;
+    }
+    return count;
+}
+
+// The trace in batches of the profile: each axis follows the reference, as one stream over
+// the batch boundaries. The fixed-point IIR history rounds differently, one count is allowed.
+static void test_reference(uint32_t length)
+{
+    int8_t ref[3 * SAMPLES_MAX];
+    int    tolerance = SAMPLE_FILTER_IIR ? 1 : 0;
+
+    for (uint32_t d = 0; d < sample_profile_count(); d++)
+    {
+        sample_profile_t const * p_profile = sample_profile_get(d);
+        uint32_t                 count     = trace_samples(length, p_profile->hz);
+        uint32_t                 differ    = 0;
+
+        memcpy(m_out, m_in, 3 * count);
+        sample_filter_init();
+        for (uint32_t i = 0; i + p_profile->batch <= count; i += p_profile->batch)
+        {
+            sample_filter_run(&m_out[3 * i], p_profile->batch, d);
+        }
+        count -= count % p_profile->batch;
+        for (uint32_t axis = 0; axis < 3; axis++)
+        {
+            reference_run(&ref[axis], &m_in[axis], count, d);
+        }
+        for (uint32_t i = 0; i < 3 * count; i++)
+        {
+            SIM_CHECK(abs(m_out[i] - ref[i]) <= tolerance);
+            SIM_CHECK((m_out[i] >= -32) && (m_out[i] <= 31));
+            differ += (m_out[i] != m_in[i]) ? 1 : 0;
+        }
+        printf("profile %u: %u samples of the trace, %u values changed by the filter\n",
+               (unsigned)d, (unsigned)count, (unsigned)differ);
+    }
+}
+
+// A constant comes out unchanged once the history is full, and a pass band sine keeps its
+// amplitude: the fit over whole periods after the start-up is within 2 counts.
+static void test_response(void)
+{
+    for (uint32_t d = 0; d < sample_profile_count(); d++)
+    {
+        double   fs    = sample_profile_get(d)->hz;
+        double   f     = (PASS_HZ < fs / 12) ? PASS_HZ : fs / 12;
+        uint32_t count = (uint32_t)(20 * fs / f);
+        double   re = 0;
+        double   im = 0;
+        uint32_t n0 = count / 2;
+
+        sample_filter_init();
+        for (uint32_t n = 0; n < 64; n++)
+        {
+            m_out[3 * n]     = 20;
+            m_out[3 * n + 1] = -17;
+            m_out[3 * n + 2] = -32;
+        }
+        sample_filter_run(m_out, 64, d);
+        for (uint32_t n = 32; n < 64; n++)
+        {
+            SIM_CHECK_EQ(m_out[3 * n], 20);
+            SIM_CHECK_EQ(m_out[3 * n + 1], -17);
+            SIM_CHECK_EQ(m_out[3 * n + 2], -32);
+        }
+
+        SIM_CHECK(count <= SAMPLES_MAX);
+        sample_filter_init();
+        for (uint32_t n = 0; n < count; n++)
+        {
+            m_out[3 * n]     = (int8_t)lround(AMPLITUDE * sin(2 * M_PI * f * n / fs));
+            m_out[3 * n + 1] = 0;
+            m_out[3 * n + 2] = 0;
+        }
+        sample_filter_run(m_out, count, d);
+        for (uint32_t n = n0; n < count; n++)
+        {
+            re += m_out[3 * n] * cos(2 * M_PI * f * n / fs);
+            im += m_out[3 * n] * sin(2 * M_PI * f * n / fs);
+        }
+        printf("profile %u: %.2f Hz sine of %d counts out with %.2f\n", (unsigned)d, f, AMPLITUDE,
+               2 * sqrt(re * re + im * im) / (count - n0));
+        SIM_CHECK(fabs(2 * sqrt(re * re + im * im) / (count - n0) - AMPLITUDE) < 2);
+    }
+}
+
+int main(void)
+{
+    uint32_t length = sim_mma7660_trace_load(TRACE_PATH, m_trace, TRACE_MAX, 0);
+
+    test_tables();
+    test_response();
+    test_reference(length);
+    printf("test_sample_filter: OK\n");
+    return 0;
+}
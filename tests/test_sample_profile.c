@@ -0,0 +1,129 @@
+/* Copyright (c) 2015 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+
+/* Sample profiles of the TWI list demo (02_twi_easydma_list/sample_profile.c) with the profiles
+ * of its config.h: the table against the rates and batch periods it is derived from, the
+ * rejection of profile numbers that do not exist, and the handoff of a request from
+ * sample_profile_select() to sample_profile_pending_take() at the end of an RX buffer. */
+
+#include "sim.h"
+#include "sample_profile.h"
+#include "nrf_error.h"
+#include <stdio.h>
+
+static void test_table(void)
+{
+    static const uint32_t rates[] = {SAMPLE_PROFILE_0_HZ, SAMPLE_PROFILE_1_HZ, SAMPLE_PROFILE_2_HZ,
+                                     SAMPLE_PROFILE_3_HZ};
+    static const uint32_t periods[] = {SAMPLE_PROFILE_0_MS, SAMPLE_PROFILE_1_MS, SAMPLE_PROFILE_2_MS,
+                                       SAMPLE_PROFILE_3_MS};
+    uint32_t count = 0;
+
+    while ((count < 4) && (rates[count] != 0))
+    {
+        count++;
+    }
+    SIM_CHECK_EQ(sample_profile_count(), count);
+    SIM_CHECK_EQ(sample_profile_count(), SAMPLE_PROFILE_COUNT);
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+        sample_profile_t const * p_profile = sample_profile_get(i);
+        int32_t                  error;
+
+        printf("profile %u: %3u Hz, RTC0 CC %4u, %2u samples per batch\n", (unsigned)i,
+               (unsigned)p_profile->hz, (unsigned)p_profile->rtc_cc, (unsigned)p_profile->batch);
+        SIM_CHECK_EQ(p_profile->hz, rates[i]);
+        // The compare value is the nearest to 32768 / hz, the batch the nearest to hz * ms / 1000.
+        error = (int32_t)(p_profile->rtc_cc * rates[i]) - SAMPLE_PROFILE_RTC_HZ;
+        SIM_CHECK((2 * error <= (int32_t)rates[i]) && (-2 * error <= (int32_t)rates[i]));
+        error = (int32_t)(p_profile->batch * 1000) - (int32_t)(rates[i] * periods[i]);
+        SIM_CHECK((error <= 500) && (error >= -500));
+        SIM_CHECK(p_profile->batch >= 1 && p_profile->batch <= SAMPLE_RING_BATCH_SAMPLES);
+        // The sensor is set to its start-up rate, at least as fast as any profile.
+        SIM_CHECK(p_profile->hz <= SAMPLE_PROFILE_SENSOR_HZ);
+    }
+
+    // The profiles of config.h as shipped.
+    SIM_CHECK_EQ(sample_profile_get(0)->hz, 120);
+    SIM_CHECK_EQ(sample_profile_get(0)->rtc_cc, 273);
+    SIM_CHECK_EQ(sample_profile_get(0)->batch, 16);
+    SIM_CHECK_EQ(sample_profile_get(1)->hz, 32);
+    SIM_CHECK_EQ(sample_profile_get(1)->rtc_cc, 1024);
+    SIM_CHECK_EQ(sample_profile_get(1)->batch, 16);
+    SIM_CHECK_EQ(sample_profile_get(2)->hz, 8);
+    SIM_CHECK_EQ(sample_profile_get(2)->rtc_cc, 4096);
+    SIM_CHECK_EQ(sample_profile_get(2)->batch, 16);
+    SIM_CHECK_EQ(SAMPLE_PROFILE_SENSOR_HZ, 120);
+    SIM_CHECK_EQ(SAMPLE_PROFILE_SENSOR_RATE, SAMPLES_PER_SEC_120);
+}
+
+static void test_select(void)
+{
+    uint32_t count = sample_profile_count();
+
+    // Starts with profile 0 and nothing pending.
+    SIM_CHECK_EQ(sample_profile_current_get(), 0);
+    SIM_CHECK(sample_profile_pending_take() == NULL);
+
+    // Numbers past the table are refused and leave nothing pending.
+    SIM_CHECK_EQ(sample_profile_select(count), NRF_ERROR_INVALID_PARAM);
+    SIM_CHECK_EQ(sample_profile_select(count + 1), NRF_ERROR_INVALID_PARAM);
+    SIM_CHECK_EQ(sample_profile_select(UINT32_MAX), NRF_ERROR_INVALID_PARAM);
+    SIM_CHECK(sample_profile_pending_take() == NULL);
+    SIM_CHECK_EQ(sample_profile_current_get(), 0);
+
+    // Selecting the profile in use is no switch.
+    SIM_CHECK_EQ(sample_profile_select(0), NRF_SUCCESS);
+    SIM_CHECK(sample_profile_pending_take() == NULL);
+
+    // A request is taken once, and only then is it the current profile.
+    SIM_CHECK_EQ(sample_profile_select(count - 1), NRF_SUCCESS);
+    SIM_CHECK_EQ(sample_profile_current_get(), 0);
+    SIM_CHECK(sample_profile_pending_take() == sample_profile_get(count - 1));
+    SIM_CHECK_EQ(sample_profile_current_get(), count - 1);
+    SIM_CHECK(sample_profile_pending_take() == NULL);
+
+    // A refused number does not cancel a pending request.
+    SIM_CHECK_EQ(sample_profile_select(1), NRF_SUCCESS);
+    SIM_CHECK_EQ(sample_profile_select(count), NRF_ERROR_INVALID_PARAM);
+    SIM_CHECK(sample_profile_pending_take() == sample_profile_get(1));
+
+    // Of requests made between two buffer ends the last one counts, also when it is back to the
+    // profile in use.
+    SIM_CHECK_EQ(sample_profile_select(0), NRF_SUCCESS);
+    SIM_CHECK_EQ(sample_profile_select(count - 1), NRF_SUCCESS);
+    SIM_CHECK(sample_profile_pending_take() == sample_profile_get(count - 1));
+    SIM_CHECK_EQ(sample_profile_select(0), NRF_SUCCESS);
+    SIM_CHECK_EQ(sample_profile_select(count - 1), NRF_SUCCESS);
+    SIM_CHECK(sample_profile_pending_take() == NULL);
+    SIM_CHECK_EQ(sample_profile_current_get(), count - 1);
+
+    // Stepping through as SAMPLE_PROFILE_BUTTON does, one press per buffer.
+    for (uint32_t press = 0; press < 2 * count; press++)
+    {
+        uint32_t next = (sample_profile_current_get() + 1) % count;
+
+        SIM_CHECK_EQ(sample_profile_select(next), NRF_SUCCESS);
+        SIM_CHECK(sample_profile_pending_take() == sample_profile_get(next));
+        SIM_CHECK_EQ(sample_profile_current_get(), next);
+    }
+}
+
+int main(void)
+{
+    test_table();
+    test_select();
+    printf("test_sample_profile: OK\n");
+    return 0;
+}
@@ -0,0 +1,200 @@
+/* Copyright (c) 2015 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+
+/* Binary sample stream of the TWI list demo on the simulated UARTE: frames of the MMA7660
+ * model replaying tests/traces/motion_30s.csv are parsed back from the line, and the dropped
+ * count in the header accounts for every sequence gap. The capture of the second test is left
+ * in _build/sample_stream.bin for ../02_twi_easydma_list/tools/sample_stream_decode.py. */
+
+#include "sim.h"
+#include "sim_mma7660.h"
+#include "mma7660.h"
+#include "sample_stream.h"
+#include "nrf_error.h"
+#include <stdio.h>
+#include <string.h>
+
+#define TRACE_PATH     "traces/motion_30s.csv"
+#define TRACE_MAX      2000
+#define BATCH_SAMPLES  16
+#define SAMPLE_NS      (1000000000ULL / 120)
+#define CAPTURE_PATH   "_build/sample_stream.bin"
+
+static sim_mma7660_sample_t m_trace[TRACE_MAX];
+static uint32_t             m_trace_length;
+static sim_mma7660_t        m_sensor;
+static uint8_t              m_capture[256 * 1024];
+
+typedef struct
+{
+    uint16_t sequence;
+    uint16_t dropped;
+    uint8_t  count;
+    uint8_t  samples[3 * BATCH_SAMPLES];
+} frame_t;
+
+static void setup(void)
+{
+    sim_reset();
+    sim_uarte_capture(m_capture, sizeof(m_capture));
+    sim_mma7660_init(&m_sensor, m_trace, m_trace_length, 0);
+    m_sensor.running = true;
+    sample_stream_init(6, 5, 7, true);
+}
+
+// Next batch of raw X, Y, Z values at 120 Hz.
+static void batch_read(uint8_t * p_batch, uint64_t * p_t)
+{
+    for (uint32_t i = 0; i < BATCH_SAMPLES; i++)
+    {
+        *p_t += SAMPLE_NS;
+        sim_mma7660_advance(&m_sensor, *p_t);
+        memcpy(&p_batch[3 * i], &m_sensor.regs[MMA7660_X], 3);
+    }
+}
+
+static uint16_t crc16(uint8_t const * p_data, uint32_t size)
+{
+    uint16_t crc = 0xFFFF;
+
+    for (uint32_t i = 0; i < size; i++)
+    {
+        crc ^= (uint16_t)(p_data[i] << 8);
+        for (uint32_t bit = 0; bit < 8; bit++)
+        {
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+// Parses the frame at *p_pos of the capture, a plain bitwise reference of sample_stream.h.
+static void frame_parse(uint32_t * p_pos, frame_t * p_frame)
+{
+    uint8_t const * p = &m_capture[*p_pos];
+    uint32_t        payload;
+    uint32_t        size;
+
+    SIM_CHECK(*p_pos + SAMPLE_STREAM_HEADER_SIZE <= sim_uarte_captured());
+    SIM_CHECK_EQ(p[0], SAMPLE_STREAM_SYNC_0);
+    SIM_CHECK_EQ(p[1], SAMPLE_STREAM_SYNC_1);
+    SIM_CHECK_EQ(p[2] & SAMPLE_STREAM_CODED, 0);
+    p_frame->count    = p[2];
+    p_frame->sequence = (uint16_t)(p[3] | (p[4] << 8));
+    p_frame->dropped  = (uint16_t)(p[9] | (p[10] << 8));
+    payload = (18 * p_frame->count + 7) / 8;
+    size    = SAMPLE_STREAM_HEADER_SIZE + payload + SAMPLE_STREAM_CRC_SIZE;
+    SIM_CHECK_EQ(size, SAMPLE_STREAM_FRAME_SIZE(p_frame->count));
+    SIM_CHECK(*p_pos + size <= sim_uarte_captured());
+    SIM_CHECK_EQ(crc16(&p[2], size - 4), p[size - 2] | (p[size - 1] << 8));
+    for (uint32_t v = 0; v < 3 * p_frame->count; v++)
+    {
+        uint32_t bit  = 6 * v;
+        uint32_t pair = p[SAMPLE_STREAM_HEADER_SIZE + bit / 8];
+
+        if (bit / 8 + 1 < payload)
+        {
+            pair |= (uint32_t)p[SAMPLE_STREAM_HEADER_SIZE + bit / 8 + 1] << 8;
+        }
+        p_frame->samples[v] = (uint8_t)((pair >> (bit % 8)) & 0x3F);
+    }
+    *p_pos += size;
+}
+
+// One frame per batch period, every frame is on the line by the next one.
+static void test_stream(void)
+{
+    uint8_t  batch[3 * BATCH_SAMPLES];
+    uint64_t t = 0;
+    uint32_t pos = 0;
+    uint32_t frames = 0;
+    frame_t  frame;
+
+    setup();
+    while (t + BATCH_SAMPLES * SAMPLE_NS < m_trace[m_trace_length - 1].t_ns)
+    {
+        batch_read(batch, &t);
+        sim_run(t - sim_now());
+        SIM_CHECK_EQ(sample_stream_send(batch, BATCH_SAMPLES, (uint32_t)(t / 30518)), NRF_SUCCESS);
+        sim_run(2000000);
+        frame_parse(&pos, &frame);
+        SIM_CHECK_EQ(frame.sequence, frames);
+        SIM_CHECK_EQ(frame.dropped, 0);
+        SIM_CHECK_EQ(frame.count, BATCH_SAMPLES);
+        for (uint32_t v = 0; v < 3 * BATCH_SAMPLES; v++)
+        {
+            SIM_CHECK_EQ(frame.samples[v], batch[v] & 0x3F);
+        }
+        frames++;
+    }
+    SIM_CHECK_EQ(pos, sim_uarte_captured());
+    SIM_CHECK_EQ(sample_stream_dropped_get(), 0);
+    printf("%u frames, %u bytes on the line, %.2f bytes per sample\n",
+           (unsigned)frames, (unsigned)pos, (double)pos / (frames * BATCH_SAMPLES));
+}
+
+// Frames every 0.7 ms, faster than the line: the header counts the dropped ones, which are
+// exactly the sequence gaps.
+static void test_dropped(void)
+{
+    uint8_t  batch[3 * BATCH_SAMPLES];
+    uint64_t t = 0;
+    uint32_t pos = 0;
+    uint32_t sent = 0;
+    uint32_t gaps = 0;
+    frame_t  frame;
+    frame_t  last;
+    FILE *   p_file;
+
+    setup();
+    for (uint32_t i = 0; i < 200; i++)
+    {
+        batch_read(batch, &t);
+        if (sample_stream_send(batch, BATCH_SAMPLES, i) == NRF_SUCCESS)
+        {
+            sent++;
+        }
+        sim_run(700000);
+    }
+    sim_run(2000000);
+    SIM_CHECK(sample_stream_dropped_get() > 0);
+    SIM_CHECK_EQ(sent + sample_stream_dropped_get(), 200);
+
+    frame_parse(&pos, &last);
+    SIM_CHECK_EQ(last.sequence, 0);
+    for (uint32_t i = 1; i < sent; i++)
+    {
+        frame_parse(&pos, &frame);
+        SIM_CHECK_EQ((uint16_t)(frame.sequence - last.sequence - 1), (uint16_t)(frame.dropped - last.dropped));
+        gaps += (uint16_t)(frame.sequence - last.sequence - 1);
+        last = frame;
+    }
+    SIM_CHECK_EQ(pos, sim_uarte_captured());
+    SIM_CHECK_EQ(gaps + 199 - last.sequence, sample_stream_dropped_get());
+
+    p_file = fopen(CAPTURE_PATH, "wb");
+    SIM_CHECK(p_file != NULL);
+    SIM_CHECK_EQ(fwrite(m_capture, 1, pos, p_file), pos);
+    fclose(p_file);
+    printf("200 frames every 0.7 ms: %u sent, %u dropped\n",
+           (unsigned)sent, (unsigned)sample_stream_dropped_get());
+}
+
+int main(void)
+{
+    m_trace_length = sim_mma7660_trace_load(TRACE_PATH, m_trace, TRACE_MAX, 0);
+    test_stream();
+    test_dropped();
+    printf("test_sample_stream: OK\n");
+    return 0;
+}
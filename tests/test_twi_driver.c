@@ -0,0 +1,640 @@
+/* Copyright (c) 2015 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+
+/* TWI driver tests on the simulator: TWIM transfer types and flags, scan tables, blocking mode,
+ * the recovery engine and the legacy TWI byte pump. */
+
+#include "sim.h"
+#include "sim_reg_slave.h"
+#include "nrf_drv_twi_mod.h"
+#include <stdio.h>
+#include <string.h>
+
+#define TWIM_BUS    0   // TWI0, EasyDMA.
+#define TWI_BUS     1   // TWI1, legacy.
+#define SLAVE_ADDR  0x4C
+#define SLAVE2_ADDR 0x1D
+
+static const nrf_drv_twi_t m_twim = NRF_DRV_TWI_INSTANCE(0);
+static const nrf_drv_twi_t m_twi  = NRF_DRV_TWI_INSTANCE(1);
+
+static sim_reg_slave_t m_slave;
+static sim_reg_slave_t m_slave2;
+
+static nrf_drv_twi_evt_t m_events[16];
+static volatile uint32_t m_event_count;
+
+static uint8_t m_tx[32];
+static uint8_t m_rx[64];
+
+static void twi_handler(nrf_drv_twi_evt_t const * p_event, void * p_context)
+{
+    (void)p_context;
+    if (m_event_count < sizeof(m_events) / sizeof(m_events[0]))
+    {
+        m_events[m_event_count] = *p_event;
+    }
+    m_event_count++;
+}
+
+static bool one_event(void)
+{
+    return m_event_count >= 1;
+}
+
+static bool m_twim_init;
+static bool m_twi_init;
+
+static void setup(void)
+{
+    if (m_twim_init)
+    {
+        nrf_drv_twi_uninit(&m_twim);
+    }
+    if (m_twi_init)
+    {
+        nrf_drv_twi_uninit(&m_twi);
+    }
+    m_twim_init = false;
+    m_twi_init  = false;
+    sim_reset();
+    sim_reg_slave_init(&m_slave, SLAVE_ADDR);
+    sim_reg_slave_init(&m_slave2, SLAVE2_ADDR);
+    sim_slave_attach(TWIM_BUS, &m_slave.slave);
+    sim_slave_attach(TWIM_BUS, &m_slave2.slave);
+    m_event_count = 0;
+    memset(m_rx, 0, sizeof(m_rx));
+}
+
+static void init(nrf_drv_twi_t const * p_instance, nrf_drv_twi_evt_handler_t handler)
+{
+    SIM_CHECK_EQ(nrf_drv_twi_init(p_instance, NULL, handler, NULL), NRF_SUCCESS);
+    *((p_instance == &m_twim) ? &m_twim_init : &m_twi_init) = true;
+    nrf_drv_twi_enable(p_instance);
+}
+
+typedef struct
+{
+    char const * name;
+    uint64_t     bus_ns;
+    uint32_t     isr_count;
+    uint64_t     cpu_ns;
+} cost_t;
+
+static cost_t m_costs[16];
+static uint32_t m_cost_count;
+
+// Runs one non-blocking transfer to its event and records what it cost.
+static void xfer_measure(char const * p_name, nrf_drv_twi_xfer_desc_t * p_desc, uint32_t flags)
+{
+    sim_cpu_stats_t cpu0, cpu1;
+    sim_bus_stats_t bus0, bus1;
+
+    sim_cpu_stats_get(&cpu0);
+    sim_bus_stats_get(TWIM_BUS, &bus0);
+    m_event_count = 0;
+    SIM_CHECK_EQ(nrf_drv_twi_xfer(&m_twim, p_desc, flags), NRF_SUCCESS);
+    SIM_CHECK(sim_run_until(one_event, 10000000));
+    SIM_CHECK_EQ(m_events[0].type, NRF_DRV_TWI_EVT_DONE);
+    SIM_CHECK_EQ(m_events[0].xfer_desc.type, p_desc->type);
+    sim_cpu_stats_get(&cpu1);
+    sim_bus_stats_get(TWIM_BUS, &bus1);
+    m_costs[m_cost_count++] = (cost_t){ p_name, bus1.busy_ns - bus0.busy_ns,
+                                        cpu1.isr_count - cpu0.isr_count,
+                                        cpu1.active_ns - cpu0.active_ns };
+}
+
+// TX, RX, TXRX and TXTX with their flag combinations, on TWIM (user-001).
+static void test_twim_xfers(void)
+{
+    setup();
+    init(&m_twim, twi_handler);
+
+    m_tx[0] = 0x10;
+    m_tx[1] = 0xA1;
+    m_tx[2] = 0xA2;
+    nrf_drv_twi_xfer_desc_t tx = NRF_DRV_TWI_XFER_DESC_TX(SLAVE_ADDR, m_tx, 3);
+    xfer_measure("TX 1+2", &tx, 0);
+    SIM_CHECK_EQ(m_slave.regs[0x10], 0xA1);
+    SIM_CHECK_EQ(m_slave.regs[0x11], 0xA2);
+    SIM_CHECK_EQ(m_slave.access_count, 1);
+
+    nrf_drv_twi_xfer_desc_t txrx = NRF_DRV_TWI_XFER_DESC_TXRX(SLAVE_ADDR, m_tx, 1, m_rx, 2);
+    xfer_measure("TXRX 1+2", &txrx, 0);
+    SIM_CHECK_EQ(m_rx[0], 0xA1);
+    SIM_CHECK_EQ(m_rx[1], 0xA2);
+    SIM_CHECK_EQ(m_slave.access_count, 3);
+    SIM_CHECK(m_slave.log[2].read);
+
+    nrf_drv_twi_xfer_desc_t rx = NRF_DRV_TWI_XFER_DESC_RX(SLAVE_ADDR, &m_rx[4], 3);
+    m_slave.pointer = 0x10;
+    xfer_measure("RX 3", &rx, 0);
+    SIM_CHECK_EQ(m_rx[4], 0xA1);
+    SIM_CHECK_EQ(m_rx[5], 0xA2);
+
+    // TXTX: a repeated START and the address again between the two buffers.
+    m_tx[4] = 0x20;
+    m_tx[5] = 0xB1;
+    nrf_drv_twi_xfer_desc_t txtx = NRF_DRV_TWI_XFER_DESC_TXTX(SLAVE_ADDR, &m_tx[4], 1, &m_tx[5], 1);
+    uint32_t accesses = m_slave.access_count;
+    xfer_measure("TXTX 1+1", &txtx, 0);
+    SIM_CHECK_EQ(m_slave.access_count, accesses + 2);
+
+    // TX without STOP then RX: the RX starts with a repeated START on the held bus.
+    sim_bus_stats_t bus;
+    sim_bus_stats_get(TWIM_BUS, &bus);
+    uint32_t stops = bus.stops;
+    nrf_drv_twi_xfer_desc_t tx_reg = NRF_DRV_TWI_XFER_DESC_TX(SLAVE_ADDR, m_tx, 1);
+    xfer_measure("TX no stop", &tx_reg, NRF_DRV_TWI_FLAGS_TX_NO_STOP);
+    memset(m_rx, 0, sizeof(m_rx));
+    nrf_drv_twi_xfer_desc_t rx2 = NRF_DRV_TWI_XFER_DESC_RX(SLAVE_ADDR, m_rx, 2);
+    xfer_measure("+ RX 2", &rx2, 0);
+    SIM_CHECK_EQ(m_rx[0], 0xA1);
+    SIM_CHECK_EQ(m_rx[1], 0xA2);
+    sim_bus_stats_get(TWIM_BUS, &bus);
+    SIM_CHECK_EQ(bus.stops, stops + 1);
+
+    // NO_XFER_EVT_HANDLER: no interrupt, STOPPED is left for the application.
+    sim_cpu_stats_t cpu0, cpu1;
+    sim_cpu_stats_get(&cpu0);
+    m_event_count = 0;
+    SIM_CHECK_EQ(nrf_drv_twi_xfer(&m_twim, &txrx, NRF_DRV_TWI_FLAGS_NO_XFER_EVT_HANDLER), NRF_SUCCESS);
+    sim_run(1000000);
+    sim_cpu_stats_get(&cpu1);
+    SIM_CHECK_EQ(m_event_count, 0);
+    SIM_CHECK_EQ(cpu1.isr_count, cpu0.isr_count);
+    SIM_CHECK(*(volatile uint32_t *)(uintptr_t)nrf_drv_twi_stopped_event_get(&m_twim) != 0);
+
+    // HOLD + REPEATED + RX_POSTINC: each trigger of the start task reads the next record.
+    memset(m_rx, 0, sizeof(m_rx));
+    nrf_drv_twi_xfer_desc_t rep = NRF_DRV_TWI_XFER_DESC_TXRX(SLAVE_ADDR, m_tx, 1, m_rx, 2);
+    SIM_CHECK_EQ(nrf_drv_twi_xfer(&m_twim, &rep, NRF_DRV_TWI_FLAGS_HOLD_XFER |
+                                              NRF_DRV_TWI_FLAGS_REPEATED_XFER |
+                                              NRF_DRV_TWI_FLAGS_RX_POSTINC |
+                                              NRF_DRV_TWI_FLAGS_NO_XFER_EVT_HANDLER), NRF_SUCCESS);
+    sim_run(1000000);
+    SIM_CHECK_EQ(m_rx[0], 0);
+    for (uint32_t i = 0; i < 4; i++)
+    {
+        m_slave.regs[0x10] = (uint8_t)(0x40 + i);
+        sim_task_trigger(nrf_drv_twi_start_task_get(&m_twim, NRF_DRV_TWI_XFER_TXRX));
+        sim_run(1000000);
+    }
+    for (uint32_t i = 0; i < 4; i++)
+    {
+        SIM_CHECK_EQ(m_rx[2 * i], 0x40 + i);
+        SIM_CHECK_EQ(m_rx[2 * i + 1], 0xA2);
+    }
+    SIM_CHECK_EQ(m_event_count, 0);
+    SIM_CHECK_EQ(sim_dma_stack_accesses(), 0);
+
+    printf("%-12s %10s %6s %10s\n", "TWIM 100k", "bus us", "ISRs", "CPU us");
+    for (uint32_t i = 0; i < m_cost_count; i++)
+    {
+        printf("%-12s %10.1f %6u %10.2f\n", m_costs[i].name, m_costs[i].bus_ns / 1000.0,
+               (unsigned)m_costs[i].isr_count, m_costs[i].cpu_ns / 1000.0);
+    }
+}
+
+// A queued batch calls the handler once, after its last transfer (user-002).
+static void test_twim_queue(void)
+{
+    static nrf_drv_twi_xfer_desc_t batch[4];
+
+    setup();
+    init(&m_twim, twi_handler);
+    for (uint32_t i = 0; i < 4; i++)
+    {
+        m_tx[2 * i]     = (uint8_t)(0x30 + i);
+        m_tx[2 * i + 1] = (uint8_t)(0xC0 + i);
+        batch[i] = (nrf_drv_twi_xfer_desc_t)NRF_DRV_TWI_XFER_DESC_TX(SLAVE_ADDR, &m_tx[2 * i], 2);
+    }
+    SIM_CHECK_EQ(nrf_drv_twi_xfer_queue(&m_twim, batch, 4, NRF_DRV_TWI_FLAGS_BATCH_EVT), NRF_SUCCESS);
+    SIM_CHECK(sim_run_until(one_event, 10000000));
+    sim_run(1000000);
+    SIM_CHECK_EQ(m_event_count, 1);
+    SIM_CHECK_EQ(m_events[0].type, NRF_DRV_TWI_EVT_DONE);
+    SIM_CHECK(m_events[0].xfer_desc.p_primary_buf == &m_tx[6]);
+    for (uint32_t i = 0; i < 4; i++)
+    {
+        SIM_CHECK_EQ(m_slave.regs[0x30 + i], 0xC0 + i);
+    }
+    SIM_CHECK_EQ(m_slave.access_count, 4);
+}
+
+// A batch with a descriptor that cannot be started is rejected whole, nothing of it reaches the
+// bus, and the queue goes on with the next batch; an unknown type does not leave the driver busy
+// (user-002).
+static void test_twim_queue_reject(void)
+{
+    static nrf_drv_twi_xfer_desc_t batch[3];
+    nrf_drv_twi_t const * instances[] = { &m_twim, &m_twi };
+
+    for (uint32_t n = 0; n < 2; n++)
+    {
+        nrf_drv_twi_t const * p_instance = instances[n];
+
+        setup();
+        sim_slave_attach(TWI_BUS, &m_slave.slave);
+        init(p_instance, twi_handler);
+        for (uint32_t i = 0; i < 3; i++)
+        {
+            m_tx[2 * i]     = (uint8_t)(0x30 + i);
+            m_tx[2 * i + 1] = (uint8_t)(0xD0 + i);
+            batch[i] = (nrf_drv_twi_xfer_desc_t)NRF_DRV_TWI_XFER_DESC_TX(SLAVE_ADDR, &m_tx[2 * i], 2);
+        }
+
+        batch[1].type = (nrf_drv_twi_xfer_type_t)(NRF_DRV_TWI_XFER_TXTX + 1);
+        SIM_CHECK_EQ(nrf_drv_twi_xfer_queue(p_instance, batch, 3, NRF_DRV_TWI_FLAGS_BATCH_EVT),
+                     NRF_ERROR_INVALID_PARAM);
+        batch[1].type = NRF_DRV_TWI_XFER_RX;
+        SIM_CHECK_EQ(nrf_drv_twi_xfer_queue(p_instance, batch, 3, NRF_DRV_TWI_FLAGS_TX_NO_STOP),
+                     NRF_ERROR_NOT_SUPPORTED);
+        SIM_CHECK_EQ(nrf_drv_twi_xfer_queue(p_instance, batch, 3, NRF_DRV_TWI_FLAGS_HOLD_XFER),
+                     NRF_ERROR_NOT_SUPPORTED);
+        batch[1] = (nrf_drv_twi_xfer_desc_t)NRF_DRV_TWI_XFER_DESC_TX(SLAVE_ADDR, NULL, 2);
+        if (p_instance == &m_twim)
+        {
+            SIM_CHECK_EQ(nrf_drv_twi_xfer_queue(p_instance, batch, 3, NRF_DRV_TWI_FLAGS_BATCH_EVT),
+                         NRF_ERROR_INVALID_ADDR);
+        }
+        sim_run(1000000);
+        SIM_CHECK_EQ(m_event_count, 0);
+        SIM_CHECK_EQ(m_slave.access_count, 0);
+
+        batch[1].type = (nrf_drv_twi_xfer_type_t)(NRF_DRV_TWI_XFER_TXTX + 1);
+        batch[1].p_primary_buf = &m_tx[2];
+        SIM_CHECK_EQ(nrf_drv_twi_xfer(p_instance, &batch[1], 0), NRF_ERROR_INVALID_PARAM);
+
+        batch[1].type = NRF_DRV_TWI_XFER_TX;
+        SIM_CHECK_EQ(nrf_drv_twi_xfer_queue(p_instance, batch, 3, NRF_DRV_TWI_FLAGS_BATCH_EVT), NRF_SUCCESS);
+        SIM_CHECK(sim_run_until(one_event, 10000000));
+        sim_run(1000000);
+        SIM_CHECK_EQ(m_event_count, 1);
+        SIM_CHECK_EQ(m_events[0].type, NRF_DRV_TWI_EVT_DONE);
+        SIM_CHECK(m_events[0].xfer_desc.p_primary_buf == &m_tx[4]);
+        for (uint32_t i = 0; i < 3; i++)
+        {
+            SIM_CHECK_EQ(m_slave.regs[0x30 + i], 0xD0 + i);
+        }
+        SIM_CHECK_EQ(m_slave.access_count, 3);
+    }
+}
+
+static nrf_drv_twi_xfer_desc_t m_race_b;
+static uint64_t                m_race_isr_ns;
+
+// Queues transfer B from the handler, when transfer A is done.
+static void race_handler(nrf_drv_twi_evt_t const * p_event, void * p_context)
+{
+    twi_handler(p_event, p_context);
+    if (p_event->xfer_desc.p_primary_buf == &m_tx[0])
+    {
+        m_race_isr_ns = sim_now();
+        SIM_CHECK_EQ(nrf_drv_twi_xfer_queue(&m_twim, &m_race_b, 1, 0), NRF_SUCCESS);
+    }
+}
+
+// Thread queues C while the handler of A queues B: every start time of C around the interrupt
+// must end with both B and C on the bus (user-002).
+static void test_twim_queue_race(void)
+{
+    nrf_drv_twi_xfer_desc_t a = NRF_DRV_TWI_XFER_DESC_TX(SLAVE_ADDR, &m_tx[0], 2);
+    nrf_drv_twi_xfer_desc_t c = NRF_DRV_TWI_XFER_DESC_TX(SLAVE2_ADDR, &m_tx[4], 2);
+    uint64_t isr_ns = 0;
+
+    m_race_b = (nrf_drv_twi_xfer_desc_t)NRF_DRV_TWI_XFER_DESC_TX(SLAVE_ADDR, &m_tx[2], 2);
+    for (int32_t delay_ns = -1; delay_ns < 3000; delay_ns += 7)
+    {
+        uint64_t t0;
+
+        setup();
+        init(&m_twim, race_handler);
+        memcpy(m_tx, (uint8_t []){ 0x40, 0xA4, 0x50, 0xB5, 0x60, 0xC6 }, 6);
+        t0 = sim_now();
+        SIM_CHECK_EQ(nrf_drv_twi_xfer_queue(&m_twim, &a, 1, 0), NRF_SUCCESS);
+        if (delay_ns < 0)
+        {
+            // Dry run, to find when the handler of A runs.
+            SIM_CHECK(sim_run_until(one_event, 10000000));
+            isr_ns = m_race_isr_ns - t0;
+            sim_run(2000000);
+            continue;
+        }
+        sim_cpu(isr_ns - 2000 - (sim_now() - t0) + (uint64_t)delay_ns);
+        SIM_CHECK_EQ(nrf_drv_twi_xfer_queue(&m_twim, &c, 1, 0), NRF_SUCCESS);
+        sim_run(2000000);
+        SIM_CHECK_EQ(m_event_count, 3);
+        SIM_CHECK_EQ(m_slave.regs[0x40], 0xA4);
+        SIM_CHECK_EQ(m_slave.regs[0x50], 0xB5);
+        SIM_CHECK_EQ(m_slave2.regs[0x60], 0xC6);
+    }
+}
+
+// Scan table over two slaves, records back to back in table order, and a missing slave (user-003).
+static void test_twim_scan(void)
+{
+    static const nrf_drv_twi_scan_entry_t table[] = {
+        { SLAVE_ADDR,  0x00, 3 },
+        { SLAVE2_ADDR, 0x08, 2 },
+    };
+    static const nrf_drv_twi_scan_entry_t table_nack[] = {
+        { SLAVE_ADDR,  0x00, 3 },
+        { 0x33,        0x00, 2 },
+        { SLAVE2_ADDR, 0x08, 2 },
+    };
+    uint32_t start_task;
+
+    setup();
+    init(&m_twim, twi_handler);
+    m_slave.regs[0] = 1;
+    m_slave.regs[1] = 2;
+    m_slave.regs[2] = 3;
+    m_slave2.regs[8] = 8;
+    m_slave2.regs[9] = 9;
+
+    SIM_CHECK_EQ(nrf_drv_twi_scan_setup(&m_twim, table, 2, m_rx, 3), NRF_SUCCESS);
+    start_task = nrf_drv_twi_start_task_get(&m_twim, NRF_DRV_TWI_XFER_TXRX);
+    for (uint32_t cycle = 0; cycle < 3; cycle++)
+    {
+        m_slave.regs[0] = (uint8_t)(0x10 * cycle + 1);
+        sim_task_trigger(start_task);
+        sim_run(2000000);
+        SIM_CHECK_EQ(m_event_count, (cycle == 2) ? 1 : 0);
+    }
+    SIM_CHECK_EQ(m_events[0].type, NRF_DRV_TWI_EVT_SCAN_DONE);
+    SIM_CHECK_EQ(m_events[0].xfer_desc.secondary_length, 5);
+    for (uint32_t cycle = 0; cycle < 3; cycle++)
+    {
+        uint8_t const * p_record = &m_rx[5 * cycle];
+        SIM_CHECK_EQ(p_record[0], 0x10 * cycle + 1);
+        SIM_CHECK_EQ(p_record[1], 2);
+        SIM_CHECK_EQ(p_record[2], 3);
+        SIM_CHECK_EQ(p_record[3], 8);
+        SIM_CHECK_EQ(p_record[4], 9);
+    }
+    // The next cycle is written at the start of the buffer again.
+    m_slave.regs[0] = 0x77;
+    sim_task_trigger(start_task);
+    sim_run(2000000);
+    SIM_CHECK_EQ(m_rx[0], 0x77);
+    nrf_drv_twi_scan_stop(&m_twim);
+
+    // A NACK reports the entry and the rest of the cycle still lands in its place.
+    memset(m_rx, 0, sizeof(m_rx));
+    m_event_count = 0;
+    SIM_CHECK_EQ(nrf_drv_twi_scan_setup(&m_twim, table_nack, 3, m_rx, 1), NRF_SUCCESS);
+    sim_task_trigger(start_task);
+    sim_run(3000000);
+    SIM_CHECK_EQ(m_event_count, 2);
+    SIM_CHECK_EQ(m_events[0].type, NRF_DRV_TWI_EVT_ADDRESS_NACK);
+    SIM_CHECK_EQ(m_events[0].xfer_desc.address, 0x33);
+    SIM_CHECK(m_events[0].xfer_desc.p_secondary_buf == &m_rx[3]);
+    SIM_CHECK_EQ(m_events[1].type, NRF_DRV_TWI_EVT_SCAN_DONE);
+    SIM_CHECK_EQ(m_rx[0], 0x77);
+    SIM_CHECK_EQ(m_rx[5], 8);
+    SIM_CHECK_EQ(m_rx[6], 9);
+    nrf_drv_twi_scan_stop(&m_twim);
+}
+
+// Blocking transfers sleep on WFE, against a busy-poll of the same transfers (user-009).
+static void test_twim_blocking(void)
+{
+    sim_cpu_stats_t cpu[2];
+
+    for (uint32_t poll = 0; poll < 2; poll++)
+    {
+        setup();
+        init(&m_twim, NULL);
+        sim_wfe_disable(poll != 0);
+        m_tx[0] = 0x10;
+        m_tx[1] = 0x5A;
+        SIM_CHECK_EQ(nrf_drv_twi_tx(&m_twim, SLAVE_ADDR, m_tx, 2, false), NRF_SUCCESS);
+        SIM_CHECK_EQ(nrf_drv_twi_tx(&m_twim, SLAVE_ADDR, m_tx, 1, true), NRF_SUCCESS);
+        SIM_CHECK_EQ(nrf_drv_twi_rx(&m_twim, SLAVE_ADDR, m_rx, 1), NRF_SUCCESS);
+        SIM_CHECK_EQ(m_rx[0], 0x5A);
+        SIM_CHECK_EQ(m_slave.regs[0x10], 0x5A);
+        sim_cpu_stats_get(&cpu[poll]);
+        // The interrupt stays disabled in the NVIC, the handler never runs.
+        SIM_CHECK_EQ(cpu[poll].isr_count, 0);
+        sim_wfe_disable(false);
+    }
+    printf("blocking TX, TX+RX: CPU active %.1f us with WFE (%u WFE), %.1f us polling\n",
+           cpu[0].active_ns / 1000.0, (unsigned)cpu[0].wfe_count, cpu[1].active_ns / 1000.0);
+    SIM_CHECK(cpu[0].active_ns * 10 < cpu[1].active_ns);
+
+    // The interrupt line is shared with SPI: its NVIC enable and SCR are left as they were.
+    for (uint32_t scr = 0; scr <= SCB_SCR_SEVONPEND_Msk; scr += SCB_SCR_SEVONPEND_Msk)
+    {
+        setup();
+        init(&m_twim, NULL);
+        NVIC_EnableIRQ(SPI0_TWI0_IRQn);
+        SCB->SCR = scr | (1UL << 1);
+        m_tx[1] = (uint8_t)(0x30 + scr);
+        SIM_CHECK_EQ(nrf_drv_twi_tx(&m_twim, SLAVE_ADDR, m_tx, 2, false), NRF_SUCCESS);
+        SIM_CHECK_EQ(m_slave.regs[0x10], 0x30 + scr);
+        SIM_CHECK_EQ(SCB->SCR, scr | (1UL << 1));
+        SIM_CHECK(NVIC->ISER[0] & (1UL << SPI0_TWI0_IRQn));
+        sim_run(100000);
+        sim_cpu_stats_get(&cpu[0]);
+        SIM_CHECK_EQ(cpu[0].isr_count, 0);
+        SIM_CHECK(cpu[0].wfe_count > 0);
+        NVIC_DisableIRQ(SPI0_TWI0_IRQn);
+    }
+}
+
+// Retries after address NACKs, failure after the last retry, and a bus clear (user-010).
+static void test_twim_recovery(void)
+{
+    nrf_drv_twi_error_stats_t stats;
+    sim_bus_stats_t           bus;
+    uint64_t                  t0;
+
+    setup();
+    init(&m_twim, NULL);
+    m_tx[0] = 0x10;
+    m_tx[1] = 0x66;
+
+    sim_fault_address_nack(TWIM_BUS, 2);
+    SIM_CHECK_EQ(nrf_drv_twi_tx(&m_twim, SLAVE_ADDR, m_tx, 2, false), NRF_SUCCESS);
+    nrf_drv_twi_error_stats_get(&m_twim, &stats);
+    SIM_CHECK_EQ(stats.address_nack, 2);
+    SIM_CHECK_EQ(stats.retries, 2);
+    SIM_CHECK_EQ(stats.failed, 0);
+    SIM_CHECK_EQ(m_slave.regs[0x10], 0x66);
+
+    sim_fault_address_nack(TWIM_BUS, 3);
+    SIM_CHECK_EQ(nrf_drv_twi_tx(&m_twim, SLAVE_ADDR, m_tx, 2, false), NRF_ERROR_INTERNAL);
+    nrf_drv_twi_error_stats_get(&m_twim, &stats);
+    SIM_CHECK_EQ(stats.failed, 1);
+
+    // SDA held low: TWI_RECOVERY_BUS_CLEAR_AFTER failed transfers, then the bus is clocked free.
+    setup();
+    init(&m_twim, NULL);
+    sim_fault_sda_stuck(TWIM_BUS, 5);
+    t0 = sim_now();
+    for (uint32_t i = 0; i < TWI_RECOVERY_BUS_CLEAR_AFTER; i++)
+    {
+        SIM_CHECK_EQ(nrf_drv_twi_tx(&m_twim, SLAVE_ADDR, m_tx, 2, false), NRF_ERROR_INTERNAL);
+    }
+    SIM_CHECK(!sim_sda_stuck(TWIM_BUS));
+    nrf_drv_twi_error_stats_get(&m_twim, &stats);
+    SIM_CHECK_EQ(stats.bus_clears, 1);
+    m_tx[1] = 0x67;
+    SIM_CHECK_EQ(nrf_drv_twi_tx(&m_twim, SLAVE_ADDR, m_tx, 2, false), NRF_SUCCESS);
+    SIM_CHECK_EQ(m_slave.regs[0x10], 0x67);
+    sim_bus_stats_get(TWIM_BUS, &bus);
+    printf("stuck SDA: recovered after %.2f ms, %u SCL pulses\n",
+           (sim_now() - t0) / 1e6, (unsigned)bus.scl_pulses);
+
+    // Non-blocking: the retry is started from the interrupt handler, one event at the end.
+    setup();
+    init(&m_twim, twi_handler);
+    sim_fault_address_nack(TWIM_BUS, 1);
+    nrf_drv_twi_xfer_desc_t tx = NRF_DRV_TWI_XFER_DESC_TX(SLAVE_ADDR, m_tx, 2);
+    SIM_CHECK_EQ(nrf_drv_twi_xfer(&m_twim, &tx, 0), NRF_SUCCESS);
+    SIM_CHECK(sim_run_until(one_event, 10000000));
+    sim_run(1000000);
+    SIM_CHECK_EQ(m_event_count, 1);
+    SIM_CHECK_EQ(m_events[0].type, NRF_DRV_TWI_EVT_DONE);
+    nrf_drv_twi_error_stats_get(&m_twim, &stats);
+    SIM_CHECK_EQ(stats.retries, 1);
+
+    // NO_RETRY: the NACK goes straight to the handler.
+    m_event_count = 0;
+    sim_fault_address_nack(TWIM_BUS, 1);
+    SIM_CHECK_EQ(nrf_drv_twi_xfer(&m_twim, &tx, NRF_DRV_TWI_FLAGS_NO_RETRY), NRF_SUCCESS);
+    SIM_CHECK(sim_run_until(one_event, 10000000));
+    SIM_CHECK_EQ(m_events[0].type, NRF_DRV_TWI_EVT_ADDRESS_NACK);
+}
+
+// Interrupts per transfer of the legacy TWI engine before user-012 (the driver of c6835d2),
+// measured on this simulator for the lengths of test_twi_legacy: RX, TXRX with a one byte
+// register address, and TX of the register address and the data.
+static const uint32_t m_legacy_isrs_before[4][3] = {
+    {  2,  3,  3 },
+    {  3,  4,  4 },
+    {  5,  6,  6 },
+    {  9, 10, 10 },
+};
+
+// Legacy TWI: one interrupt per byte, with the last byte of a read taken at STOPPED, against the
+// engine before the change (user-012).
+static void test_twi_legacy(void)
+{
+    static char const * const names[3] = { "RX", "TXRX", "TX" };
+    sim_cpu_stats_t cpu0, cpu1;
+    uint32_t        row = 0;
+
+    setup();
+    sim_slave_attach(TWI_BUS, &m_slave.slave);
+    init(&m_twi, twi_handler);
+
+    printf("%-12s %7s %7s %10s\n", "legacy 400k", "ISRs", "before", "CPU us");
+    for (uint32_t length = 1; length <= 8; length *= 2, row++)
+    {
+        for (uint32_t kind = 0; kind < 3; kind++)
+        {
+            nrf_drv_twi_xfer_desc_t desc;
+            uint32_t                isrs;
+            char                    name[16];
+
+            for (uint32_t i = 0; i < length; i++)
+            {
+                m_tx[1 + i] = (uint8_t)(0x80 + 0x10 * kind + length + i);
+            }
+            m_tx[0] = 0x20;
+            if (kind == 0)
+            {
+                memcpy(&m_slave.regs[0x20], &m_tx[1], length);
+                m_slave.pointer = 0x20;
+                desc = (nrf_drv_twi_xfer_desc_t)NRF_DRV_TWI_XFER_DESC_RX(SLAVE_ADDR, m_rx, (uint8_t)length);
+            }
+            else if (kind == 1)
+            {
+                desc = (nrf_drv_twi_xfer_desc_t)NRF_DRV_TWI_XFER_DESC_TXRX(SLAVE_ADDR, m_tx, 1, m_rx, (uint8_t)length);
+            }
+            else
+            {
+                m_tx[0] = 0x40;
+                desc = (nrf_drv_twi_xfer_desc_t)NRF_DRV_TWI_XFER_DESC_TX(SLAVE_ADDR, m_tx, (uint8_t)(length + 1));
+            }
+            memset(m_rx, 0, sizeof(m_rx));
+            m_event_count = 0;
+            sim_cpu_stats_get(&cpu0);
+            SIM_CHECK_EQ(nrf_drv_twi_xfer(&m_twi, &desc, 0), NRF_SUCCESS);
+            SIM_CHECK(sim_run_until(one_event, 10000000));
+            sim_cpu_stats_get(&cpu1);
+            sim_run(100000);
+            SIM_CHECK_EQ(m_event_count, 1);
+            SIM_CHECK_EQ(m_events[0].type, NRF_DRV_TWI_EVT_DONE);
+            if (kind == 2)
+            {
+                SIM_CHECK(memcmp(&m_slave.regs[0x40], &m_tx[1], length) == 0);
+            }
+            else
+            {
+                // TXRX reads back what the RX of this length placed at 0x20.
+                SIM_CHECK(memcmp(m_rx, &m_slave.regs[0x20], length) == 0);
+                SIM_CHECK_EQ(m_rx[length], 0);
+            }
+
+            isrs = cpu1.isr_count - cpu0.isr_count;
+            snprintf(name, sizeof(name), "%s %u", names[kind], (unsigned)length);
+            printf("%-12s %7u %7u %10.2f\n", name, (unsigned)isrs, (unsigned)m_legacy_isrs_before[row][kind],
+                   (cpu1.active_ns - cpu0.active_ns) / 1000.0);
+            if (kind == 2)
+            {
+                // No BB->STOP short helps a write: one interrupt per byte and STOPPED, as before.
+                SIM_CHECK_EQ(isrs, m_legacy_isrs_before[row][kind]);
+            }
+            else
+            {
+                SIM_CHECK_EQ(isrs, m_legacy_isrs_before[row][kind] - 1);
+            }
+        }
+    }
+
+    // Address NACK on the legacy TWI, retried once from the handler.
+    m_event_count = 0;
+    sim_fault_address_nack(TWI_BUS, 1);
+    nrf_drv_twi_xfer_desc_t tx = NRF_DRV_TWI_XFER_DESC_TX(SLAVE_ADDR, m_tx, 2);
+    SIM_CHECK_EQ(nrf_drv_twi_xfer(&m_twi, &tx, 0), NRF_SUCCESS);
+    SIM_CHECK(sim_run_until(one_event, 10000000));
+    SIM_CHECK_EQ(m_events[0].type, NRF_DRV_TWI_EVT_DONE);
+
+    // The same for a one byte read, which has no RXDREADY interrupt.
+    m_event_count = 0;
+    m_rx[0] = 0;
+    m_slave.pointer = 0x20;
+    sim_fault_address_nack(TWI_BUS, 1);
+    nrf_drv_twi_xfer_desc_t rx = NRF_DRV_TWI_XFER_DESC_RX(SLAVE_ADDR, m_rx, 1);
+    SIM_CHECK_EQ(nrf_drv_twi_xfer(&m_twi, &rx, 0), NRF_SUCCESS);
+    SIM_CHECK(sim_run_until(one_event, 10000000));
+    SIM_CHECK_EQ(m_events[0].type, NRF_DRV_TWI_EVT_DONE);
+    SIM_CHECK_EQ(m_rx[0], m_slave.regs[0x20]);
+}
+
+int main(void)
+{
+    test_twim_xfers();
+    test_twim_queue();
+    test_twim_queue_reject();
+    test_twim_queue_race();
+    test_twim_scan();
+    test_twim_blocking();
+    test_twim_recovery();
+    test_twi_legacy();
+    printf("test_twi_driver: OK\n");
+    return 0;
+}
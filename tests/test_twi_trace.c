@@ -0,0 +1,288 @@
+/* Copyright (c) 2015 Nordic Semiconductor. All Rights Reserved.
+ *
+ * The information contained herein is property of Nordic Semiconductor ASA.
+ * Terms and conditions of usage are described in detail in NORDIC
+ * SEMICONDUCTOR STANDARD SOFTWARE LICENSE AGREEMENT.
+ *
+ * Licensees are granted free, non-transferable use of the information. NO
+ * WARRANTY of ANY KIND is provided. This heading must NOT be removed from
+ * the file.
+ *
+ */
+
+
+/* Transfer trace of the TWI driver, built with TWI_TRACE_ENABLED and the simulator clock as the
+ * timestamp: records of queued, direct, blocking, failed and retried transfers on TWIM and the
+ * legacy TWI, the ring read back past an overwrite, and the text lines of the TWI list demo and a
+ * dump of the ring through common/tools/twi_trace_hist.py. */
+
+#include "sim.h"
+#include "sim_reg_slave.h"
+#include "nrf_drv_twi_mod.h"
+#include <stdio.h>
+#include <string.h>
+
+#define TWIM_BUS    0   // TWI0, EasyDMA.
+#define TWI_BUS     1   // TWI1, legacy.
+#define SLAVE_ADDR  0x4C
+#define RECORDS_MAX 16
+#define LOG_PATH    "_build/twi_trace.log"
+#define DUMP_PATH   "_build/twi_trace.bin"
+#define TOOL        "python3 ../common/tools/twi_trace_hist.py"
+
+static const nrf_drv_twi_t m_twim = NRF_DRV_TWI_INSTANCE(0);
+static const nrf_drv_twi_t m_twi  = NRF_DRV_TWI_INSTANCE(1);
+
+static sim_reg_slave_t     m_slave;
+static volatile uint32_t   m_event_count;
+static uint8_t             m_tx[32];
+static uint8_t             m_rx[32];
+static nrf_drv_twi_trace_t m_records[RECORDS_MAX];
+static uint32_t            m_record_count;
+static uint32_t            m_cursor;
+static uint32_t            m_reset_record; // First record after the last sim_reset, which restarts the clock.
+
+static void twi_handler(nrf_drv_twi_evt_t const * p_event, void * p_context)
+{
+    (void)p_event;
+    (void)p_context;
+    m_event_count++;
+}
+
+static bool events_done(void)
+{
+    return m_event_count >= 1;
+}
+
+static void init(nrf_drv_twi_t const * p_instance, nrf_drv_twi_evt_handler_t handler)
+{
+    SIM_CHECK_EQ(nrf_drv_twi_init(p_instance, NULL, handler, NULL), NRF_SUCCESS);
+    nrf_drv_twi_enable(p_instance);
+}
+
+// Runs one transfer to its event.
+static void xfer_run(nrf_drv_twi_t const * p_instance, nrf_drv_twi_xfer_desc_t * p_desc, uint32_t flags)
+{
+    m_event_count = 0;
+    SIM_CHECK_EQ(nrf_drv_twi_xfer(p_instance, p_desc, flags), NRF_SUCCESS);
+    SIM_CHECK(sim_run_until(events_done, 10000000));
+    sim_run(100000);
+}
+
+static void setup(uint8_t bus)
+{
+    sim_reset();
+    sim_reg_slave_init(&m_slave, SLAVE_ADDR);
+    sim_slave_attach(bus, &m_slave.slave);
+    m_reset_record = m_record_count;
+}
+
+// Reads the new records, each one in time order and after the previous one.
+static void records_read(uint32_t expected)
+{
+    uint32_t first = m_record_count;
+
+    while (nrf_drv_twi_trace_read(&m_cursor, &m_records[m_record_count]) == NRF_SUCCESS)
+    {
+        nrf_drv_twi_trace_t const * p_record = &m_records[m_record_count];
+
+        SIM_CHECK(p_record->submit <= p_record->start);
+        SIM_CHECK(p_record->start < p_record->end);
+        SIM_CHECK(p_record->end <= p_record->done);
+        if (m_record_count > m_reset_record)
+        {
+            SIM_CHECK(p_record->start >= m_records[m_record_count - 1].end);
+        }
+        SIM_CHECK(++m_record_count <= RECORDS_MAX);
+    }
+    SIM_CHECK_EQ(m_record_count - first, expected);
+}
+
+static void record_check(uint32_t index, uint8_t instance, nrf_drv_twi_xfer_type_t type,
+                         uint16_t bytes, uint8_t attempts, uint8_t errorsrc)
+{
+    nrf_drv_twi_trace_t const * p_record = &m_records[index];
+
+    SIM_CHECK_EQ(p_record->instance, instance);
+    SIM_CHECK_EQ(p_record->address, SLAVE_ADDR);
+    SIM_CHECK_EQ(p_record->type, type);
+    SIM_CHECK_EQ(p_record->bytes, bytes);
+    SIM_CHECK_EQ(p_record->attempts, attempts);
+    SIM_CHECK_EQ(p_record->errorsrc, errorsrc);
+}
+
+// TWIM: a queued batch, TXTX, a NACK without retry, a retried NACK and a blocking TX.
+static void test_twim(void)
+{
+    static nrf_drv_twi_xfer_desc_t batch[3];
+    uint64_t                       bus_ns;
+
+    setup(TWIM_BUS);
+    init(&m_twim, twi_handler);
+
+    memcpy(m_tx, (uint8_t []){ 0x10, 0xA1, 0xA2, 0x10, 0x20, 0xB1 }, 6);
+    batch[0] = (nrf_drv_twi_xfer_desc_t)NRF_DRV_TWI_XFER_DESC_TX(SLAVE_ADDR, m_tx, 3);
+    batch[1] = (nrf_drv_twi_xfer_desc_t)NRF_DRV_TWI_XFER_DESC_TXRX(SLAVE_ADDR, &m_tx[3], 1, m_rx, 2);
+    batch[2] = (nrf_drv_twi_xfer_desc_t)NRF_DRV_TWI_XFER_DESC_RX(SLAVE_ADDR, &m_rx[2], 3);
+    m_event_count = 0;
+    SIM_CHECK_EQ(nrf_drv_twi_xfer_queue(&m_twim, batch, 3, NRF_DRV_TWI_FLAGS_BATCH_EVT), NRF_SUCCESS);
+    SIM_CHECK(sim_run_until(events_done, 10000000));
+    sim_run(100000);
+    records_read(3);
+    record_check(0, 0, NRF_DRV_TWI_XFER_TX, 3, 1, 0);
+    record_check(1, 0, NRF_DRV_TWI_XFER_TXRX, 3, 1, 0);
+    record_check(2, 0, NRF_DRV_TWI_XFER_RX, 3, 1, 0);
+    // The batch was queued at once: the later transfers start from the interrupt of the one
+    // before, ahead of its handler, and their queue time covers the bus time before them.
+    bus_ns = 0;
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        SIM_CHECK(m_records[i].submit <= m_records[0].start);
+        SIM_CHECK(m_records[i].start - m_records[i].submit >= bus_ns);
+        bus_ns += m_records[i].end - m_records[i].start;
+    }
+    SIM_CHECK(m_records[1].start <= m_records[0].done);
+    SIM_CHECK(m_records[2].start <= m_records[1].done);
+
+    nrf_drv_twi_xfer_desc_t txtx = NRF_DRV_TWI_XFER_DESC_TXTX(SLAVE_ADDR, &m_tx[4], 1, &m_tx[5], 1);
+    xfer_run(&m_twim, &txtx, 0);
+    records_read(1);
+    record_check(3, 0, NRF_DRV_TWI_XFER_TXTX, 2, 1, 0);
+
+    nrf_drv_twi_xfer_desc_t tx = NRF_DRV_TWI_XFER_DESC_TX(SLAVE_ADDR, m_tx, 2);
+    sim_fault_address_nack(TWIM_BUS, 1);
+    xfer_run(&m_twim, &tx, NRF_DRV_TWI_FLAGS_NO_RETRY);
+    records_read(1);
+    record_check(4, 0, NRF_DRV_TWI_XFER_TX, 0, 1, NRF_TWIM_ERROR_ADDRESS_NACK);
+
+    sim_fault_address_nack(TWIM_BUS, 1);
+    xfer_run(&m_twim, &tx, 0);
+    records_read(1);
+    record_check(5, 0, NRF_DRV_TWI_XFER_TX, 2, 2, 0);
+
+    nrf_drv_twi_uninit(&m_twim);
+    init(&m_twim, NULL);
+    SIM_CHECK_EQ(nrf_drv_twi_tx(&m_twim, SLAVE_ADDR, m_tx, 3, false), NRF_SUCCESS);
+    records_read(1);
+    record_check(6, 0, NRF_DRV_TWI_XFER_TX, 3, 1, 0);
+    SIM_CHECK_EQ(m_records[6].submit, m_records[6].start);
+    nrf_drv_twi_uninit(&m_twim);
+}
+
+// Legacy TWI: TX and RX byte counts on the second instance.
+static void test_twi(void)
+{
+    setup(TWI_BUS);
+    init(&m_twi, twi_handler);
+
+    nrf_drv_twi_xfer_desc_t tx = NRF_DRV_TWI_XFER_DESC_TX(SLAVE_ADDR, m_tx, 3);
+    xfer_run(&m_twi, &tx, 0);
+    nrf_drv_twi_xfer_desc_t rx = NRF_DRV_TWI_XFER_DESC_RX(SLAVE_ADDR, m_rx, 2);
+    m_slave.pointer = 0x10;
+    xfer_run(&m_twi, &rx, 0);
+    records_read(2);
+    record_check(7, 1, NRF_DRV_TWI_XFER_TX, 3, 1, 0);
+    record_check(8, 1, NRF_DRV_TWI_XFER_RX, 2, 1, 0);
+    SIM_CHECK_EQ(m_rx[0], 0xA1);
+    nrf_drv_twi_uninit(&m_twi);
+}
+
+// Runs the tool on a file and checks that every expected line is in its report.
+static void tool_check(char const * p_args, char const * const * pp_lines, uint32_t line_count)
+{
+    char  command[160];
+    char  report[4096];
+    FILE * p_pipe;
+    size_t size;
+
+    snprintf(command, sizeof(command), TOOL " %s", p_args);
+    p_pipe = popen(command, "r");
+    SIM_CHECK(p_pipe != NULL);
+    size = fread(report, 1, sizeof(report) - 1, p_pipe);
+    report[size] = '\0';
+    SIM_CHECK_EQ(pclose(p_pipe), 0);
+    for (uint32_t i = 0; i < line_count; i++)
+    {
+        if (strstr(report, pp_lines[i]) == NULL)
+        {
+            sim_fail("\"%s\" not in the report of %s:\n%s", pp_lines[i], command, report);
+        }
+    }
+}
+
+// The records as the TWI list demo prints them, and the ring as a debugger dumps it.
+static void test_tool(void)
+{
+    char          throughput[64];
+    char const *  lines[] = { "queue: n=9", "bus: n=9", "handler: n=9", "total: n=9",
+                              throughput, "transfers: TX 5, RX 2, TXRX 1, TXTX 1",
+                              "failed: 1, retried: 1", "address NACK: 1" };
+    uint32_t      bytes = 0;
+    FILE *        p_file;
+
+    for (uint32_t i = 0; i < m_record_count; i++)
+    {
+        bytes += m_records[i].bytes;
+    }
+    snprintf(throughput, sizeof(throughput), "throughput: %u bytes", (unsigned)bytes);
+
+    p_file = fopen(LOG_PATH, "w");
+    SIM_CHECK(p_file != NULL);
+    fprintf(p_file, "boot\n");
+    for (uint32_t i = 0; i < m_record_count; i++)
+    {
+        nrf_drv_twi_trace_t const * p_record = &m_records[i];
+
+        fprintf(p_file, "TWI,%lu,%u,%u,%u,%u,%u,%u,%lu,%lu,%lu,%lu\n\r",
+                (unsigned long)i, p_record->instance, p_record->address, p_record->type,
+                p_record->attempts, p_record->errorsrc, p_record->bytes,
+                (unsigned long)p_record->submit, (unsigned long)p_record->start,
+                (unsigned long)p_record->end, (unsigned long)p_record->done);
+    }
+    fclose(p_file);
+    tool_check("--hz 1000000000 " LOG_PATH, lines, sizeof(lines) / sizeof(lines[0]));
+
+    p_file = fopen(DUMP_PATH, "wb");
+    SIM_CHECK(p_file != NULL);
+    SIM_CHECK_EQ(fwrite(&nrf_drv_twi_trace, sizeof(nrf_drv_twi_trace), 1, p_file), 1);
+    fclose(p_file);
+    tool_check("--dump " DUMP_PATH, lines, sizeof(lines) / sizeof(lines[0]));
+}
+
+// A reader more than TWI_TRACE_SIZE records behind skips to the oldest record still in the ring.
+static void test_overwrite(void)
+{
+    nrf_drv_twi_trace_t record;
+    uint32_t            cursor = m_cursor;
+    uint32_t            count = 0;
+
+    setup(TWIM_BUS);
+    init(&m_twim, NULL);
+    for (uint32_t i = 0; i < TWI_TRACE_SIZE + 5; i++)
+    {
+        m_tx[1] = (uint8_t)i;
+        SIM_CHECK_EQ(nrf_drv_twi_tx(&m_twim, SLAVE_ADDR, m_tx, 2, false), NRF_SUCCESS);
+    }
+    while (nrf_drv_twi_trace_read(&cursor, &record) == NRF_SUCCESS)
+    {
+        count++;
+    }
+    SIM_CHECK_EQ(count, TWI_TRACE_SIZE);
+    SIM_CHECK_EQ(cursor, nrf_drv_twi_trace.head);
+    SIM_CHECK_EQ(nrf_drv_twi_trace.head, m_cursor + TWI_TRACE_SIZE + 5);
+    nrf_drv_twi_uninit(&m_twim);
+}
+
+int main(void)
+{
+    SIM_CHECK_EQ(nrf_drv_twi_trace.magic, NRF_DRV_TWI_TRACE_MAGIC);
+    SIM_CHECK_EQ(nrf_drv_twi_trace.timestamp_hz, 1000000000UL);
+    test_twim();
+    test_twi();
+    test_tool();
+    test_overwrite();
+    printf("%u records checked, read back by twi_trace_hist.py from text and from a ring dump\n",
+           (unsigned)m_record_count);
+    printf("test_twi_trace: OK\n");
+    return 0;
+}